@@ -0,0 +1,159 @@
+#pragma once
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "GatewareDefine.h"
+#include "GenericDefines.h"
+#include "GpuMemory.h"
+
+/*
+* Destroys GPU resources once the frames that may still use them are done, instead of waiting for the device to go idle
+*	Everything retired during frame N is destroyed at the start of frame N + FramesInFlight, by then StartFrame() has waited
+*	on the fence of frame N's slot and every frame up to N has finished on the GPU
+*	BeginFrame() has to be called once per frame right after StartFrame() succeeded
+*/
+class DeletionQueue
+{
+public:
+	struct Stats
+	{
+		uint32 PendingCount;
+		uint32 DestroyedLastFrame;
+		uint32 TotalRetired;
+	};
+
+private:
+	struct Retired
+	{
+		/* Last frame that may have used the resource */
+		size_t FrameNumber;
+		std::function<void()> Destroy;
+	};
+
+	std::deque<Retired> Pending;
+
+	/* Frames started so far, the frame being recorded */
+	size_t FrameNumber;
+	uint32 FramesInFlight;
+
+	std::mutex Lock;
+
+	Stats CurrentStats;
+
+private:
+	DeletionQueue()
+	{
+		FrameNumber = 0;
+		FramesInFlight = 1;
+		CurrentStats = { };
+	}
+
+public:
+	DeletionQueue(const DeletionQueue& other) = delete;
+	DeletionQueue& operator=(const DeletionQueue& other) = delete;
+
+	static DeletionQueue& Get()
+	{
+		static DeletionQueue Instance;
+		return Instance;
+	}
+
+public:
+	/* framesInFlight is the number of render fences the frames cycle through */
+	void Initialize(uint32 framesInFlight)
+	{
+		FramesInFlight = framesInFlight > 0 ? framesInFlight : 1;
+	}
+
+	/* Starts the next frame and destroys what the frames that are now done retired */
+	void BeginFrame()
+	{
+		std::vector<std::function<void()>> Ready;
+		{
+			std::lock_guard<std::mutex> Guard(Lock);
+
+			FrameNumber++;
+			while (!Pending.empty() && Pending.front().FrameNumber + FramesInFlight <= FrameNumber)
+			{
+				Ready.push_back(std::move(Pending.front().Destroy));
+				Pending.pop_front();
+			}
+
+			CurrentStats.DestroyedLastFrame = static_cast<uint32>(Ready.size());
+			CurrentStats.PendingCount = static_cast<uint32>(Pending.size());
+		}
+
+		/* Outside the lock, destroying a level may retire more */
+		for (uint32 i = 0; i < Ready.size(); ++i)
+		{
+			Ready[i]();
+		}
+	}
+
+	/* destroy runs once every frame recorded so far is done with what it destroys */
+	void Retire(std::function<void()> destroy)
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+
+		/* Entries stay sorted by frame, BeginFrame() only looks at the front */
+		Pending.push_back({ FrameNumber, std::move(destroy) });
+
+		CurrentStats.TotalRetired++;
+		CurrentStats.PendingCount = static_cast<uint32>(Pending.size());
+	}
+
+	/* Retires a buffer made by GpuMemory::CreateBuffer(), buffer and allocation are reset so they can be recreated right away */
+	void RetireBuffer(VkBuffer& buffer, GpuAllocation& allocation)
+	{
+		if (buffer == nullptr && !allocation.IsValid())
+		{
+			return;
+		}
+
+		VkBuffer Buffer = buffer;
+		GpuAllocation Allocation = allocation;
+		Retire([Buffer, Allocation]() mutable { GpuMemory::Get().DestroyBuffer(Buffer, Allocation); });
+
+		buffer = nullptr;
+		allocation = GpuAllocation();
+	}
+
+	/* Destroys everything now, the device has to be idle */
+	void Flush()
+	{
+		/* Until nothing is left, a destroyed resource may retire others */
+		while (true)
+		{
+			std::deque<Retired> Ready;
+			{
+				std::lock_guard<std::mutex> Guard(Lock);
+				Ready.swap(Pending);
+				CurrentStats.PendingCount = 0;
+			}
+
+			if (Ready.empty())
+			{
+				return;
+			}
+
+			for (uint32 i = 0; i < Ready.size(); ++i)
+			{
+				Ready[i].Destroy();
+			}
+		}
+	}
+
+	size_t GetFrameNumber()
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+		return FrameNumber;
+	}
+
+	Stats GetStats()
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+		return CurrentStats;
+	}
+};
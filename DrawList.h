@@ -0,0 +1,377 @@
+#pragma once
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "GatewareDefine.h"
+#include "GenericDefines.h"
+#include "Math/Vector4D.h"
+#include "StaticMesh.h"
+#include "StorageArray.h"
+#include "LevelData.h"
+
+/* Everything a draw used to push as constants, indexed by draw ID (Draws in the shaders) */
+struct DrawData
+{
+	uint32 MeshID;
+	uint32 MaterialID;
+	uint32 DiffuseTextureID;
+	uint32 SpecularTextureID;
+	uint32 NormalTextureID;
+
+	/* First of the draw's InstanceCount slots in InstanceDraws and VisibleInstances, firstInstance of its command */
+	uint32 FirstInstance;
+	uint32 InstanceCount;
+
+	/* Command arguments, for culling shaders that write the command */
+	uint32 IndexCount;
+	uint32 FirstIndex;
+	int32_t VertexOffset;
+
+	/* PositionDequantizations slot of the draw's mesh, its index in the meshes the list was built from */
+	uint32 DequantizationID;
+	uint32 Padding;
+
+	/* Mesh space AABB, W is unused */
+	Vector4D BoundsCenter;
+	Vector4D BoundsExtents;
+};
+
+/*
+* The opaque pass as indirect draws, one per submesh, rebuilt from the meshes to draw when they or the visible instances change
+*	Draws, InstanceDraws, VisibleInstances and Commands are storage arrays of the level (set 0, bindings 7 - 10),
+*	Commands is also the indirect buffer
+*	Every draw owns a range of instance slots, the commands hand out ranges that do not overlap through firstInstance
+*	so the vertex shader finds its slot through SV_INSTANCEID, InstanceDraws holds the draw of every slot and
+*	VisibleInstances the instance of the mesh drawn in it
+*	Build() draws every instance or the ones culled on the CPU, a culling pass may overwrite the commands' instance counts
+*	and VisibleInstances
+*	Draws are grouped by index width, Record() issues one vkCmdDrawIndexedIndirect() per group when the device has
+*	multiDrawIndirect and drawIndirectFirstInstance, one vkCmdDrawIndexed() per draw otherwise
+*/
+class DrawList
+{
+public:
+	struct Stats
+	{
+		uint32 DrawCount;
+		uint32 InstanceCount;
+
+		/* Instances the commands of the last Build() draw, before any culling pass */
+		uint32 VisibleInstanceCount;
+
+		/* vkCmdDrawIndexedIndirect() or vkCmdDrawIndexed() calls of the last Record() */
+		uint32 CallCount;
+		float RecordTimeMs;
+
+		bool UsesMultiDrawIndirect;
+	};
+
+private:
+	/* Commands that share an index buffer */
+	struct Batch
+	{
+		uint32 IndexSizeInBytes;
+		uint32 FirstCommand;
+		uint32 CommandCount;
+	};
+
+public:
+	StorageArray<DrawData> Draws;
+	StorageArray<uint32> InstanceDraws;
+	StorageArray<uint32> VisibleInstances;
+	StorageArray<VkDrawIndexedIndirectCommand> Commands;
+
+private:
+	std::vector<Batch> Batches;
+
+	bool UseMultiDrawIndirect;
+	uint32 MaxDrawIndirectCount;
+
+	Stats CurrentStats;
+
+public:
+	DrawList()
+	{
+		UseMultiDrawIndirect = false;
+		MaxDrawIndirectCount = 1;
+		CurrentStats = { };
+	}
+
+	DrawList(const DrawList& other) = delete;
+	DrawList& operator=(const DrawList& other) = delete;
+
+public:
+	/* Sized for every submesh and instance of staticMeshes, all of them visible never grows the buffers */
+	void Create(VkPhysicalDevice physicalDevice, VkDevice* device, uint32 frameCount, const std::vector<StaticMesh>& staticMeshes)
+	{
+		VkPhysicalDeviceFeatures Features;
+		vkGetPhysicalDeviceFeatures(physicalDevice, &Features);
+
+		VkPhysicalDeviceProperties Properties;
+		vkGetPhysicalDeviceProperties(physicalDevice, &Properties);
+
+		/* Both are enabled by the surface whenever the device has them */
+		UseMultiDrawIndirect = Features.multiDrawIndirect && Features.drawIndirectFirstInstance;
+		MaxDrawIndirectCount = UseMultiDrawIndirect && Properties.limits.maxDrawIndirectCount > 0 ? Properties.limits.maxDrawIndirectCount : 1;
+
+		size_t MaxDraws = 0;
+		size_t MaxInstances = 0;
+		for (uint32 i = 0; i < staticMeshes.size(); ++i)
+		{
+			MaxDraws += staticMeshes[i].GetMeshCount();
+			MaxInstances += staticMeshes[i].GetMeshCount() * staticMeshes[i].GetInstanceCount();
+		}
+
+		Draws.Create(physicalDevice, device, frameCount, MaxDraws);
+		InstanceDraws.Create(physicalDevice, device, frameCount, MaxInstances);
+		VisibleInstances.Create(physicalDevice, device, frameCount, MaxInstances);
+		Commands.Create(physicalDevice, device, frameCount, MaxDraws, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+
+		CurrentStats = { };
+		CurrentStats.UsesMultiDrawIndirect = UseMultiDrawIndirect;
+
+#if DEBUG
+		std::cout << "[DrawList]: room for " << MaxDraws << " draws and " << MaxInstances << " instances, "
+			<< (UseMultiDrawIndirect ? "multi draw indirect\n" : "no multi draw indirect, one call per draw\n");
+#endif // DEBUG
+	}
+
+	void Destroy()
+	{
+		Draws.Destroy();
+		InstanceDraws.Destroy();
+		VisibleInstances.Destroy();
+		Commands.Destroy();
+		Batches.clear();
+	}
+
+	/*
+	* Replaces the list with every submesh of meshes, 16 bit index meshes first so each index width is one batch
+	*	visibleInstances holds the instances to draw of every mesh (indexed like meshes), every instance is drawn without it
+	*	and of the meshes past its end
+	*	A draw keeps its slots whatever is visible, only the elements that differ from last frame's are marked dirty
+	*/
+	void Build(const std::vector<StaticMesh>& meshes, const std::vector<std::vector<uint32>>* visibleInstances = nullptr)
+	{
+		Batches.clear();
+
+		uint32 DrawCount = 0;
+		uint32 InstanceCount = 0;
+		uint32 VisibleInstanceCount = 0;
+		const uint32 IndexSizes[] = { sizeof(uint16), sizeof(uint32) };
+		for (uint32 Size = 0; Size < 2; ++Size)
+		{
+			for (uint32 i = 0; i < meshes.size(); ++i)
+			{
+				const StaticMesh& Mesh = meshes[i];
+				if (Mesh.GetIndexSizeInBytes() != IndexSizes[Size])
+				{
+					continue;
+				}
+
+				if (Batches.empty() || Batches.back().IndexSizeInBytes != IndexSizes[Size])
+				{
+					Batches.push_back({ IndexSizes[Size], DrawCount, 0 });
+				}
+
+				Vector3D Center = (Mesh.MinBox_AABB + Mesh.MaxBox_AABB) * 0.5f;
+				Vector3D Extents = Mesh.MaxBox_AABB - Center;
+
+				const std::vector<uint32>* MeshVisibleInstances = visibleInstances && i < visibleInstances->size() ? &(*visibleInstances)[i] : nullptr;
+				uint32 VisibleCount = MeshVisibleInstances ? static_cast<uint32>(MeshVisibleInstances->size()) : Mesh.GetInstanceCount();
+
+				for (uint32 j = 0; j < Mesh.GetMeshCount(); ++j)
+				{
+					DrawData Data = { };
+					Data.MeshID = Mesh.GetWorldMatrixIndex();
+					Data.MaterialID = Mesh.GetMaterialIndex() + Mesh.GetSubMeshMaterialIndex(j);
+					Data.DiffuseTextureID = Mesh.GetSubMeshDiffuseTextureIndex(j);
+					Data.SpecularTextureID = Mesh.GetSubMeshSpecularTextureIndex(j);
+					Data.NormalTextureID = Mesh.GetSubMeshNormalTextureIndex(j);
+					Data.FirstInstance = InstanceCount;
+					Data.InstanceCount = Mesh.GetInstanceCount();
+					Data.IndexCount = Mesh.GetSubMeshIndexCount(j);
+					Data.FirstIndex = Mesh.GetIndexOffset() + Mesh.GetSubMeshIndexOffset(j);
+					Data.VertexOffset = static_cast<int32_t>(Mesh.GetVertexOffset());
+					Data.DequantizationID = i;
+					Data.BoundsCenter = Vector4D(Center, 0.0f);
+					Data.BoundsExtents = Vector4D(Extents, 0.0f);
+
+					VkDrawIndexedIndirectCommand Command = { };
+					Command.indexCount = Data.IndexCount;
+					Command.instanceCount = VisibleCount;
+					Command.firstIndex = Data.FirstIndex;
+					Command.vertexOffset = Data.VertexOffset;
+					Command.firstInstance = Data.FirstInstance;
+
+					Write(Draws, DrawCount, Data);
+					Write(Commands, DrawCount, Command);
+					for (uint32 k = 0; k < Data.InstanceCount; ++k)
+					{
+						Write(InstanceDraws, InstanceCount + k, DrawCount);
+					}
+
+					/* Slots past the visible ones are not read */
+					for (uint32 k = 0; k < VisibleCount; ++k)
+					{
+						Write(VisibleInstances, InstanceCount + k, MeshVisibleInstances ? (*MeshVisibleInstances)[k] : k);
+					}
+
+					Batches.back().CommandCount++;
+					DrawCount++;
+					InstanceCount += Data.InstanceCount;
+					VisibleInstanceCount += VisibleCount;
+				}
+			}
+		}
+
+		Draws.Elements.resize(DrawCount);
+		Commands.Elements.resize(DrawCount);
+		InstanceDraws.Elements.resize(InstanceCount);
+		VisibleInstances.Elements.resize(InstanceCount);
+
+		CurrentStats.DrawCount = DrawCount;
+		CurrentStats.InstanceCount = InstanceCount;
+		CurrentStats.VisibleInstanceCount = VisibleInstanceCount;
+	}
+
+	/*
+	* Draws the list with frameIndex's slice of Commands, has to be flushed and bound (Level::Bind()) first
+	*	LevelData::Bind() left the 16 bit index buffer bound, it is switched once per batch of the other width
+	*/
+	void Record(VkCommandBuffer commandBuffer, uint32 frameIndex, LevelData* levelData)
+	{
+		std::chrono::steady_clock::time_point Begin = std::chrono::steady_clock::now();
+
+		const VkDeviceSize Stride = sizeof(VkDrawIndexedIndirectCommand);
+		VkBuffer CommandBufferHandle = Commands.GetHandle();
+		VkDeviceSize SliceOffset = Commands.GetSliceOffset(frameIndex);
+
+		uint32 CallCount = 0;
+		uint32 BoundIndexSize = sizeof(uint16);
+		for (uint32 i = 0; i < Batches.size(); ++i)
+		{
+			const Batch& DrawBatch = Batches[i];
+			if (DrawBatch.IndexSizeInBytes != BoundIndexSize)
+			{
+				BoundIndexSize = DrawBatch.IndexSizeInBytes;
+				levelData->BindIndices(BoundIndexSize);
+			}
+
+			if (UseMultiDrawIndirect)
+			{
+				for (uint32 First = 0; First < DrawBatch.CommandCount; First += MaxDrawIndirectCount)
+				{
+					uint32 Count = DrawBatch.CommandCount - First;
+					Count = Count < MaxDrawIndirectCount ? Count : MaxDrawIndirectCount;
+
+					vkCmdDrawIndexedIndirect(commandBuffer, CommandBufferHandle, SliceOffset + (DrawBatch.FirstCommand + First) * Stride,
+						Count, static_cast<uint32>(Stride));
+					CallCount++;
+				}
+			}
+			else
+			{
+				/* Same commands, a non zero firstInstance is always allowed on direct draws */
+				for (uint32 j = DrawBatch.FirstCommand; j < DrawBatch.FirstCommand + DrawBatch.CommandCount; ++j)
+				{
+					const VkDrawIndexedIndirectCommand& Command = Commands[j];
+					if (Command.instanceCount == 0)
+					{
+						continue;
+					}
+
+					vkCmdDrawIndexed(commandBuffer, Command.indexCount, Command.instanceCount, Command.firstIndex,
+						Command.vertexOffset, Command.firstInstance);
+					CallCount++;
+				}
+			}
+		}
+
+		std::chrono::steady_clock::time_point End = std::chrono::steady_clock::now();
+		CurrentStats.CallCount = CallCount;
+		CurrentStats.RecordTimeMs = std::chrono::duration<float, std::milli>(End - Begin).count();
+	}
+
+	bool NeedsToGrow() const
+	{
+		return Draws.NeedsToGrow() || InstanceDraws.NeedsToGrow() || VisibleInstances.NeedsToGrow() || Commands.NeedsToGrow();
+	}
+
+	/* Descriptors pointing at the arrays have to be rewritten */
+	void Grow(VkPhysicalDevice physicalDevice, VkDevice* device, uint32 frameCount)
+	{
+		if (Draws.NeedsToGrow())
+		{
+			Draws.Grow(physicalDevice, device, frameCount);
+		}
+		if (InstanceDraws.NeedsToGrow())
+		{
+			InstanceDraws.Grow(physicalDevice, device, frameCount);
+		}
+		if (VisibleInstances.NeedsToGrow())
+		{
+			VisibleInstances.Grow(physicalDevice, device, frameCount);
+		}
+		if (Commands.NeedsToGrow())
+		{
+			Commands.Grow(physicalDevice, device, frameCount);
+		}
+	}
+
+	/* Copies what changed into frameIndex's slices, @returns the bytes written */
+	size_t Flush(uint32 frameIndex)
+	{
+		return Draws.Flush(frameIndex) + InstanceDraws.Flush(frameIndex) + VisibleInstances.Flush(frameIndex) + Commands.Flush(frameIndex);
+	}
+
+	/* Upload stats of the arrays added up */
+	FrameRingBuffer::Stats GetUploadStats() const
+	{
+		const FrameRingBuffer::Stats* ArrayStats[] = { &Draws.GetStats(), &InstanceDraws.GetStats(), &VisibleInstances.GetStats(), &Commands.GetStats() };
+
+		FrameRingBuffer::Stats Total = { };
+		for (uint32 i = 0; i < 4; ++i)
+		{
+			Total.BytesUploadedLastFrame += ArrayStats[i]->BytesUploadedLastFrame;
+			Total.RangesUploadedLastFrame += ArrayStats[i]->RangesUploadedLastFrame;
+			Total.TotalBytesUploaded += ArrayStats[i]->TotalBytesUploaded;
+			Total.SliceSizeInBytes += ArrayStats[i]->SliceSizeInBytes;
+		}
+
+		return Total;
+	}
+
+	/* Commands are only read as an indirect buffer when this is true, a culling pass that writes them needs it */
+	bool UsesMultiDrawIndirect() const
+	{
+		return UseMultiDrawIndirect;
+	}
+
+	const Stats& GetStats() const
+	{
+		return CurrentStats;
+	}
+
+private:
+	/* Overwrites or appends, the element is only marked dirty if it changed */
+	template<typename T>
+	static void Write(StorageArray<T>& array, size_t index, const T& value)
+	{
+		/* Slots skipped on the way are not read until written */
+		if (index >= array.Size())
+		{
+			array.Elements.resize(index + 1);
+			array[index] = value;
+			return;
+		}
+
+		if (memcmp(&array[index], &value, sizeof(T)) != 0)
+		{
+			array[index] = value;
+			array.MarkDirty(index);
+		}
+	}
+};
@@ -1,14 +1,30 @@
 #include "FileHelper.h"
+#include "MappedFile.h"
+#include "GameLevelBinary.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "Math/VrixicMathBounds.h"
 #include <iostream>
 #include <unordered_map>
-
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#ifdef _WIN32
 #include <windows.h>
 #include <ShObjIdl.h>
+#endif
 
 #include <sstream>
 
 bool FileHelper::OpenFileDialog(std::string& outFilePath)
 {
+#ifdef _WIN32
 	HRESULT Result = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED |
 		COINIT_DISABLE_OLE1DDE);
 	IFileOpenDialog* FileOpenDialog;
@@ -40,6 +56,10 @@ bool FileHelper::OpenFileDialog(std::string& outFilePath)
 			}
 		}
 	}
+#else
+	/* No native dialog outside Windows */
+	(void)outFilePath;
+#endif // _WIN32
 
 	return false;
 }
@@ -64,6 +84,442 @@ std::string FileHelper::LoadShaderFileIntoString(const char* shaderFilePath)
 }
 
 void FileHelper::ReadGameLevelFile(const char* path, std::vector<RawMeshData>& Meshes)
+{
+	if (!ScanGameLevelFile(path, Meshes))
+	{
+#if DEBUG
+		std::cout << "[FILE] Could not map " << path << ", falling back to stream reading...\n";
+#endif // DEBUG
+		Meshes.clear();
+		ReadGameLevelFileStream(path, Meshes);
+		return;
+	}
+
+	LoadGameLevelMeshes(Meshes);
+}
+
+bool FileHelper::ReadGameLevelBinaryFile(const char* path, std::vector<RawMeshData>& Meshes)
+{
+#if DEBUG
+	std::cout << "[FILE] Opening " << path << "\n";
+	std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+#endif // DEBUG
+
+	MappedFile LevelFile;
+	if (!LevelFile.Open(path))
+	{
+#if DEBUG
+		std::cout << "[FILE] Error could not open file..." << std::endl;
+#endif // DEBUG
+		return false;
+	}
+
+	const char* Data = LevelFile.Data();
+	const size_t Size = LevelFile.Size();
+
+	/* Validate the whole layout before touching any entry */
+	if (Size < sizeof(GameLevelBinaryHeader))
+	{
+#if DEBUG
+		std::cout << "[FILE] Error " << path << " is not a compiled level...\n";
+#endif // DEBUG
+		return false;
+	}
+
+	GameLevelBinaryHeader Header;
+	std::memcpy(&Header, Data, sizeof(GameLevelBinaryHeader));
+
+	const uint64_t EntriesEnd = sizeof(GameLevelBinaryHeader) + static_cast<uint64_t>(Header.EntryCount) * sizeof(GameLevelBinaryEntry);
+	const uint64_t MatricesEnd = Header.MatrixOffset + static_cast<uint64_t>(Header.MatrixCount) * sizeof(Matrix4D);
+	const uint64_t StringTableEnd = Header.StringTableOffset + static_cast<uint64_t>(Header.StringTableSize);
+
+	if (std::memcmp(Header.Magic, GAME_LEVEL_BINARY_MAGIC, sizeof(Header.Magic)) != 0 || Header.Version != GAME_LEVEL_BINARY_VERSION
+		|| Header.MatrixOffset % alignof(Matrix4D) != 0 || Header.MatrixOffset < EntriesEnd
+		|| Header.StringTableOffset < MatricesEnd || StringTableEnd > Size)
+	{
+#if DEBUG
+		std::cout << "[FILE] Error " << path << " is not a compiled level or was compiled by another version...\n";
+#endif // DEBUG
+		return false;
+	}
+
+	const GameLevelBinaryEntry* Entries = reinterpret_cast<const GameLevelBinaryEntry*>(Data + sizeof(GameLevelBinaryHeader));
+	const Matrix4D* Matrices = reinterpret_cast<const Matrix4D*>(Data + Header.MatrixOffset);
+	const char* StringTable = Data + Header.StringTableOffset;
+
+	for (uint32 i = 0; i < Header.EntryCount; ++i)
+	{
+		/* Type and Light become enums, a value outside them is a corrupt file rather than something to cast */
+		if (static_cast<uint64_t>(Entries[i].NameOffset) + Entries[i].NameLength > Header.StringTableSize
+			|| static_cast<uint64_t>(Entries[i].FirstMatrix) + Entries[i].MatrixCount > Header.MatrixCount
+			|| Entries[i].Type > GameLevelEntryType::LevelEntryLight || Entries[i].Light > LightType::Spot)
+		{
+#if DEBUG
+			std::cout << "[FILE] Error " << path << " has an out of range entry, discarding level...\n";
+#endif // DEBUG
+			Meshes.clear();
+			return false;
+		}
+	}
+
+	Meshes.reserve(Meshes.size() + Header.EntryCount);
+	for (uint32 i = 0; i < Header.EntryCount; ++i)
+	{
+		const GameLevelBinaryEntry& Entry = Entries[i];
+
+		RawMeshData EmptyMesh;
+		EmptyMesh.Name.assign(StringTable + Entry.NameOffset, Entry.NameLength);
+		EmptyMesh.IsCamera = Entry.Type == GameLevelEntryType::LevelEntryCamera;
+		EmptyMesh.IsLight = Entry.Type == GameLevelEntryType::LevelEntryLight;
+		EmptyMesh.Light = static_cast<LightType>(Entry.Light);
+
+		/* Matrices are stored exactly as they are laid out in memory */
+		EmptyMesh.WorldMatrices.assign(Matrices + Entry.FirstMatrix, Matrices + Entry.FirstMatrix + Entry.MatrixCount);
+		if (Entry.Type == GameLevelEntryType::LevelEntryMesh)
+		{
+			EmptyMesh.InstanceCount = Entry.MatrixCount;
+		}
+
+		Meshes.push_back(std::move(EmptyMesh));
+	}
+
+#if DEBUG
+	std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - StartTime;
+	std::cout << "[FILE] Read " << Header.EntryCount << " entries, " << Header.MatrixCount << " matrices in "
+		<< Elapsed.count() << "ms\n";
+#endif // DEBUG
+
+	LoadGameLevelMeshes(Meshes);
+
+	return true;
+}
+
+bool FileHelper::ConvertGameLevelFile(const char* textPath, const char* binaryPath)
+{
+	std::vector<RawMeshData> Meshes;
+	if (!ScanGameLevelFile(textPath, Meshes))
+	{
+		return false;
+	}
+
+	return WriteGameLevelBinaryFile(binaryPath, Meshes);
+}
+
+std::string FileHelper::GetGameLevelBinaryPath(const std::string& textPath)
+{
+	std::filesystem::path BinaryPath(textPath);
+	BinaryPath.replace_extension(GAME_LEVEL_BINARY_EXTENSION);
+	return BinaryPath.string();
+}
+
+bool FileHelper::IsFileNewer(const std::string& path, const std::string& otherPath)
+{
+	std::error_code Error;
+	std::filesystem::file_time_type Time = std::filesystem::last_write_time(path, Error);
+	if (Error)
+	{
+		return false;
+	}
+
+	std::filesystem::file_time_type OtherTime = std::filesystem::last_write_time(otherPath, Error);
+	if (Error)
+	{
+		/* Nothing to compare against */
+		return true;
+	}
+
+	return Time > OtherTime;
+}
+
+bool FileHelper::ScanGameLevelFile(const char* path, std::vector<RawMeshData>& Meshes)
+{
+#if DEBUG
+	std::cout << "[FILE] Opening " << path << "\n";
+	std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+#endif // DEBUG
+
+	MappedFile LevelFile;
+	if (!LevelFile.Open(path))
+	{
+		return false;
+	}
+
+#if DEBUG
+	std::cout << "[FILE] Opened " << path << "\n\n";
+#endif // DEBUG
+
+	const char* Cursor = LevelFile.Data();
+	const char* End = Cursor + LevelFile.Size();
+
+	std::string_view Line;
+	Matrix4D Matrix;
+	uint32 MeshIndex = 0;
+	uint32 InstanceCount = 0;
+	int32 CameraIndex = -1;
+	bool IsMalformed = false;
+
+	/* Keys point into the mapped file, which outlives the map */
+	std::unordered_map<std::string_view, uint32> InstancingMap;
+
+	while (ReadLineInPlace(Cursor, End, Line))
+	{
+		if (Line == "MESH")
+		{
+			if (!ReadLineInPlace(Cursor, End, Line)) { IsMalformed = true; break; }
+
+			std::string_view MeshName = StripInstanceSuffix(Line);
+			std::unordered_map<std::string_view, uint32>::iterator It = InstancingMap.find(MeshName);
+
+			if (It == InstancingMap.end())
+			{
+				/* New mesh */
+#if DEBUG
+				std::cout << "[Mesh Found]: " << MeshName << "\n";
+#endif // DEBUG
+
+				RawMeshData EmptyMesh;
+				EmptyMesh.Name = std::string(MeshName);
+				EmptyMesh.InstanceCount = 0;
+				EmptyMesh.IsCamera = false;
+
+				Meshes.push_back(std::move(EmptyMesh));
+				MeshIndex = Meshes.size() - 1;
+
+				InstancingMap.insert(std::pair<std::string_view, uint32>(MeshName, MeshIndex));
+			}
+			else
+			{
+				MeshIndex = It->second;
+			}
+
+			if (!ReadMatrixInPlace(Cursor, End, Matrix)) { IsMalformed = true; break; }
+
+			Meshes[MeshIndex].InstanceCount++;
+			Meshes[MeshIndex].WorldMatrices.push_back(Matrix);
+			InstanceCount++;
+		}
+		else if (Line == "CAMERA")
+		{
+			if (!ReadLineInPlace(Cursor, End, Line)) { IsMalformed = true; break; }
+			if (!ReadMatrixInPlace(Cursor, End, Matrix)) { IsMalformed = true; break; }
+
+			if (CameraIndex == -1)
+			{
+#if DEBUG
+				std::cout << "[Camera Found]: " << Line << "\n";
+#endif // DEBUG
+				RawMeshData EmptyMesh;
+				EmptyMesh.Name = std::string(Line);
+				EmptyMesh.IsCamera = true;
+				EmptyMesh.WorldMatrices.push_back(Matrix);
+
+				Meshes.push_back(std::move(EmptyMesh));
+				CameraIndex = Meshes.size() - 1;
+			}
+			else
+			{
+#if DEBUG
+				std::cout << "[Camera Found]: " << Line << ".. will be discarded, multiple cameras not supported..\n";
+#endif // DEBUG
+			}
+		}
+		else if (Line == "LIGHT")
+		{
+			if (!ReadLineInPlace(Cursor, End, Line)) { IsMalformed = true; break; }
+
+#if DEBUG
+			std::cout << "[Light Found]: " << Line << "\n";
+#endif // DEBUG
+			std::string_view LightName = StripInstanceSuffix(Line);
+
+			RawMeshData EmptyMesh;
+			EmptyMesh.Name = std::string(LightName);
+			EmptyMesh.IsCamera = false;
+			EmptyMesh.IsLight = true;
+
+			if (LightName == "Point")
+			{
+				EmptyMesh.Light = LightType::Point;
+			}
+			else if (LightName == "Sun")
+			{
+				EmptyMesh.Light = LightType::Directional;
+			}
+			else if (LightName == "Spot")
+			{
+				EmptyMesh.Light = LightType::Spot;
+			}
+
+			if (!ReadMatrixInPlace(Cursor, End, Matrix)) { IsMalformed = true; break; }
+
+			EmptyMesh.WorldMatrices.push_back(Matrix);
+			Meshes.push_back(std::move(EmptyMesh));
+		}
+	}
+
+#if DEBUG
+	if (IsMalformed)
+	{
+		std::cout << "[FILE] Error malformed matrix block in " << path << ", stopped reading...\n";
+	}
+
+	std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - StartTime;
+	std::cout << "[FILE] Read " << InstancingMap.size() << " unique meshes, " << InstanceCount << " instances in "
+		<< Elapsed.count() << "ms\n";
+#endif // DEBUG
+
+	return true;
+}
+
+void FileHelper::LoadGameLevelMeshes(std::vector<RawMeshData>& Meshes, uint32 workerCount)
+{
+#if DEBUG
+	std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+#endif // DEBUG
+
+	/* Only mesh entries have geometry, their order was fixed by the scan stage */
+	std::vector<uint32> MeshIndices;
+	for (uint32 i = 0; i < Meshes.size(); ++i)
+	{
+		if (!Meshes[i].IsCamera && !Meshes[i].IsLight)
+		{
+			MeshIndices.push_back(i);
+		}
+	}
+
+	if (MeshIndices.empty())
+	{
+		return;
+	}
+
+	/*
+	* Every worker claims the next unloaded mesh until none are left,
+	* results are written into the mesh's own slot so Meshes never depends on which thread finished first
+	*/
+	std::vector<uint8> Loaded(MeshIndices.size(), 0);
+	std::atomic<uint32> NextMesh(0);
+
+	auto LoadWorker = [&Meshes, &MeshIndices, &Loaded, &NextMesh]()
+	{
+		for (uint32 Slot = NextMesh++; Slot < MeshIndices.size(); Slot = NextMesh++)
+		{
+			RawMeshData& Mesh = Meshes[MeshIndices[Slot]];
+			Loaded[Slot] = FillRawMeshDataFromH2BFile(("../Assets/h2b/" + Mesh.Name + ".h2b").c_str(), Mesh);
+		}
+	};
+
+	uint32 WorkerCount = workerCount > 0 ? workerCount : std::max(1u, std::thread::hardware_concurrency());
+	WorkerCount = std::min(WorkerCount, static_cast<uint32>(MeshIndices.size()));
+
+	/* The calling thread is one of the workers */
+	std::vector<std::thread> Workers;
+	Workers.reserve(WorkerCount - 1);
+	for (uint32 i = 1; i < WorkerCount; ++i)
+	{
+		Workers.emplace_back(LoadWorker);
+	}
+	LoadWorker();
+
+	for (uint32 i = 0; i < Workers.size(); ++i)
+	{
+		Workers[i].join();
+	}
+
+#if DEBUG
+	uint32 LoadedCount = 0;
+	for (uint32 Slot = 0; Slot < MeshIndices.size(); ++Slot)
+	{
+		if (Loaded[Slot])
+		{
+			LoadedCount++;
+		}
+		else
+		{
+			std::cout << "[Error]: Mesh h2b file could not be read or found: " << Meshes[MeshIndices[Slot]].Name << "\n";
+		}
+	}
+
+	std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - StartTime;
+	std::cout << "[H2B]: Loaded " << LoadedCount << "/" << MeshIndices.size() << " meshes on " << WorkerCount << " threads in "
+		<< Elapsed.count() << "ms\n";
+
+	MeshCache::Stats CacheStats = MeshCache::Get().GetStats();
+	std::cout << "[MeshCache]: " << CacheStats.Hits << " hits, " << CacheStats.Misses << " misses, " << CacheStats.Evictions << " evictions, "
+		<< CacheStats.EntryCount << " meshes " << (CacheStats.SizeInBytes >> 10) << "/" << (CacheStats.BudgetInBytes >> 10) << "KB\n";
+#endif // DEBUG
+}
+
+bool FileHelper::WriteGameLevelBinaryFile(const char* path, const std::vector<RawMeshData>& Meshes)
+{
+	std::vector<GameLevelBinaryEntry> Entries(Meshes.size());
+	std::string StringTable;
+	uint32 MatrixCount = 0;
+
+	for (uint32 i = 0; i < Meshes.size(); ++i)
+	{
+		GameLevelBinaryEntry& Entry = Entries[i];
+		Entry.NameOffset = StringTable.size();
+		Entry.NameLength = Meshes[i].Name.size();
+		Entry.FirstMatrix = MatrixCount;
+		Entry.MatrixCount = Meshes[i].WorldMatrices.size();
+		Entry.Type = Meshes[i].IsCamera ? GameLevelEntryType::LevelEntryCamera
+			: Meshes[i].IsLight ? GameLevelEntryType::LevelEntryLight : GameLevelEntryType::LevelEntryMesh;
+		Entry.Light = Meshes[i].Light;
+
+		StringTable.append(Meshes[i].Name);
+		MatrixCount += Entry.MatrixCount;
+	}
+
+	GameLevelBinaryHeader Header = { };
+	std::memcpy(Header.Magic, GAME_LEVEL_BINARY_MAGIC, sizeof(Header.Magic));
+	Header.Version = GAME_LEVEL_BINARY_VERSION;
+	Header.EntryCount = Entries.size();
+	Header.MatrixCount = MatrixCount;
+	Header.StringTableSize = StringTable.size();
+
+	/* Matrices are read in place, keep them aligned */
+	const uint32 EntriesEnd = sizeof(GameLevelBinaryHeader) + Entries.size() * sizeof(GameLevelBinaryEntry);
+	Header.MatrixOffset = (EntriesEnd + alignof(Matrix4D) - 1) & ~(alignof(Matrix4D) - 1);
+	Header.StringTableOffset = Header.MatrixOffset + MatrixCount * sizeof(Matrix4D);
+
+	std::ofstream FileHandle(path, std::ios::binary | std::ios::trunc);
+	if (!FileHandle.is_open())
+	{
+#if DEBUG
+		std::cout << "[FILE] Error could not write " << path << "...\n";
+#endif // DEBUG
+		return false;
+	}
+
+	const char Padding[alignof(Matrix4D)] = { };
+
+	FileHandle.write(reinterpret_cast<const char*>(&Header), sizeof(GameLevelBinaryHeader));
+	FileHandle.write(reinterpret_cast<const char*>(Entries.data()), Entries.size() * sizeof(GameLevelBinaryEntry));
+	FileHandle.write(Padding, Header.MatrixOffset - EntriesEnd);
+	for (uint32 i = 0; i < Meshes.size(); ++i)
+	{
+		FileHandle.write(reinterpret_cast<const char*>(Meshes[i].WorldMatrices.data()), Meshes[i].WorldMatrices.size() * sizeof(Matrix4D));
+	}
+	FileHandle.write(StringTable.data(), StringTable.size());
+
+	if (!FileHandle.good())
+	{
+#if DEBUG
+		std::cout << "[FILE] Error could not write " << path << "...\n";
+#endif // DEBUG
+		FileHandle.close();
+		std::remove(path);
+		return false;
+	}
+
+#if DEBUG
+	std::cout << "[FILE] Compiled level written to " << path << "\n";
+#endif // DEBUG
+
+	return true;
+}
+
+void FileHelper::ReadGameLevelFileStream(const char* path, std::vector<RawMeshData>& Meshes)
 {
 	std::ifstream FileHandle(path);
 	std::string LastMeshName = "";
@@ -73,8 +529,6 @@ void FileHelper::ReadGameLevelFile(const char* path, std::vector<RawMeshData>& M
 
 	std::unordered_map<std::string, uint32> InstancingMap;
 
-	H2B::Parser* Parser = new H2B::Parser;
-
 #if DEBUG
 	std::cout << "[FILE] Opening " << path << "\n";
 #endif // DEBUG
@@ -126,7 +580,7 @@ void FileHelper::ReadGameLevelFile(const char* path, std::vector<RawMeshData>& M
 					EmptyMesh.InstanceCount = 0;
 					EmptyMesh.IsCamera = false;
 
-					if (!FillRawMeshDataFromH2BFile(("../Assets/h2b/" + LastMeshName + ".h2b").c_str(), Parser, EmptyMesh))
+					if (!FillRawMeshDataFromH2BFile(("../Assets/h2b/" + LastMeshName + ".h2b").c_str(), EmptyMesh))
 					{
 #if DEBUG
 						std::cout << "[Error]: Mesh h2b file could not be read or found....\n";
@@ -149,11 +603,7 @@ void FileHelper::ReadGameLevelFile(const char* path, std::vector<RawMeshData>& M
 #endif // DEBUG
 
 				/* Read the Matrix */
-				ReadMatrixFromFile(FileHandle, Matrix, Line);
-
-#if DEBUG
-				std::cout << Line;
-#endif // DEBUG
+				ReadMatrixFromFile(FileHandle, Matrix);
 
 				Meshes[MeshIndex].WorldMatrices.push_back(Matrix);
 			}
@@ -182,10 +632,7 @@ void FileHelper::ReadGameLevelFile(const char* path, std::vector<RawMeshData>& M
 				}
 
 				/* Read the Matrix */
-				ReadMatrixFromFile(FileHandle, Matrix, Line);
-#if DEBUG
-				std::cout << Line;
-#endif // DEBUG
+				ReadMatrixFromFile(FileHandle, Matrix);
 
 				Meshes[MeshIndex].WorldMatrices.push_back(Matrix);
 			}
@@ -208,8 +655,6 @@ void FileHelper::ReadGameLevelFile(const char* path, std::vector<RawMeshData>& M
 				}
 				Line.pop_back(); // Account for a period or one character 
 
-				LightType LType;
-
 				Line = Line.length() == 0 ? LineCopy : Line;
 
 				//				if (std::strcmp(Line.c_str(), "Point") != 0)
@@ -246,10 +691,7 @@ void FileHelper::ReadGameLevelFile(const char* path, std::vector<RawMeshData>& M
 				MeshIndex = Meshes.size() - 1;
 
 				/* Read the Matrix */
-				ReadMatrixFromFile(FileHandle, Matrix, Line);
-#if DEBUG
-				std::cout << Line;
-#endif // DEBUG
+				ReadMatrixFromFile(FileHandle, Matrix);
 
 				Meshes[MeshIndex].WorldMatrices.push_back(Matrix);
 			}
@@ -274,7 +716,6 @@ void FileHelper::ReadGameLevelFile(const char* path, std::vector<RawMeshData>& M
 
 		/*--------------------------------------------------DEBUG-------------------------------------------------------*/
 
-		delete Parser;
 		FileHandle.close();
 	}
 	else
@@ -285,28 +726,21 @@ void FileHelper::ReadGameLevelFile(const char* path, std::vector<RawMeshData>& M
 	}
 }
 
-void FileHelper::ReadMatrixFromFile(std::ifstream& fileHandle, Matrix4D& outMatrix, std::string& outMatrixString)
+void FileHelper::ReadMatrixFromFile(std::ifstream& fileHandle, Matrix4D& outMatrix)
 {
-	outMatrixString.clear();
-
 	std::string Line = "";
 	std::getline(fileHandle, Line, '('); // Read Matrix Header
-	outMatrixString.append(Line + "(");
 
 	std::getline(fileHandle, Line, ')'); // read row 1
-	outMatrixString.append(Line + ")");
 	Vector4D V1 = ReadVectorFromString(Line);
 
 	std::getline(fileHandle, Line, ')'); // read row 2
-	outMatrixString.append(Line + ")");
 	Vector4D V2 = ReadVectorFromString(Line);
 
 	std::getline(fileHandle, Line, ')'); // read row 3
-	outMatrixString.append(Line + ")");
 	Vector4D V3 = ReadVectorFromString(Line);
 
 	std::getline(fileHandle, Line, ')'); // read row 4
-	outMatrixString.append(Line + ")\n\n");
 	Vector4D V4 = ReadVectorFromString(Line);
 
 	std::getline(fileHandle, Line, '\n');
@@ -314,93 +748,170 @@ void FileHelper::ReadMatrixFromFile(std::ifstream& fileHandle, Matrix4D& outMatr
 	outMatrix = Matrix4D(V1, V2, V3, V4);
 }
 
-void FileHelper::ParseFileNameFromPath(const std::string& inPath, std::string& outFileName)
+bool FileHelper::ReadLineInPlace(const char*& cursor, const char* end, std::string_view& outLine)
 {
-	for (uint32 i = 0; i < inPath.length(); ++i)
+	if (cursor >= end)
 	{
-		if (inPath[i] == '\\' || inPath[i] == '/')
-		{
-			break;
-		}
+		return false;
+	}
 
-		outFileName.append(&inPath[i]);
+	const char* LineEnd = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+	const char* Next = LineEnd == nullptr ? end : LineEnd + 1;
+	if (LineEnd == nullptr)
+	{
+		LineEnd = end;
 	}
-}
 
-bool FileHelper::FillRawMeshDataFromH2BFile(const char* filePath, H2B::Parser* parser, RawMeshData& outMesh)
-{
-	if (parser->Parse(filePath))
+	/* Levels are exported with CRLF line endings */
+	if (LineEnd > cursor && *(LineEnd - 1) == '\r')
 	{
-		outMesh.VertexCount = parser->vertexCount;
-		outMesh.IndexCount = parser->indexCount;
-		outMesh.MaterialCount = parser->materialCount;
-		outMesh.MeshCount = parser->meshCount;
-		outMesh.Vertices = parser->vertices;
-		outMesh.Indices = parser->indices;
+		--LineEnd;
+	}
 
-		float MinX = FLT_MAX;
-		float MinY = FLT_MAX;
-		float MinZ = FLT_MAX;
+	outLine = std::string_view(cursor, LineEnd - cursor);
+	cursor = Next;
+	return true;
+}
 
-		float MaxX = FLT_MIN;
-		float MaxY = FLT_MIN;
-		float MaxZ = FLT_MIN;
+bool FileHelper::ReadMatrixInPlace(const char*& cursor, const char* end, Matrix4D& outMatrix)
+{
+	float Values[16] = { };
 
-		/* Aabb*/
-		for (uint32 i = 0; i < parser->vertexCount; ++i)
+	for (uint32 Row = 0; Row < 4; ++Row)
+	{
+		/* Each row is "(x, y, z, w)", anything before the '(' is the matrix header or indentation */
+		const char* RowStart = static_cast<const char*>(std::memchr(cursor, '(', end - cursor));
+		if (RowStart == nullptr)
 		{
-			H2B::VECTOR Position = parser->vertices[i].pos;
+			cursor = end;
+			return false;
+		}
 
-			if (Position.x < MinX)
-			{
-				MinX = Position.x;
-			}
-			if (Position.y < MinY)
-			{
-				MinY = Position.y;
-			}
-			if (Position.z < MinZ)
-			{
-				MinZ = Position.z;
-			}
+		const char* RowEnd = static_cast<const char*>(std::memchr(RowStart, ')', end - RowStart));
+		if (RowEnd == nullptr)
+		{
+			cursor = end;
+			return false;
+		}
 
-			if (Position.x > MaxX)
-			{
-				MaxX = Position.x;
-			}
-			if (Position.y > MaxY)
+		cursor = RowStart + 1;
+		for (uint32 Column = 0; Column < 4; ++Column)
+		{
+			while (cursor < RowEnd && (*cursor == ' ' || *cursor == ',' || *cursor == '+' || *cursor == '\t'))
 			{
-				MaxY = Position.y;
+				++cursor;
 			}
-			if (Position.z > MaxZ)
+
+			std::from_chars_result Result = std::from_chars(cursor, RowEnd, Values[Row * 4 + Column]);
+			if (Result.ec != std::errc())
 			{
-				MaxZ = Position.z;
+				cursor = end;
+				return false;
 			}
+			cursor = Result.ptr;
 		}
 
-		outMesh.BoxMin_AABB = Vector3D(MinX, MinY, MinZ);
-		outMesh.BoxMax_AABB = Vector3D(MaxX, MaxY, MaxZ);
+		cursor = RowEnd + 1;
+	}
+
+	/* Skip the closing '>' and the rest of the line */
+	const char* LineEnd = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+	cursor = LineEnd == nullptr ? end : LineEnd + 1;
+
+	outMatrix = Matrix4D(
+		Values[0], Values[1], Values[2], Values[3],
+		Values[4], Values[5], Values[6], Values[7],
+		Values[8], Values[9], Values[10], Values[11],
+		Values[12], Values[13], Values[14], Values[15]);
+
+	return true;
+}
+
+std::string_view FileHelper::StripInstanceSuffix(std::string_view name)
+{
+	/* Only one instance exists if there is no period, the name is used as is */
+	size_t Period = name.rfind('.');
+	return (Period == std::string_view::npos || Period == 0) ? name : name.substr(0, Period);
+}
 
-		for (uint32 i = 0; i < parser->materialCount; ++i)
+void FileHelper::ParseFileNameFromPath(const std::string& inPath, std::string& outFileName)
+{
+	for (uint32 i = 0; i < inPath.length(); ++i)
+	{
+		if (inPath[i] == '\\' || inPath[i] == '/')
+		{
+			break;
+		}
+
+		outFileName.append(&inPath[i]);
+	}
+}
+
+bool FileHelper::FillRawMeshDataFromH2BFile(const char* filePath, RawMeshData& outMesh)
+{
+	/* Props shared between levels are only parsed once */
+	if (MeshCache::Get().Find(filePath, outMesh))
+	{
+		return true;
+	}
+
+	/* Stamped before parsing, a file re-exported meanwhile gets a new key on the next load instead of keeping this one */
+	outMesh.SourceKey = MeshCache::GetSourceKey(filePath);
+
+	std::shared_ptr<H2B::MappedParser> Parser = std::make_shared<H2B::MappedParser>();
+	if (Parser->Parse(filePath, true))
+	{
+		outMesh.VertexCount = Parser->vertexCount;
+		outMesh.IndexCount = Parser->indexCount;
+		outMesh.MaterialCount = Parser->materialCount;
+		outMesh.MeshCount = Parser->meshCount;
+
+		/* Geometry is read straight from the mapping when it's uploaded */
+		outMesh.Vertices.clear();
+		outMesh.Indices.clear();
+		outMesh.Source = Parser;
+		outMesh.SharedGeometry.reset();
+
+		/* Aabb and bounding sphere, positions are the first member of every vertex */
+		BoundingVolume Volume;
+		Bounds::Compute(&Parser->vertices[0].pos.x, Parser->vertexCount, sizeof(H2B::VERTEX), Volume);
+
+		outMesh.BoxMin_AABB = Volume.Min;
+		outMesh.BoxMax_AABB = Volume.Max;
+		outMesh.BoundingSphereCenter = Volume.SphereCenter;
+		outMesh.BoundingSphereRadius = Volume.SphereRadius;
+
+		for (uint32 i = 0; i < Parser->materialCount; ++i)
 		{
 			RawMaterial Mat;
-			Mat.attrib = parser->materials[i].attrib;
-			Mat.DiffuseMap = std::string(parser->materials[i].map_Kd == nullptr ? "" : parser->materials[i].map_Kd);
-			Mat.SpecularMap = std::string(parser->materials[i].map_Ks == nullptr ? "" : parser->materials[i].map_Ks);
-			Mat.NormalMap = std::string(parser->materials[i].bump == nullptr ? "" : parser->materials[i].bump);
+			Mat.attrib = Parser->materials[i].attrib;
+			Mat.DiffuseMap = std::string(Parser->materials[i].map_Kd == nullptr ? "" : Parser->materials[i].map_Kd);
+			Mat.SpecularMap = std::string(Parser->materials[i].map_Ks == nullptr ? "" : Parser->materials[i].map_Ks);
+			Mat.NormalMap = std::string(Parser->materials[i].bump == nullptr ? "" : Parser->materials[i].bump);
 			outMesh.Materials.push_back(Mat);
 		}
 
-		outMesh.Batches = parser->batches;
-		outMesh.Meshes = parser->meshes;
+		outMesh.Batches.assign(Parser->batches, Parser->batches + Parser->materialCount);
+		outMesh.Meshes = Parser->meshes;
 
-#if DEBUG
-		std::cout << "[H2B]: Successfully parsed file" << filePath << "....\n";
-#endif // DEBUG
+		/* Names point into the mapping, which is released once the geometry is owned */
+		outMesh.MeshNames.resize(Parser->meshCount);
+		for (uint32 i = 0; i < Parser->meshCount; ++i)
+		{
+			outMesh.MeshNames[i] = Parser->meshes[i].name == nullptr ? "" : Parser->meshes[i].name;
+			outMesh.Meshes[i].name = nullptr;
+		}
+
+		/* Cached meshes are stored already welded and optimized, outMesh shares the cached geometry afterwards */
+		MeshOptimizer::WeldVertices(outMesh, MESH_WELD_EPSILON);
+		MeshOptimizer::Optimize(outMesh);
+
+		MeshCache::Get().Insert(filePath, outMesh);
 
 		return true;
 	}
 
+	outMesh.SourceKey.clear();
 	return false;
 }
 
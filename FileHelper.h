@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
 #include "RawMeshData.h"
@@ -15,16 +16,58 @@ public:
 	// Load a shader file as a string of characters.
 	static std::string LoadShaderFileIntoString(const char* shaderFilePath);
 
+	/*
+	* Reads a Game Level Exporter text file into Meshes
+	*	The file is memory mapped and tokenized in place, falls back to ReadGameLevelFileStream if it cannot be mapped
+	*/
 	static void ReadGameLevelFile(const char* path, std::vector<RawMeshData>& Meshes);
 
-	static bool FillRawMeshDataFromH2BFile(const char* filePath, H2B::Parser* parser, RawMeshData& outMesh);
+	/* Reads a compiled (.lvlb) level into Meshes, @returns false if the file is missing, corrupt or from another version */
+	static bool ReadGameLevelBinaryFile(const char* path, std::vector<RawMeshData>& Meshes);
+
+	/* Compiles a Game Level Exporter text file into the binary level format, see GameLevelBinary.h */
+	static bool ConvertGameLevelFile(const char* textPath, const char* binaryPath);
+
+	/* "../Levels/Level.txt" -> "../Levels/Level.lvlb" */
+	static std::string GetGameLevelBinaryPath(const std::string& textPath);
+
+	/* @returns true if path exists and was written after otherPath, or otherPath does not exist */
+	static bool IsFileNewer(const std::string& path, const std::string& otherPath);
+
+	/* Reads a Game Level Exporter text file line by line through an ifstream */
+	static void ReadGameLevelFileStream(const char* path, std::vector<RawMeshData>& Meshes);
+
+	/* Maps the h2b file and points outMesh at its geometry, see RawMeshData::Source */
+	static bool FillRawMeshDataFromH2BFile(const char* filePath, RawMeshData& outMesh);
 
 	static void ParseFileNameFromPath(const std::string& inPath, std::string& outFileName);
 
+	/*
+	* Loads the h2b file of every mesh entry in Meshes, workerCount threads (the calling one included) share the meshes
+	*	0 is one per hardware thread, 1 loads them in order on the calling thread
+	*/
+	static void LoadGameLevelMeshes(std::vector<RawMeshData>& Meshes, uint32 workerCount = 0);
+
 private:
 
 	static Vector4D ReadVectorFromString(std::string& str);
 
-	static void ReadMatrixFromFile(std::ifstream& fileHandle, Matrix4D& outMatrix, std::string& outMatrixString);
+	static void ReadMatrixFromFile(std::ifstream& fileHandle, Matrix4D& outMatrix);
+
+	/* Fills Meshes with names, instance matrices, lights and the camera, no mesh data is loaded */
+	static bool ScanGameLevelFile(const char* path, std::vector<RawMeshData>& Meshes);
+
+	static bool WriteGameLevelBinaryFile(const char* path, const std::vector<RawMeshData>& Meshes);
+
+	/* Mapped level parsing, cursor is always advanced and never moves past end */
+
+	/* Returns the next line without its line terminator ('\r' is trimmed), false at the end of the file */
+	static bool ReadLineInPlace(const char*& cursor, const char* end, std::string_view& outLine);
+
+	/* Reads a "<Matrix 4x4 (...) (...) (...) (...)>" block, false if the block is malformed */
+	static bool ReadMatrixInPlace(const char*& cursor, const char* end, Matrix4D& outMatrix);
+
+	/* Strips the instance suffix from an exported name, "Farm_House.001" -> "Farm_House" */
+	static std::string_view StripInstanceSuffix(std::string_view name);
 };
 
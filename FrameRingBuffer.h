@@ -0,0 +1,312 @@
+#pragma once
+#include <vector>
+#include <iostream>
+#include <cstring>
+
+#include "GatewareDefine.h"
+#include "GenericDefines.h"
+#include "GpuMemory.h"
+
+/*
+* One host visible buffer split into a slice per swapchain image, persistently mapped
+*	The CPU copy (shadow) is the source of truth, MarkDirty() records which bytes of it changed and
+*	Flush() copies only those bytes into the slice of the frame being recorded
+*	Every slice keeps its own dirty ranges, a change reaches a slice the next time that slice's frame is flushed
+*	A slice can be bigger than the shadow (capacity) so the shadow can grow without recreating the buffer
+*/
+class FrameRingBuffer
+{
+public:
+	struct Stats
+	{
+		/* Flushed by the last call to Flush() */
+		size_t BytesUploadedLastFrame;
+		uint32 RangesUploadedLastFrame;
+
+		size_t TotalBytesUploaded;
+
+		/* What a full rewrite of a slice would cost */
+		size_t SliceSizeInBytes;
+	};
+
+private:
+	struct DirtyRange
+	{
+		size_t Begin;
+		size_t End;
+	};
+
+	/* Ranges closer than this are merged, one bigger memcpy is cheaper than many small ones */
+	static const size_t MergeGapInBytes = 256;
+
+	/* A slice with more ranges than this is collapsed into one range covering all of them */
+	static const uint32 MaxRangesPerSlice = 32;
+
+	VkDevice* Device;
+
+	VkBuffer BufferHandle;
+	GpuAllocation BufferMemory;
+	char* MappedMemory;
+
+	const char* Shadow;
+	size_t ShadowSizeInBytes;
+
+	/* Bytes of a slice the shadow may use */
+	size_t CapacityInBytes;
+
+	/* Capacity rounded up to minStorageBufferOffsetAlignment */
+	VkDeviceSize SliceStride;
+
+	std::vector<std::vector<DirtyRange>> SliceDirtyRanges;
+
+	Stats CurrentStats;
+
+public:
+	FrameRingBuffer()
+	{
+		Device = nullptr;
+		BufferHandle = nullptr;
+		MappedMemory = nullptr;
+
+		Shadow = nullptr;
+		ShadowSizeInBytes = 0;
+		CapacityInBytes = 0;
+		SliceStride = 0;
+
+		CurrentStats = { };
+	}
+
+	FrameRingBuffer(const FrameRingBuffer& other) = delete;
+	FrameRingBuffer& operator=(const FrameRingBuffer& other) = delete;
+
+	~FrameRingBuffer()
+	{
+		Destroy();
+	}
+
+public:
+	/*
+	* Creates frameCount slices of capacityInBytes (at least shadowSizeInBytes) and fills all of them from shadow
+	*	shadow must stay valid until it is replaced by SetShadow() or the ring buffer is destroyed
+	*/
+	bool Create(VkPhysicalDevice physicalDevice, VkDevice* device, uint32 frameCount, const void* shadow, size_t shadowSizeInBytes,
+		size_t capacityInBytes, VkBufferUsageFlags usage)
+	{
+		Destroy();
+
+		Device = device;
+		Shadow = static_cast<const char*>(shadow);
+		ShadowSizeInBytes = shadowSizeInBytes;
+
+		/* An empty buffer is not allowed */
+		CapacityInBytes = capacityInBytes > shadowSizeInBytes ? capacityInBytes : shadowSizeInBytes;
+		CapacityInBytes = CapacityInBytes > 0 ? CapacityInBytes : 1;
+
+		VkPhysicalDeviceProperties Properties;
+		vkGetPhysicalDeviceProperties(physicalDevice, &Properties);
+
+		VkDeviceSize Alignment = Properties.limits.minStorageBufferOffsetAlignment;
+		Alignment = Alignment > 0 ? Alignment : 1;
+		SliceStride = (CapacityInBytes + Alignment - 1) / Alignment * Alignment;
+
+		frameCount = frameCount > 0 ? frameCount : 1;
+		if (GpuMemory::Get().CreateBuffer(SliceStride * frameCount, usage,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &BufferHandle, &BufferMemory) != VK_SUCCESS)
+		{
+			std::cout << "\n[FrameRingBuffer]: Failed to create a " << SliceStride * frameCount << " byte buffer";
+			return false;
+		}
+
+		MappedMemory = BufferMemory.Mapped;
+
+		SliceDirtyRanges.assign(frameCount, std::vector<DirtyRange>());
+		for (uint32 i = 0; i < frameCount && ShadowSizeInBytes > 0; ++i)
+		{
+			memcpy(MappedMemory + i * SliceStride, Shadow, ShadowSizeInBytes);
+		}
+
+		CurrentStats = { };
+		CurrentStats.SliceSizeInBytes = ShadowSizeInBytes;
+
+		return true;
+	}
+
+	void Destroy()
+	{
+		GpuMemory::Get().DestroyBuffer(BufferHandle, BufferMemory);
+
+		MappedMemory = nullptr;
+		SliceDirtyRanges.clear();
+	}
+
+	/* sizeInBytes bytes of the shadow starting at offsetInBytes changed */
+	void MarkDirtyOffset(size_t offsetInBytes, size_t sizeInBytes)
+	{
+		if (sizeInBytes == 0 || offsetInBytes >= ShadowSizeInBytes)
+		{
+			return;
+		}
+
+		DirtyRange Range = { offsetInBytes, offsetInBytes + sizeInBytes };
+		Range.End = Range.End > ShadowSizeInBytes ? ShadowSizeInBytes : Range.End;
+
+		for (uint32 i = 0; i < SliceDirtyRanges.size(); ++i)
+		{
+			AddRange(SliceDirtyRanges[i], Range);
+		}
+	}
+
+	/*
+	* Points the ring buffer at a new shadow (a std::vector that reallocated or resized), the slices are not touched
+	*	Bytes past the old shadow size are marked dirty
+	*	@returns false if the shadow does not fit in a slice, the buffer has to be recreated with a bigger capacity
+	*/
+	bool SetShadow(const void* shadow, size_t shadowSizeInBytes)
+	{
+		if (shadowSizeInBytes > CapacityInBytes)
+		{
+			return false;
+		}
+
+		size_t OldSizeInBytes = ShadowSizeInBytes;
+		Shadow = static_cast<const char*>(shadow);
+		ShadowSizeInBytes = shadowSizeInBytes;
+
+		if (ShadowSizeInBytes > OldSizeInBytes)
+		{
+			MarkDirtyOffset(OldSizeInBytes, ShadowSizeInBytes - OldSizeInBytes);
+		}
+		else if (ShadowSizeInBytes < OldSizeInBytes)
+		{
+			/* Never copy past the end of the smaller shadow */
+			for (uint32 i = 0; i < SliceDirtyRanges.size(); ++i)
+			{
+				std::vector<DirtyRange>& Ranges = SliceDirtyRanges[i];
+				for (uint32 j = 0; j < Ranges.size(); )
+				{
+					Ranges[j].End = Ranges[j].End > ShadowSizeInBytes ? ShadowSizeInBytes : Ranges[j].End;
+					if (Ranges[j].Begin >= Ranges[j].End)
+					{
+						Ranges[j] = Ranges.back();
+						Ranges.pop_back();
+						continue;
+					}
+
+					++j;
+				}
+			}
+		}
+
+		CurrentStats.SliceSizeInBytes = ShadowSizeInBytes;
+		return true;
+	}
+
+	/* Same as MarkDirtyOffset() but takes a pointer into the shadow */
+	void MarkDirty(const void* first, size_t sizeInBytes)
+	{
+		const char* First = static_cast<const char*>(first);
+		if (First < Shadow || First >= Shadow + ShadowSizeInBytes)
+		{
+			return;
+		}
+
+		MarkDirtyOffset(static_cast<size_t>(First - Shadow), sizeInBytes);
+	}
+
+	/*
+	* Copies the dirty ranges of frameIndex's slice from the shadow, call once the frame's fence was waited on
+	*	@returns the number of bytes written
+	*/
+	size_t Flush(uint32 frameIndex)
+	{
+		CurrentStats.BytesUploadedLastFrame = 0;
+		CurrentStats.RangesUploadedLastFrame = 0;
+
+		if (MappedMemory == nullptr || frameIndex >= SliceDirtyRanges.size())
+		{
+			return 0;
+		}
+
+		std::vector<DirtyRange>& Ranges = SliceDirtyRanges[frameIndex];
+		char* Slice = MappedMemory + frameIndex * SliceStride;
+
+		size_t BytesUploaded = 0;
+		for (uint32 i = 0; i < Ranges.size(); ++i)
+		{
+			size_t Size = Ranges[i].End - Ranges[i].Begin;
+			memcpy(Slice + Ranges[i].Begin, Shadow + Ranges[i].Begin, Size);
+			BytesUploaded += Size;
+		}
+
+		CurrentStats.BytesUploadedLastFrame = BytesUploaded;
+		CurrentStats.RangesUploadedLastFrame = Ranges.size();
+		CurrentStats.TotalBytesUploaded += BytesUploaded;
+
+		Ranges.clear();
+		return BytesUploaded;
+	}
+
+	VkBuffer GetHandle() const
+	{
+		return BufferHandle;
+	}
+
+	VkDeviceSize GetSliceOffset(uint32 frameIndex) const
+	{
+		return frameIndex * SliceStride;
+	}
+
+	/* Size a descriptor should cover, the capacity of a slice */
+	VkDeviceSize GetSliceSize() const
+	{
+		return CapacityInBytes;
+	}
+
+	size_t GetCapacity() const
+	{
+		return CapacityInBytes;
+	}
+
+	const Stats& GetStats() const
+	{
+		return CurrentStats;
+	}
+
+private:
+	/* Merges range into ranges, overlapping or nearby ranges become one */
+	static void AddRange(std::vector<DirtyRange>& ranges, DirtyRange range)
+	{
+		for (uint32 i = 0; i < ranges.size(); )
+		{
+			bool IsNearby = range.Begin <= ranges[i].End + MergeGapInBytes && ranges[i].Begin <= range.End + MergeGapInBytes;
+			if (IsNearby)
+			{
+				/* Grow the new range and drop the old one, the grown range may now reach others */
+				range.Begin = ranges[i].Begin < range.Begin ? ranges[i].Begin : range.Begin;
+				range.End = ranges[i].End > range.End ? ranges[i].End : range.End;
+
+				ranges[i] = ranges.back();
+				ranges.pop_back();
+				i = 0;
+				continue;
+			}
+
+			++i;
+		}
+
+		ranges.push_back(range);
+
+		if (ranges.size() > MaxRangesPerSlice)
+		{
+			DirtyRange Covering = ranges[0];
+			for (uint32 i = 1; i < ranges.size(); ++i)
+			{
+				Covering.Begin = ranges[i].Begin < Covering.Begin ? ranges[i].Begin : Covering.Begin;
+				Covering.End = ranges[i].End > Covering.End ? ranges[i].End : Covering.End;
+			}
+
+			ranges.clear();
+			ranges.push_back(Covering);
+		}
+	}
+};
@@ -1,5 +1,9 @@
 #pragma once
+#include <cmath>
+#include <vector>
+
 #include "Math/Matrix4D.h"
+#include "Math/VrixicMathBounds.h"
 #include "GatewareDefine.h"
 
 enum {
@@ -53,7 +57,7 @@ struct Plane
 	inline Plane(Vector3D& normal, float distance)
 		: X(normal.X), Y(normal.Y), Z(normal.Z), Distance(distance) { }
 
-	inline const Vector3D& GetNormal() const
+	inline Vector3D GetNormal() const
 	{
 		return Vector3D(X, Y, Z);
 	}
@@ -236,7 +240,6 @@ public:
 
 	PlaneIntersectionResult TestAABB(const Vector3D& aabbMin, const Vector3D& aabbMax)
 	{
-		PlaneIntersectionResult Result;
 		for (uint32 i = 0; i < 6; ++i)
 		{
 			if (IntersectAABBOnPlane(aabbMin, aabbMax, Planes[i]) == PlaneIntersectionResult::Back)
@@ -248,6 +251,92 @@ public:
 		return PlaneIntersectionResult::Front;
 	}
 
+	/*
+	* TestAABB() of every box of boxes, bit i % 32 of outVisibleMask[i / 32] is set when box i is not behind a plane
+	*	No branches per box, the absolute normals are made once per call
+	*	AVX2 tests 8 boxes per iteration, SSE 4, the last few go through TestAABBsScalar()
+	*/
+	void TestAABBs(const BoxStreams& boxes, std::vector<uint32>& outVisibleMask) const
+	{
+		size_t Count = boxes.Size();
+		outVisibleMask.assign((Count + 31) / 32, 0);
+
+		size_t i = 0;
+#if VRIXIC_BOUNDS_AVX2
+		for (; i + 8 <= Count; i += 8)
+		{
+			__m256 CX = _mm256_loadu_ps(&boxes.CenterX[i]);
+			__m256 CY = _mm256_loadu_ps(&boxes.CenterY[i]);
+			__m256 CZ = _mm256_loadu_ps(&boxes.CenterZ[i]);
+			__m256 EX = _mm256_loadu_ps(&boxes.ExtentX[i]);
+			__m256 EY = _mm256_loadu_ps(&boxes.ExtentY[i]);
+			__m256 EZ = _mm256_loadu_ps(&boxes.ExtentZ[i]);
+
+			__m256 Culled = _mm256_setzero_ps();
+			for (uint32 p = 0; p < 6; ++p)
+			{
+				const Plane& P = Planes[p];
+				__m256 Distance = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(P.X), CX),
+					_mm256_mul_ps(_mm256_set1_ps(P.Y), CY)), _mm256_mul_ps(_mm256_set1_ps(P.Z), CZ)), _mm256_set1_ps(P.Distance));
+				__m256 NegativeRadius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-std::fabs(P.X)), EX),
+					_mm256_mul_ps(_mm256_set1_ps(-std::fabs(P.Y)), EY)), _mm256_mul_ps(_mm256_set1_ps(-std::fabs(P.Z)), EZ));
+
+				Culled = _mm256_or_ps(Culled, _mm256_cmp_ps(Distance, NegativeRadius, _CMP_LT_OQ));
+			}
+
+			uint32 Visible = ~static_cast<uint32>(_mm256_movemask_ps(Culled)) & 0xFFu;
+			outVisibleMask[i / 32] |= Visible << (i % 32);
+		}
+#endif
+#if VRIXIC_BOUNDS_SSE
+		for (; i + 4 <= Count; i += 4)
+		{
+			__m128 CX = _mm_loadu_ps(&boxes.CenterX[i]);
+			__m128 CY = _mm_loadu_ps(&boxes.CenterY[i]);
+			__m128 CZ = _mm_loadu_ps(&boxes.CenterZ[i]);
+			__m128 EX = _mm_loadu_ps(&boxes.ExtentX[i]);
+			__m128 EY = _mm_loadu_ps(&boxes.ExtentY[i]);
+			__m128 EZ = _mm_loadu_ps(&boxes.ExtentZ[i]);
+
+			__m128 Culled = _mm_setzero_ps();
+			for (uint32 p = 0; p < 6; ++p)
+			{
+				const Plane& P = Planes[p];
+				__m128 Distance = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(P.X), CX),
+					_mm_mul_ps(_mm_set1_ps(P.Y), CY)), _mm_mul_ps(_mm_set1_ps(P.Z), CZ)), _mm_set1_ps(P.Distance));
+				__m128 NegativeRadius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(-std::fabs(P.X)), EX),
+					_mm_mul_ps(_mm_set1_ps(-std::fabs(P.Y)), EY)), _mm_mul_ps(_mm_set1_ps(-std::fabs(P.Z)), EZ));
+
+				Culled = _mm_or_ps(Culled, _mm_cmplt_ps(Distance, NegativeRadius));
+			}
+
+			uint32 Visible = ~static_cast<uint32>(_mm_movemask_ps(Culled)) & 0xFu;
+			outVisibleMask[i / 32] |= Visible << (i % 32);
+		}
+#endif
+
+		TestAABBsScalar(boxes, i, Count, outVisibleMask);
+	}
+
+	/* Reference implementation of TestAABBs() for boxes first to last - 1, outVisibleMask has to be sized and those bits clear */
+	void TestAABBsScalar(const BoxStreams& boxes, size_t first, size_t last, std::vector<uint32>& outVisibleMask) const
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			bool Culled = false;
+			for (uint32 p = 0; p < 6; ++p)
+			{
+				const Plane& P = Planes[p];
+				float Distance = P.X * boxes.CenterX[i] + P.Y * boxes.CenterY[i] + P.Z * boxes.CenterZ[i] - P.Distance;
+				float NegativeRadius = -std::fabs(P.X) * boxes.ExtentX[i] + -std::fabs(P.Y) * boxes.ExtentY[i] + -std::fabs(P.Z) * boxes.ExtentZ[i];
+
+				Culled |= Distance < NegativeRadius;
+			}
+
+			outVisibleMask[i / 32] |= static_cast<uint32>(!Culled) << (i % 32);
+		}
+	}
+
 	/*--------------------------------------------------DEBUG-------------------------------------------------------*/
 
 	void DebugUpdateVertices(uint32 startVertex, std::vector<Vertex>* vertices)
@@ -257,10 +346,10 @@ public:
 		Vertex NBL = { {0,0}, {NearPlaneBottomLeft}, {0,0,0}, {0.1f,0.1f,0.1f,1} };
 		Vertex NBR = { {0,0}, {NearPlaneBottomRight}, {0,0,0}, {0.1f,0.1f,0.1f,1} };
 
-		Vertex FTL = { {0,0}, {FarPlaneTopLeft} };
-		Vertex FTR = { {0,0}, {FarPlaneTopRight} };
-		Vertex FBL = { {0,0}, {FarPlaneBottomLeft} };
-		Vertex FBR = { {0,0}, {FarPlaneBottomRight} };
+		Vertex FTL = { {0,0}, {FarPlaneTopLeft}, {0,0,0}, {0,0,0,0} };
+		Vertex FTR = { {0,0}, {FarPlaneTopRight}, {0,0,0}, {0,0,0,0} };
+		Vertex FBL = { {0,0}, {FarPlaneBottomLeft}, {0,0,0}, {0,0,0,0} };
+		Vertex FBR = { {0,0}, {FarPlaneBottomRight}, {0,0,0}, {0,0,0,0} };
 
 		(*vertices)[startVertex] = NTL;
 		(*vertices)[startVertex + 1] = NTR;
@@ -305,7 +394,7 @@ public:
 
 	static uint32* GetFrustumIndices()
 	{
-		uint32 Indices[24] =
+		static uint32 Indices[24] =
 		{
 			0, 1, 1, 3, 3, 2, 2, 0,
 			4, 5, 5, 7, 7, 6, 6, 4,
@@ -0,0 +1,54 @@
+#pragma once
+#include "GenericDefines.h"
+
+/*
+* Compiled Game Level (.lvlb) layout, all offsets are from the start of the file
+*
+*	GameLevelBinaryHeader
+*	GameLevelBinaryEntry[EntryCount]
+*	Matrix4D[MatrixCount]			-> at MatrixOffset, 16 byte aligned, entries index into this array
+*	char[StringTableSize]			-> at StringTableOffset, entry names, not null terminated
+*/
+
+#define GAME_LEVEL_BINARY_MAGIC "LVLB"
+#define GAME_LEVEL_BINARY_VERSION 1
+#define GAME_LEVEL_BINARY_EXTENSION ".lvlb"
+
+enum GameLevelEntryType
+{
+	LevelEntryMesh =	0,
+	LevelEntryCamera =	1,
+	LevelEntryLight =	2
+};
+
+struct GameLevelBinaryHeader
+{
+	char Magic[4];
+	uint32 Version;
+
+	uint32 EntryCount;
+	uint32 MatrixCount;
+	uint32 StringTableSize;
+
+	uint32 MatrixOffset;
+	uint32 StringTableOffset;
+
+	uint32 Reserved;
+};
+
+struct GameLevelBinaryEntry
+{
+	/* Name as it appears in the text file, minus the instance suffix */
+	uint32 NameOffset;
+	uint32 NameLength;
+
+	/* Range of world matrices, one per instance */
+	uint32 FirstMatrix;
+	uint32 MatrixCount;
+
+	/* GameLevelEntryType */
+	uint32 Type;
+
+	/* LightType, only valid for lights */
+	uint32 Light;
+};
@@ -56896,6 +56896,7 @@ namespace GW
 			virtual GReturn GetQueueFamilyIndices(unsigned int& _outGraphicsIndex, unsigned int& _outPresentIndex) const = 0;
 			virtual GReturn GetGraphicsQueue(void** _outVkQueue) const = 0;
 			virtual GReturn GetPresentQueue(void** _outVkQueue) const = 0;
+			virtual GReturn GetTransferQueue(void** _outVkQueue, unsigned int& _outFamilyIndex) const = 0;
 			virtual GReturn GetSwapchainImage(const int& _index, void** _outVkImage) const = 0;
 			virtual GReturn GetSwapchainView(const int& _index, void** _outVkImageView) const = 0;
 			virtual GReturn GetSwapchainFramebuffer(const int& _index, void** _outVkFramebuffer) const = 0;
@@ -56957,6 +56958,7 @@ namespace GW
 			GReturn GetSwapchainCurrentImage(unsigned int& _outImageIndex) const override { return GReturn::FAILURE; }
 			GReturn GetGraphicsQueue(void** _outVkQueue) const override         		  { return GReturn::FAILURE; }
 			GReturn GetPresentQueue(void** _outVkQueue) const override           		  { return GReturn::FAILURE; }
+			GReturn GetTransferQueue(void** _outVkQueue, unsigned int& _outFamilyIndex) const override { return GReturn::FAILURE; }
 			GReturn GetQueueFamilyIndices(unsigned int& _outGraphicsIndex, unsigned int& _outPresentIndex) const override { return GReturn::FAILURE; }
 			GReturn GetSwapchainImage(const int& _index, void** _outVkImage) const override								  { return GReturn::FAILURE; }
 			GReturn GetSwapchainView(const int& _index, void** _outVkImageView) const override          				  { return GReturn::FAILURE; }
@@ -58833,6 +58835,27 @@ namespace GW
 				return GReturn::SUCCESS;
 			}
 
+			GReturn GetTransferQueue(void** _outVkQueue, unsigned int& _outFamilyIndex) const override {
+				//Error Check: Deallocated
+				if (m_Deallocated)
+					return GReturn::PREMATURE_DEALLOCATION;
+
+				//Error Check: Parameter is Nullptr
+				if (!_outVkQueue)
+					return GReturn::INVALID_ARGUMENT;
+
+				//Error Check: No Transfer only Queue Family or no VK_KHR_timeline_semaphore on the device
+				if (m_VkQueueTransfer == VK_NULL_HANDLE)
+					return GReturn::FEATURE_UNSUPPORTED;
+
+				//Give the object and its family to the parameters
+				*_outVkQueue = m_VkQueueTransfer;
+				_outFamilyIndex = static_cast<uint32_t>(m_TransferQueueFamilyIndex);
+
+				//Return Success
+				return GReturn::SUCCESS;
+			}
+
 			GReturn GetQueueFamilyIndices(unsigned int& _outGraphicsIndex, unsigned int& _outPresentIndex) const override {
 				//Error Check: Deallocated
 				if (m_Deallocated)
@@ -59511,10 +59534,12 @@ namespace GW
 				//Vulkan Properties Setup
 				m_QueueFamilyIndices[0] = -1;
 				m_QueueFamilyIndices[1] = -1;
+				m_TransferQueueFamilyIndex = -1;
 				m_CanCompute = VK_FALSE;
 				m_MSAA = VK_SAMPLE_COUNT_1_BIT;
 				m_VkQueueGraphics = {};
 				m_VkQueuePresent = {};
+				m_VkQueueTransfer = {};
 				m_VkSurfaceCapabilitiesKHR = {};
 				m_VkPresentModeKHRSurface = {};
 				m_VkExtent2DSurface = {};
@@ -59676,7 +59701,7 @@ namespace GW
 					qf_createsize = 2;						
 				else										
 					qf_createsize = 1;						
-				VkDeviceQueueCreateInfo* queue_create_info_array = new VkDeviceQueueCreateInfo[qf_createsize];
+				VkDeviceQueueCreateInfo* queue_create_info_array = new VkDeviceQueueCreateInfo[qf_createsize + 1];
 
 				//Set up Create Info for all unique queue families
 				float priority = 1.0f;
@@ -59690,6 +59715,29 @@ namespace GW
 					queue_create_info_array[i] = create_info;
 				}
 
+				//Setup Transfer only Queue Family [Uploads beside the graphics queue, ordered with a timeline semaphore]
+				std::vector<const char*> device_extensions(m_DeviceExtensions, m_DeviceExtensions + m_DeviceExtensionCount);
+				VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_features = {};
+				timeline_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+				m_TransferQueueFamilyIndex = GetTransferQueueFamilyIndex();
+				if (m_TransferQueueFamilyIndex >= 0) {
+					VkDeviceQueueCreateInfo transfer_create_info = {};
+					transfer_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+					transfer_create_info.queueFamilyIndex = m_TransferQueueFamilyIndex;
+					transfer_create_info.queueCount = 1;
+					transfer_create_info.pQueuePriorities = &priority;
+					queue_create_info_array[qf_createsize++] = transfer_create_info;
+
+					//Enable the extension unless the application already asked for it
+					bool listed = false;
+					for (uint32_t i = 0; i < m_DeviceExtensionCount; ++i)
+						if (!strcmp(m_DeviceExtensions[i], VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+							listed = true;
+					if (!listed)
+						device_extensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+					timeline_features.timelineSemaphore = VK_TRUE;
+				}
+
 				//Get all available device features
 				VkPhysicalDeviceFeatures all_device_features;
 				vkGetPhysicalDeviceFeatures(m_VkPhysicalDevice, &all_device_features);
@@ -59703,6 +59751,8 @@ namespace GW
 					if (all_device_features.geometryShader)		device_features.geometryShader = VK_TRUE;
 					if (all_device_features.fillModeNonSolid)	device_features.fillModeNonSolid = VK_TRUE;
 					if (all_device_features.samplerAnisotropy)	device_features.samplerAnisotropy = VK_TRUE; //MSAA
+					if (all_device_features.multiDrawIndirect)	device_features.multiDrawIndirect = VK_TRUE; //Indirect draws
+					if (all_device_features.drawIndirectFirstInstance)	device_features.drawIndirectFirstInstance = VK_TRUE; //Indirect draws
 					if (m_MSAAOn)						
 						if (all_device_features.sampleRateShading)	device_features.sampleRateShading = VK_TRUE; //MSAA
 				}
@@ -59716,8 +59766,8 @@ namespace GW
 				create_info.queueCreateInfoCount = qf_createsize;
 				create_info.pEnabledFeatures = &device_features;
 
-				create_info.enabledExtensionCount = m_DeviceExtensionCount;
-				create_info.ppEnabledExtensionNames = m_DeviceExtensions;
+				create_info.enabledExtensionCount = static_cast<uint32_t>(device_extensions.size());
+				create_info.ppEnabledExtensionNames = device_extensions.data();
 
 				VkPhysicalDeviceDescriptorIndexingFeatures indexing_features = { };
 				indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
@@ -59729,6 +59779,8 @@ namespace GW
 				indexing_features.descriptorBindingPartiallyBound = VK_TRUE;
 				indexing_features.runtimeDescriptorArray = VK_TRUE;
 				indexing_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+				if (m_TransferQueueFamilyIndex >= 0)
+					indexing_features.pNext = &timeline_features;
 				
 				create_info.pNext = &indexing_features;
 
@@ -59739,6 +59791,8 @@ namespace GW
 				//If Device has been created, Setup the Device Queue for graphics and present family
 				vkGetDeviceQueue(m_VkDevice, m_QueueFamilyIndices[0], 0, &m_VkQueueGraphics);
 				vkGetDeviceQueue(m_VkDevice, m_QueueFamilyIndices[1], 0, &m_VkQueuePresent);
+				if (m_TransferQueueFamilyIndex >= 0)
+					vkGetDeviceQueue(m_VkDevice, m_TransferQueueFamilyIndex, 0, &m_VkQueueTransfer);
 
 				//Device has been created successfully!
 				delete[] queue_create_info_array;
@@ -60605,6 +60659,33 @@ namespace GW
 				return VK_ERROR_FEATURE_NOT_PRESENT;
 			}
 
+			int GetTransferQueueFamilyIndex() {
+				//Check the picked GPU for VK_KHR_timeline_semaphore, without it the transfer queue could not be waited on
+				uint32_t extension_count = 0;
+				if (vkEnumerateDeviceExtensionProperties(m_VkPhysicalDevice, nullptr, &extension_count, nullptr) || !extension_count) return -1;
+				std::vector<VkExtensionProperties> extensions(extension_count);
+				if (vkEnumerateDeviceExtensionProperties(m_VkPhysicalDevice, nullptr, &extension_count, extensions.data())) return -1;
+
+				bool timeline_semaphore = false;
+				for (uint32_t i = 0; i < extension_count; ++i)
+					if (!strcmp(extensions[i].extensionName, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+						timeline_semaphore = true;
+				if (!timeline_semaphore) return -1;
+
+				//Loop through each Queue Properties and find one that can only transfer [Usually the copy engine of a discrete GPU]
+				uint32_t family_count = 0;
+				vkGetPhysicalDeviceQueueFamilyProperties(m_VkPhysicalDevice, &family_count, VK_NULL_HANDLE);
+				std::vector<VkQueueFamilyProperties> families(family_count);
+				vkGetPhysicalDeviceQueueFamilyProperties(m_VkPhysicalDevice, &family_count, families.data());
+				for (uint32_t i = 0; i < family_count; ++i)
+					if (families[i].queueCount && (families[i].queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+						!(families[i].queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+						return static_cast<int>(i);
+
+				//Couldn't find anything.
+				return -1;
+			}
+
 			//Gathering Surface Data
 			std::vector<VkSurfaceFormatKHR> m_AllSurfaceFormats;	uint32_t m_AllSurfaceFormatCount = 0;
 			std::vector<VkPresentModeKHR> m_AllPresentModes;		uint32_t m_AllPresentModeCount = 0;
@@ -61006,10 +61087,12 @@ namespace GW
 			uint64_t m_InitMask = 0;
 			bool m_AllPhysicalDeviceFeatures = false;
 			int m_QueueFamilyIndices[2] = {-1, -1};
+			int m_TransferQueueFamilyIndex = -1;
 			VkBool32 m_CanCompute = VK_FALSE;
 			VkSampleCountFlagBits m_MSAA = VK_SAMPLE_COUNT_FLAG_BITS_MAX_ENUM;
 			VkQueue m_VkQueueGraphics = VK_NULL_HANDLE;
 			VkQueue m_VkQueuePresent = VK_NULL_HANDLE;
+			VkQueue m_VkQueueTransfer = VK_NULL_HANDLE;
 			VkSurfaceCapabilitiesKHR m_VkSurfaceCapabilitiesKHR = { 0, 0, {0, 0}, {0, 0}, {0, 0}, 0, VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR, VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR, VK_COMPOSITE_ALPHA_FLAG_BITS_MAX_ENUM_KHR, VK_IMAGE_USAGE_FLAG_BITS_MAX_ENUM };
 			VkPresentModeKHR m_VkPresentModeKHRSurface = VK_PRESENT_MODE_MAX_ENUM_KHR;
 			VkExtent2D m_VkExtent2DSurface = {0, 0};
@@ -61046,6 +61129,7 @@ namespace GW
 			GATEWARE_CONST_FUNCTION(GetQueueFamilyIndices)
 			GATEWARE_CONST_FUNCTION(GetGraphicsQueue)
 			GATEWARE_CONST_FUNCTION(GetPresentQueue)
+			GATEWARE_CONST_FUNCTION(GetTransferQueue)
 			GATEWARE_CONST_FUNCTION(GetSwapchainImage)
 			GATEWARE_CONST_FUNCTION(GetSwapchainView)
 			GATEWARE_CONST_FUNCTION(GetSwapchainFramebuffer)
@@ -1,4 +1,8 @@
 // Simple basecode showing how to create a window and attatch a vulkansurface
+#if defined(LEVELRENDERER_MOCK_GATEWARE)
+// The headless tests in Tests/ have no window, GPU or Vulkan SDK
+#include "Tests/MockGateware.h"
+#else
 #define GATEWARE_ENABLE_CORE // All libraries need this
 #define GATEWARE_ENABLE_SYSTEM // Graphics libs require system level libraries
 #define GATEWARE_ENABLE_GRAPHICS // Enables all Graphics Libraries
@@ -12,4 +16,5 @@
 // TODO: Part 4a
 #define GATEWARE_ENABLE_INPUT
 // With what we want & what we don't defined we can include the API
-#include "Gateware.h"
\ No newline at end of file
+#include "Gateware.h"
+#endif // LEVELRENDERER_MOCK_GATEWARE
\ No newline at end of file
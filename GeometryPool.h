@@ -0,0 +1,711 @@
+#pragma once
+#include <map>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstring>
+#include <iostream>
+
+#include "GatewareDefine.h"
+#include "GenericDefines.h"
+#include "GpuMemory.h"
+#include "UploadService.h"
+
+/*
+* First fit allocator of element ranges in [0, Capacity)
+*	A freed range is merged with the free ranges right before and after it, so free space never splinters into neighbours
+*/
+class FreeListAllocator
+{
+private:
+	/* Offset -> count of every free range, ordered so neighbours can be found */
+	std::map<uint32, uint32> FreeRanges;
+
+	uint32 Capacity;
+	uint32 UsedCount;
+
+public:
+	FreeListAllocator()
+	{
+		Capacity = 0;
+		UsedCount = 0;
+	}
+
+public:
+	void Reset(uint32 capacity)
+	{
+		FreeRanges.clear();
+		Capacity = capacity;
+		UsedCount = 0;
+
+		if (Capacity > 0)
+		{
+			FreeRanges[0] = Capacity;
+		}
+	}
+
+	/* @returns false if no free range is big enough */
+	bool Allocate(uint32 count, uint32& outOffset)
+	{
+		for (std::map<uint32, uint32>::iterator It = FreeRanges.begin(); It != FreeRanges.end(); ++It)
+		{
+			if (It->second < count)
+			{
+				continue;
+			}
+
+			outOffset = It->first;
+
+			uint32 Remaining = It->second - count;
+			FreeRanges.erase(It);
+			if (Remaining > 0)
+			{
+				FreeRanges[outOffset + count] = Remaining;
+			}
+
+			UsedCount += count;
+			return true;
+		}
+
+		return false;
+	}
+
+	void Free(uint32 offset, uint32 count)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		UsedCount -= count;
+
+		std::map<uint32, uint32>::iterator Next = FreeRanges.lower_bound(offset);
+
+		/* Merge with the range after */
+		if (Next != FreeRanges.end() && offset + count == Next->first)
+		{
+			count += Next->second;
+			Next = FreeRanges.erase(Next);
+		}
+
+		/* Merge with the range before */
+		if (Next != FreeRanges.begin())
+		{
+			std::map<uint32, uint32>::iterator Previous = std::prev(Next);
+			if (Previous->first + Previous->second == offset)
+			{
+				Previous->second += count;
+				return;
+			}
+		}
+
+		FreeRanges[offset] = count;
+	}
+
+	/* Elements past the old capacity become free, merged with a free range at the end */
+	void Grow(uint32 newCapacity)
+	{
+		if (newCapacity <= Capacity)
+		{
+			return;
+		}
+
+		uint32 Added = newCapacity - Capacity;
+		uint32 OldCapacity = Capacity;
+		Capacity = newCapacity;
+
+		/* Free() counts the range as used before freeing it */
+		UsedCount += Added;
+		Free(OldCapacity, Added);
+	}
+
+	uint32 GetCapacity() const
+	{
+		return Capacity;
+	}
+
+	uint32 GetUsedCount() const
+	{
+		return UsedCount;
+	}
+
+	uint32 GetFreeRangeCount() const
+	{
+		return static_cast<uint32>(FreeRanges.size());
+	}
+
+	uint32 GetLargestFreeRange() const
+	{
+		uint32 Largest = 0;
+		for (std::map<uint32, uint32>::const_iterator It = FreeRanges.begin(); It != FreeRanges.end(); ++It)
+		{
+			Largest = It->second > Largest ? It->second : Largest;
+		}
+
+		return Largest;
+	}
+
+	/* One past the last used element, everything after it is free */
+	uint32 GetUsedExtent() const
+	{
+		if (FreeRanges.empty())
+		{
+			return Capacity;
+		}
+
+		std::map<uint32, uint32>::const_iterator Last = std::prev(FreeRanges.end());
+		return Last->first + Last->second == Capacity ? Last->first : Capacity;
+	}
+
+	/* 0 when all free space is one range, close to 1 when it is scattered in small pieces */
+	float GetFragmentation() const
+	{
+		uint32 FreeCount = Capacity - UsedCount;
+		return FreeCount > 0 ? 1.0f - static_cast<float>(GetLargestFreeRange()) / FreeCount : 0.0f;
+	}
+};
+
+/*
+* Vertex and index arenas shared by every level, they outlive Level so switching levels does not recreate them
+*	Meshes are keyed by asset and reference counted, a level that uses a mesh already resident (the previous level used it too)
+*	gets the same ranges and nothing is uploaded for it, ranges whose last user is released go back to the free lists
+*	Ranges without a key (level specific debug geometry) are never shared
+*	Meshes whose indices all fit in 16 bits go to a separate uint16 index arena, halving their index memory
+*/
+class GeometryPool
+{
+public:
+	/*
+	* Geometry of one mesh to acquire, Vertices and Indices are only read if the mesh is not resident yet
+	*	Indices are always given as uint32, they are narrowed on upload if the mesh fits in 16 bits
+	*/
+	struct MeshData
+	{
+		std::string Key;
+
+		const void* Vertices;
+		uint32 VertexCount;
+
+		const uint32* Indices;
+		uint32 IndexCount;
+	};
+
+	/* Where a mesh lives, offsets are in elements so they can be used as vertexOffset/firstIndex of a draw */
+	struct Range
+	{
+		std::string Key;
+
+		uint32 VertexOffset;
+		uint32 VertexCount;
+
+		uint32 IndexOffset;
+		uint32 IndexCount;
+
+		/* 2 or 4, picks the index buffer IndexOffset points into, see GetIndexBuffer() */
+		uint32 IndexSizeInBytes;
+	};
+
+	struct Stats
+	{
+		uint32 MeshCount;
+
+		uint32 VertexCapacity;
+		uint32 VerticesUsed;
+		uint32 VertexFreeRangeCount;
+		float VertexFragmentation;
+
+		uint32 IndexCapacity;
+		uint32 IndicesUsed;
+		uint32 IndexFreeRangeCount;
+		float IndexFragmentation;
+
+		uint32 ShortIndexCapacity;
+		uint32 ShortIndicesUsed;
+		uint32 ShortIndexFreeRangeCount;
+		float ShortIndexFragmentation;
+
+		/* What the last Acquire() did */
+		uint32 MeshesUploadedLastAcquire;
+		uint32 MeshesReusedLastAcquire;
+		size_t BytesUploadedLastAcquire;
+
+		/* Times an arena had to be recreated bigger */
+		uint32 GrowCount;
+	};
+
+	static const uint32 InitialVertexCapacity = 1024 * 1024;
+	static const uint32 InitialIndexCapacity = 1024 * 1024;
+	static const uint32 InitialShortIndexCapacity = 4 * 1024 * 1024;
+
+	/* Largest index a mesh may use to go to the 16 bit arena, 0xFFFF is left out as it is the restart index if primitive restart is turned on */
+	static const uint32 MaxShortIndex = 0xFFFE;
+
+private:
+	struct Arena
+	{
+		VkBuffer Buffer;
+		GpuAllocation Memory;
+
+		uint32 StrideInBytes;
+		VkBufferUsageFlags Usage;
+
+		FreeListAllocator Allocator;
+	};
+
+	struct Entry
+	{
+		Range MeshRange;
+		uint32 RefCount;
+	};
+
+	Arena Vertices;
+	Arena Indices;
+	Arena ShortIndices;
+
+	std::unordered_map<std::string, Entry> Entries;
+
+	std::mutex Lock;
+
+	Stats CurrentStats;
+
+private:
+	GeometryPool()
+	{
+		Vertices.Buffer = nullptr;
+		Vertices.StrideInBytes = 0;
+		Vertices.Usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+
+		Indices.Buffer = nullptr;
+		Indices.StrideInBytes = sizeof(uint32);
+		Indices.Usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+
+		ShortIndices.Buffer = nullptr;
+		ShortIndices.StrideInBytes = sizeof(uint16);
+		ShortIndices.Usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+
+		CurrentStats = { };
+	}
+
+public:
+	GeometryPool(const GeometryPool& other) = delete;
+	GeometryPool& operator=(const GeometryPool& other) = delete;
+
+	static GeometryPool& Get()
+	{
+		static GeometryPool Instance;
+		return Instance;
+	}
+
+public:
+	/* Has to be called after GpuMemory::Initialize() and before the first level loads */
+	void Initialize(uint32 vertexStrideInBytes)
+	{
+		Vertices.StrideInBytes = vertexStrideInBytes;
+	}
+
+	/* Destroys the arenas, every level has to be released first */
+	void Shutdown()
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+
+#if DEBUG
+		if (!Entries.empty())
+		{
+			std::cout << "\n[GeometryPool]: " << Entries.size() << " meshes were never released";
+		}
+#endif // DEBUG
+
+		Entries.clear();
+
+		GpuMemory::Get().DestroyBuffer(Vertices.Buffer, Vertices.Memory);
+		GpuMemory::Get().DestroyBuffer(Indices.Buffer, Indices.Memory);
+		GpuMemory::Get().DestroyBuffer(ShortIndices.Buffer, ShortIndices.Memory);
+		Vertices.Allocator.Reset(0);
+		Indices.Allocator.Reset(0);
+		ShortIndices.Allocator.Reset(0);
+	}
+
+	/*
+	* Gives every mesh a range, meshes that are not resident yet are staged into UploadService's batch
+	*	The ranges can be drawn from once that batch is submitted, by the frame that calls UploadService::Submit()
+	*	Growing an arena retires its old buffer once the batch copied it, frames in flight may still have it bound
+	*	outRanges has one range per mesh, give them back with Release()
+	*	@returns false if an arena could not grow or the geometry could not be staged,
+	*	the meshes that did not fit or were not staged get an empty range (no vertices, no indices)
+	*/
+	bool Acquire(const std::vector<MeshData>& meshes, std::vector<Range>& outRanges)
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+
+		outRanges.assign(meshes.size(), Range());
+		CurrentStats.MeshesUploadedLastAcquire = 0;
+		CurrentStats.MeshesReusedLastAcquire = 0;
+		CurrentStats.BytesUploadedLastAcquire = 0;
+
+		/* Resident meshes only get a reference, the others are counted so the arenas grow at most once */
+		std::vector<uint32> NewMeshes;
+		std::vector<uint32> NewIndexSizes;
+		uint32 NewVertexCount = 0;
+		uint32 NewIndexCount = 0;
+		uint32 NewShortIndexCount = 0;
+		for (uint32 i = 0; i < meshes.size(); ++i)
+		{
+			std::unordered_map<std::string, Entry>::iterator It = meshes[i].Key.empty() ? Entries.end() : Entries.find(meshes[i].Key);
+			if (It != Entries.end())
+			{
+				It->second.RefCount++;
+				outRanges[i] = It->second.MeshRange;
+				CurrentStats.MeshesReusedLastAcquire++;
+				continue;
+			}
+
+			/* The same mesh twice in one call, the first one is uploaded */
+			bool IsDuplicate = false;
+			for (uint32 j = 0; j < NewMeshes.size() && !meshes[i].Key.empty(); ++j)
+			{
+				IsDuplicate |= meshes[NewMeshes[j]].Key == meshes[i].Key;
+			}
+
+			uint32 IndexSize = FitsShortIndices(meshes[i]) ? sizeof(uint16) : sizeof(uint32);
+			if (!IsDuplicate)
+			{
+				NewVertexCount += meshes[i].VertexCount;
+				NewIndexCount += IndexSize == sizeof(uint32) ? meshes[i].IndexCount : 0;
+				NewShortIndexCount += IndexSize == sizeof(uint16) ? meshes[i].IndexCount : 0;
+			}
+
+			NewMeshes.push_back(i);
+			NewIndexSizes.push_back(IndexSize);
+		}
+
+		Reserve(Vertices, NewVertexCount, InitialVertexCapacity);
+		Reserve(Indices, NewIndexCount, InitialIndexCapacity);
+		Reserve(ShortIndices, NewShortIndexCount, InitialShortIndexCapacity);
+
+		std::vector<uint32> Uploads;
+		bool AllAcquired = true;
+		for (uint32 i = 0; i < NewMeshes.size(); ++i)
+		{
+			const MeshData& Mesh = meshes[NewMeshes[i]];
+			Range& MeshRange = outRanges[NewMeshes[i]];
+
+			/* Duplicates within this call are resident by now */
+			std::unordered_map<std::string, Entry>::iterator It = Mesh.Key.empty() ? Entries.end() : Entries.find(Mesh.Key);
+			if (It != Entries.end())
+			{
+				It->second.RefCount++;
+				MeshRange = It->second.MeshRange;
+				CurrentStats.MeshesReusedLastAcquire++;
+				continue;
+			}
+
+			uint32 VertexOffset = 0;
+			uint32 IndexOffset = 0;
+			if (!AllocateFrom(Vertices, Mesh.VertexCount, VertexOffset))
+			{
+				AllAcquired = false;
+				continue;
+			}
+
+			if (!AllocateFrom(GetIndexArena(NewIndexSizes[i]), Mesh.IndexCount, IndexOffset))
+			{
+				Vertices.Allocator.Free(VertexOffset, Mesh.VertexCount);
+				AllAcquired = false;
+				continue;
+			}
+
+			MeshRange.Key = Mesh.Key;
+			MeshRange.VertexCount = Mesh.VertexCount;
+			MeshRange.IndexCount = Mesh.IndexCount;
+			MeshRange.IndexSizeInBytes = NewIndexSizes[i];
+			MeshRange.VertexOffset = VertexOffset;
+			MeshRange.IndexOffset = IndexOffset;
+
+			if (!Mesh.Key.empty())
+			{
+				Entries[Mesh.Key] = { MeshRange, 1 };
+			}
+
+			Uploads.push_back(NewMeshes[i]);
+		}
+
+		if (!Upload(meshes, outRanges, Uploads))
+		{
+			DiscardUploads(NewMeshes, Uploads, outRanges);
+			Uploads.clear();
+			AllAcquired = false;
+		}
+
+		CurrentStats.MeshesUploadedLastAcquire = static_cast<uint32>(Uploads.size());
+
+#if DEBUG
+		std::cout << "[GeometryPool]: " << CurrentStats.MeshesUploadedLastAcquire << " meshes uploaded (" << CurrentStats.BytesUploadedLastAcquire
+			<< " bytes), " << CurrentStats.MeshesReusedLastAcquire << " already resident\n";
+#endif // DEBUG
+
+		return AllAcquired;
+	}
+
+	/* Drops a reference to every range, the GPU must be done with them */
+	void Release(const std::vector<Range>& ranges)
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+
+		for (uint32 i = 0; i < ranges.size(); ++i)
+		{
+			if (!ranges[i].Key.empty())
+			{
+				std::unordered_map<std::string, Entry>::iterator It = Entries.find(ranges[i].Key);
+				if (It == Entries.end() || --It->second.RefCount > 0)
+				{
+					continue;
+				}
+
+				Entries.erase(It);
+			}
+
+			Vertices.Allocator.Free(ranges[i].VertexOffset, ranges[i].VertexCount);
+			GetIndexArena(ranges[i].IndexSizeInBytes).Allocator.Free(ranges[i].IndexOffset, ranges[i].IndexCount);
+		}
+	}
+
+	VkBuffer GetVertexBuffer() const
+	{
+		return Vertices.Buffer;
+	}
+
+	/* Arena holding the ranges of indexSizeInBytes wide indices */
+	VkBuffer GetIndexBuffer(uint32 indexSizeInBytes) const
+	{
+		return indexSizeInBytes == sizeof(uint16) ? ShortIndices.Buffer : Indices.Buffer;
+	}
+
+	static VkIndexType GetIndexType(uint32 indexSizeInBytes)
+	{
+		return indexSizeInBytes == sizeof(uint16) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+	}
+
+	Stats GetStats()
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+
+		CurrentStats.MeshCount = static_cast<uint32>(Entries.size());
+
+		CurrentStats.VertexCapacity = Vertices.Allocator.GetCapacity();
+		CurrentStats.VerticesUsed = Vertices.Allocator.GetUsedCount();
+		CurrentStats.VertexFreeRangeCount = Vertices.Allocator.GetFreeRangeCount();
+		CurrentStats.VertexFragmentation = Vertices.Allocator.GetFragmentation();
+
+		CurrentStats.IndexCapacity = Indices.Allocator.GetCapacity();
+		CurrentStats.IndicesUsed = Indices.Allocator.GetUsedCount();
+		CurrentStats.IndexFreeRangeCount = Indices.Allocator.GetFreeRangeCount();
+		CurrentStats.IndexFragmentation = Indices.Allocator.GetFragmentation();
+
+		CurrentStats.ShortIndexCapacity = ShortIndices.Allocator.GetCapacity();
+		CurrentStats.ShortIndicesUsed = ShortIndices.Allocator.GetUsedCount();
+		CurrentStats.ShortIndexFreeRangeCount = ShortIndices.Allocator.GetFreeRangeCount();
+		CurrentStats.ShortIndexFragmentation = ShortIndices.Allocator.GetFragmentation();
+
+		return CurrentStats;
+	}
+
+private:
+	static bool FitsShortIndices(const MeshData& mesh)
+	{
+		for (uint32 i = 0; i < mesh.IndexCount; ++i)
+		{
+			if (mesh.Indices[i] > MaxShortIndex)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	Arena& GetIndexArena(uint32 indexSizeInBytes)
+	{
+		return indexSizeInBytes == sizeof(uint16) ? ShortIndices : Indices;
+	}
+
+	/* Makes sure count more elements fit, the arena is created or recreated bigger if not */
+	void Reserve(Arena& arena, uint32 count, uint32 initialCapacity)
+	{
+		uint32 Capacity = arena.Allocator.GetCapacity();
+		if (arena.Buffer != nullptr && Capacity - arena.Allocator.GetUsedCount() >= count)
+		{
+			return;
+		}
+
+		uint32 NewCapacity = Capacity > 0 ? Capacity * 2 : initialCapacity;
+		uint32 Needed = arena.Allocator.GetUsedCount() + count;
+		Resize(arena, NewCapacity > Needed ? NewCapacity : Needed);
+	}
+
+	/*
+	* Reserve() made room for the total, a fragmented arena can still fail and grows by the rest
+	*	@returns false if the arena could not grow, outOffset is not a range of the arena then
+	*/
+	bool AllocateFrom(Arena& arena, uint32 count, uint32& outOffset)
+	{
+		outOffset = 0;
+		if (count == 0 || arena.Allocator.Allocate(count, outOffset))
+		{
+			return true;
+		}
+
+		uint32 Capacity = arena.Allocator.GetCapacity();
+		if (!Resize(arena, Capacity * 2 > Capacity + count ? Capacity * 2 : Capacity + count))
+		{
+			return false;
+		}
+
+		return arena.Allocator.Allocate(count, outOffset);
+	}
+
+	/*
+	* Creates the arena's buffer at newCapacity elements and copies what is in use over in the upload batch
+	*	@returns false if the buffer could not be created, the arena is left as it was
+	*/
+	bool Resize(Arena& arena, uint32 newCapacity)
+	{
+		VkBuffer NewBuffer = nullptr;
+		GpuAllocation NewMemory;
+		if (GpuMemory::Get().CreateBuffer(static_cast<VkDeviceSize>(newCapacity) * arena.StrideInBytes,
+			arena.Usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &NewBuffer, &NewMemory) != VK_SUCCESS)
+		{
+			std::cout << "\n[GeometryPool]: Failed to grow an arena to " << newCapacity << " elements";
+			return false;
+		}
+
+		if (arena.Buffer != nullptr)
+		{
+			/* The batch may have written the old buffer already, the copy has to see it */
+			uint32 UsedExtent = arena.Allocator.GetUsedExtent();
+			if (UsedExtent > 0)
+			{
+				UploadService::Get().TransferBarrier();
+				UploadService::Get().CopyBuffer(arena.Buffer, NewBuffer, { { 0, 0, static_cast<VkDeviceSize>(UsedExtent) * arena.StrideInBytes } });
+			}
+
+			/* Read by the copy and by frames in flight */
+			UploadService::Get().RetireBufferAfterSubmit(arena.Buffer, arena.Memory);
+			CurrentStats.GrowCount++;
+		}
+		else
+		{
+			arena.Allocator.Reset(0);
+		}
+
+		arena.Buffer = NewBuffer;
+		arena.Memory = NewMemory;
+		arena.Allocator.Grow(newCapacity);
+		return true;
+	}
+
+	/*
+	* Upload() failed, the ranges given to uploads were never written so none of them may become resident
+	*	They go back to the free lists and their entries are erased, every new mesh given one of them
+	*	(duplicates within the call share their range) gets an empty range instead
+	*/
+	void DiscardUploads(const std::vector<uint32>& newMeshes, const std::vector<uint32>& uploads, std::vector<Range>& ranges)
+	{
+		for (uint32 i = 0; i < uploads.size(); ++i)
+		{
+			const Range& MeshRange = ranges[uploads[i]];
+			Vertices.Allocator.Free(MeshRange.VertexOffset, MeshRange.VertexCount);
+			GetIndexArena(MeshRange.IndexSizeInBytes).Allocator.Free(MeshRange.IndexOffset, MeshRange.IndexCount);
+
+			if (!MeshRange.Key.empty())
+			{
+				Entries.erase(MeshRange.Key);
+			}
+		}
+
+		for (uint32 i = 0; i < newMeshes.size(); ++i)
+		{
+			Range& MeshRange = ranges[newMeshes[i]];
+			if (MeshRange.Key.empty() || Entries.find(MeshRange.Key) == Entries.end())
+			{
+				MeshRange = Range();
+			}
+		}
+	}
+
+	/*
+	* Copies the geometry of every mesh in uploads through one staging buffer
+	*	@returns false if the staging buffer could not be created, nothing was copied then
+	*/
+	bool Upload(const std::vector<MeshData>& meshes, const std::vector<Range>& ranges, const std::vector<uint32>& uploads)
+	{
+		size_t VertexBytes = 0;
+		size_t IndexBytes = 0;
+		for (uint32 i = 0; i < uploads.size(); ++i)
+		{
+			VertexBytes += static_cast<size_t>(meshes[uploads[i]].VertexCount) * Vertices.StrideInBytes;
+			IndexBytes += static_cast<size_t>(meshes[uploads[i]].IndexCount) * ranges[uploads[i]].IndexSizeInBytes;
+		}
+
+		if (VertexBytes + IndexBytes == 0)
+		{
+			return true;
+		}
+
+		VkBuffer StagingBufferHandle = nullptr;
+		char* StagingMemory = UploadService::Get().Stage(VertexBytes + IndexBytes, &StagingBufferHandle);
+		if (StagingMemory == nullptr)
+		{
+			return false;
+		}
+
+		/* Vertices first, then indices */
+		std::vector<VkBufferCopy> VertexCopies;
+		std::vector<VkBufferCopy> IndexCopies;
+		std::vector<VkBufferCopy> ShortIndexCopies;
+		std::vector<uint16> NarrowedIndices;
+		size_t VertexCursor = 0;
+		size_t IndexCursor = VertexBytes;
+		for (uint32 i = 0; i < uploads.size(); ++i)
+		{
+			const MeshData& Mesh = meshes[uploads[i]];
+			const Range& MeshRange = ranges[uploads[i]];
+
+			size_t MeshVertexBytes = static_cast<size_t>(Mesh.VertexCount) * Vertices.StrideInBytes;
+			if (MeshVertexBytes > 0)
+			{
+				memcpy(StagingMemory + VertexCursor, Mesh.Vertices, MeshVertexBytes);
+				VertexCopies.push_back({ VertexCursor, static_cast<VkDeviceSize>(MeshRange.VertexOffset) * Vertices.StrideInBytes, MeshVertexBytes });
+				VertexCursor += MeshVertexBytes;
+			}
+
+			size_t MeshIndexBytes = static_cast<size_t>(Mesh.IndexCount) * MeshRange.IndexSizeInBytes;
+			if (MeshIndexBytes == 0)
+			{
+				continue;
+			}
+
+			if (MeshRange.IndexSizeInBytes == sizeof(uint16))
+			{
+				NarrowedIndices.assign(Mesh.Indices, Mesh.Indices + Mesh.IndexCount);
+				memcpy(StagingMemory + IndexCursor, NarrowedIndices.data(), MeshIndexBytes);
+				ShortIndexCopies.push_back({ IndexCursor, static_cast<VkDeviceSize>(MeshRange.IndexOffset) * ShortIndices.StrideInBytes, MeshIndexBytes });
+			}
+			else
+			{
+				memcpy(StagingMemory + IndexCursor, Mesh.Indices, MeshIndexBytes);
+				IndexCopies.push_back({ IndexCursor, static_cast<VkDeviceSize>(MeshRange.IndexOffset) * Indices.StrideInBytes, MeshIndexBytes });
+			}
+			IndexCursor += MeshIndexBytes;
+		}
+
+		UploadService::Get().CopyBuffer(StagingBufferHandle, Vertices.Buffer, VertexCopies);
+		UploadService::Get().CopyBuffer(StagingBufferHandle, Indices.Buffer, IndexCopies);
+		UploadService::Get().CopyBuffer(StagingBufferHandle, ShortIndices.Buffer, ShortIndexCopies);
+
+		CurrentStats.BytesUploadedLastAcquire = VertexBytes + IndexBytes;
+		return true;
+	}
+};
@@ -0,0 +1,258 @@
+#pragma once
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "GatewareDefine.h"
+#include "GenericDefines.h"
+#include "Math/Matrix4D.h"
+#include "Math/VrixicMathBounds.h"
+#include "DrawList.h"
+#include "Frustum.h"
+#include "DeletionQueue.h"
+
+/* Pushed to Shaders/CullCompute.hlsl, planes are the frustum's with XYZ the normal pointing inside and W the distance */
+struct CullConstants
+{
+	Vector4D Planes[6];
+	uint32 FirstDraw;
+	uint32 DrawCount;
+	uint32 Padding[2];
+};
+
+/*
+* Frustum culls every instance of a DrawList on the GPU, one workgroup per draw (Shaders/CullCompute.hlsl)
+*	The visible instances of a draw are compacted in order into its slots of VisibleInstances and its command is
+*	rewritten with the visible count, both in the slices of the frame that draws them
+*	Dispatches go into the graphics command buffer of the UploadService batch, the frame's command buffer is inside its render pass already
+*	CullReference() is the same kernel on the CPU, Tests/CullingTests.cpp checks it against the CPU culling path
+*/
+class GpuCulling
+{
+public:
+	/* numthreads of the shader, instances of a draw are tested this many at a time */
+	static const uint32 ThreadsPerDraw = 64;
+
+	/* Lowest maxComputeWorkGroupCount[0] a device may have, bigger lists are dispatched in parts */
+	static const uint32 MaxDrawsPerDispatch = 65535;
+
+	struct Stats
+	{
+		uint32 DrawsCulled;
+		uint32 InstancesTested;
+	};
+
+private:
+	VkDevice Device;
+	VkPipelineLayout PipelineLayout;
+	VkPipeline Pipeline;
+
+	Stats CurrentStats;
+
+public:
+	GpuCulling()
+	{
+		Device = nullptr;
+		PipelineLayout = nullptr;
+		Pipeline = nullptr;
+
+		CurrentStats = { };
+	}
+
+	GpuCulling(const GpuCulling& other) = delete;
+	GpuCulling& operator=(const GpuCulling& other) = delete;
+
+public:
+	/* Creates the pipeline against a level's storage set layout, the previous one is retired */
+	void CreatePipeline(VkDevice device, VkShaderModule computeShader, VkDescriptorSetLayout storageSetLayout)
+	{
+		RetirePipeline();
+		Device = device;
+
+		VkPushConstantRange PushConstantRange = { };
+		PushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		PushConstantRange.offset = 0;
+		PushConstantRange.size = sizeof(CullConstants);
+
+		VkPipelineLayoutCreateInfo LayoutCreateInfo = { };
+		LayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		LayoutCreateInfo.setLayoutCount = 1;
+		LayoutCreateInfo.pSetLayouts = &storageSetLayout;
+		LayoutCreateInfo.pushConstantRangeCount = 1;
+		LayoutCreateInfo.pPushConstantRanges = &PushConstantRange;
+
+		if (vkCreatePipelineLayout(Device, &LayoutCreateInfo, nullptr, &PipelineLayout) != VK_SUCCESS)
+		{
+			std::cout << "\n[GpuCulling]: Failed to create the pipeline layout";
+			PipelineLayout = nullptr;
+			return;
+		}
+
+		VkComputePipelineCreateInfo PipelineCreateInfo = { };
+		PipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		PipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		PipelineCreateInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		PipelineCreateInfo.stage.module = computeShader;
+		PipelineCreateInfo.stage.pName = "main";
+		PipelineCreateInfo.layout = PipelineLayout;
+
+		if (vkCreateComputePipelines(Device, VK_NULL_HANDLE, 1, &PipelineCreateInfo, nullptr, &Pipeline) != VK_SUCCESS)
+		{
+			std::cout << "\n[GpuCulling]: Failed to create the pipeline";
+			Pipeline = nullptr;
+		}
+	}
+
+	/* The device has to be idle */
+	void Destroy()
+	{
+		if (Pipeline)
+		{
+			vkDestroyPipeline(Device, Pipeline, nullptr);
+			Pipeline = nullptr;
+		}
+
+		if (PipelineLayout)
+		{
+			vkDestroyPipelineLayout(Device, PipelineLayout, nullptr);
+			PipelineLayout = nullptr;
+		}
+	}
+
+	/*
+	* Records the culling of drawList with frameIndex's storage set (Level::GetShaderStorageDescSet())
+	*	drawList has to be built and flushed for the frame, its commands are read as an indirect buffer by the frame
+	*/
+	void Record(VkCommandBuffer commandBuffer, VkDescriptorSet storageSet, const Frustum& frustum, const DrawList& drawList)
+	{
+		const DrawList::Stats& DrawStats = drawList.GetStats();
+		CurrentStats.DrawsCulled = DrawStats.DrawCount;
+		CurrentStats.InstancesTested = DrawStats.InstanceCount;
+
+		if (Pipeline == nullptr || DrawStats.DrawCount == 0)
+		{
+			return;
+		}
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, Pipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, PipelineLayout, 0, 1, &storageSet, 0, nullptr);
+
+		CullConstants Constants = MakeConstants(frustum, DrawStats.DrawCount);
+		for (uint32 First = 0; First < DrawStats.DrawCount; First += MaxDrawsPerDispatch)
+		{
+			uint32 Count = DrawStats.DrawCount - First;
+			Count = Count < MaxDrawsPerDispatch ? Count : MaxDrawsPerDispatch;
+
+			Constants.FirstDraw = First;
+			vkCmdPushConstants(commandBuffer, PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullConstants), &Constants);
+			vkCmdDispatch(commandBuffer, Count, 1, 1);
+		}
+	}
+
+	const Stats& GetStats() const
+	{
+		return CurrentStats;
+	}
+
+	/*
+	* The shader's kernel on the CPU, outCommands gets one command per draw and outVisibleInstances the compacted instances
+	*	outVisibleInstances is grown to cover every draw's slots, slots past a draw's visible count are not written
+	*/
+	static void CullReference(const std::vector<DrawData>& draws, const std::vector<Matrix4D>& worldMatrices, const Frustum& frustum,
+		std::vector<VkDrawIndexedIndirectCommand>& outCommands, std::vector<uint32>& outVisibleInstances)
+	{
+		CullConstants Constants = MakeConstants(frustum, static_cast<uint32>(draws.size()));
+
+		outCommands.resize(draws.size());
+		for (uint32 i = 0; i < draws.size(); ++i)
+		{
+			const DrawData& Draw = draws[i];
+			if (outVisibleInstances.size() < Draw.FirstInstance + Draw.InstanceCount)
+			{
+				outVisibleInstances.resize(Draw.FirstInstance + Draw.InstanceCount);
+			}
+
+			uint32 VisibleCount = 0;
+			for (uint32 Instance = 0; Instance < Draw.InstanceCount; ++Instance)
+			{
+				if (IsInstanceVisible(Draw, worldMatrices[Draw.MeshID + Instance], Constants.Planes))
+				{
+					outVisibleInstances[Draw.FirstInstance + VisibleCount] = Instance;
+					VisibleCount++;
+				}
+			}
+
+			VkDrawIndexedIndirectCommand& Command = outCommands[i];
+			Command.indexCount = Draw.IndexCount;
+			Command.instanceCount = VisibleCount;
+			Command.firstIndex = Draw.FirstIndex;
+			Command.vertexOffset = Draw.VertexOffset;
+			Command.firstInstance = Draw.FirstInstance;
+		}
+	}
+
+	/* Frustum::TestAABB() on the instance's world AABB (Bounds::TransformAABB()), planes as in CullConstants */
+	static bool IsInstanceVisible(const DrawData& draw, const Matrix4D& world, const Vector4D* planes)
+	{
+		Vector3D WorldCenter;
+		Vector3D WorldExtents;
+		Bounds::TransformAABB(Vector3D(draw.BoundsCenter.X, draw.BoundsCenter.Y, draw.BoundsCenter.Z),
+			Vector3D(draw.BoundsExtents.X, draw.BoundsExtents.Y, draw.BoundsExtents.Z), world, WorldCenter, WorldExtents);
+
+		for (uint32 i = 0; i < 6; ++i)
+		{
+			const Vector4D& Plane = planes[i];
+			float Distance = Plane.X * WorldCenter.X + Plane.Y * WorldCenter.Y + Plane.Z * WorldCenter.Z - Plane.W;
+			float Radius = std::fabs(Plane.X) * WorldExtents.X + std::fabs(Plane.Y) * WorldExtents.Y + std::fabs(Plane.Z) * WorldExtents.Z;
+
+			if (Distance < -Radius)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+private:
+	static CullConstants MakeConstants(const Frustum& frustum, uint32 drawCount)
+	{
+		CullConstants Constants = { };
+		for (uint32 i = 0; i < 6; ++i)
+		{
+			const Plane& FrustumPlane = frustum.Planes[i];
+			Constants.Planes[i] = Vector4D(FrustumPlane.X, FrustumPlane.Y, FrustumPlane.Z, FrustumPlane.Distance);
+		}
+
+		Constants.FirstDraw = 0;
+		Constants.DrawCount = drawCount;
+		return Constants;
+	}
+
+	/* Frames in flight may still use the old pipeline */
+	void RetirePipeline()
+	{
+		if (Pipeline == nullptr && PipelineLayout == nullptr)
+		{
+			return;
+		}
+
+		VkDevice DeviceHandle = Device;
+		VkPipeline OldPipeline = Pipeline;
+		VkPipelineLayout OldPipelineLayout = PipelineLayout;
+		DeletionQueue::Get().Retire([DeviceHandle, OldPipeline, OldPipelineLayout]()
+			{
+				if (OldPipeline)
+				{
+					vkDestroyPipeline(DeviceHandle, OldPipeline, nullptr);
+				}
+				if (OldPipelineLayout)
+				{
+					vkDestroyPipelineLayout(DeviceHandle, OldPipelineLayout, nullptr);
+				}
+			});
+
+		Pipeline = nullptr;
+		PipelineLayout = nullptr;
+	}
+};
@@ -0,0 +1,261 @@
+#pragma once
+#include <iostream>
+
+#include "GatewareDefine.h"
+#include "GpuMemoryAllocator.h"
+
+/* GpuMemoryBackend on top of vkAllocateMemory(), host visible blocks are mapped once for their whole life */
+class VulkanMemoryBackend : public GpuMemoryBackend
+{
+private:
+	VkDevice Device;
+	VkPhysicalDeviceMemoryProperties MemoryProperties;
+
+public:
+	VulkanMemoryBackend()
+	{
+		Device = nullptr;
+		MemoryProperties = { };
+	}
+
+	void Initialize(VkPhysicalDevice physicalDevice, VkDevice device)
+	{
+		Device = device;
+		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &MemoryProperties);
+	}
+
+	virtual GpuMemoryHandle AllocateBlock(uint32 memoryTypeIndex, size_t sizeInBytes, char** outMapped) override
+	{
+		VkMemoryAllocateInfo AllocateInfo = { };
+		AllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		AllocateInfo.allocationSize = sizeInBytes;
+		AllocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+		VkDeviceMemory Memory = nullptr;
+		if (vkAllocateMemory(Device, &AllocateInfo, nullptr, &Memory) != VK_SUCCESS)
+		{
+			return nullptr;
+		}
+
+		*outMapped = nullptr;
+		if (MemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+		{
+			vkMapMemory(Device, Memory, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(outMapped));
+		}
+
+		return Memory;
+	}
+
+	virtual void FreeBlock(uint32 memoryTypeIndex, GpuMemoryHandle memory) override
+	{
+		VkDeviceMemory Memory = static_cast<VkDeviceMemory>(memory);
+		if (MemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+		{
+			vkUnmapMemory(Device, Memory);
+		}
+
+		vkFreeMemory(Device, Memory, nullptr);
+	}
+
+	const VkPhysicalDeviceMemoryProperties& GetMemoryProperties() const
+	{
+		return MemoryProperties;
+	}
+};
+
+/*
+* Process wide device memory, every buffer of the renderer is created through CreateBuffer() and sub allocated by GpuMemoryAllocator
+*	Mapped memory stays mapped, use GpuAllocation::Mapped instead of vkMapMemory()
+*	KTX textures are not part of it, ktxVulkan allocates their memory itself
+*/
+class GpuMemory
+{
+public:
+	/* Share of a heap the allocator may take, leaves room for textures, swapchain images and other processes */
+	static const uint32 HeapBudgetPercent = 80;
+
+private:
+	VulkanMemoryBackend Backend;
+	GpuMemoryAllocator Allocator;
+
+	VkPhysicalDevice PhysicalDevice;
+	VkDevice Device;
+
+	VkDeviceSize NonCoherentAtomSize;
+
+	/* Graphics and transfer family while the upload batch copies on a queue of its own, see SetUploadQueueFamilies() */
+	uint32 UploadQueueFamilies[2];
+	uint32 UploadQueueFamilyCount;
+
+private:
+	GpuMemory()
+	{
+		PhysicalDevice = nullptr;
+		Device = nullptr;
+		NonCoherentAtomSize = 1;
+
+		UploadQueueFamilies[0] = UploadQueueFamilies[1] = 0;
+		UploadQueueFamilyCount = 0;
+	}
+
+public:
+	GpuMemory(const GpuMemory& other) = delete;
+	GpuMemory& operator=(const GpuMemory& other) = delete;
+
+	static GpuMemory& Get()
+	{
+		static GpuMemory Instance;
+		return Instance;
+	}
+
+public:
+	/* Has to be called before the first buffer is created */
+	void Initialize(VkPhysicalDevice physicalDevice, VkDevice device)
+	{
+		PhysicalDevice = physicalDevice;
+		Device = device;
+
+		VkPhysicalDeviceProperties Properties;
+		vkGetPhysicalDeviceProperties(PhysicalDevice, &Properties);
+		NonCoherentAtomSize = Properties.limits.nonCoherentAtomSize > 0 ? Properties.limits.nonCoherentAtomSize : 1;
+
+		Backend.Initialize(PhysicalDevice, Device);
+		const VkPhysicalDeviceMemoryProperties& MemoryProperties = Backend.GetMemoryProperties();
+
+		std::vector<uint32> MemoryTypeHeaps(MemoryProperties.memoryTypeCount);
+		for (uint32 i = 0; i < MemoryProperties.memoryTypeCount; ++i)
+		{
+			MemoryTypeHeaps[i] = MemoryProperties.memoryTypes[i].heapIndex;
+		}
+
+		std::vector<size_t> HeapBudgets(MemoryProperties.memoryHeapCount);
+		for (uint32 i = 0; i < MemoryProperties.memoryHeapCount; ++i)
+		{
+			HeapBudgets[i] = MemoryProperties.memoryHeaps[i].size / 100 * HeapBudgetPercent;
+		}
+
+		Allocator.Initialize(&Backend, MemoryTypeHeaps, HeapBudgets);
+	}
+
+	/* Frees every block, call once the device is idle and every buffer was destroyed */
+	void Shutdown()
+	{
+#if DEBUG
+		DumpStats(std::cout);
+#endif // DEBUG
+
+		Allocator.Shutdown();
+	}
+
+	/*
+	* Buffers created with transfer usage after this, and images set up through SetUploadSharing(), are VK_SHARING_MODE_CONCURRENT
+	*	between the two families, so the transfer queue writes what the graphics queue reads without ownership transfers
+	*	The same family twice goes back to VK_SHARING_MODE_EXCLUSIVE
+	*/
+	void SetUploadQueueFamilies(uint32 graphicsFamily, uint32 transferFamily)
+	{
+		UploadQueueFamilies[0] = graphicsFamily;
+		UploadQueueFamilies[1] = transferFamily;
+		UploadQueueFamilyCount = graphicsFamily != transferFamily ? 2 : 0;
+	}
+
+	/* Sharing mode of a VkBufferCreateInfo or VkImageCreateInfo for a resource the upload batch writes */
+	template<typename CreateInfoType>
+	void SetUploadSharing(CreateInfoType& outCreateInfo) const
+	{
+		outCreateInfo.sharingMode = UploadQueueFamilyCount > 1 ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+		outCreateInfo.queueFamilyIndexCount = UploadQueueFamilyCount;
+		outCreateInfo.pQueueFamilyIndices = UploadQueueFamilyCount > 1 ? UploadQueueFamilies : nullptr;
+	}
+
+	/*
+	* Same as GvkHelper::create_buffer() but the memory comes out of a shared block
+	*	@returns the result of the first call that failed
+	*/
+	VkResult CreateBuffer(VkDeviceSize sizeInBytes, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+		VkBuffer* outBuffer, GpuAllocation* outAllocation)
+	{
+		*outBuffer = nullptr;
+		*outAllocation = GpuAllocation();
+
+		VkBufferCreateInfo CreateInfo = { };
+		CreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		CreateInfo.size = sizeInBytes;
+		CreateInfo.usage = usage;
+		CreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		if (usage & (VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT))
+		{
+			SetUploadSharing(CreateInfo);
+		}
+
+		VkResult Result = vkCreateBuffer(Device, &CreateInfo, nullptr, outBuffer);
+		if (Result != VK_SUCCESS)
+		{
+			*outBuffer = nullptr;
+			return Result;
+		}
+
+		VkMemoryRequirements Requirements;
+		vkGetBufferMemoryRequirements(Device, *outBuffer, &Requirements);
+
+		uint32 MemoryTypeIndex = 0;
+		Result = GvkHelper::find_memory_type(PhysicalDevice, Requirements.memoryTypeBits, properties, &MemoryTypeIndex);
+		if (Result == VK_SUCCESS && !Allocator.Allocate(MemoryTypeIndex, Requirements.size, Requirements.alignment, *outAllocation))
+		{
+			Result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+		}
+
+		if (Result == VK_SUCCESS)
+		{
+			Result = vkBindBufferMemory(Device, *outBuffer, static_cast<VkDeviceMemory>(outAllocation->Memory), outAllocation->Offset);
+		}
+
+		if (Result != VK_SUCCESS)
+		{
+			std::cout << "\n[GpuMemory]: Failed to create a " << sizeInBytes << " byte buffer";
+			DestroyBuffer(*outBuffer, *outAllocation);
+		}
+
+		return Result;
+	}
+
+	/* Resets buffer and allocation, the GPU must be done with the buffer */
+	void DestroyBuffer(VkBuffer& buffer, GpuAllocation& allocation)
+	{
+		if (buffer)
+		{
+			vkDestroyBuffer(Device, buffer, nullptr);
+			buffer = nullptr;
+		}
+
+		Allocator.Free(allocation);
+	}
+
+	/* Makes CPU writes to allocation visible to the GPU, only needed for memory that is not host coherent */
+	void Flush(const GpuAllocation& allocation)
+	{
+		if (!allocation.IsValid())
+		{
+			return;
+		}
+
+		/* Offset has to be a multiple of the atom size, the range runs to the end of the block so the size needs no rounding */
+		VkMappedMemoryRange Range = { };
+		Range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+		Range.memory = static_cast<VkDeviceMemory>(allocation.Memory);
+		Range.offset = allocation.Offset / NonCoherentAtomSize * NonCoherentAtomSize;
+		Range.size = VK_WHOLE_SIZE;
+
+		vkFlushMappedMemoryRanges(Device, 1, &Range);
+	}
+
+	GpuMemoryAllocator::Stats GetStats()
+	{
+		return Allocator.GetStats();
+	}
+
+	void DumpStats(std::ostream& stream)
+	{
+		Allocator.DumpStats(stream);
+	}
+};
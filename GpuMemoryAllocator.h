@@ -0,0 +1,838 @@
+#pragma once
+#include <vector>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <iostream>
+
+#include "GenericDefines.h"
+
+/* A VkDeviceMemory handle, kept opaque so the allocator does not depend on Vulkan */
+typedef void* GpuMemoryHandle;
+
+/*
+* Where the allocator gets its blocks from, vkAllocateMemory() in GpuMemory.h
+*	Anything else (a calloc based mock...) can stand in for it, the allocator never touches the memory itself
+*/
+class GpuMemoryBackend
+{
+public:
+	virtual ~GpuMemoryBackend() { }
+
+	/* @returns nullptr if the device is out of memory, outMapped is set to the start of the block for host visible types */
+	virtual GpuMemoryHandle AllocateBlock(uint32 memoryTypeIndex, size_t sizeInBytes, char** outMapped) = 0;
+
+	virtual void FreeBlock(uint32 memoryTypeIndex, GpuMemoryHandle memory) = 0;
+};
+
+/* A piece of a block handed out by GpuMemoryAllocator, has to be given back with Free() */
+struct GpuAllocation
+{
+	GpuMemoryHandle Memory = nullptr;
+	size_t Offset = 0;
+
+	/* What was asked for, ReservedSize is what the allocator set aside for it */
+	size_t Size = 0;
+	size_t ReservedSize = 0;
+
+	/* Memory + Offset on the CPU, nullptr if the memory type is not host visible */
+	char* Mapped = nullptr;
+
+	/* Bookkeeping for Free() */
+	uint32 MemoryTypeIndex = 0;
+	uint32 BlockIndex = 0;
+	int32 SizeClass = -1;
+	uint32 PageIndex = 0;
+
+	bool IsValid() const
+	{
+		return Memory != nullptr;
+	}
+};
+
+/*
+* Power of two allocator over a range of [0, SizeInBytes), nodes are split in halves on allocation and merged with their buddy on free
+*	Sizes are rounded up to a power of two of at least MinNodeSizeInBytes, offsets are aligned to the rounded size
+*/
+class BuddyAllocator
+{
+private:
+	size_t SizeInBytes;
+	size_t MinNodeSizeInBytes;
+
+	/* Level 0 is the whole range, every level halves the node size */
+	uint32 LevelCount;
+
+	/* Offsets of the free nodes of every level, ordered so the lowest offset is reused first */
+	std::vector<std::set<size_t>> FreeNodes;
+
+	size_t FreeBytes;
+
+public:
+	/* sizeInBytes and minNodeSizeInBytes have to be powers of two */
+	BuddyAllocator(size_t sizeInBytes, size_t minNodeSizeInBytes)
+	{
+		SizeInBytes = sizeInBytes;
+		MinNodeSizeInBytes = minNodeSizeInBytes < sizeInBytes ? minNodeSizeInBytes : sizeInBytes;
+
+		LevelCount = 1;
+		for (size_t NodeSize = SizeInBytes; NodeSize > MinNodeSizeInBytes; NodeSize >>= 1)
+		{
+			LevelCount++;
+		}
+
+		FreeNodes.resize(LevelCount);
+		FreeNodes[0].insert(0);
+		FreeBytes = SizeInBytes;
+	}
+
+public:
+	/* @returns false if no node of the rounded size is left */
+	bool Allocate(size_t sizeInBytes, size_t& outOffset)
+	{
+		if (sizeInBytes == 0 || sizeInBytes > SizeInBytes)
+		{
+			return false;
+		}
+
+		uint32 Level = GetLevel(sizeInBytes);
+
+		/* Smallest free node that fits, the deepest level at or above Level */
+		int32 FoundLevel = -1;
+		for (int32 i = Level; i >= 0; --i)
+		{
+			if (!FreeNodes[i].empty())
+			{
+				FoundLevel = i;
+				break;
+			}
+		}
+
+		if (FoundLevel < 0)
+		{
+			return false;
+		}
+
+		size_t Offset = *FreeNodes[FoundLevel].begin();
+		FreeNodes[FoundLevel].erase(FreeNodes[FoundLevel].begin());
+
+		/* Split down to Level, the upper halves become free */
+		for (uint32 i = FoundLevel; i < Level; ++i)
+		{
+			FreeNodes[i + 1].insert(Offset + GetNodeSize(i + 1));
+		}
+
+		FreeBytes -= GetNodeSize(Level);
+		outOffset = Offset;
+		return true;
+	}
+
+	/* sizeInBytes has to be what was passed to Allocate() */
+	void Free(size_t offset, size_t sizeInBytes)
+	{
+		uint32 Level = GetLevel(sizeInBytes);
+		FreeBytes += GetNodeSize(Level);
+
+		/* Merge with the buddy as long as it is free */
+		while (Level > 0)
+		{
+			size_t Buddy = offset ^ GetNodeSize(Level);
+			std::set<size_t>::iterator BuddyIt = FreeNodes[Level].find(Buddy);
+			if (BuddyIt == FreeNodes[Level].end())
+			{
+				break;
+			}
+
+			FreeNodes[Level].erase(BuddyIt);
+			offset = offset < Buddy ? offset : Buddy;
+			Level--;
+		}
+
+		FreeNodes[Level].insert(offset);
+	}
+
+	/* What Allocate() really reserves for sizeInBytes */
+	size_t GetAllocationSize(size_t sizeInBytes) const
+	{
+		return GetNodeSize(GetLevel(sizeInBytes));
+	}
+
+	bool IsEmpty() const
+	{
+		return FreeBytes == SizeInBytes;
+	}
+
+	size_t GetFreeBytes() const
+	{
+		return FreeBytes;
+	}
+
+	/* Biggest allocation that would still succeed */
+	size_t GetLargestFreeNode() const
+	{
+		for (uint32 i = 0; i < LevelCount; ++i)
+		{
+			if (!FreeNodes[i].empty())
+			{
+				return GetNodeSize(i);
+			}
+		}
+
+		return 0;
+	}
+
+private:
+	size_t GetNodeSize(uint32 level) const
+	{
+		return SizeInBytes >> level;
+	}
+
+	/* Deepest level whose nodes still fit sizeInBytes */
+	uint32 GetLevel(size_t sizeInBytes) const
+	{
+		uint32 Level = LevelCount - 1;
+		while (Level > 0 && GetNodeSize(Level) < sizeInBytes)
+		{
+			Level--;
+		}
+
+		return Level;
+	}
+};
+
+/*
+* Sub allocates buffers out of big blocks of device memory instead of one vkAllocateMemory() per buffer
+*	Small allocations (up to MaxSizeClassInBytes) come from size classes, pages of the block split into equal slots with a free list
+*	Bigger allocations come straight from the block's buddy allocator, anything over half a block gets a dedicated block
+*	Every memory heap has a budget, a new block that would go over it fails the allocation instead of oversubscribing the heap
+*/
+class GpuMemoryAllocator
+{
+public:
+	static const size_t DefaultBlockSizeInBytes = 32ull * 1024ull * 1024ull;
+
+	/* Size classes go from MinSizeClassInBytes to MaxSizeClassInBytes in powers of two */
+	static const size_t MinSizeClassInBytes = 256;
+	static const size_t MaxSizeClassInBytes = 64 * 1024;
+	static const uint32 SizeClassCount = 9;
+
+	/* Size classes carve their slots out of pages of this size */
+	static const size_t PageSizeInBytes = 256 * 1024;
+
+	struct HeapStats
+	{
+		size_t BudgetInBytes;
+
+		/* Allocated from the backend */
+		size_t BlockBytes;
+		uint32 BlockCount;
+
+		/* Handed out, as asked for */
+		size_t UsedBytes;
+		uint32 AllocationCount;
+
+		/* Allocations that failed because of the budget */
+		uint32 OverBudgetCount;
+	};
+
+	struct Stats
+	{
+		std::vector<HeapStats> Heaps;
+
+		size_t BlockBytes;
+		size_t UsedBytes;
+
+		/* Used bytes after rounding to size classes and buddy nodes */
+		size_t ReservedBytes;
+
+		uint32 BlockCount;
+		uint32 DedicatedBlockCount;
+		uint32 AllocationCount;
+	};
+
+private:
+	struct Block
+	{
+		GpuMemoryHandle Memory;
+		char* Mapped;
+		size_t SizeInBytes;
+
+		/* nullptr for a dedicated block, it holds a single allocation */
+		std::unique_ptr<BuddyAllocator> Buddy;
+
+		/* Buddy allocations and size class pages, the block is released when it drops to zero */
+		uint32 AllocationCount;
+	};
+
+	struct Page
+	{
+		uint32 BlockIndex;
+		size_t Offset;
+
+		std::vector<uint16> FreeSlots;
+		uint32 SlotCount;
+
+		bool IsInUse;
+	};
+
+	struct MemoryType
+	{
+		uint32 HeapIndex;
+
+		/* Freed blocks leave an empty slot behind so the indices in GpuAllocation stay valid */
+		std::vector<std::unique_ptr<Block>> Blocks;
+
+		std::vector<Page> Pages[SizeClassCount];
+	};
+
+	GpuMemoryBackend* Backend;
+
+	std::vector<MemoryType> MemoryTypes;
+	std::vector<HeapStats> Heaps;
+
+	size_t BlockSizeInBytes;
+	size_t ReservedBytes;
+
+	std::mutex Lock;
+
+public:
+	GpuMemoryAllocator()
+	{
+		Backend = nullptr;
+		BlockSizeInBytes = DefaultBlockSizeInBytes;
+		ReservedBytes = 0;
+	}
+
+	GpuMemoryAllocator(const GpuMemoryAllocator& other) = delete;
+	GpuMemoryAllocator& operator=(const GpuMemoryAllocator& other) = delete;
+
+	~GpuMemoryAllocator()
+	{
+		Shutdown();
+	}
+
+public:
+	/*
+	* memoryTypeHeaps maps every memory type to its heap, heapBudgets is the budget of every heap in bytes
+	*	blockSizeInBytes is rounded up to a power of two of at least a page
+	*/
+	void Initialize(GpuMemoryBackend* backend, const std::vector<uint32>& memoryTypeHeaps, const std::vector<size_t>& heapBudgets,
+		size_t blockSizeInBytes = DefaultBlockSizeInBytes)
+	{
+		Shutdown();
+
+		std::lock_guard<std::mutex> Guard(Lock);
+
+		Backend = backend;
+
+		BlockSizeInBytes = PageSizeInBytes;
+		while (BlockSizeInBytes < blockSizeInBytes)
+		{
+			BlockSizeInBytes <<= 1;
+		}
+
+		MemoryTypes.resize(memoryTypeHeaps.size());
+		for (uint32 i = 0; i < memoryTypeHeaps.size(); ++i)
+		{
+			MemoryTypes[i].HeapIndex = memoryTypeHeaps[i];
+		}
+
+		Heaps.assign(heapBudgets.size(), HeapStats());
+		for (uint32 i = 0; i < heapBudgets.size(); ++i)
+		{
+			Heaps[i].BudgetInBytes = heapBudgets[i];
+		}
+
+		ReservedBytes = 0;
+	}
+
+	/* Gives every block back to the backend, allocations still alive are leaked */
+	void Shutdown()
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+
+#if DEBUG
+		for (uint32 i = 0; i < Heaps.size(); ++i)
+		{
+			if (Heaps[i].AllocationCount > 0)
+			{
+				std::cout << "\n[GpuMemoryAllocator]: " << Heaps[i].AllocationCount << " allocations of heap " << i << " were never freed";
+			}
+		}
+#endif // DEBUG
+
+		for (uint32 i = 0; i < MemoryTypes.size(); ++i)
+		{
+			for (uint32 j = 0; j < MemoryTypes[i].Blocks.size(); ++j)
+			{
+				if (MemoryTypes[i].Blocks[j])
+				{
+					Backend->FreeBlock(i, MemoryTypes[i].Blocks[j]->Memory);
+				}
+			}
+		}
+
+		MemoryTypes.clear();
+		Heaps.clear();
+		ReservedBytes = 0;
+	}
+
+	/*
+	* alignment has to be a power of two, the offset is always aligned to it
+	*	@returns false if the backend is out of memory or the heap's budget would be exceeded
+	*/
+	bool Allocate(uint32 memoryTypeIndex, size_t sizeInBytes, size_t alignment, GpuAllocation& outAllocation)
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+
+		outAllocation = GpuAllocation();
+		if (memoryTypeIndex >= MemoryTypes.size() || sizeInBytes == 0)
+		{
+			return false;
+		}
+
+		/* Slots and buddy nodes are aligned to their size, rounding up to the alignment is enough */
+		size_t AlignedSize = sizeInBytes > alignment ? sizeInBytes : alignment;
+
+		bool Result;
+		if (AlignedSize <= MaxSizeClassInBytes)
+		{
+			Result = AllocateFromSizeClass(memoryTypeIndex, AlignedSize, outAllocation);
+		}
+		else if (AlignedSize <= BlockSizeInBytes / 2)
+		{
+			Result = AllocateFromBuddy(memoryTypeIndex, AlignedSize, outAllocation);
+		}
+		else
+		{
+			Result = AllocateDedicated(memoryTypeIndex, AlignedSize, outAllocation);
+		}
+
+		if (!Result)
+		{
+			outAllocation = GpuAllocation();
+			return false;
+		}
+
+		Block& Owner = *MemoryTypes[memoryTypeIndex].Blocks[outAllocation.BlockIndex];
+		Owner.AllocationCount++;
+
+		outAllocation.Memory = Owner.Memory;
+		outAllocation.Size = sizeInBytes;
+		outAllocation.Mapped = Owner.Mapped ? Owner.Mapped + outAllocation.Offset : nullptr;
+		outAllocation.MemoryTypeIndex = memoryTypeIndex;
+
+		HeapStats& Heap = Heaps[MemoryTypes[memoryTypeIndex].HeapIndex];
+		Heap.UsedBytes += sizeInBytes;
+		Heap.AllocationCount++;
+
+		return true;
+	}
+
+	/* Resets allocation, freeing an invalid allocation does nothing */
+	void Free(GpuAllocation& allocation)
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+
+		if (!allocation.IsValid() || allocation.MemoryTypeIndex >= MemoryTypes.size())
+		{
+			allocation = GpuAllocation();
+			return;
+		}
+
+		MemoryType& Type = MemoryTypes[allocation.MemoryTypeIndex];
+		Block& Owner = *Type.Blocks[allocation.BlockIndex];
+
+		if (allocation.SizeClass >= 0)
+		{
+			FreeToSizeClass(Type, allocation);
+		}
+		else if (Owner.Buddy)
+		{
+			Owner.Buddy->Free(allocation.Offset, allocation.ReservedSize);
+			ReservedBytes -= allocation.ReservedSize;
+		}
+		else
+		{
+			ReservedBytes -= allocation.ReservedSize;
+		}
+
+		Owner.AllocationCount--;
+
+		HeapStats& Heap = Heaps[Type.HeapIndex];
+		Heap.UsedBytes -= allocation.Size;
+		Heap.AllocationCount--;
+
+		ReleaseBlockIfEmpty(allocation.MemoryTypeIndex, allocation.BlockIndex);
+
+		allocation = GpuAllocation();
+	}
+
+	Stats GetStats()
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+
+		Stats Result = { };
+		Result.Heaps = Heaps;
+		Result.ReservedBytes = ReservedBytes;
+
+		for (uint32 i = 0; i < Heaps.size(); ++i)
+		{
+			Result.BlockBytes += Heaps[i].BlockBytes;
+			Result.UsedBytes += Heaps[i].UsedBytes;
+			Result.BlockCount += Heaps[i].BlockCount;
+			Result.AllocationCount += Heaps[i].AllocationCount;
+		}
+
+		for (uint32 i = 0; i < MemoryTypes.size(); ++i)
+		{
+			for (uint32 j = 0; j < MemoryTypes[i].Blocks.size(); ++j)
+			{
+				if (MemoryTypes[i].Blocks[j] && !MemoryTypes[i].Blocks[j]->Buddy)
+				{
+					Result.DedicatedBlockCount++;
+				}
+			}
+		}
+
+		return Result;
+	}
+
+	/* Writes the budget and usage of every heap and the blocks of every memory type to stream */
+	void DumpStats(std::ostream& stream)
+	{
+		Stats Current = GetStats();
+
+		std::lock_guard<std::mutex> Guard(Lock);
+
+		const float MB = 1024.0f * 1024.0f;
+		stream << "\n[GpuMemoryAllocator]: " << Current.AllocationCount << " allocations in " << Current.BlockCount << " blocks ("
+			<< Current.DedicatedBlockCount << " dedicated), " << Current.UsedBytes / MB << " MB used, " << Current.ReservedBytes / MB
+			<< " MB reserved, " << Current.BlockBytes / MB << " MB allocated";
+
+		for (uint32 i = 0; i < Heaps.size(); ++i)
+		{
+			const HeapStats& Heap = Heaps[i];
+			stream << "\n\tHeap " << i << ": " << Heap.UsedBytes / MB << " MB used, " << Heap.BlockBytes / MB << " / "
+				<< Heap.BudgetInBytes / MB << " MB of the budget, " << Heap.BlockCount << " blocks, " << Heap.AllocationCount << " allocations";
+
+			if (Heap.OverBudgetCount > 0)
+			{
+				stream << ", " << Heap.OverBudgetCount << " allocations over budget";
+			}
+		}
+
+		for (uint32 i = 0; i < MemoryTypes.size(); ++i)
+		{
+			const MemoryType& Type = MemoryTypes[i];
+			for (uint32 j = 0; j < Type.Blocks.size(); ++j)
+			{
+				const Block* CurrentBlock = Type.Blocks[j].get();
+				if (CurrentBlock == nullptr)
+				{
+					continue;
+				}
+
+				stream << "\n\tType " << i << " block " << j << ": " << CurrentBlock->SizeInBytes / MB << " MB, " << CurrentBlock->AllocationCount << " ranges in use";
+				if (CurrentBlock->Buddy)
+				{
+					stream << ", " << CurrentBlock->Buddy->GetFreeBytes() / MB << " MB free, largest free node " << CurrentBlock->Buddy->GetLargestFreeNode() / MB << " MB";
+				}
+				else
+				{
+					stream << ", dedicated";
+				}
+			}
+
+			for (uint32 j = 0; j < SizeClassCount; ++j)
+			{
+				uint32 PageCount = 0;
+				uint32 UsedSlots = 0;
+				for (uint32 k = 0; k < Type.Pages[j].size(); ++k)
+				{
+					if (Type.Pages[j][k].IsInUse)
+					{
+						PageCount++;
+						UsedSlots += Type.Pages[j][k].SlotCount - Type.Pages[j][k].FreeSlots.size();
+					}
+				}
+
+				if (PageCount > 0)
+				{
+					stream << "\n\tType " << i << " size class " << GetSizeClassSize(j) << " bytes: " << UsedSlots << " slots used in " << PageCount << " pages";
+				}
+			}
+		}
+
+		stream << "\n";
+	}
+
+	size_t GetBlockSize() const
+	{
+		return BlockSizeInBytes;
+	}
+
+private:
+	static size_t GetSizeClassSize(uint32 sizeClass)
+	{
+		return MinSizeClassInBytes << sizeClass;
+	}
+
+	static uint32 GetSizeClass(size_t sizeInBytes)
+	{
+		uint32 SizeClass = 0;
+		while (GetSizeClassSize(SizeClass) < sizeInBytes)
+		{
+			SizeClass++;
+		}
+
+		return SizeClass;
+	}
+
+	bool AllocateFromSizeClass(uint32 memoryTypeIndex, size_t sizeInBytes, GpuAllocation& outAllocation)
+	{
+		MemoryType& Type = MemoryTypes[memoryTypeIndex];
+
+		uint32 SizeClass = GetSizeClass(sizeInBytes);
+		std::vector<Page>& Pages = Type.Pages[SizeClass];
+
+		/* A page with a free slot, or an unused entry to put a new page in */
+		int32 PageIndex = -1;
+		int32 UnusedIndex = -1;
+		for (uint32 i = 0; i < Pages.size(); ++i)
+		{
+			if (Pages[i].IsInUse && !Pages[i].FreeSlots.empty())
+			{
+				PageIndex = i;
+				break;
+			}
+
+			if (!Pages[i].IsInUse && UnusedIndex < 0)
+			{
+				UnusedIndex = i;
+			}
+		}
+
+		if (PageIndex < 0)
+		{
+			GpuAllocation PageAllocation;
+			if (!AllocateFromBuddy(memoryTypeIndex, PageSizeInBytes, PageAllocation))
+			{
+				return false;
+			}
+
+			/* The page is not an allocation of its own, its slots are, but it keeps the block alive until it is given back */
+			ReservedBytes -= PageSizeInBytes;
+			Type.Blocks[PageAllocation.BlockIndex]->AllocationCount++;
+
+			if (UnusedIndex < 0)
+			{
+				UnusedIndex = Pages.size();
+				Pages.push_back(Page());
+			}
+
+			Page& NewPage = Pages[UnusedIndex];
+			NewPage.BlockIndex = PageAllocation.BlockIndex;
+			NewPage.Offset = PageAllocation.Offset;
+			NewPage.SlotCount = static_cast<uint32>(PageSizeInBytes / GetSizeClassSize(SizeClass));
+			NewPage.IsInUse = true;
+
+			/* Popped from the back, lowest slot first */
+			NewPage.FreeSlots.resize(NewPage.SlotCount);
+			for (uint32 i = 0; i < NewPage.SlotCount; ++i)
+			{
+				NewPage.FreeSlots[i] = static_cast<uint16>(NewPage.SlotCount - 1 - i);
+			}
+
+			PageIndex = UnusedIndex;
+		}
+
+		Page& Owner = Pages[PageIndex];
+		uint16 Slot = Owner.FreeSlots.back();
+		Owner.FreeSlots.pop_back();
+
+		outAllocation.BlockIndex = Owner.BlockIndex;
+		outAllocation.Offset = Owner.Offset + Slot * GetSizeClassSize(SizeClass);
+		outAllocation.ReservedSize = GetSizeClassSize(SizeClass);
+		outAllocation.SizeClass = static_cast<int32>(SizeClass);
+		outAllocation.PageIndex = static_cast<uint32>(PageIndex);
+
+		ReservedBytes += GetSizeClassSize(SizeClass);
+		return true;
+	}
+
+	void FreeToSizeClass(MemoryType& type, const GpuAllocation& allocation)
+	{
+		Page& Owner = type.Pages[allocation.SizeClass][allocation.PageIndex];
+
+		size_t SlotSize = GetSizeClassSize(allocation.SizeClass);
+		Owner.FreeSlots.push_back(static_cast<uint16>((allocation.Offset - Owner.Offset) / SlotSize));
+		ReservedBytes -= SlotSize;
+
+		/* An empty page goes back to the block so other size classes or the block's release can use it */
+		if (Owner.FreeSlots.size() == Owner.SlotCount)
+		{
+			type.Blocks[Owner.BlockIndex]->Buddy->Free(Owner.Offset, PageSizeInBytes);
+			type.Blocks[Owner.BlockIndex]->AllocationCount--;
+
+			Owner.IsInUse = false;
+			Owner.FreeSlots.clear();
+		}
+	}
+
+	/* Also used for the pages of the size classes */
+	bool AllocateFromBuddy(uint32 memoryTypeIndex, size_t sizeInBytes, GpuAllocation& outAllocation)
+	{
+		MemoryType& Type = MemoryTypes[memoryTypeIndex];
+
+		for (uint32 i = 0; i < Type.Blocks.size(); ++i)
+		{
+			Block* Current = Type.Blocks[i].get();
+			if (Current == nullptr || !Current->Buddy)
+			{
+				continue;
+			}
+
+			size_t Offset;
+			if (Current->Buddy->Allocate(sizeInBytes, Offset))
+			{
+				return FinishBuddyAllocation(memoryTypeIndex, i, Offset, sizeInBytes, outAllocation);
+			}
+		}
+
+		uint32 BlockIndex;
+		if (!CreateBlock(memoryTypeIndex, BlockSizeInBytes, true, BlockIndex))
+		{
+			return false;
+		}
+
+		size_t Offset = 0;
+		Type.Blocks[BlockIndex]->Buddy->Allocate(sizeInBytes, Offset);
+		return FinishBuddyAllocation(memoryTypeIndex, BlockIndex, Offset, sizeInBytes, outAllocation);
+	}
+
+	bool FinishBuddyAllocation(uint32 memoryTypeIndex, uint32 blockIndex, size_t offset, size_t sizeInBytes, GpuAllocation& outAllocation)
+	{
+		Block& Owner = *MemoryTypes[memoryTypeIndex].Blocks[blockIndex];
+
+		outAllocation.BlockIndex = blockIndex;
+		outAllocation.Offset = offset;
+		outAllocation.ReservedSize = Owner.Buddy->GetAllocationSize(sizeInBytes);
+		outAllocation.SizeClass = -1;
+
+		ReservedBytes += outAllocation.ReservedSize;
+		return true;
+	}
+
+	bool AllocateDedicated(uint32 memoryTypeIndex, size_t sizeInBytes, GpuAllocation& outAllocation)
+	{
+		uint32 BlockIndex;
+		if (!CreateBlock(memoryTypeIndex, sizeInBytes, false, BlockIndex))
+		{
+			return false;
+		}
+
+		outAllocation.BlockIndex = BlockIndex;
+		outAllocation.Offset = 0;
+		outAllocation.ReservedSize = sizeInBytes;
+		outAllocation.SizeClass = -1;
+
+		ReservedBytes += sizeInBytes;
+		return true;
+	}
+
+	bool CreateBlock(uint32 memoryTypeIndex, size_t sizeInBytes, bool isSubAllocated, uint32& outBlockIndex)
+	{
+		MemoryType& Type = MemoryTypes[memoryTypeIndex];
+		HeapStats& Heap = Heaps[Type.HeapIndex];
+
+		if (Heap.BlockBytes + sizeInBytes > Heap.BudgetInBytes)
+		{
+			Heap.OverBudgetCount++;
+#if DEBUG
+			std::cout << "\n[GpuMemoryAllocator]: a " << sizeInBytes << " byte block would go over the " << Heap.BudgetInBytes
+				<< " byte budget of heap " << Type.HeapIndex;
+#endif // DEBUG
+			return false;
+		}
+
+		char* Mapped = nullptr;
+		GpuMemoryHandle Memory = Backend->AllocateBlock(memoryTypeIndex, sizeInBytes, &Mapped);
+		if (Memory == nullptr)
+		{
+#if DEBUG
+			std::cout << "\n[GpuMemoryAllocator]: Failed to allocate a " << sizeInBytes << " byte block of memory type " << memoryTypeIndex;
+#endif // DEBUG
+			return false;
+		}
+
+		std::unique_ptr<Block> NewBlock(new Block());
+		NewBlock->Memory = Memory;
+		NewBlock->Mapped = Mapped;
+		NewBlock->SizeInBytes = sizeInBytes;
+		NewBlock->AllocationCount = 0;
+		if (isSubAllocated)
+		{
+			NewBlock->Buddy.reset(new BuddyAllocator(sizeInBytes, MinSizeClassInBytes));
+		}
+
+		/* Reuse the slot of a released block */
+		outBlockIndex = Type.Blocks.size();
+		for (uint32 i = 0; i < Type.Blocks.size(); ++i)
+		{
+			if (!Type.Blocks[i])
+			{
+				outBlockIndex = i;
+				break;
+			}
+		}
+
+		if (outBlockIndex == Type.Blocks.size())
+		{
+			Type.Blocks.push_back(nullptr);
+		}
+		Type.Blocks[outBlockIndex] = std::move(NewBlock);
+
+		Heap.BlockBytes += sizeInBytes;
+		Heap.BlockCount++;
+
+		return true;
+	}
+
+	/* Dedicated blocks are released right away, the last sub allocated block of a memory type is kept around for reuse */
+	void ReleaseBlockIfEmpty(uint32 memoryTypeIndex, uint32 blockIndex)
+	{
+		MemoryType& Type = MemoryTypes[memoryTypeIndex];
+		Block& Owner = *Type.Blocks[blockIndex];
+
+		if (Owner.AllocationCount > 0)
+		{
+			return;
+		}
+
+		if (Owner.Buddy)
+		{
+			uint32 SubAllocatedBlockCount = 0;
+			for (uint32 i = 0; i < Type.Blocks.size(); ++i)
+			{
+				if (Type.Blocks[i] && Type.Blocks[i]->Buddy)
+				{
+					SubAllocatedBlockCount++;
+				}
+			}
+
+			if (SubAllocatedBlockCount <= 1)
+			{
+				return;
+			}
+		}
+
+		HeapStats& Heap = Heaps[Type.HeapIndex];
+		Heap.BlockBytes -= Owner.SizeInBytes;
+		Heap.BlockCount--;
+
+		Backend->FreeBlock(memoryTypeIndex, Owner.Memory);
+		Type.Blocks[blockIndex].reset();
+	}
+};
@@ -1,8 +1,12 @@
 #pragma once
 #include "GatewareDefine.h"
 #include <iostream>
+#include <atomic>
 
 #include "LevelData.h"
+#include "StorageArray.h"
+#include "DrawList.h"
+#include "UploadService.h"
 //#include "StorageBuffer.h"
 #define KHRONOS_STATIC
 #include <ktxvulkan.h>
@@ -34,10 +38,11 @@
 	}	
 #endif // DEBUG
 
-#define MAX_SUBMESH_PER_DRAW 512
-#define MAX_LIGHTS_PER_DRAW 16
 #define MAX_TEXTURES_PER_DRAW 20
 
+/* SceneData + the storage arrays of a level + the draw list, all in descriptor set 0 */
+#define SCENE_STORAGE_BINDING_COUNT 11
+
 struct Texture
 {
 	VkSampler Sampler;
@@ -56,15 +61,6 @@ struct SceneData
 	Vector4D AmbientTerm;
 	Vector4D CameraWorldPosition;
 
-	Matrix4D WorldMatrices[MAX_SUBMESH_PER_DRAW];
-	Material Materials[MAX_SUBMESH_PER_DRAW];
-
-	DirectionalLight DirectionalLights[MAX_LIGHTS_PER_DRAW];
-
-	PointLight PointLights[MAX_LIGHTS_PER_DRAW];
-
-	SpotLight SpotLights[MAX_LIGHTS_PER_DRAW];
-
 	/* 16-byte padding for the lights,
 	* X component -> num of point lights
 	* Y component -> num of spot lights
@@ -73,6 +69,13 @@ struct SceneData
 	Vector4D NumOfLights;
 };
 
+/* Dequantizes PackedVertex positions, one per static mesh, indexed by DrawData::DequantizationID */
+struct PositionDequantization
+{
+	Vector4D Scale;
+	Vector4D Offset;
+};
+
 class Level
 {
 private:
@@ -83,9 +86,11 @@ private:
 
 	/* API shader storage buffers */
 private:
-	/* Structured buffers for shaders */
-	std::vector<VkBuffer> ShaderStorageHandles;
-	std::vector<VkDeviceMemory> ShaderStorageDatas;
+	/* ShaderSceneData, one slice per frame, only the parts that changed are copied each frame */
+	FrameRingBuffer SceneDataRing;
+
+	/* ShaderSceneData and the storage arrays together, as flushed by the last Bind() */
+	FrameRingBuffer::Stats UploadStats;
 
 	/* Used to tell vulkan what type of descriptor we want to set */
 	VkDescriptorSetLayout ShaderStorageDescSetLayout;
@@ -107,15 +112,39 @@ private:
 
 	bool IsDataLoaded;
 
+	/* CPU side of the load is done, GPU resources are not created yet */
+	bool IsDataPrepared;
+
+	/* 0 -> 1, written by whichever thread is loading the level */
+	std::atomic<float> LoadProgress;
+
 	/* Scene Data */
 public:
 	SceneData* ShaderSceneData;
 
+	/*
+	* Per instance, per material and per light data, each in its own storage buffer (set 0, bindings 1 - 6)
+	*	Sized by the level, they can be appended to at runtime, Bind() grows the buffers when needed
+	*	MarkDirty() anything changed in place
+	*/
+	StorageArray<Matrix4D> WorldMatrices;
+	StorageArray<Material> Materials;
+	StorageArray<DirectionalLight> DirectionalLights;
+	StorageArray<PointLight> PointLights;
+	StorageArray<SpotLight> SpotLights;
+	StorageArray<PositionDequantization> PositionDequantizations;
+
+	/* Submeshes of the level (set 0, bindings 7 - 10), rebuilt by the renderer before Bind() when they change */
+	DrawList OpaqueDraws;
+
 private:
 	uint64 SceneDataSizeInBytes;
 
 	std::vector<Texture> Textures;
 
+	/* Textures read from disk by PrepareLoad(), uploaded and destroyed by FinishLoad() */
+	std::vector<ktxTexture*> DecodedTextures;
+
 public:
 	Level(VkDevice* deviceHandle, GW::GRAPHICS::GVulkanSurface* vlkSurface, VkPipelineLayout* pipelineLayout, const char* name, const char* path)
 	{
@@ -124,15 +153,20 @@ public:
 		PipelineLayout = pipelineLayout;
 
 		ShaderStorageDescSetLayout = nullptr;
+		ShaderTextureDescSetLayout = nullptr;
 		ShaderStoragePool = nullptr;
 
 		Path = path;
 		Name = name;
 		WorldData = nullptr;
+		ShaderSceneData = nullptr;
 
 		IsDataLoaded = false;
+		IsDataPrepared = false;
+		LoadProgress = 0.0f;
 
 		SceneDataSizeInBytes = 0;
+		UploadStats = { };
 	}
 
 	Level(const Level& Other) = delete;
@@ -158,8 +192,17 @@ public:
 
 			//ShaderSceneData->CameraWorldPosition = ShaderSceneData->View[0];
 
+			/* Arrays that outgrew their buffers get new ones, every frame's set still points at the old ones */
+			if (GrowStorageArrays())
+			{
+				for (uint32 i = 0; i < ShaderStorageDescSets.size(); ++i)
+				{
+					LinkStorageArrays(i);
+				}
+			}
+
 			/* Bind Shader data desc set*/
-			GvkHelper::write_to_buffer(*Device, ShaderStorageDatas[CurrentBuffer], ShaderSceneData, SceneDataSizeInBytes);
+			FlushStorage(CurrentBuffer);
 			vkCmdBindDescriptorSets(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, *PipelineLayout, 0, 1, &ShaderStorageDescSets[CurrentBuffer], 0, nullptr);
 
 			vkCmdBindDescriptorSets(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, *PipelineLayout, 1, 1, &ShaderTextureDescSets[CurrentBuffer], 0, nullptr);
@@ -177,27 +220,105 @@ public:
 
 		/* Load the file */
 		std::vector<RawMeshData> RawData;
-		FileHelper::ReadGameLevelFile(Path.c_str(), RawData);
+		ReadRawData(RawData);
 
 		return Load(RawData);
 	}
 
+	/*
+	* Reads the level file into outRawData
+	*	The compiled level (.lvlb) next to the text file is used when it is newer than the text file,
+	*	otherwise the text file is compiled first so the next load skips text parsing
+	*	A compiled level that cannot be read (corrupt or from another version) is compiled again,
+	*	the text file is read directly when compiling fails (e.g. the Levels folder is read only)
+	*/
+	void ReadRawData(std::vector<RawMeshData>& outRawData)
+	{
+		std::string BinaryPath = FileHelper::GetGameLevelBinaryPath(Path);
+		bool IsCompiled = BinaryPath == Path;
+
+		bool ReadBinary = IsCompiled || FileHelper::IsFileNewer(BinaryPath, Path)
+			|| FileHelper::ConvertGameLevelFile(Path.c_str(), BinaryPath.c_str());
+
+		if (ReadBinary && !FileHelper::ReadGameLevelBinaryFile(BinaryPath.c_str(), outRawData))
+		{
+			outRawData.clear();
+			ReadBinary = !IsCompiled && FileHelper::ConvertGameLevelFile(Path.c_str(), BinaryPath.c_str())
+				&& FileHelper::ReadGameLevelBinaryFile(BinaryPath.c_str(), outRawData);
+		}
+
+		if (!ReadBinary && !IsCompiled)
+		{
+			outRawData.clear();
+			FileHelper::ReadGameLevelFile(Path.c_str(), outRawData);
+		}
+
+		LoadProgress = 0.4f;
+	}
+
 	std::vector<StaticMesh> Load(std::vector<RawMeshData>& rawData)
 	{
-		if (IsDataLoaded)
+		std::vector<StaticMesh> StaticMeshes = PrepareLoad(rawData);
+		FinishLoad(StaticMeshes);
+
+		return StaticMeshes;
+	}
+
+	/*
+	* CPU half of Load(), builds the scene data, vertex/index arrays and reads the textures from disk
+	*	Does not touch the device or the queues so it can run on a worker thread while another level is rendering,
+	*	FinishLoad() must be called afterwards on the render thread
+	*/
+	std::vector<StaticMesh> PrepareLoad(std::vector<RawMeshData>& rawData)
+	{
+		if (IsDataLoaded || IsDataPrepared)
 		{
 			std::cout << "\n[Level]: " << Name << " is already loaded in.. Failed to load!";
 			return { };
 		}
 
-		/* Load the file */
 		std::vector<StaticMesh> StaticMeshes;
 
 		SetupGlobalSceneDataVars(rawData, StaticMeshes);
 		WorldData = new LevelData(Device, VlkSurface, rawData);
 
+		IsDataPrepared = true;
+		LoadProgress = 0.9f;
+
+		return StaticMeshes;
+	}
+
+	/*
+	* GPU half of Load(), creates the buffers, uploads the textures and writes the descriptor sets
+	*	staticMeshes are the meshes PrepareLoad() returned, their offsets are moved to where GeometryPool put their geometry
+	*/
+	void FinishLoad(std::vector<StaticMesh>& staticMeshes)
+	{
+		if (IsDataLoaded || !IsDataPrepared)
+		{
+			std::cout << "\n[Level]: " << Name << " was not prepared.. Failed to load!";
+			return;
+		}
+
 		WorldData->Load();
 
+		/* Same order as the meshes, the frustum (last mesh) gets the debug region */
+		const std::vector<GeometryPool::Range>& MeshRanges = WorldData->GetMeshRanges();
+		for (uint32 i = 0; i < staticMeshes.size() && i < MeshRanges.size(); ++i)
+		{
+			/* GeometryPool had no room for it, its offsets point at other meshes' geometry */
+			if (MeshRanges[i].IndexCount == 0 && staticMeshes[i].IndexCount > 0)
+			{
+				staticMeshes[i].InstanceCount = 0;
+			}
+
+			staticMeshes[i].VertexOffset = MeshRanges[i].VertexOffset;
+			staticMeshes[i].IndexOffset = MeshRanges[i].IndexOffset;
+			staticMeshes[i].IndexSizeInBytes = MeshRanges[i].IndexSizeInBytes;
+		}
+
+		UploadDecodedTextures();
+
 		/*  ----  */
 		uint32 NumOfActiveFrames = 0;
 		VlkSurface->GetSwapchainImageCount(NumOfActiveFrames);
@@ -207,15 +328,29 @@ public:
 		/* Resize storage vectors */
 		ShaderStorageDescSets.resize(NumOfActiveFrames);
 		ShaderTextureDescSets.resize(NumOfActiveFrames);
-		ShaderStorageHandles.resize(NumOfActiveFrames);
-		ShaderStorageDatas.resize(NumOfActiveFrames);
 
 		/* Create the storage buffers */
-		CreateStorageBuffers(NumOfActiveFrames, ShaderStorageHandles, ShaderStorageDatas, ShaderSceneData, SceneDataSizeInBytes);
+		VkPhysicalDevice PhysicalDevice = nullptr;
+		VlkSurface->GetPhysicalDevice((void**)&PhysicalDevice);
+		SceneDataRing.Create(PhysicalDevice, Device, NumOfActiveFrames, ShaderSceneData, SceneDataSizeInBytes, SceneDataSizeInBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+		WorldMatrices.Create(PhysicalDevice, Device, NumOfActiveFrames);
+		Materials.Create(PhysicalDevice, Device, NumOfActiveFrames);
+		DirectionalLights.Create(PhysicalDevice, Device, NumOfActiveFrames);
+		PointLights.Create(PhysicalDevice, Device, NumOfActiveFrames);
+		SpotLights.Create(PhysicalDevice, Device, NumOfActiveFrames);
+		PositionDequantizations.Create(PhysicalDevice, Device, NumOfActiveFrames);
+
+		OpaqueDraws.Create(PhysicalDevice, Device, NumOfActiveFrames, staticMeshes);
+
+#if DEBUG
+		std::cout << "[Level]: " << WorldMatrices.Size() << " world matrices, " << Materials.Size() << " materials, "
+			<< DirectionalLights.Size() << "/" << PointLights.Size() << "/" << SpotLights.Size() << " directional/point/spot lights\n";
+#endif // DEBUG
 
 		/* Create only one pool for our descriptor sets */
 		VkDescriptorPoolSize DescPoolSize[2];
-		DescPoolSize[0].descriptorCount = 1;
+		DescPoolSize[0].descriptorCount = SCENE_STORAGE_BINDING_COUNT * NumOfActiveFrames;
 		DescPoolSize[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 
 		DescPoolSize[1].descriptorCount = Textures.size();
@@ -234,12 +369,16 @@ public:
 		// Creatae bindless global descriptor layout
 		{
 			VkDescriptorSetLayoutBinding LayoutBinding[2];
-			/* Storage buffer binding */
-			LayoutBinding[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-			LayoutBinding[0].descriptorCount = 1;
-			LayoutBinding[0].binding = 0;
-			LayoutBinding[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-			LayoutBinding[0].pImmutableSamplers = nullptr;
+			/* Storage buffer bindings, SceneData then the storage arrays */
+			VkDescriptorSetLayoutBinding StorageBindings[SCENE_STORAGE_BINDING_COUNT];
+			for (uint32 i = 0; i < SCENE_STORAGE_BINDING_COUNT; ++i)
+			{
+				StorageBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				StorageBindings[i].descriptorCount = 1;
+				StorageBindings[i].binding = i;
+				StorageBindings[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+				StorageBindings[i].pImmutableSamplers = nullptr;
+			}
 
 			/* Texture buffer binding */
 			LayoutBinding[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -251,8 +390,8 @@ public:
 			VkDescriptorSetLayoutCreateInfo LayoutCreateInfo[2];
 			/* Storage buffer binding */
 			LayoutCreateInfo[0].sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-			LayoutCreateInfo[0].bindingCount = 1;
-			LayoutCreateInfo[0].pBindings = &LayoutBinding[0];
+			LayoutCreateInfo[0].bindingCount = SCENE_STORAGE_BINDING_COUNT;
+			LayoutCreateInfo[0].pBindings = StorageBindings;
 			LayoutCreateInfo[0].flags = 0;// VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
 			LayoutCreateInfo[0].pNext = nullptr;
 
@@ -278,8 +417,9 @@ public:
 		for (uint32 i = 0; i < NumOfActiveFrames; ++i)
 		{
 			AllocateDescriptorSet(&ShaderStorageDescSetLayout, &ShaderStorageDescSets[i], &ShaderStoragePool);
-			LinkDescriptorSetToBuffer(0, SceneDataSizeInBytes, &ShaderStorageDescSets[i], &ShaderStorageHandles[i]);
-
+			VkBuffer SceneDataHandle = SceneDataRing.GetHandle();
+			LinkDescriptorSetToBuffer(0, SceneDataRing.GetSliceOffset(i), SceneDataSizeInBytes, &ShaderStorageDescSets[i], &SceneDataHandle);
+			LinkStorageArrays(i);
 		}
 
 		uint32 NumWritesPerFrame = Textures.size();
@@ -329,10 +469,10 @@ public:
 		delete[] BindLessImageInfo;
 
 		IsDataLoaded = true;
+		IsDataPrepared = false;
+		LoadProgress = 1.0f;
 
 		std::cout << "[Level]: " << Name << " was loaded...";
-
-		return StaticMeshes;
 	}
 
 	/* Unloads all data from gpu and cpu for the current level */
@@ -340,6 +480,13 @@ public:
 	{
 		DestroyGPUData();
 
+		/* Prepared but never finished */
+		for (uint32 i = 0; i < DecodedTextures.size(); ++i)
+		{
+			ktxTexture_Destroy(DecodedTextures[i]);
+		}
+		DecodedTextures.clear();
+
 		if (WorldData != nullptr)
 		{
 			delete WorldData;
@@ -349,7 +496,26 @@ public:
 		delete ShaderSceneData;
 		ShaderSceneData = nullptr;
 
+		WorldMatrices.Elements.clear();
+		Materials.Elements.clear();
+		DirectionalLights.Elements.clear();
+		PointLights.Elements.clear();
+		SpotLights.Elements.clear();
+		PositionDequantizations.Elements.clear();
+
 		IsDataLoaded = false;
+		IsDataPrepared = false;
+		LoadProgress = 0.0f;
+	}
+
+	const std::string& GetName() const
+	{
+		return Name;
+	}
+
+	float GetLoadProgress() const
+	{
+		return LoadProgress.load(std::memory_order_relaxed);
 	}
 
 	/* Returns the desc set layouts for the main pipeline */
@@ -382,6 +548,169 @@ public:
 	* Tip: Always use optimal tiled images for rendering
 	*/
 	void LoadTexture(const char* filePath, Texture& outTexture)
+	{
+		ktxTexture* KTexture = nullptr;
+		if (DecodeTexture(filePath, KTexture))
+		{
+			UploadTexture(KTexture, outTexture);
+			ktxTexture_Destroy(KTexture);
+		}
+	}
+
+	/* Loads a texture into CPU memory, no vulkan calls are made so this is safe to call off the render thread */
+	bool DecodeTexture(const char* filePath, ktxTexture*& outKTexture)
+	{
+		KTX_error_code Result = ktxTexture_CreateFromNamedFile(filePath, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &outKTexture);
+		KTX_ERROR(Result);
+
+		if (Result != KTX_error_code::KTX_SUCCESS)
+		{
+			outKTexture = nullptr;
+			return false;
+		}
+
+		std::cout << "[Texture]: " << filePath << " loaded successfully...\n";
+		return true;
+	}
+
+	/*
+	* Records the upload of a decoded texture into UploadService's batch, render thread only
+	*	kTexture can be destroyed right after, its data is staged. Mipmaps ktx would generate are blitted in the batch
+	*	Textures the batch cannot copy as is (rows KTX pads to 4 bytes, mipmaps of a format without linear blits) or stage
+	*	go through UploadTextureBlocking()
+	*/
+	void UploadTexture(ktxTexture* kTexture, Texture& outTexture)
+	{
+		VkPhysicalDevice PhysicalDevice = nullptr;
+		GW_ERROR(VlkSurface->GetPhysicalDevice((void**)&PhysicalDevice));
+
+		VkFormat Format = ktxTexture_GetVkFormat(kTexture);
+		if (kTexture->numDimensions != 2 || !HasPackedRows(Format) || (kTexture->generateMipmaps && !CanBlitMipmaps(PhysicalDevice, Format)))
+		{
+			UploadTextureBlocking(kTexture, outTexture);
+			return;
+		}
+
+		/* Staged before the image is made, a texture without staging memory is uploaded the blocking way instead */
+		VkBuffer StagingBufferHandle = nullptr;
+		char* StagingMemory = UploadService::Get().Stage(ktxTexture_GetDataSize(kTexture), &StagingBufferHandle);
+		if (StagingMemory == nullptr)
+		{
+			UploadTextureBlocking(kTexture, outTexture);
+			return;
+		}
+		memcpy(StagingMemory, ktxTexture_GetData(kTexture), ktxTexture_GetDataSize(kTexture));
+
+		uint32 LayerCount = kTexture->numLayers * kTexture->numFaces;
+
+		/* The full chain ktx would generate, down to 1x1 */
+		uint32 LevelCount = kTexture->numLevels;
+		if (kTexture->generateMipmaps)
+		{
+			uint32 LargerSide = kTexture->baseWidth > kTexture->baseHeight ? kTexture->baseWidth : kTexture->baseHeight;
+			LevelCount = 1;
+			while (LargerSide >> LevelCount > 0)
+			{
+				++LevelCount;
+			}
+		}
+
+		VkImageCreateInfo ImageCreateInfo = { };
+		ImageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		ImageCreateInfo.flags = kTexture->isCubemap ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
+		ImageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+		ImageCreateInfo.format = Format;
+		ImageCreateInfo.extent = { kTexture->baseWidth, kTexture->baseHeight, 1 };
+		ImageCreateInfo.mipLevels = LevelCount;
+		ImageCreateInfo.arrayLayers = LayerCount;
+		ImageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		ImageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		ImageCreateInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+			(kTexture->generateMipmaps ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
+		ImageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		/* Copied on the transfer queue and read on the graphics queue */
+		GpuMemory::Get().SetUploadSharing(ImageCreateInfo);
+
+		ktxVulkanTexture& VkTexture = outTexture.Texture;
+		VkTexture = { };
+		VK_ERROR(vkCreateImage(*Device, &ImageCreateInfo, nullptr, &VkTexture.image));
+
+		/* Freed with vkFreeMemory() like the memory ktx allocates, see DestroyGPUData() */
+		VkMemoryRequirements Requirements;
+		vkGetImageMemoryRequirements(*Device, VkTexture.image, &Requirements);
+
+		VkMemoryAllocateInfo AllocateInfo = { };
+		AllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		AllocateInfo.allocationSize = Requirements.size;
+		VK_ERROR(GvkHelper::find_memory_type(PhysicalDevice, Requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &AllocateInfo.memoryTypeIndex));
+		VK_ERROR(vkAllocateMemory(*Device, &AllocateInfo, nullptr, &VkTexture.deviceMemory));
+		VK_ERROR(vkBindImageMemory(*Device, VkTexture.image, VkTexture.deviceMemory, 0));
+
+		VkTexture.imageFormat = Format;
+		VkTexture.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		VkTexture.viewType = kTexture->isCubemap ? (kTexture->isArray ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY : VK_IMAGE_VIEW_TYPE_CUBE)
+			: (kTexture->isArray ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D);
+		VkTexture.width = kTexture->baseWidth;
+		VkTexture.height = kTexture->baseHeight;
+		VkTexture.depth = 1;
+		VkTexture.levelCount = LevelCount;
+		VkTexture.layerCount = LayerCount;
+
+		/* One region per mip level in the file, layer and face, ktx knows where each image starts */
+		std::vector<VkBufferImageCopy> Regions;
+		for (uint32 MipLevel = 0; MipLevel < kTexture->numLevels; ++MipLevel)
+		{
+			for (uint32 Layer = 0; Layer < kTexture->numLayers; ++Layer)
+			{
+				for (uint32 Face = 0; Face < kTexture->numFaces; ++Face)
+				{
+					ktx_size_t Offset = 0;
+					KTX_ERROR(ktxTexture_GetImageOffset(kTexture, MipLevel, Layer, Face, &Offset));
+
+					VkBufferImageCopy Region = { };
+					Region.bufferOffset = Offset;
+					Region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, MipLevel, Layer * kTexture->numFaces + Face, 1 };
+					Region.imageExtent.width = kTexture->baseWidth >> MipLevel > 0 ? kTexture->baseWidth >> MipLevel : 1;
+					Region.imageExtent.height = kTexture->baseHeight >> MipLevel > 0 ? kTexture->baseHeight >> MipLevel : 1;
+					Region.imageExtent.depth = 1;
+					Regions.push_back(Region);
+				}
+			}
+		}
+
+		if (kTexture->generateMipmaps)
+		{
+			UploadService::Get().CopyBufferToImageAndBlitMipmaps(StagingBufferHandle, VkTexture.image, VkTexture.width, VkTexture.height,
+				VkTexture.levelCount, VkTexture.layerCount, Regions);
+		}
+		else
+		{
+			UploadService::Get().CopyBufferToImage(StagingBufferHandle, VkTexture.image, VkTexture.levelCount, VkTexture.layerCount, Regions);
+		}
+	}
+
+	/* Generated mipmaps are linear filtered blits, compressed and some other formats cannot be blitted */
+	static bool CanBlitMipmaps(VkPhysicalDevice physicalDevice, VkFormat format)
+	{
+		const VkFormatFeatureFlags Needed = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+		VkFormatProperties Properties;
+		vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &Properties);
+		return (Properties.optimalTilingFeatures & Needed) == Needed;
+	}
+
+	/* KTX 1 pads every row to 4 bytes, formats whose texels (or blocks) are a multiple of 4 bytes never have padding */
+	static bool HasPackedRows(VkFormat format)
+	{
+		return (format >= VK_FORMAT_R8G8B8A8_UNORM && format <= VK_FORMAT_A2B10G10R10_SINT_PACK32) ||
+			(format >= VK_FORMAT_R16G16_UNORM && format <= VK_FORMAT_R16G16_SFLOAT) ||
+			(format >= VK_FORMAT_R16G16B16A16_UNORM && format <= VK_FORMAT_R64G64B64A64_SFLOAT) ||
+			(format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK);
+	}
+
+	/* Uploads a decoded texture through ktx, it submits to the graphics queue and waits so it has to be called on the render thread */
+	void UploadTextureBlocking(ktxTexture* kTexture, Texture& outTexture)
 	{
 		VkQueue GraphicsQueue = nullptr;
 		VkCommandPool CommandPool = nullptr;
@@ -391,30 +720,18 @@ public:
 		GW_ERROR(VlkSurface->GetCommandPool((void**)&CommandPool));
 		GW_ERROR(VlkSurface->GetPhysicalDevice((void**)&PhysicalDevice));
 
-		// Temp vars for KTX
-		ktxTexture* KTexture = nullptr;
-		ktxVulkanDeviceInfo VulkanDeviceInfo;
-
 		// Used to transfer texture from CPU memory to GPU
+		ktxVulkanDeviceInfo VulkanDeviceInfo;
 		KTX_ERROR(ktxVulkanDeviceInfo_Construct(&VulkanDeviceInfo, PhysicalDevice, *Device,
 			GraphicsQueue, CommandPool, nullptr));
 
-		// Load texture into CPU memory from file
-		KTX_ERROR(ktxTexture_CreateFromNamedFile(filePath,
-			KTX_TEXTURE_CREATE_NO_FLAGS, &KTexture));
-
 		// This gets mad if you don't encode/save the .ktx file in a format Vulkan likes
-		KTX_ERROR(ktxTexture_VkUploadEx(KTexture, &VulkanDeviceInfo, &outTexture.Texture,
+		KTX_ERROR(ktxTexture_VkUploadEx(kTexture, &VulkanDeviceInfo, &outTexture.Texture,
 			VK_IMAGE_TILING_OPTIMAL,
 			VK_IMAGE_USAGE_SAMPLED_BIT,
 			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
 
-
-		// after loading all textures you don't need these anymore
-		ktxTexture_Destroy(KTexture);
 		ktxVulkanDeviceInfo_Destruct(&VulkanDeviceInfo);
-
-		std::cout << "[Texture]: " << filePath << " loaded successfully...\n";
 	}
 
 	GW::MATH::GMATRIXF GetViewMatrix1()
@@ -438,26 +755,43 @@ public:
 	void SetViewMatrix1(GW::MATH::GMATRIXF& mat)
 	{
 		ShaderSceneData->View[0] = reinterpret_cast<Matrix4D&>(mat.data);
+		SceneDataRing.MarkDirty(&ShaderSceneData->View[0], sizeof(Matrix4D));
 	}
 
 	void SetViewMatrix2(GW::MATH::GMATRIXF& mat)
 	{
 		ShaderSceneData->View[1] = reinterpret_cast<Matrix4D&>(mat.data);
+		SceneDataRing.MarkDirty(&ShaderSceneData->View[1], sizeof(Matrix4D));
 	}
 
 	void SetViewMatrix3(GW::MATH::GMATRIXF& mat)
 	{
 		ShaderSceneData->View[2] = reinterpret_cast<Matrix4D&>(mat.data);
+		SceneDataRing.MarkDirty(&ShaderSceneData->View[2], sizeof(Matrix4D));
 	}
 
 	void UpdateCameraWorldPosition(GW::MATH::GVECTORF& mat)
 	{
 		ShaderSceneData->CameraWorldPosition = reinterpret_cast<Vector4D&>(mat);
+		SceneDataRing.MarkDirty(&ShaderSceneData->CameraWorldPosition, sizeof(Vector4D));
 	}
 
 	void SetProjectionMatrix(GW::MATH::GMATRIXF& mat)
 	{
 		ShaderSceneData->Projection = reinterpret_cast<Matrix4D&>(mat.data);
+		SceneDataRing.MarkDirty(&ShaderSceneData->Projection, sizeof(Matrix4D));
+	}
+
+	/* Call after writing ShaderSceneData directly, first -> the first byte written */
+	void MarkSceneDataDirty(const void* first, size_t sizeInBytes)
+	{
+		SceneDataRing.MarkDirty(first, sizeInBytes);
+	}
+
+	/* Bytes of ShaderSceneData and the storage arrays copied to the GPU by the last Bind() */
+	const FrameRingBuffer::Stats& GetSceneDataUploadStats() const
+	{
+		return UploadStats;
 	}
 
 	LevelData* GetLevelData()
@@ -465,17 +799,28 @@ public:
 		return WorldData;
 	}
 
+	/* Storage set of frameIndex, also bound by the culling pass */
+	VkDescriptorSet GetShaderStorageDescSet(uint32 frameIndex)
+	{
+		return ShaderStorageDescSets[frameIndex];
+	}
+
 	/*--------------------------------------------------DEBUG-------------------------------------------------------*/
 
 private:
 
 	void DestroyGPUData()
 	{
-		for (uint32 i = 0; i < ShaderStorageHandles.size(); ++i)
-		{
-			vkDestroyBuffer(*Device, ShaderStorageHandles[i], nullptr);
-			vkFreeMemory(*Device, ShaderStorageDatas[i], nullptr);
-		}
+		SceneDataRing.Destroy();
+
+		WorldMatrices.Destroy();
+		Materials.Destroy();
+		DirectionalLights.Destroy();
+		PointLights.Destroy();
+		SpotLights.Destroy();
+		PositionDequantizations.Destroy();
+
+		OpaqueDraws.Destroy();
 
 		vkDestroyDescriptorSetLayout(*Device, ShaderStorageDescSetLayout, nullptr);
 		vkDestroyDescriptorSetLayout(*Device, ShaderTextureDescSetLayout, nullptr);
@@ -491,37 +836,6 @@ private:
 		}
 	}
 
-	void CreateStorageBuffers(const uint32 numBuffers, std::vector<VkBuffer>& bufferHandles, std::vector<VkDeviceMemory>& bufferDatas, const void* data, const uint64& bufferSize)
-	{
-		GW::GReturn Result;
-		VkPhysicalDevice PhysicalDevice = nullptr;
-		if ((Result = VlkSurface->GetPhysicalDevice((void**)&PhysicalDevice)) != GW::GReturn::SUCCESS)
-		{
-			std::cout << "\n[Gateware] Failed to get PhysicalDevice....";
-			return;
-		}
-
-		/* Resize vectors incase their not already resized */
-		if (bufferHandles.size() < numBuffers)
-		{
-			bufferHandles.resize(numBuffers);
-		}
-		if (bufferDatas.size() < numBuffers)
-		{
-			bufferDatas.resize(numBuffers);
-		}
-
-		VkResult VResult;
-		for (uint32 i = 0; i < numBuffers; ++i)
-		{
-			VK_ERROR(GvkHelper::create_buffer(PhysicalDevice, *Device, bufferSize,
-				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-				VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &bufferHandles[i], &bufferDatas[i]));
-
-			VK_ERROR(GvkHelper::write_to_buffer(*Device, bufferDatas[i], data, bufferSize));
-		}
-	}
-
 	void CreateDescriptorSetLayouts(uint32 numOfLayouts, uint32 descCount, VkDescriptorSetLayout* descSetLayout, VkDescriptorType descType, VkShaderStageFlags shaderStageFlags)
 	{
 		VkDescriptorSetLayoutBinding* DescSetLayoutBinding = new VkDescriptorSetLayoutBinding[numOfLayouts];
@@ -562,17 +876,157 @@ private:
 		VK_ERROR(Result);
 	}
 
-	void LinkDescriptorSetToBuffer(uint32 bindingNum, uint64 sizeOfBuffer, VkDescriptorSet* descSet, VkBuffer* bufferHandle)
+	/* Points bindings 1 - 10 of frameIndex's storage set at that frame's slice of every storage array */
+	void LinkStorageArrays(uint32 frameIndex)
+	{
+		VkDescriptorSet* DescSet = &ShaderStorageDescSets[frameIndex];
+
+		VkBuffer Handle = WorldMatrices.GetHandle();
+		LinkDescriptorSetToBuffer(1, WorldMatrices.GetSliceOffset(frameIndex), WorldMatrices.GetSliceSize(), DescSet, &Handle);
+
+		Handle = Materials.GetHandle();
+		LinkDescriptorSetToBuffer(2, Materials.GetSliceOffset(frameIndex), Materials.GetSliceSize(), DescSet, &Handle);
+
+		Handle = DirectionalLights.GetHandle();
+		LinkDescriptorSetToBuffer(3, DirectionalLights.GetSliceOffset(frameIndex), DirectionalLights.GetSliceSize(), DescSet, &Handle);
+
+		Handle = PointLights.GetHandle();
+		LinkDescriptorSetToBuffer(4, PointLights.GetSliceOffset(frameIndex), PointLights.GetSliceSize(), DescSet, &Handle);
+
+		Handle = SpotLights.GetHandle();
+		LinkDescriptorSetToBuffer(5, SpotLights.GetSliceOffset(frameIndex), SpotLights.GetSliceSize(), DescSet, &Handle);
+
+		Handle = PositionDequantizations.GetHandle();
+		LinkDescriptorSetToBuffer(6, PositionDequantizations.GetSliceOffset(frameIndex), PositionDequantizations.GetSliceSize(), DescSet, &Handle);
+
+		Handle = OpaqueDraws.Draws.GetHandle();
+		LinkDescriptorSetToBuffer(7, OpaqueDraws.Draws.GetSliceOffset(frameIndex), OpaqueDraws.Draws.GetSliceSize(), DescSet, &Handle);
+
+		Handle = OpaqueDraws.InstanceDraws.GetHandle();
+		LinkDescriptorSetToBuffer(8, OpaqueDraws.InstanceDraws.GetSliceOffset(frameIndex), OpaqueDraws.InstanceDraws.GetSliceSize(), DescSet, &Handle);
+
+		Handle = OpaqueDraws.VisibleInstances.GetHandle();
+		LinkDescriptorSetToBuffer(9, OpaqueDraws.VisibleInstances.GetSliceOffset(frameIndex), OpaqueDraws.VisibleInstances.GetSliceSize(), DescSet, &Handle);
+
+		Handle = OpaqueDraws.Commands.GetHandle();
+		LinkDescriptorSetToBuffer(10, OpaqueDraws.Commands.GetSliceOffset(frameIndex), OpaqueDraws.Commands.GetSliceSize(), DescSet, &Handle);
+	}
+
+	/*
+	* Recreates the buffers of the storage arrays that no longer fit, waits for every frame in flight first
+	*	@returns true if any buffer was recreated, the descriptor sets have to be relinked
+	*/
+	bool GrowStorageArrays()
+	{
+		if (!WorldMatrices.NeedsToGrow() && !Materials.NeedsToGrow() && !DirectionalLights.NeedsToGrow() &&
+			!PointLights.NeedsToGrow() && !SpotLights.NeedsToGrow() && !PositionDequantizations.NeedsToGrow() && !OpaqueDraws.NeedsToGrow())
+		{
+			return false;
+		}
+
+		uint32 FrameCount = 0;
+		VlkSurface->GetSwapchainImageCount(FrameCount);
+
+		/* The current frame's fence was waited on by StartFrame() and is not reset until EndFrame() */
+		for (uint32 i = 0; i < FrameCount; ++i)
+		{
+			VkFence Fence = nullptr;
+			VlkSurface->GetRenderFence(i, (void**)&Fence);
+			vkWaitForFences(*Device, 1, &Fence, VK_TRUE, ~(static_cast<uint64_t>(0)));
+		}
+
+		VkPhysicalDevice PhysicalDevice = nullptr;
+		VlkSurface->GetPhysicalDevice((void**)&PhysicalDevice);
+
+		if (WorldMatrices.NeedsToGrow())
+		{
+			WorldMatrices.Grow(PhysicalDevice, Device, FrameCount);
+		}
+		if (Materials.NeedsToGrow())
+		{
+			Materials.Grow(PhysicalDevice, Device, FrameCount);
+		}
+		if (DirectionalLights.NeedsToGrow())
+		{
+			DirectionalLights.Grow(PhysicalDevice, Device, FrameCount);
+		}
+		if (PointLights.NeedsToGrow())
+		{
+			PointLights.Grow(PhysicalDevice, Device, FrameCount);
+		}
+		if (SpotLights.NeedsToGrow())
+		{
+			SpotLights.Grow(PhysicalDevice, Device, FrameCount);
+		}
+		if (PositionDequantizations.NeedsToGrow())
+		{
+			PositionDequantizations.Grow(PhysicalDevice, Device, FrameCount);
+		}
+		if (OpaqueDraws.NeedsToGrow())
+		{
+			OpaqueDraws.Grow(PhysicalDevice, Device, FrameCount);
+		}
+
+#if DEBUG
+		std::cout << "[Level]: storage arrays grown to " << WorldMatrices.GetCapacity() << " world matrices, " << Materials.GetCapacity() << " materials\n";
+#endif // DEBUG
+
+		return true;
+	}
+
+	/* Copies what changed in ShaderSceneData and the storage arrays into frameIndex's slices */
+	void FlushStorage(uint32 frameIndex)
+	{
+		size_t BytesUploaded = SceneDataRing.Flush(frameIndex);
+		uint32 RangesUploaded = SceneDataRing.GetStats().RangesUploadedLastFrame;
+		size_t SizeInBytes = SceneDataRing.GetStats().SliceSizeInBytes;
+
+		BytesUploaded += WorldMatrices.Flush(frameIndex);
+		RangesUploaded += WorldMatrices.GetStats().RangesUploadedLastFrame;
+		SizeInBytes += WorldMatrices.GetStats().SliceSizeInBytes;
+
+		BytesUploaded += Materials.Flush(frameIndex);
+		RangesUploaded += Materials.GetStats().RangesUploadedLastFrame;
+		SizeInBytes += Materials.GetStats().SliceSizeInBytes;
+
+		BytesUploaded += DirectionalLights.Flush(frameIndex);
+		RangesUploaded += DirectionalLights.GetStats().RangesUploadedLastFrame;
+		SizeInBytes += DirectionalLights.GetStats().SliceSizeInBytes;
+
+		BytesUploaded += PointLights.Flush(frameIndex);
+		RangesUploaded += PointLights.GetStats().RangesUploadedLastFrame;
+		SizeInBytes += PointLights.GetStats().SliceSizeInBytes;
+
+		BytesUploaded += SpotLights.Flush(frameIndex);
+		RangesUploaded += SpotLights.GetStats().RangesUploadedLastFrame;
+		SizeInBytes += SpotLights.GetStats().SliceSizeInBytes;
+
+		BytesUploaded += PositionDequantizations.Flush(frameIndex);
+		RangesUploaded += PositionDequantizations.GetStats().RangesUploadedLastFrame;
+		SizeInBytes += PositionDequantizations.GetStats().SliceSizeInBytes;
+
+		BytesUploaded += OpaqueDraws.Flush(frameIndex);
+		FrameRingBuffer::Stats DrawUploadStats = OpaqueDraws.GetUploadStats();
+		RangesUploaded += DrawUploadStats.RangesUploadedLastFrame;
+		SizeInBytes += DrawUploadStats.SliceSizeInBytes;
+
+		UploadStats.BytesUploadedLastFrame = BytesUploaded;
+		UploadStats.RangesUploadedLastFrame = RangesUploaded;
+		UploadStats.TotalBytesUploaded += BytesUploaded;
+		UploadStats.SliceSizeInBytes = SizeInBytes;
+	}
+
+	void LinkDescriptorSetToBuffer(uint32 bindingNum, VkDeviceSize offset, uint64 sizeOfBuffer, VkDescriptorSet* descSet, VkBuffer* bufferHandle)
 	{
 		VkDescriptorBufferInfo DescBufferInfo = { };
 		DescBufferInfo.buffer = *bufferHandle;
-		DescBufferInfo.offset = 0;
+		DescBufferInfo.offset = offset;
 		DescBufferInfo.range = sizeOfBuffer;
 
 		VkWriteDescriptorSet DescWriteSets = { };
 		DescWriteSets.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 		DescWriteSets.pNext = nullptr;
-		DescWriteSets.dstBinding = 0;
+		DescWriteSets.dstBinding = bindingNum;
 		DescWriteSets.dstSet = *descSet;
 		DescWriteSets.dstArrayElement = 0;
 		DescWriteSets.descriptorCount = 1;
@@ -708,6 +1162,27 @@ private:
 		SpotLight SLight;
 		DirectionalLight DLight;
 
+		/* Size the storage arrays up front, slot 0 of the world matrices is reserved */
+		uint32 TotalWorldMatrices = 1;
+		uint32 TotalMaterials = 0;
+		uint32 TotalStaticMeshes = 0;
+		for (uint32 i = 0; i < rawData.size(); ++i)
+		{
+			if (!rawData[i].IsCamera && !rawData[i].IsLight)
+			{
+				TotalWorldMatrices += rawData[i].WorldMatrices.size();
+				TotalMaterials += rawData[i].MaterialCount;
+				TotalStaticMeshes++;
+			}
+		}
+
+		WorldMatrices.Elements.assign(TotalWorldMatrices, Matrix4D::Identity());
+		Materials.Elements.assign(TotalMaterials, Material());
+		PositionDequantizations.Elements.assign(TotalStaticMeshes, { Vector4D(1.0f, 1.0f, 1.0f, 0.0f), Vector4D(0.0f, 0.0f, 0.0f, 0.0f) });
+		DirectionalLights.Elements.clear();
+		PointLights.Elements.clear();
+		SpotLights.Elements.clear();
+
 		/* store the texture paths so we can load them in later */
 		std::vector<std::string> TexturePaths;
 		TexturePaths.push_back("../Assets/Textures/DefaultDiffuseMap.ktx");
@@ -716,7 +1191,7 @@ private:
 
 		srand(time(NULL));
 
-		ShaderSceneData->WorldMatrices[0] = Matrix4D::Identity();
+		WorldMatrices[0] = Matrix4D::Identity();
 
 		/* Load the Materices and Materials */
 		for (uint32 i = 0; i < rawData.size(); i++)
@@ -741,7 +1216,7 @@ private:
 					DLight.Direction = DirectionVector;
 					DLight.Color = (rawData[i].WorldMatrices[0])[1];
 
-					ShaderSceneData->DirectionalLights[static_cast<uint32>(ShaderSceneData->NumOfLights.Z)] = DLight;
+					DirectionalLights.Elements.push_back(DLight);
 					ShaderSceneData->NumOfLights.Z += 1.0f;
 					break;
 				}
@@ -754,7 +1229,7 @@ private:
 					//PLight.AddStrength(3.0f);
 					//PLight.SetRadius(6.0f);
 
-					ShaderSceneData->PointLights[static_cast<uint32>(ShaderSceneData->NumOfLights.X)] = PLight;
+					PointLights.Elements.push_back(PLight);
 					ShaderSceneData->NumOfLights.X += 1.0f;
 
 					break;
@@ -777,7 +1252,7 @@ private:
 					SLight.SetInnerConeRatio((rawData[i].WorldMatrices[0])(1, 3));
 					SLight.SetOuterConeRatio((rawData[i].WorldMatrices[0])(2, 3));
 
-					ShaderSceneData->SpotLights[static_cast<uint32>(ShaderSceneData->NumOfLights.Y)] = SLight;
+					SpotLights.Elements.push_back(SLight);
 					ShaderSceneData->NumOfLights.Y += 1.0f;
 					break;
 				}
@@ -788,14 +1263,18 @@ private:
 
 			outStaticMeshes.push_back(StaticMesh(rawData[i].VertexCount, VertexOffset, rawData[i].IndexCount, IndexOffset, rawData[i].MaterialCount, MaterialOffset,
 				rawData[i].MeshCount, rawData[i].InstanceCount, WorldMatricesOffset + 1,
-				&ShaderSceneData->WorldMatrices[WorldMatricesOffset + 1]));
+				&WorldMatrices.Elements));
+
+			/* Same box LevelData quantized the positions against */
+			PackedVertex::GetDequantization(rawData[i].BoxMin_AABB, rawData[i].BoxMax_AABB,
+				PositionDequantizations[StaticMeshIndex].Scale, PositionDequantizations[StaticMeshIndex].Offset);
 
 			uint32 TexOffsetPerMesh = 0; // This offset keeps in track of how many meshes actually had a texture
 			for (uint32 j = 0; j < rawData[i].MeshCount; ++j)
 			{
 				TempMesh.IndexCount = rawData[i].Meshes[j].drawInfo.indexCount;
 				TempMesh.IndexOffset = rawData[i].Meshes[j].drawInfo.indexOffset;
-				TempMesh.Name = rawData[i].Meshes[j].name;
+				TempMesh.Name = rawData[i].GetMeshName(j);
 				TempMesh.MaterialIndex = rawData[i].Meshes[j].materialIndex;
 
 				outStaticMeshes[StaticMeshIndex].AddSubMesh(TempMesh);
@@ -803,7 +1282,7 @@ private:
 
 			for (uint32 j = 0; j < rawData[i].WorldMatrices.size(); ++j)
 			{
-				ShaderSceneData->WorldMatrices[(j + WorldMatricesOffset) + 1] = rawData[i].WorldMatrices[j];
+				WorldMatrices[(j + WorldMatricesOffset) + 1] = rawData[i].WorldMatrices[j];
 			}
 
 			if (i == rawData.size() - 1)
@@ -883,7 +1362,7 @@ private:
 
 				Mat.TextureFlags = TextureFlags;
 
-				ShaderSceneData->Materials[j + MaterialOffset] = Mat;
+				Materials[j + MaterialOffset] = Mat;
 			}
 
 			MaterialOffset += rawData[i].MaterialCount;
@@ -895,14 +1374,30 @@ private:
 			StaticMeshIndex++;
 		}
 
-		/* Load all textures */
-		Textures.resize(TexturePaths.size());
+		/* Read all textures, uploaded later by FinishLoad() */
+		DecodedTextures.resize(TexturePaths.size());
 		for (uint32 i = 0; i < TexturePaths.size(); ++i)
 		{
+			DecodeTexture(TexturePaths[i].c_str(), DecodedTextures[i]);
+			LoadProgress = 0.4f + 0.5f * (i + 1) / TexturePaths.size();
+		}
+	}
+
+	void UploadDecodedTextures()
+	{
+		Textures.resize(DecodedTextures.size());
+		for (uint32 i = 0; i < DecodedTextures.size(); ++i)
+		{
+			if (DecodedTextures[i] != nullptr)
+			{
+				UploadTexture(DecodedTextures[i], Textures[i]);
+				ktxTexture_Destroy(DecodedTextures[i]);
+			}
+
 			CreateDefaultSampler(Textures[i].Texture.levelCount, Textures[i].Sampler);
-			LoadTexture(TexturePaths[i].c_str(), Textures[i]);
 			CreateDefaultImageViewFromTexture(&Textures[i], Textures[i].View);
 		}
+		DecodedTextures.clear();
 	}
 
 public:
@@ -2,20 +2,69 @@
 #include "Math/Vector4D.h"
 #include "Math/Vector2D.h"
 #include <vector>
+#include <cstring>
 #include "Math/Matrix4D.h"
 #include "RawMeshData.h"
 #include "GenericDefines.h"
 #include "FileHelper.h"
 #include "GatewareDefine.h"
+#include "GpuMemory.h"
+#include "GeometryPool.h"
+#include "VertexLayout.h"
+#include "Math/VrixicMathQuantize.h"
 
 #include "FSLogo.h"
 
+/* Full precision vertex, only used for the debug geometry */
 struct Vertex
 {
 	Vector2D TexCoord;
 	Vector3D Position;
 	Vector3D Normal;
 	Vector4D Color;
+
+	static VertexLayout GetLayout()
+	{
+		return { sizeof(Vertex),
+			{
+				{ 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, TexCoord) },
+				{ 1, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, Position) },
+				{ 2, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, Normal) },
+				{ 3, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Vertex, Color) }
+			} };
+	}
+};
+
+/*
+* Static level geometry, 16 bytes instead of the 48 of Vertex
+*	Position -> unorm16 inside the mesh AABB, scaled back by SceneData::PositionScales/PositionOffsets, w is padding
+*	Normal -> octahedral snorm16
+*	TexCoord -> half floats
+*/
+struct PackedVertex
+{
+	uint16 Position[4];
+	int16 Normal[2];
+	uint16 TexCoord[2];
+
+	static VertexLayout GetLayout()
+	{
+		return { sizeof(PackedVertex),
+			{
+				{ 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(PackedVertex, Position) },
+				{ 1, VK_FORMAT_R16G16_SNORM, offsetof(PackedVertex, Normal) },
+				{ 2, VK_FORMAT_R16G16_SFLOAT, offsetof(PackedVertex, TexCoord) }
+			} };
+	}
+
+	/* Position = Packed * Scale + Offset, a flat axis gets a scale of one so nothing divides by zero */
+	static void GetDequantization(const Vector3D& boxMin, const Vector3D& boxMax, Vector4D& outScale, Vector4D& outOffset)
+	{
+		Vector3D Extent = boxMax - boxMin;
+
+		outScale = Vector4D(Extent.X > 0.0f ? Extent.X : 1.0f, Extent.Y > 0.0f ? Extent.Y : 1.0f, Extent.Z > 0.0f ? Extent.Z : 1.0f, 0.0f);
+		outOffset = Vector4D(boxMin, 0.0f);
+	}
 };
 
 const uint32 TEXTURE_DIFFUSE_FLAG = 1 << 1;
@@ -40,6 +89,23 @@ struct Material
 class LevelData
 {
 private:
+	/* Where one static mesh is in PackedVertices/Indices */
+	struct MeshGeometry
+	{
+		std::string Key;
+
+		uint32 VertexStart;
+		uint32 VertexCount;
+
+		uint32 IndexStart;
+		uint32 IndexCount;
+	};
+
+	/* Static meshes */
+	std::vector<PackedVertex> PackedVertices;
+	std::vector<MeshGeometry> StaticMeshGeometry;
+
+	/* Debug region, starts at DynamicVertexStart */
 	std::vector<Vertex> Vertices;
 	std::vector<uint32> Indices;
 	std::vector<Matrix4D> WorldMatrices;
@@ -48,21 +114,42 @@ public:
 	uint32 DebugBoxVertexStart;
 	uint32 DebugBoxIndexStart;
 
+	/* First vertex of the debug region (frustum, debug boxes, normal lines), it lives in its own host visible buffer */
+	uint32 DynamicVertexStart;
+
 private:
 	uint32 TotalVertices;
 	uint32 TotalIndices;
 
+	/* First index of the debug region (frustum, debug boxes) in Indices */
+	uint32 DebugIndexStart;
+
 	/* Rendering Vars */
 	GW::GRAPHICS::GVulkanSurface* VlkSurface;
 
 	VkDevice* Device = nullptr;
 
-	/* Vertex/Index Buffers */
-	VkBuffer VertexBufferHandle = nullptr;
-	VkDeviceMemory VertexBufferData = nullptr;
+	/*
+	* Ranges of the static meshes in GeometryPool's arenas followed by the range of the debug indices
+	*	Meshes another level already uploaded are shared with it instead of being uploaded again
+	*/
+	std::vector<GeometryPool::Range> MeshRanges;
+
+	/* Index memory this level's meshes did not need because they went to the 16 bit arena */
+	size_t IndexBytesSaved;
 
-	VkBuffer IndexBufferHandle = nullptr;
-	VkDeviceMemory IndexBufferData = nullptr;
+	/*
+	* Debug region of the vertices, one slice per frame in flight so a frame never writes vertices the GPU may still be reading
+	*	Persistently mapped, a slice is refreshed when its frame binds it after the debug region changed
+	*/
+	VkBuffer DynamicVertexBufferHandle = nullptr;
+	GpuAllocation DynamicVertexBufferMemory;
+	void* DynamicVertexMemory = nullptr;
+	VkDeviceSize DynamicSliceSizeInBytes = 0;
+
+	/* Bumped every time the debug region changes, a slice is stale when its version is behind */
+	uint32 DynamicVersion = 1;
+	std::vector<uint32> DynamicSliceVersions;
 
 public:
 	LevelData(VkDevice* deviceHandle, GW::GRAPHICS::GVulkanSurface* vlkSurface, std::vector<RawMeshData>& rawMeshDatas)
@@ -73,6 +160,28 @@ public:
 		TotalIndices = 0;
 		TotalVertices = 0;
 		DebugBoxVertexStart = 0;
+		DynamicVertexStart = 0;
+		DebugIndexStart = 0;
+		IndexBytesSaved = 0;
+
+		/* Size everything up front so meshes are appended without reallocating, 8 verts and 24 indices per debug box, 12 normal line verts */
+		uint32 ReservePackedVertices = 0;
+		uint32 ReserveVertices = 12;
+		uint32 ReserveIndices = 0;
+		for (uint32 i = 0; i < rawMeshDatas.size(); ++i)
+		{
+			if (rawMeshDatas[i].IsCamera || rawMeshDatas[i].IsLight)
+			{
+				continue;
+			}
+
+			ReservePackedVertices += rawMeshDatas[i].VertexCount;
+			ReserveVertices += 8;
+			ReserveIndices += rawMeshDatas[i].IndexCount + 24;
+		}
+		PackedVertices.reserve(ReservePackedVertices);
+		Vertices.reserve(ReserveVertices);
+		Indices.reserve(ReserveIndices);
 
 		for (uint32 i = 0; i < rawMeshDatas.size(); ++i)
 		{
@@ -81,6 +190,15 @@ public:
 				continue;
 			}
 
+			/* Last mesh is the frustum, its vertices are updated every frame */
+			if (i == rawMeshDatas.size() - 1)
+			{
+				DynamicVertexStart = TotalVertices;
+				DebugIndexStart = TotalIndices;
+				AddDebugRawMeshData(rawMeshDatas[i]);
+				continue;
+			}
+
 			AddRawMeshData(rawMeshDatas[i]);
 		}
 
@@ -96,7 +214,7 @@ public:
 
 			/* Debug boxes */
 			{
-				RawMeshData rawMeshData = rawMeshDatas[i];
+				const RawMeshData& rawMeshData = rawMeshDatas[i];
 
 				Vector3D Min = rawMeshData.BoxMin_AABB;
 				Vector3D Max = rawMeshData.BoxMax_AABB;
@@ -155,22 +273,54 @@ public:
 
 	~LevelData()
 	{
+		GeometryPool::Get().Release(MeshRanges);
+		GpuMemory::Get().DestroyBuffer(DynamicVertexBufferHandle, DynamicVertexBufferMemory);
+	}
+
+public:
+	/* Bind Data to API */
+	void Bind()
+	{
+		uint32 CurrentBuffer = 0;
+		VlkSurface->GetSwapchainCurrentImage(CurrentBuffer);
+
+		VkCommandBuffer CommandBuffer;
+		VlkSurface->GetCommandBuffer(CurrentBuffer, (void**)&CommandBuffer);
+
+		VkDeviceSize Offsets[] = { 0 };
+
+		/* Bind the shared Vertex and Index Buffers, no level may have uploaded static vertices yet */
+		VkBuffer VertexBufferHandle = GeometryPool::Get().GetVertexBuffer();
 		if (VertexBufferHandle)
 		{
-			vkDestroyBuffer(*Device, VertexBufferHandle, nullptr);
-			vkFreeMemory(*Device, VertexBufferData, nullptr);
+			vkCmdBindVertexBuffers(CommandBuffer, 0, 1, &VertexBufferHandle, Offsets);
 		}
 
+		/* Most meshes fit in 16 bits, meshes that do not have to BindIndices() their width first */
+		BindIndices(sizeof(uint16));
+	}
+
+	/* Binds the index buffer of indexSizeInBytes wide indices, see StaticMesh::GetIndexSizeInBytes() */
+	void BindIndices(uint32 indexSizeInBytes)
+	{
+		uint32 CurrentBuffer = 0;
+		VlkSurface->GetSwapchainCurrentImage(CurrentBuffer);
+
+		VkCommandBuffer CommandBuffer;
+		VlkSurface->GetCommandBuffer(CurrentBuffer, (void**)&CommandBuffer);
+
+		VkBuffer IndexBufferHandle = GeometryPool::Get().GetIndexBuffer(indexSizeInBytes);
 		if (IndexBufferHandle)
 		{
-			vkDestroyBuffer(*Device, IndexBufferHandle, nullptr);
-			vkFreeMemory(*Device, IndexBufferData, nullptr);
+			vkCmdBindIndexBuffer(CommandBuffer, IndexBufferHandle, 0, GeometryPool::GetIndexType(indexSizeInBytes));
 		}
 	}
 
-public:
-	/* Bind Data to API */
-	void Bind()
+	/*
+	* Binds this frame's slice of the debug region instead of the static vertices and the index buffer the debug indices are in
+	*	Vertex offsets of debug draws are relative to DynamicVertexStart after this
+	*/
+	void BindDynamic()
 	{
 		uint32 CurrentBuffer = 0;
 		VlkSurface->GetSwapchainCurrentImage(CurrentBuffer);
@@ -178,11 +328,15 @@ public:
 		VkCommandBuffer CommandBuffer;
 		VlkSurface->GetCommandBuffer(CurrentBuffer, (void**)&CommandBuffer);
 
-		VkDeviceSize Offsets[] = { 0 };
+		WriteDynamicSlice(CurrentBuffer);
+
+		VkDeviceSize Offsets[] = { CurrentBuffer * DynamicSliceSizeInBytes };
+		vkCmdBindVertexBuffers(CommandBuffer, 0, 1, &DynamicVertexBufferHandle, Offsets);
 
-		/* Bind Vertex and Index Buffers */
-		vkCmdBindVertexBuffers(CommandBuffer, 0, 1, &VertexBufferHandle, Offsets);
-		vkCmdBindIndexBuffer(CommandBuffer, IndexBufferHandle, Offsets[0], VK_INDEX_TYPE_UINT32);
+		if (!MeshRanges.empty())
+		{
+			BindIndices(MeshRanges.back().IndexSizeInBytes);
+		}
 	}
 
 	void Load()
@@ -195,105 +349,187 @@ public:
 
 	}
 
+	/* One range per static mesh in the order they were added, the last range is the debug region's */
+	const std::vector<GeometryPool::Range>& GetMeshRanges() const
+	{
+		return MeshRanges;
+	}
+
+	/* Bytes of index memory saved over storing every index of this level as uint32 */
+	size_t GetIndexBytesSaved() const
+	{
+		return IndexBytesSaved;
+	}
+
 public:
-	void AddRawMeshData(RawMeshData& rawMeshData)
+	/* Packs the mesh vertices, positions are quantized against the mesh AABB */
+	void AddRawMeshData(const RawMeshData& rawMeshData)
 	{
-		/* Copy All Vertices */
+		StaticMeshGeometry.push_back({ GetGeometryKey(rawMeshData), static_cast<uint32>(PackedVertices.size()), rawMeshData.VertexCount,
+			static_cast<uint32>(Indices.size()), rawMeshData.IndexCount });
+
+		Vector4D Scale;
+		Vector4D Offset;
+		PackedVertex::GetDequantization(rawMeshData.BoxMin_AABB, rawMeshData.BoxMax_AABB, Scale, Offset);
+		Vector3D InvScale = Vector3D(1.0f / Scale.X, 1.0f / Scale.Y, 1.0f / Scale.Z);
+
+		/* Pack All Vertices, read straight from the mapped h2b file */
 		TotalVertices += rawMeshData.VertexCount;
-		Vertex V;
-		V.Color = Vector4D(0.5f, 0.5f, 0.5f, 1.0f);
+		const H2B::VERTEX* SourceVertices = rawMeshData.GetVertexData();
+		PackedVertex V = { };
 		for (uint32 i = 0; i < rawMeshData.VertexCount; ++i)
 		{
-			V.TexCoord = Vector2D(rawMeshData.Vertices[i].uvw.x, rawMeshData.Vertices[i].uvw.y);
-			V.Position = Vector3D(rawMeshData.Vertices[i].pos.x, rawMeshData.Vertices[i].pos.y, rawMeshData.Vertices[i].pos.z);
-			V.Normal = Vector3D(rawMeshData.Vertices[i].nrm.x, rawMeshData.Vertices[i].nrm.y, rawMeshData.Vertices[i].nrm.z);
-			Vertices.push_back(V);
-		}
+			V.Position[0] = Quantize::FloatToUnorm16((SourceVertices[i].pos.x - Offset.X) * InvScale.X);
+			V.Position[1] = Quantize::FloatToUnorm16((SourceVertices[i].pos.y - Offset.Y) * InvScale.Y);
+			V.Position[2] = Quantize::FloatToUnorm16((SourceVertices[i].pos.z - Offset.Z) * InvScale.Z);
 
-		/* Copy All Indices */
-		TotalIndices += rawMeshData.IndexCount;
-		for (uint32 i = 0; i < rawMeshData.IndexCount; ++i)
-		{
-			Indices.push_back(rawMeshData.Indices[i]);
+			Quantize::OctEncode(Vector3D(SourceVertices[i].nrm.x, SourceVertices[i].nrm.y, SourceVertices[i].nrm.z), V.Normal);
+
+			V.TexCoord[0] = Quantize::FloatToHalf(SourceVertices[i].uvw.x);
+			V.TexCoord[1] = Quantize::FloatToHalf(SourceVertices[i].uvw.y);
+			PackedVertices.push_back(V);
 		}
 
-		/* Copy All WorldMatrices */
-		for (uint32 i = 0; i < rawMeshData.WorldMatrices.size(); ++i)
+		AddIndicesAndMatrices(rawMeshData);
+	}
+
+	/* Full precision copy for the debug meshes that get rewritten on the CPU */
+	void AddDebugRawMeshData(const RawMeshData& rawMeshData)
+	{
+		TotalVertices += rawMeshData.VertexCount;
+		const H2B::VERTEX* SourceVertices = rawMeshData.GetVertexData();
+		Vertex V;
+		V.Color = Vector4D(0.5f, 0.5f, 0.5f, 1.0f);
+		for (uint32 i = 0; i < rawMeshData.VertexCount; ++i)
 		{
-			WorldMatrices.push_back(rawMeshData.WorldMatrices[i]);
+			V.TexCoord = Vector2D(SourceVertices[i].uvw.x, SourceVertices[i].uvw.y);
+			V.Position = Vector3D(SourceVertices[i].pos.x, SourceVertices[i].pos.y, SourceVertices[i].pos.z);
+			V.Normal = Vector3D(SourceVertices[i].nrm.x, SourceVertices[i].nrm.y, SourceVertices[i].nrm.z);
+			Vertices.push_back(V);
 		}
+
+		AddIndicesAndMatrices(rawMeshData);
 	}
 
+	/* Debug region only, vertex indices are relative to DynamicVertexStart */
 	std::vector<Vertex>* GetVertices()
 	{
 		return &Vertices;
 	}
 
+	/*
+	* Call after changing the debug region, only the current frame's slice is written here,
+	*	the other frames pick the change up when they bind it. The static vertices never change after Load()
+	*/
 	void UpdateVertexBuffer()
 	{
-		uint32 VerticesSizeInBytes = sizeof(Vertex) * Vertices.size();
-		GvkHelper::write_to_buffer(*Device, VertexBufferData, Vertices.data(), VerticesSizeInBytes);
+		DynamicVersion++;
+
+		uint32 CurrentBuffer = 0;
+		VlkSurface->GetSwapchainCurrentImage(CurrentBuffer);
+		WriteDynamicSlice(CurrentBuffer);
 	}
 
 private:
-	void LoadVertexData()
+	/*
+	* Same file as MeshCache sees it (path, last write time and size) -> same packed geometry
+	*	A re-exported h2b gets a new key, so its new geometry and dequantization are never drawn from the old range
+	*	Geometry not read from a file has no key and is never shared
+	*/
+	static std::string GetGeometryKey(const RawMeshData& rawMeshData)
 	{
-		GW::GReturn Result;
-		VkPhysicalDevice PhysicalDevice = nullptr;
-		if ((Result = VlkSurface->GetPhysicalDevice((void**)&PhysicalDevice)) != GW::GReturn::SUCCESS)
-		{
-			std::cout << "\n[Gateware] Failed to get PhysicalDevice....";
-			return;
-		}
+		return rawMeshData.SourceKey;
+	}
 
-		uint32 VerticesSizeInBytes = sizeof(Vertex) * Vertices.size();
+	void AddIndicesAndMatrices(const RawMeshData& rawMeshData)
+	{
+		/* Copy All Indices */
+		TotalIndices += rawMeshData.IndexCount;
+		const uint32* SourceIndices = rawMeshData.GetIndexData();
+		Indices.insert(Indices.end(), SourceIndices, SourceIndices + rawMeshData.IndexCount);
 
-		GvkHelper::create_buffer(PhysicalDevice, *Device, VerticesSizeInBytes,
-			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-			VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &VertexBufferHandle, &VertexBufferData);
-		GvkHelper::write_to_buffer(*Device, VertexBufferData, Vertices.data(), VerticesSizeInBytes);
+		/* Copy All WorldMatrices */
+		WorldMatrices.insert(WorldMatrices.end(), rawMeshData.WorldMatrices.begin(), rawMeshData.WorldMatrices.end());
 	}
 
-	void LoadIndexData()
+	/* Copies the debug region into a frame's slice if it is stale, the frame's fence was waited on by StartFrame() */
+	void WriteDynamicSlice(uint32 frameIndex)
 	{
-		GW::GReturn Result;
-		VkPhysicalDevice PhysicalDevice = nullptr;
-		if ((Result = VlkSurface->GetPhysicalDevice((void**)&PhysicalDevice)) != GW::GReturn::SUCCESS)
+		if (DynamicVertexMemory == nullptr || frameIndex >= DynamicSliceVersions.size() || DynamicSliceVersions[frameIndex] == DynamicVersion)
 		{
-			std::cout << "\n[Gateware] Failed to get PhysicalDevice....";
 			return;
 		}
 
-		uint32 IndicesSizeInBytes = Indices.size() * sizeof(uint32);
-
-		GvkHelper::create_buffer(PhysicalDevice, *Device, IndicesSizeInBytes,
-			VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-			VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &IndexBufferHandle, &IndexBufferData);
-		GvkHelper::write_to_buffer(*Device, IndexBufferData, Indices.data(), IndicesSizeInBytes);
+		memcpy(static_cast<char*>(DynamicVertexMemory) + frameIndex * DynamicSliceSizeInBytes, Vertices.data(), sizeof(Vertex) * Vertices.size());
+		DynamicSliceVersions[frameIndex] = DynamicVersion;
 	}
 
+	/*
+	* Static vertices and all indices go to GeometryPool's device local arenas, only meshes that are not resident yet are uploaded,
+	*	the debug region is small and rewritten every frame so it stays host visible, ring buffered per frame
+	*/
 	void LoadVertexAndIndexData()
 	{
-		GW::GReturn Result;
-		VkPhysicalDevice PhysicalDevice = nullptr;
-		if ((Result = VlkSurface->GetPhysicalDevice((void**)&PhysicalDevice)) != GW::GReturn::SUCCESS)
+		uint32 StaticVerticesSizeInBytes = sizeof(PackedVertex) * PackedVertices.size();
+		uint32 DynamicVerticesSizeInBytes = sizeof(Vertex) * Vertices.size();
+
+#if DEBUG
+		size_t UnpackedSizeInBytes = sizeof(Vertex) * PackedVertices.size();
+		std::cout << "[LevelData]: " << PackedVertices.size() << " static vertices, " << StaticVerticesSizeInBytes << " bytes packed vs "
+			<< UnpackedSizeInBytes << " bytes unpacked (" << (StaticVerticesSizeInBytes > 0 ? static_cast<float>(UnpackedSizeInBytes) / StaticVerticesSizeInBytes : 0.0f)
+			<< "x smaller), " << DynamicVerticesSizeInBytes << " bytes of debug vertices\n";
+#endif // DEBUG
+
+		std::vector<GeometryPool::MeshData> Meshes;
+		Meshes.reserve(StaticMeshGeometry.size() + 1);
+		for (uint32 i = 0; i < StaticMeshGeometry.size(); ++i)
 		{
-			std::cout << "\n[Gateware] Failed to get PhysicalDevice....";
-			return;
+			const MeshGeometry& Geometry = StaticMeshGeometry[i];
+			Meshes.push_back({ Geometry.Key, PackedVertices.data() + Geometry.VertexStart, Geometry.VertexCount,
+				Indices.data() + Geometry.IndexStart, Geometry.IndexCount });
 		}
 
-		uint32 IndicesSizeInBytes = Indices.size() * sizeof(uint32);
-		uint32 VerticesSizeInBytes = sizeof(Vertex) * Vertices.size();
+		/* Debug indices belong to this level only, no key so they are never shared */
+		Meshes.push_back({ std::string(), nullptr, 0, Indices.data() + DebugIndexStart, TotalIndices - DebugIndexStart });
 
-		GvkHelper::create_buffer(PhysicalDevice, *Device, VerticesSizeInBytes,
-			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-			VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &VertexBufferHandle, &VertexBufferData);
-		GvkHelper::write_to_buffer(*Device, VertexBufferData, Vertices.data(), VerticesSizeInBytes);
+		if (!GeometryPool::Get().Acquire(Meshes, MeshRanges))
+		{
+			std::cout << "\n[LevelData]: Out of geometry memory, meshes that did not fit will not be drawn";
+		}
+
+		/* Debug draws index from DebugBoxIndexStart, it now has to point into the arena */
+		DebugBoxIndexStart = MeshRanges.back().IndexOffset + (DebugBoxIndexStart - DebugIndexStart);
+
+		IndexBytesSaved = 0;
+		uint32 ShortMeshCount = 0;
+		for (uint32 i = 0; i < MeshRanges.size(); ++i)
+		{
+			if (MeshRanges[i].IndexSizeInBytes == sizeof(uint16))
+			{
+				IndexBytesSaved += static_cast<size_t>(MeshRanges[i].IndexCount) * (sizeof(uint32) - sizeof(uint16));
+				ShortMeshCount++;
+			}
+		}
+
+#if DEBUG
+		size_t FullIndexSizeInBytes = sizeof(uint32) * static_cast<size_t>(TotalIndices);
+		std::cout << "[LevelData]: " << ShortMeshCount << " of " << MeshRanges.size() << " index ranges use 16 bit indices, "
+			<< FullIndexSizeInBytes - IndexBytesSaved << " bytes of indices vs " << FullIndexSizeInBytes << " bytes as uint32 ("
+			<< IndexBytesSaved << " bytes saved)\n";
+#endif // DEBUG
 
-		GvkHelper::create_buffer(PhysicalDevice, *Device, IndicesSizeInBytes,
-			VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-			VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &IndexBufferHandle, &IndexBufferData);
-		GvkHelper::write_to_buffer(*Device, IndexBufferData, Indices.data(), IndicesSizeInBytes);
+		/* One slice of the debug region per frame in flight, every slice starts stale */
+		uint32 FrameCount = 1;
+		VlkSurface->GetSwapchainImageCount(FrameCount);
+		FrameCount = FrameCount > 0 ? FrameCount : 1;
+
+		DynamicSliceSizeInBytes = DynamicVerticesSizeInBytes;
+		DynamicSliceVersions.assign(FrameCount, 0);
+
+		GpuMemory::Get().CreateBuffer(DynamicSliceSizeInBytes * FrameCount,
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+			VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &DynamicVertexBufferHandle, &DynamicVertexBufferMemory);
+		DynamicVertexMemory = DynamicVertexBufferMemory.Mapped;
 	}
 
 };
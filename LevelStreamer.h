@@ -0,0 +1,147 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Level.h"
+
+/*
+* Loads the next level on a worker thread while the current one keeps rendering
+*	The worker reads the level file, parses the h2b meshes and reads the textures (Level::PrepareLoad()),
+*	everything that touches the device or the graphics queue is left to Finish() which the renderer calls at a frame boundary
+*/
+class LevelStreamer
+{
+public:
+	/* Lets the owner add its own meshes (debug geometry...) before the level is built, called on the worker thread */
+	typedef void (*AppendRawDataFunc)(std::vector<RawMeshData>& rawData);
+
+private:
+	std::thread Worker;
+
+	Level* PendingLevel;
+	std::vector<StaticMesh> PendingStaticMeshes;
+
+	/* Set by the worker once PendingLevel is prepared */
+	std::atomic<bool> IsWorkerDone;
+
+	bool IsStreaming;
+
+public:
+	LevelStreamer()
+	{
+		PendingLevel = nullptr;
+		IsWorkerDone = false;
+		IsStreaming = false;
+	}
+
+	LevelStreamer(const LevelStreamer& other) = delete;
+	LevelStreamer& operator=(const LevelStreamer& other) = delete;
+
+	~LevelStreamer()
+	{
+		Cancel();
+	}
+
+public:
+	/*
+	* Starts loading nextLevel in the background, the streamer owns it until Finish() hands it back
+	*	@returns false if a level is already streaming, nextLevel is not taken in that case
+	*/
+	bool Begin(Level* nextLevel, AppendRawDataFunc appendRawData)
+	{
+		if (IsStreaming)
+		{
+			return false;
+		}
+
+		PendingLevel = nextLevel;
+		PendingStaticMeshes.clear();
+		IsWorkerDone = false;
+		IsStreaming = true;
+
+		Worker = std::thread([this, appendRawData]()
+			{
+				std::vector<RawMeshData> RawData;
+				PendingLevel->ReadRawData(RawData);
+
+				if (appendRawData != nullptr)
+				{
+					appendRawData(RawData);
+				}
+
+				PendingStaticMeshes = PendingLevel->PrepareLoad(RawData);
+
+				IsWorkerDone.store(true, std::memory_order_release);
+			});
+
+#if DEBUG
+		std::cout << "\n[LevelStreamer]: streaming " << PendingLevel->GetName() << "...\n";
+#endif // DEBUG
+
+		return true;
+	}
+
+	/*
+	* Creates the GPU resources of the streamed level on the calling (render) thread
+	*	Only call once IsReadyToSwap() returns true, the caller owns the returned level
+	*/
+	Level* Finish(std::vector<StaticMesh>& outStaticMeshes)
+	{
+		if (!IsReadyToSwap())
+		{
+			return nullptr;
+		}
+
+		Worker.join();
+
+		Level* NewLevel = PendingLevel;
+		NewLevel->FinishLoad(PendingStaticMeshes);
+
+		outStaticMeshes = std::move(PendingStaticMeshes);
+		PendingStaticMeshes.clear();
+
+		PendingLevel = nullptr;
+		IsStreaming = false;
+
+		return NewLevel;
+	}
+
+	/* Waits for the worker and throws the streamed level away */
+	void Cancel()
+	{
+		if (Worker.joinable())
+		{
+			Worker.join();
+		}
+
+		delete PendingLevel;
+		PendingLevel = nullptr;
+		PendingStaticMeshes.clear();
+
+		IsStreaming = false;
+	}
+
+	/* A level is being streamed or is waiting to be swapped in */
+	bool IsBusy() const
+	{
+		return IsStreaming;
+	}
+
+	bool IsReadyToSwap() const
+	{
+		return IsStreaming && IsWorkerDone.load(std::memory_order_acquire);
+	}
+
+	/* 0 -> 1 progress of the level being streamed */
+	float GetProgress() const
+	{
+		return IsStreaming ? PendingLevel->GetLoadProgress() : 0.0f;
+	}
+
+	const std::string& GetLevelName() const
+	{
+		static const std::string None;
+		return IsStreaming ? PendingLevel->GetName() : None;
+	}
+};
@@ -0,0 +1,123 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+	FileHandle = nullptr;
+	MappingHandle = nullptr;
+	FileData = nullptr;
+	FileSize = 0;
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const char* filePath)
+{
+	Close();
+
+#ifdef _WIN32
+	/* Exporters may replace or delete the file while it is mapped */
+	HANDLE File = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (File == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	FileHandle = File;
+
+	LARGE_INTEGER Size;
+	if (!GetFileSizeEx(File, &Size) || Size.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+
+	HANDLE Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (Mapping == nullptr)
+	{
+		Close();
+		return false;
+	}
+	MappingHandle = Mapping;
+
+	FileData = static_cast<const char*>(MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0));
+	if (FileData == nullptr)
+	{
+		Close();
+		return false;
+	}
+	FileSize = static_cast<size_t>(Size.QuadPart);
+
+	/* The mapping keeps its own reference to the file */
+	CloseHandle(File);
+	FileHandle = nullptr;
+#else
+	int Descriptor = open(filePath, O_RDONLY);
+	if (Descriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat FileStat;
+	if (fstat(Descriptor, &FileStat) != 0 || FileStat.st_size == 0)
+	{
+		close(Descriptor);
+		return false;
+	}
+
+	void* View = mmap(nullptr, static_cast<size_t>(FileStat.st_size), PROT_READ, MAP_PRIVATE, Descriptor, 0);
+
+	/* The mapping keeps its own reference to the file */
+	close(Descriptor);
+
+	if (View == MAP_FAILED)
+	{
+		return false;
+	}
+	madvise(View, static_cast<size_t>(FileStat.st_size), MADV_SEQUENTIAL);
+
+	FileData = static_cast<const char*>(View);
+	FileSize = static_cast<size_t>(FileStat.st_size);
+#endif
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (FileData != nullptr)
+	{
+		UnmapViewOfFile(FileData);
+	}
+	if (MappingHandle != nullptr)
+	{
+		CloseHandle(static_cast<HANDLE>(MappingHandle));
+	}
+	if (FileHandle != nullptr)
+	{
+		CloseHandle(static_cast<HANDLE>(FileHandle));
+	}
+#else
+	if (FileData != nullptr)
+	{
+		munmap(const_cast<char*>(FileData), FileSize);
+	}
+#endif
+
+	FileHandle = nullptr;
+	MappingHandle = nullptr;
+	FileData = nullptr;
+	FileSize = 0;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+
+#include "GenericDefines.h"
+
+/*
+* Read-only memory mapped view of a file on disk
+*	The whole file is mapped on Open() and stays mapped until Close() or destruction,
+*	Data() points directly at the OS page cache so no copies are made while reading
+*/
+class MappedFile
+{
+private:
+	/* Win32: mapping handle (the file handle is closed once mapped), Posix: only the view is kept after mapping */
+	void* FileHandle;
+	void* MappingHandle;
+
+	const char* FileData;
+	size_t FileSize;
+
+public:
+	MappedFile();
+
+	MappedFile(const MappedFile& other) = delete;
+	MappedFile& operator=(const MappedFile& other) = delete;
+
+	~MappedFile();
+
+public:
+	/* @returns false if the file could not be opened or mapped (empty files cannot be mapped) */
+	bool Open(const char* filePath);
+
+	void Close();
+
+public:
+	inline bool IsOpen() const
+	{
+		return FileData != nullptr;
+	}
+
+	inline const char* Data() const
+	{
+		return FileData;
+	}
+
+	inline size_t Size() const
+	{
+		return FileSize;
+	}
+};
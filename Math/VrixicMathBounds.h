@@ -0,0 +1,323 @@
+#pragma once
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#include "Vector3D.h"
+#include "Matrix4D.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VRIXIC_BOUNDS_AVX2 1
+#define VRIXIC_BOUNDS_SSE 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VRIXIC_BOUNDS_SSE 1
+#endif
+
+/* Axis aligned box and a bounding sphere around the box center */
+struct BoundingVolume
+{
+	Vector3D Min;
+	Vector3D Max;
+
+	Vector3D SphereCenter;
+	float SphereRadius;
+};
+
+/* Axis aligned boxes as center / extents streams, box i is Center[i] +- Extents[i] on each axis */
+struct BoxStreams
+{
+	std::vector<float> CenterX;
+	std::vector<float> CenterY;
+	std::vector<float> CenterZ;
+
+	std::vector<float> ExtentX;
+	std::vector<float> ExtentY;
+	std::vector<float> ExtentZ;
+
+	void Resize(size_t count)
+	{
+		CenterX.resize(count);
+		CenterY.resize(count);
+		CenterZ.resize(count);
+		ExtentX.resize(count);
+		ExtentY.resize(count);
+		ExtentZ.resize(count);
+	}
+
+	size_t Size() const
+	{
+		return CenterX.size();
+	}
+};
+
+struct Bounds
+{
+public:
+	/*
+	* Computes the AABB and bounding sphere of count positions in two passes, vectorized with AVX2/SSE when available
+	*	positions -> first position's X, positions are strideInBytes apart
+	*	16 bytes must be readable at every position (the 4th float is ignored), true for any vertex with data after its position
+	*	Sphere is centered on the AABB and tight around the points, an empty set gives a zero box and sphere
+	*/
+	inline static void Compute(const float* positions, unsigned int count, unsigned int strideInBytes, BoundingVolume& outVolume)
+	{
+#if VRIXIC_BOUNDS_SSE
+		ComputeSIMD(positions, count, strideInBytes, outVolume);
+#else
+		ComputeScalar(positions, count, strideInBytes, outVolume);
+#endif
+	}
+
+	/* Reference implementation, only reads the 3 position floats */
+	inline static void ComputeScalar(const float* positions, unsigned int count, unsigned int strideInBytes, BoundingVolume& outVolume)
+	{
+		if (count == 0)
+		{
+			outVolume = { Vector3D(0.0f), Vector3D(0.0f), Vector3D(0.0f), 0.0f };
+			return;
+		}
+
+		Vector3D Min(FLT_MAX);
+		Vector3D Max(-FLT_MAX);
+
+		const char* Position = reinterpret_cast<const char*>(positions);
+		for (unsigned int i = 0; i < count; ++i, Position += strideInBytes)
+		{
+			const float* P = reinterpret_cast<const float*>(Position);
+
+			Min.X = P[0] < Min.X ? P[0] : Min.X;
+			Min.Y = P[1] < Min.Y ? P[1] : Min.Y;
+			Min.Z = P[2] < Min.Z ? P[2] : Min.Z;
+
+			Max.X = P[0] > Max.X ? P[0] : Max.X;
+			Max.Y = P[1] > Max.Y ? P[1] : Max.Y;
+			Max.Z = P[2] > Max.Z ? P[2] : Max.Z;
+		}
+
+		Vector3D Center = (Min + Max) * 0.5f;
+
+		float MaxDistanceSq = 0.0f;
+		Position = reinterpret_cast<const char*>(positions);
+		for (unsigned int i = 0; i < count; ++i, Position += strideInBytes)
+		{
+			const float* P = reinterpret_cast<const float*>(Position);
+
+			float DX = P[0] - Center.X;
+			float DY = P[1] - Center.Y;
+			float DZ = P[2] - Center.Z;
+			float DistanceSq = DX * DX + DY * DY + DZ * DZ;
+
+			MaxDistanceSq = DistanceSq > MaxDistanceSq ? DistanceSq : MaxDistanceSq;
+		}
+
+		outVolume.Min = Min;
+		outVolume.Max = Max;
+		outVolume.SphereCenter = Center;
+		outVolume.SphereRadius = std::sqrt(MaxDistanceSq);
+	}
+
+	/*
+	* World AABB of a center / extents box under a row vector world matrix (Arvo)
+	*	The extents go through the absolute value of the 3x3 part, transforming min and max as points does not bound the box
+	*	once the matrix rotates it
+	*/
+	inline static void TransformAABB(const Vector3D& center, const Vector3D& extents, const Matrix4D& world, Vector3D& outCenter, Vector3D& outExtents)
+	{
+		float Center[3];
+		float Extents[3];
+		for (unsigned int j = 0; j < 3; ++j)
+		{
+			Center[j] = center.X * world(0, j) + center.Y * world(1, j) + center.Z * world(2, j) + world(3, j);
+			Extents[j] = extents.X * std::fabs(world(0, j)) + extents.Y * std::fabs(world(1, j)) + extents.Z * std::fabs(world(2, j));
+		}
+
+		outCenter = Vector3D(Center[0], Center[1], Center[2]);
+		outExtents = Vector3D(Extents[0], Extents[1], Extents[2]);
+	}
+
+	/*
+	* TransformAABB() of one box under count matrices, into boxes firstBox to firstBox + count of outBoxes
+	*	Four boxes per iteration with SSE, outBoxes has to be big enough
+	*/
+	inline static void TransformAABBs(const Vector3D& center, const Vector3D& extents, const Matrix4D* worlds, unsigned int count,
+		BoxStreams& outBoxes, size_t firstBox)
+	{
+#if VRIXIC_BOUNDS_SSE
+		TransformAABBsSIMD(center, extents, worlds, count, outBoxes, firstBox);
+#else
+		TransformAABBsScalar(center, extents, worlds, count, outBoxes, firstBox);
+#endif
+	}
+
+	/* Reference implementation of TransformAABBs() */
+	inline static void TransformAABBsScalar(const Vector3D& center, const Vector3D& extents, const Matrix4D* worlds, unsigned int count,
+		BoxStreams& outBoxes, size_t firstBox)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			StoreBox(center, extents, worlds[i], outBoxes, firstBox + i);
+		}
+	}
+
+#if VRIXIC_BOUNDS_SSE
+	/*
+	* One box per lane, the rows of four matrices are transposed so each register holds one matrix element of all four
+	*	The remaining count % 4 boxes go through TransformAABB()
+	*/
+	inline static void TransformAABBsSIMD(const Vector3D& center, const Vector3D& extents, const Matrix4D* worlds, unsigned int count,
+		BoxStreams& outBoxes, size_t firstBox)
+	{
+		const __m128 CX = _mm_set1_ps(center.X);
+		const __m128 CY = _mm_set1_ps(center.Y);
+		const __m128 CZ = _mm_set1_ps(center.Z);
+		const __m128 EX = _mm_set1_ps(extents.X);
+		const __m128 EY = _mm_set1_ps(extents.Y);
+		const __m128 EZ = _mm_set1_ps(extents.Z);
+		const __m128 SignMask = _mm_set1_ps(-0.0f);
+
+		unsigned int i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			/* Row[r][j] -> element (r, j) of the four matrices */
+			__m128 Row[4][4];
+			for (unsigned int r = 0; r < 4; ++r)
+			{
+				Row[r][0] = _mm_load_ps(&worlds[i](r, 0));
+				Row[r][1] = _mm_load_ps(&worlds[i + 1](r, 0));
+				Row[r][2] = _mm_load_ps(&worlds[i + 2](r, 0));
+				Row[r][3] = _mm_load_ps(&worlds[i + 3](r, 0));
+				_MM_TRANSPOSE4_PS(Row[r][0], Row[r][1], Row[r][2], Row[r][3]);
+			}
+
+			float* Centers[3] = { &outBoxes.CenterX[firstBox + i], &outBoxes.CenterY[firstBox + i], &outBoxes.CenterZ[firstBox + i] };
+			float* Extents[3] = { &outBoxes.ExtentX[firstBox + i], &outBoxes.ExtentY[firstBox + i], &outBoxes.ExtentZ[firstBox + i] };
+			for (unsigned int j = 0; j < 3; ++j)
+			{
+				__m128 Center = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(CX, Row[0][j]), _mm_mul_ps(CY, Row[1][j])), _mm_mul_ps(CZ, Row[2][j])), Row[3][j]);
+				__m128 Extent = _mm_add_ps(_mm_add_ps(_mm_mul_ps(EX, _mm_andnot_ps(SignMask, Row[0][j])), _mm_mul_ps(EY, _mm_andnot_ps(SignMask, Row[1][j]))),
+					_mm_mul_ps(EZ, _mm_andnot_ps(SignMask, Row[2][j])));
+
+				_mm_storeu_ps(Centers[j], Center);
+				_mm_storeu_ps(Extents[j], Extent);
+			}
+		}
+
+		for (; i < count; ++i)
+		{
+			StoreBox(center, extents, worlds[i], outBoxes, firstBox + i);
+		}
+	}
+
+	/*
+	* Two passes over the positions, the first finds min/max and the second the radius around the box center they give
+	*	One position per 128 bit lane, min/max have no branches
+	*	AVX2 handles two positions per iteration in the two halves of a 256 bit register
+	*/
+	inline static void ComputeSIMD(const float* positions, unsigned int count, unsigned int strideInBytes, BoundingVolume& outVolume)
+	{
+		if (count == 0)
+		{
+			outVolume = { Vector3D(0.0f), Vector3D(0.0f), Vector3D(0.0f), 0.0f };
+			return;
+		}
+
+		const char* Base = reinterpret_cast<const char*>(positions);
+		unsigned int i = 0;
+
+		__m128 Min = _mm_set1_ps(FLT_MAX);
+		__m128 Max = _mm_set1_ps(-FLT_MAX);
+
+#if VRIXIC_BOUNDS_AVX2
+		__m256 Min2 = _mm256_set1_ps(FLT_MAX);
+		__m256 Max2 = _mm256_set1_ps(-FLT_MAX);
+		for (; i + 2 <= count; i += 2)
+		{
+			__m256 P = Load2(Base, i, strideInBytes);
+			Min2 = _mm256_min_ps(Min2, P);
+			Max2 = _mm256_max_ps(Max2, P);
+		}
+		Min = _mm_min_ps(_mm256_castps256_ps128(Min2), _mm256_extractf128_ps(Min2, 1));
+		Max = _mm_max_ps(_mm256_castps256_ps128(Max2), _mm256_extractf128_ps(Max2, 1));
+#endif
+		for (; i < count; ++i)
+		{
+			__m128 P = _mm_loadu_ps(reinterpret_cast<const float*>(Base + static_cast<size_t>(i) * strideInBytes));
+			Min = _mm_min_ps(Min, P);
+			Max = _mm_max_ps(Max, P);
+		}
+
+		__m128 Center = _mm_mul_ps(_mm_add_ps(Min, Max), _mm_set1_ps(0.5f));
+
+		/* Only x, y, z take part in the distance */
+		const __m128 XYZMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+		__m128 MaxDistanceSq = _mm_setzero_ps();
+		i = 0;
+
+#if VRIXIC_BOUNDS_AVX2
+		__m256 Center2 = _mm256_set_m128(Center, Center);
+		__m256 XYZMask2 = _mm256_set_m128(XYZMask, XYZMask);
+		__m256 MaxDistanceSq2 = _mm256_setzero_ps();
+		for (; i + 2 <= count; i += 2)
+		{
+			__m256 D = _mm256_and_ps(_mm256_sub_ps(Load2(Base, i, strideInBytes), Center2), XYZMask2);
+			D = _mm256_mul_ps(D, D);
+
+			/* Sum the lanes of each half, every lane of a half ends up with that position's squared distance */
+			D = _mm256_add_ps(D, _mm256_permute_ps(D, _MM_SHUFFLE(2, 3, 0, 1)));
+			D = _mm256_add_ps(D, _mm256_permute_ps(D, _MM_SHUFFLE(1, 0, 3, 2)));
+			MaxDistanceSq2 = _mm256_max_ps(MaxDistanceSq2, D);
+		}
+		MaxDistanceSq = _mm_max_ps(_mm256_castps256_ps128(MaxDistanceSq2), _mm256_extractf128_ps(MaxDistanceSq2, 1));
+#endif
+		for (; i < count; ++i)
+		{
+			__m128 P = _mm_loadu_ps(reinterpret_cast<const float*>(Base + static_cast<size_t>(i) * strideInBytes));
+			__m128 D = _mm_and_ps(_mm_sub_ps(P, Center), XYZMask);
+			D = _mm_mul_ps(D, D);
+
+			D = _mm_add_ps(D, _mm_shuffle_ps(D, D, _MM_SHUFFLE(2, 3, 0, 1)));
+			D = _mm_add_ps(D, _mm_shuffle_ps(D, D, _MM_SHUFFLE(1, 0, 3, 2)));
+			MaxDistanceSq = _mm_max_ps(MaxDistanceSq, D);
+		}
+
+		alignas(16) float MinOut[4];
+		alignas(16) float MaxOut[4];
+		alignas(16) float CenterOut[4];
+		_mm_store_ps(MinOut, Min);
+		_mm_store_ps(MaxOut, Max);
+		_mm_store_ps(CenterOut, Center);
+
+		outVolume.Min = Vector3D(MinOut[0], MinOut[1], MinOut[2]);
+		outVolume.Max = Vector3D(MaxOut[0], MaxOut[1], MaxOut[2]);
+		outVolume.SphereCenter = Vector3D(CenterOut[0], CenterOut[1], CenterOut[2]);
+		outVolume.SphereRadius = std::sqrt(_mm_cvtss_f32(MaxDistanceSq));
+	}
+
+private:
+#if VRIXIC_BOUNDS_AVX2
+	/* Positions i and i + 1 in the low and high half */
+	inline static __m256 Load2(const char* base, unsigned int i, unsigned int strideInBytes)
+	{
+		const float* P0 = reinterpret_cast<const float*>(base + static_cast<size_t>(i) * strideInBytes);
+		const float* P1 = reinterpret_cast<const float*>(base + static_cast<size_t>(i + 1) * strideInBytes);
+		return _mm256_set_m128(_mm_loadu_ps(P1), _mm_loadu_ps(P0));
+	}
+#endif
+#endif
+
+	inline static void StoreBox(const Vector3D& center, const Vector3D& extents, const Matrix4D& world, BoxStreams& outBoxes, size_t box)
+	{
+		Vector3D WorldCenter;
+		Vector3D WorldExtents;
+		TransformAABB(center, extents, world, WorldCenter, WorldExtents);
+
+		outBoxes.CenterX[box] = WorldCenter.X;
+		outBoxes.CenterY[box] = WorldCenter.Y;
+		outBoxes.CenterZ[box] = WorldCenter.Z;
+		outBoxes.ExtentX[box] = WorldExtents.X;
+		outBoxes.ExtentY[box] = WorldExtents.Y;
+		outBoxes.ExtentZ[box] = WorldExtents.Z;
+	}
+};
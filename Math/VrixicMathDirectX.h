@@ -1,7 +1,9 @@
 #pragma once
-#include <DirectXMath.h>
 #include "Matrix4D.h"
 
+#if defined(_WIN32)
+#include <DirectXMath.h>
+
 /* A float4 vector where the X component of the vector is stored in the lowest 32 bits */
 typedef DirectX::XMVECTOR VectorRegister;
 
@@ -42,4 +44,72 @@ inline VectorRegister TransformVectorByMatrix(const VectorRegister& V1, const Ma
 {
 	DirectX::XMMATRIX matrix = DirectX::XMLoadFloat4x4A((const DirectX::XMFLOAT4X4A*)(Transform));
 	return DirectX::XMVector4Transform(V1, matrix);
-}
\ No newline at end of file
+}
+
+#else
+
+/* DirectXMath only ships with the Windows SDK, elsewhere the same operations are done on plain floats */
+struct alignas(16) VectorRegister
+{
+	float V[4];
+};
+
+/* returns and makes a vector with 4 floats */
+inline VectorRegister MakeVectorRegister(float x, float y, float z, float w)
+{
+	return { { x, y, z, w } };
+}
+
+/* returns and makes a vector with 4 floats */
+inline VectorRegister MakeVectorRegister(Vector4D v)
+{
+	return { { v.X, v.Y, v.Z, v.W } };
+}
+
+/* stores a vector register into a Vector4D */
+inline void StoreVectorRegister(Vector4D* v, VectorRegister& vectorRegister)
+{
+	v->X = vectorRegister.V[0];
+	v->Y = vectorRegister.V[1];
+	v->Z = vectorRegister.V[2];
+	v->W = vectorRegister.V[3];
+}
+
+/* Multiplies two matrices and result is returned via Param1, Result may be M1 or M2 */
+inline void VectorRegisterMatrixMultiply(Matrix4D* Result, const Matrix4D* M1, const Matrix4D* M2)
+{
+	/* Matrix4D is only declared here, its rows are its first and only member */
+	const float* A = reinterpret_cast<const float*>(M1);
+	const float* B = reinterpret_cast<const float*>(M2);
+
+	float Product[16];
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			Product[i * 4 + j] = A[i * 4] * B[j] + A[i * 4 + 1] * B[4 + j] + A[i * 4 + 2] * B[8 + j] + A[i * 4 + 3] * B[12 + j];
+		}
+	}
+
+	float* Out = reinterpret_cast<float*>(Result);
+	for (int i = 0; i < 16; ++i)
+	{
+		Out[i] = Product[i];
+	}
+}
+
+/* A Homogenous transform, V1 is a row vector */
+inline VectorRegister TransformVectorByMatrix(const VectorRegister& V1, const Matrix4D* Transform)
+{
+	const float* M = reinterpret_cast<const float*>(Transform);
+
+	VectorRegister Result;
+	for (int j = 0; j < 4; ++j)
+	{
+		Result.V[j] = V1.V[0] * M[j] + V1.V[1] * M[4 + j] + V1.V[2] * M[8 + j] + V1.V[3] * M[12 + j];
+	}
+
+	return Result;
+}
+
+#endif // _WIN32
\ No newline at end of file
@@ -0,0 +1,165 @@
+#pragma once
+#include <cmath>
+#include <cstring>
+
+#include "Vector3D.h"
+
+/*
+* Conversions used to pack vertex attributes into 16 bit formats
+*	Every Encode has a matching Decode that gives back what the GPU reads from the packed value
+*/
+struct Quantize
+{
+public:
+	/* IEEE half float, round to nearest even, overflow goes to infinity, NaN stays NaN */
+	inline static unsigned short FloatToHalf(float value)
+	{
+		unsigned int Bits;
+		std::memcpy(&Bits, &value, sizeof(Bits));
+
+		unsigned int Sign = (Bits >> 16) & 0x8000u;
+		unsigned int Exponent = (Bits >> 23) & 0xFFu;
+		unsigned int Mantissa = Bits & 0x7FFFFFu;
+
+		if (Exponent == 0xFFu)
+		{
+			return static_cast<unsigned short>(Sign | 0x7C00u | (Mantissa != 0 ? 0x200u : 0u));
+		}
+
+		int HalfExponent = static_cast<int>(Exponent) - 127 + 15;
+		if (HalfExponent >= 31)
+		{
+			return static_cast<unsigned short>(Sign | 0x7C00u);
+		}
+
+		if (HalfExponent <= 0)
+		{
+			/* Denormal or zero */
+			if (HalfExponent < -10)
+			{
+				return static_cast<unsigned short>(Sign);
+			}
+
+			Mantissa |= 0x800000u;
+			unsigned int Shift = static_cast<unsigned int>(14 - HalfExponent);
+			unsigned int HalfMantissa = Mantissa >> Shift;
+			unsigned int Remainder = Mantissa & ((1u << Shift) - 1u);
+			unsigned int Halfway = 1u << (Shift - 1u);
+
+			if (Remainder > Halfway || (Remainder == Halfway && (HalfMantissa & 1u)))
+			{
+				HalfMantissa++;
+			}
+
+			return static_cast<unsigned short>(Sign | HalfMantissa);
+		}
+
+		unsigned int Half = Sign | (static_cast<unsigned int>(HalfExponent) << 10) | (Mantissa >> 13);
+		unsigned int Remainder = Mantissa & 0x1FFFu;
+
+		/* A carry out of the mantissa correctly bumps the exponent */
+		if (Remainder > 0x1000u || (Remainder == 0x1000u && (Half & 1u)))
+		{
+			Half++;
+		}
+
+		return static_cast<unsigned short>(Half);
+	}
+
+	inline static float HalfToFloat(unsigned short value)
+	{
+		unsigned int Sign = (static_cast<unsigned int>(value) & 0x8000u) << 16;
+		unsigned int Exponent = (value >> 10) & 0x1Fu;
+		unsigned int Mantissa = value & 0x3FFu;
+
+		unsigned int Bits;
+		if (Exponent == 0)
+		{
+			float Denormal = std::ldexp(static_cast<float>(Mantissa), -24);
+			return Sign ? -Denormal : Denormal;
+		}
+		else if (Exponent == 31)
+		{
+			Bits = Sign | 0x7F800000u | (Mantissa << 13);
+		}
+		else
+		{
+			Bits = Sign | ((Exponent - 15 + 127) << 23) | (Mantissa << 13);
+		}
+
+		float Result;
+		std::memcpy(&Result, &Bits, sizeof(Result));
+		return Result;
+	}
+
+	/* [0, 1] -> [0, 65535] */
+	inline static unsigned short FloatToUnorm16(float value)
+	{
+		value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+		return static_cast<unsigned short>(value * 65535.0f + 0.5f);
+	}
+
+	inline static float Unorm16ToFloat(unsigned short value)
+	{
+		return value / 65535.0f;
+	}
+
+	/* [-1, 1] -> [-32767, 32767], same mapping Vulkan uses for SNORM */
+	inline static short FloatToSnorm16(float value)
+	{
+		value = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+		return static_cast<short>(std::lround(value * 32767.0f));
+	}
+
+	inline static float Snorm16ToFloat(short value)
+	{
+		float Result = value / 32767.0f;
+		return Result < -1.0f ? -1.0f : Result;
+	}
+
+	/*
+	* Octahedral encoding of a unit vector into two snorm16 values
+	*	The vector is projected onto the octahedron |x| + |y| + |z| = 1 and the lower half is folded over the upper half
+	*	A zero vector encodes as +Z
+	*/
+	inline static void OctEncode(const Vector3D& normal, short outEncoded[2])
+	{
+		float L1 = std::fabs(normal.X) + std::fabs(normal.Y) + std::fabs(normal.Z);
+		if (L1 <= 0.0f)
+		{
+			outEncoded[0] = 0;
+			outEncoded[1] = 0;
+			return;
+		}
+
+		float X = normal.X / L1;
+		float Y = normal.Y / L1;
+
+		if (normal.Z < 0.0f)
+		{
+			float FoldedX = (1.0f - std::fabs(Y)) * (X >= 0.0f ? 1.0f : -1.0f);
+			float FoldedY = (1.0f - std::fabs(X)) * (Y >= 0.0f ? 1.0f : -1.0f);
+			X = FoldedX;
+			Y = FoldedY;
+		}
+
+		outEncoded[0] = FloatToSnorm16(X);
+		outEncoded[1] = FloatToSnorm16(Y);
+	}
+
+	/* Matches OctDecode() in NormalVertex.hlsl */
+	inline static Vector3D OctDecode(const short encoded[2])
+	{
+		Vector3D Normal;
+		Normal.X = Snorm16ToFloat(encoded[0]);
+		Normal.Y = Snorm16ToFloat(encoded[1]);
+		Normal.Z = 1.0f - std::fabs(Normal.X) - std::fabs(Normal.Y);
+
+		float T = Normal.Z < 0.0f ? -Normal.Z : 0.0f;
+		Normal.X += Normal.X >= 0.0f ? -T : T;
+		Normal.Y += Normal.Y >= 0.0f ? -T : T;
+
+		Normal.Normalize();
+		return Normal;
+	}
+};
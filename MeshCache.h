@@ -0,0 +1,258 @@
+#pragma once
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <filesystem>
+
+#include "RawMeshData.h"
+#include "GenericDefines.h"
+
+/*
+* Process wide cache of parsed h2b meshes, shared by every level load
+*	Entries are keyed by path and validated against the file's last write time and size, so a hit costs no file reads,
+*	the least recently used entries are evicted once the cached geometry goes over the byte budget
+*	Only geometry is cached (source key, counts, vertices, indices, materials, batches, sub meshes and bounds), never instances
+*	Vertices and indices are shared with the meshes a hit fills (RawMeshData::SharedGeometry), never copied,
+*	and entries never keep the h2b file mapped so it can be re-exported while the mesh is cached
+*/
+class MeshCache
+{
+public:
+	struct Stats
+	{
+		uint32 Hits;
+		uint32 Misses;
+		uint32 Evictions;
+		uint32 EntryCount;
+		size_t SizeInBytes;
+		size_t BudgetInBytes;
+	};
+
+private:
+	struct Entry
+	{
+		std::filesystem::file_time_type WriteTime;
+		uintmax_t FileSize;
+		size_t SizeInBytes;
+
+		/* Only the geometry members are used */
+		RawMeshData Mesh;
+
+		/* Position in UsageOrder, front is the most recently used */
+		std::list<std::string>::iterator UsageIt;
+	};
+
+	std::unordered_map<std::string, Entry> Entries;
+	std::list<std::string> UsageOrder;
+
+	std::mutex Lock;
+
+	size_t SizeInBytes;
+	size_t BudgetInBytes;
+
+	uint32 Hits;
+	uint32 Misses;
+	uint32 Evictions;
+
+private:
+	MeshCache()
+	{
+		SizeInBytes = 0;
+		BudgetInBytes = 256ull * 1024ull * 1024ull;
+
+		Hits = 0;
+		Misses = 0;
+		Evictions = 0;
+	}
+
+public:
+	MeshCache(const MeshCache& other) = delete;
+	MeshCache& operator=(const MeshCache& other) = delete;
+
+	static MeshCache& Get()
+	{
+		static MeshCache Instance;
+		return Instance;
+	}
+
+public:
+	/* Fills the geometry of outMesh from the cache, @returns false if the file is not cached or changed on disk */
+	bool Find(const std::string& filePath, RawMeshData& outMesh)
+	{
+		std::filesystem::file_time_type WriteTime;
+		uintmax_t FileSize = 0;
+		bool FileExists = GetFileStamp(filePath, WriteTime, FileSize);
+
+		std::lock_guard<std::mutex> Guard(Lock);
+
+		std::unordered_map<std::string, Entry>::iterator It = Entries.find(filePath);
+		if (It == Entries.end())
+		{
+			Misses++;
+			return false;
+		}
+
+		if (!FileExists || It->second.WriteTime != WriteTime || It->second.FileSize != FileSize)
+		{
+			/* Stale, the file was re-exported */
+			Remove(It);
+			Misses++;
+			return false;
+		}
+
+		UsageOrder.splice(UsageOrder.begin(), UsageOrder, It->second.UsageIt);
+		CopyGeometry(It->second.Mesh, outMesh);
+		Hits++;
+
+		return true;
+	}
+
+	/*
+	* Caches the geometry of mesh, evicts least recently used entries to stay within the budget
+	*	mesh's vertices and indices are moved into storage it shares with the cache (RawMeshData::ShareGeometry())
+	*/
+	void Insert(const std::string& filePath, RawMeshData& mesh)
+	{
+		Entry NewEntry;
+		if (!GetFileStamp(filePath, NewEntry.WriteTime, NewEntry.FileSize))
+		{
+			return;
+		}
+
+		mesh.ShareGeometry();
+
+		NewEntry.SizeInBytes = GetGeometrySizeInBytes(mesh);
+		CopyGeometry(mesh, NewEntry.Mesh);
+
+		std::lock_guard<std::mutex> Guard(Lock);
+
+		std::unordered_map<std::string, Entry>::iterator It = Entries.find(filePath);
+		if (It != Entries.end())
+		{
+			Remove(It);
+		}
+
+		if (NewEntry.SizeInBytes > BudgetInBytes)
+		{
+			return;
+		}
+
+		UsageOrder.push_front(filePath);
+		NewEntry.UsageIt = UsageOrder.begin();
+		SizeInBytes += NewEntry.SizeInBytes;
+		Entries.emplace(filePath, std::move(NewEntry));
+
+		EvictToBudget();
+	}
+
+	/*
+	* Path, last write time and size of the file, the identity entries are validated against, "" if the file does not exist
+	*	A re-exported file gets a new key even if its vertex and index counts did not change
+	*/
+	static std::string GetSourceKey(const std::string& filePath)
+	{
+		std::filesystem::file_time_type WriteTime;
+		uintmax_t FileSize = 0;
+		if (!GetFileStamp(filePath, WriteTime, FileSize))
+		{
+			return std::string();
+		}
+
+		return filePath + "|" + std::to_string(WriteTime.time_since_epoch().count()) + "|" + std::to_string(FileSize);
+	}
+
+	void SetBudget(size_t budgetInBytes)
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+
+		BudgetInBytes = budgetInBytes;
+		EvictToBudget();
+	}
+
+	void Clear()
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+
+		Entries.clear();
+		UsageOrder.clear();
+		SizeInBytes = 0;
+	}
+
+	Stats GetStats()
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+
+		Stats CurrentStats;
+		CurrentStats.Hits = Hits;
+		CurrentStats.Misses = Misses;
+		CurrentStats.Evictions = Evictions;
+		CurrentStats.EntryCount = Entries.size();
+		CurrentStats.SizeInBytes = SizeInBytes;
+		CurrentStats.BudgetInBytes = BudgetInBytes;
+
+		return CurrentStats;
+	}
+
+private:
+	static bool GetFileStamp(const std::string& filePath, std::filesystem::file_time_type& outWriteTime, uintmax_t& outFileSize)
+	{
+		std::error_code Error;
+		outWriteTime = std::filesystem::last_write_time(filePath, Error);
+		if (Error)
+		{
+			return false;
+		}
+
+		outFileSize = std::filesystem::file_size(filePath, Error);
+		return !Error;
+	}
+
+	static size_t GetGeometrySizeInBytes(const RawMeshData& mesh)
+	{
+		return mesh.VertexCount * sizeof(H2B::VERTEX) + mesh.IndexCount * sizeof(uint32)
+			+ mesh.Materials.size() * sizeof(RawMaterial) + mesh.Batches.size() * sizeof(H2B::BATCH)
+			+ mesh.Meshes.size() * sizeof(H2B::MESH);
+	}
+
+	static void CopyGeometry(const RawMeshData& from, RawMeshData& to)
+	{
+		to.SourceKey = from.SourceKey;
+		to.VertexCount = from.VertexCount;
+		to.IndexCount = from.IndexCount;
+		to.MaterialCount = from.MaterialCount;
+		to.MeshCount = from.MeshCount;
+
+		/* Shared, not copied */
+		to.Vertices = from.Vertices;
+		to.Indices = from.Indices;
+		to.Source = from.Source;
+		to.SharedGeometry = from.SharedGeometry;
+
+		to.Materials = from.Materials;
+		to.Batches = from.Batches;
+		to.Meshes = from.Meshes;
+		to.MeshNames = from.MeshNames;
+
+		to.BoxMin_AABB = from.BoxMin_AABB;
+		to.BoxMax_AABB = from.BoxMax_AABB;
+		to.BoundingSphereCenter = from.BoundingSphereCenter;
+		to.BoundingSphereRadius = from.BoundingSphereRadius;
+	}
+
+	void Remove(std::unordered_map<std::string, Entry>::iterator it)
+	{
+		SizeInBytes -= it->second.SizeInBytes;
+		UsageOrder.erase(it->second.UsageIt);
+		Entries.erase(it);
+	}
+
+	void EvictToBudget()
+	{
+		while (SizeInBytes > BudgetInBytes && !UsageOrder.empty())
+		{
+			Remove(Entries.find(UsageOrder.back()));
+			Evictions++;
+		}
+	}
+};
@@ -0,0 +1,597 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <unordered_map>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+
+#include "RawMeshData.h"
+#include "GenericDefines.h"
+
+#define DEBUG 1
+
+/* Vertices whose position, uvw and normal components all match within this distance are welded at load time */
+#define MESH_WELD_EPSILON 1.0e-6f
+
+/*
+* Load time mesh processing, every pass keeps the sub mesh (H2B::MESH) draw ranges valid
+*	Triangles are only reordered inside their own draw range, vertices are reordered across the whole mesh
+*/
+struct MeshOptimizer
+{
+public:
+	/* Post transform cache efficiency of an index buffer, lower is better for both */
+	struct CacheStats
+	{
+		/* Average cache miss ratio, vertex shader invocations per triangle, 0.5 is ideal for large meshes */
+		float ACMR;
+
+		/* Average transformed vertex ratio, vertex shader invocations per referenced vertex, 1.0 is ideal */
+		float ATVR;
+	};
+
+	/* FIFO size used for the ACMR/ATVR reports, matches what most desktop GPUs behave like */
+	static const uint32 ReportCacheSize = 16;
+
+	/* LRU size the vertex cache optimizer scores against */
+	static const uint32 OptimizerCacheSize = 32;
+
+public:
+	/*
+	* Runs the vertex cache, overdraw and vertex fetch passes on a mesh
+	*	Mapped geometry is copied out first, @returns false if the draw ranges overlap and nothing was changed
+	*/
+	inline static bool Optimize(RawMeshData& mesh)
+	{
+		if (mesh.VertexCount == 0 || mesh.IndexCount == 0 || !HasDisjointDrawRanges(mesh))
+		{
+			return false;
+		}
+
+		mesh.MakeGeometryMutable();
+
+#if DEBUG
+		CacheStats Before = AnalyzeVertexCache(mesh.Indices.data(), mesh.IndexCount, mesh.VertexCount, ReportCacheSize);
+#endif // DEBUG
+
+		for (uint32 i = 0; i < mesh.MeshCount; ++i)
+		{
+			uint32* RangeIndices = mesh.Indices.data() + mesh.Meshes[i].drawInfo.indexOffset;
+			uint32 RangeIndexCount = mesh.Meshes[i].drawInfo.indexCount;
+
+			OptimizeVertexCache(RangeIndices, RangeIndexCount, mesh.VertexCount);
+			OptimizeOverdraw(RangeIndices, RangeIndexCount, mesh.Vertices.data(), mesh.VertexCount);
+		}
+
+		OptimizeVertexFetch(mesh.Vertices.data(), mesh.VertexCount, mesh.Indices.data(), mesh.IndexCount);
+
+#if DEBUG
+		CacheStats After = AnalyzeVertexCache(mesh.Indices.data(), mesh.IndexCount, mesh.VertexCount, ReportCacheSize);
+		std::cout << "[MeshOptimizer]: " << mesh.Name << " ACMR " << Before.ACMR << " -> " << After.ACMR
+			<< ", ATVR " << Before.ATVR << " -> " << After.ATVR << "\n";
+#endif // DEBUG
+
+		return true;
+	}
+
+	/*
+	* Merges vertices whose position, uvw and normal all match within epsilon and remaps the indices to the survivors
+	*	Components are snapped to an epsilon grid and hashed, so two vertices on either side of a grid line are kept apart,
+	*	an epsilon of 0 only welds bit exact duplicates (+0 and -0 are the same)
+	*	Duplicates are searched in place, mapped geometry is only copied out if vertices are welded, @returns the number of vertex bytes saved
+	*/
+	inline static uint32 WeldVertices(RawMeshData& mesh, float epsilon)
+	{
+		if (mesh.VertexCount < 2)
+		{
+			return 0;
+		}
+
+		const H2B::VERTEX* SourceVertices = mesh.GetVertexData();
+
+		typedef std::array<int64_t, 9> WeldKey;
+
+		struct WeldKeyHash
+		{
+			size_t operator()(const WeldKey& key) const
+			{
+				/* FNV-1a */
+				uint64_t Hash = 14695981039346656037ull;
+				for (uint32 i = 0; i < key.size(); ++i)
+				{
+					Hash = (Hash ^ static_cast<uint64_t>(key[i])) * 1099511628211ull;
+				}
+				return static_cast<size_t>(Hash);
+			}
+		};
+
+		std::unordered_map<WeldKey, uint32, WeldKeyHash> UniqueVertices;
+		UniqueVertices.reserve(mesh.VertexCount);
+
+		/* Remap[i] is the welded vertex of vertex i, Survivors[j] the vertex welded vertex j is copied from */
+		std::vector<uint32> Remap(mesh.VertexCount);
+		std::vector<uint32> Survivors;
+		Survivors.reserve(mesh.VertexCount);
+
+		for (uint32 i = 0; i < mesh.VertexCount; ++i)
+		{
+			const float* Components = &SourceVertices[i].pos.x;
+
+			WeldKey Key;
+			for (uint32 j = 0; j < Key.size(); ++j)
+			{
+				Key[j] = QuantizeComponent(Components[j], epsilon);
+			}
+
+			std::pair<std::unordered_map<WeldKey, uint32, WeldKeyHash>::iterator, bool> Result =
+				UniqueVertices.emplace(Key, static_cast<uint32>(Survivors.size()));
+			if (Result.second)
+			{
+				Survivors.push_back(i);
+			}
+
+			Remap[i] = Result.first->second;
+		}
+
+		const uint32 SavedBytes = (mesh.VertexCount - static_cast<uint32>(Survivors.size())) * sizeof(H2B::VERTEX);
+
+#if DEBUG
+		std::cout << "[MeshOptimizer]: " << mesh.Name << " welded " << mesh.VertexCount << " -> " << Survivors.size()
+			<< " vertices, saved " << SavedBytes << " bytes\n";
+#endif // DEBUG
+
+		if (SavedBytes == 0)
+		{
+			return 0;
+		}
+
+		/* Built straight from the source, mapped geometry is never copied as a whole */
+		std::vector<H2B::VERTEX> Welded(Survivors.size());
+		for (uint32 i = 0; i < Survivors.size(); ++i)
+		{
+			Welded[i] = SourceVertices[Survivors[i]];
+		}
+
+		const uint32* SourceIndices = mesh.GetIndexData();
+		std::vector<uint32> Indices(mesh.IndexCount);
+		for (uint32 i = 0; i < mesh.IndexCount; ++i)
+		{
+			Indices[i] = Remap[SourceIndices[i]];
+		}
+
+		mesh.SetGeometry(std::move(Welded), std::move(Indices));
+
+		return SavedBytes;
+	}
+
+	/* Simulates a FIFO post transform cache of cacheSize entries over the triangle list */
+	inline static CacheStats AnalyzeVertexCache(const uint32* indices, uint32 indexCount, uint32 vertexCount, uint32 cacheSize)
+	{
+		std::vector<uint32> InsertedAt(vertexCount, 0);
+		std::vector<uint8> Referenced(vertexCount, 0);
+
+		/* A vertex is in the cache if it was inserted less than cacheSize insertions ago, Time starts past cacheSize so 0 means never */
+		uint32 Time = cacheSize + 1;
+		uint32 Misses = 0;
+		uint32 ReferencedCount = 0;
+
+		for (uint32 i = 0; i < indexCount; ++i)
+		{
+			uint32 Index = indices[i];
+			if (Time - InsertedAt[Index] > cacheSize)
+			{
+				InsertedAt[Index] = Time++;
+				Misses++;
+			}
+
+			if (!Referenced[Index])
+			{
+				Referenced[Index] = 1;
+				ReferencedCount++;
+			}
+		}
+
+		CacheStats Stats;
+		Stats.ACMR = indexCount >= 3 ? static_cast<float>(Misses) / (indexCount / 3) : 0.0f;
+		Stats.ATVR = ReferencedCount > 0 ? static_cast<float>(Misses) / ReferencedCount : 0.0f;
+
+		return Stats;
+	}
+
+	/*
+	* Tom Forsyth's linear-speed vertex cache optimization
+	*	Greedily emits the triangle with the highest score, a vertex scores higher the more recently it was used
+	*	and the fewer triangles it has left, so fans and strips are finished before moving on
+	*/
+	inline static void OptimizeVertexCache(uint32* indices, uint32 indexCount, uint32 vertexCount)
+	{
+		const uint32 TriangleCount = indexCount / 3;
+		if (TriangleCount < 2)
+		{
+			return;
+		}
+
+		/* Triangles adjacent to every vertex, live triangles are kept at the front of each vertex's list */
+		std::vector<uint32> LiveTriangles(vertexCount, 0);
+		for (uint32 i = 0; i < TriangleCount * 3; ++i)
+		{
+			LiveTriangles[indices[i]]++;
+		}
+
+		std::vector<uint32> AdjacencyOffsets(vertexCount + 1, 0);
+		for (uint32 i = 0; i < vertexCount; ++i)
+		{
+			AdjacencyOffsets[i + 1] = AdjacencyOffsets[i] + LiveTriangles[i];
+		}
+
+		std::vector<uint32> Adjacency(TriangleCount * 3);
+		{
+			std::vector<uint32> Fill(AdjacencyOffsets.begin(), AdjacencyOffsets.end() - 1);
+			for (uint32 i = 0; i < TriangleCount * 3; ++i)
+			{
+				Adjacency[Fill[indices[i]]++] = i / 3;
+			}
+		}
+
+		std::vector<float> VertexScores(vertexCount);
+		for (uint32 i = 0; i < vertexCount; ++i)
+		{
+			VertexScores[i] = ScoreVertex(-1, LiveTriangles[i]);
+		}
+
+		std::vector<float> TriangleScores(TriangleCount);
+		for (uint32 i = 0; i < TriangleCount; ++i)
+		{
+			TriangleScores[i] = VertexScores[indices[i * 3]] + VertexScores[indices[i * 3 + 1]] + VertexScores[indices[i * 3 + 2]];
+		}
+
+		std::vector<uint8> Emitted(TriangleCount, 0);
+		std::vector<uint32> Output;
+		Output.reserve(TriangleCount * 3);
+
+		/* Holds up to 3 vertices past the cache size while a triangle is added */
+		uint32 Cache[OptimizerCacheSize + 3];
+		uint32 CacheCount = 0;
+
+		uint32 NextInputTriangle = 0;
+		int32 BestTriangle = -1;
+
+		for (uint32 Emit = 0; Emit < TriangleCount; ++Emit)
+		{
+			/* Dead end, nothing in the cache touches a live triangle so continue in input order */
+			if (BestTriangle < 0)
+			{
+				while (Emitted[NextInputTriangle])
+				{
+					NextInputTriangle++;
+				}
+				BestTriangle = NextInputTriangle;
+			}
+
+			const uint32 Triangle = BestTriangle;
+			const uint32 A = indices[Triangle * 3];
+			const uint32 B = indices[Triangle * 3 + 1];
+			const uint32 C = indices[Triangle * 3 + 2];
+
+			Emitted[Triangle] = 1;
+			Output.push_back(A);
+			Output.push_back(B);
+			Output.push_back(C);
+
+			/* Remove the triangle from its vertices' live lists */
+			const uint32 Corners[3] = { A, B, C };
+			for (uint32 Corner = 0; Corner < 3; ++Corner)
+			{
+				uint32 Vertex = Corners[Corner];
+				uint32* List = Adjacency.data() + AdjacencyOffsets[Vertex];
+				for (uint32 k = 0; k < LiveTriangles[Vertex]; ++k)
+				{
+					if (List[k] == Triangle)
+					{
+						std::swap(List[k], List[LiveTriangles[Vertex] - 1]);
+						LiveTriangles[Vertex]--;
+						break;
+					}
+				}
+			}
+
+			/* Move the triangle's vertices to the front of the LRU cache */
+			uint32 NewCache[OptimizerCacheSize + 3];
+			uint32 NewCacheCount = 0;
+			NewCache[NewCacheCount++] = A;
+			NewCache[NewCacheCount++] = B;
+			NewCache[NewCacheCount++] = C;
+			for (uint32 k = 0; k < CacheCount; ++k)
+			{
+				uint32 Vertex = Cache[k];
+				if (Vertex != A && Vertex != B && Vertex != C)
+				{
+					NewCache[NewCacheCount++] = Vertex;
+				}
+			}
+
+			/* Rescore everything that was or is in the cache, evicted vertices lose their cache bonus */
+			for (uint32 k = 0; k < NewCacheCount; ++k)
+			{
+				uint32 Vertex = NewCache[k];
+				int32 Position = k < OptimizerCacheSize ? static_cast<int32>(k) : -1;
+
+				float NewScore = ScoreVertex(Position, LiveTriangles[Vertex]);
+				float Delta = NewScore - VertexScores[Vertex];
+				VertexScores[Vertex] = NewScore;
+
+				const uint32* List = Adjacency.data() + AdjacencyOffsets[Vertex];
+				for (uint32 t = 0; t < LiveTriangles[Vertex]; ++t)
+				{
+					TriangleScores[List[t]] += Delta;
+				}
+			}
+
+			CacheCount = NewCacheCount < OptimizerCacheSize ? NewCacheCount : OptimizerCacheSize;
+			std::copy(NewCache, NewCache + CacheCount, Cache);
+
+			/* Next triangle is the best one touching the cache */
+			BestTriangle = -1;
+			float BestScore = -1.0f;
+			for (uint32 k = 0; k < CacheCount; ++k)
+			{
+				const uint32* List = Adjacency.data() + AdjacencyOffsets[Cache[k]];
+				for (uint32 t = 0; t < LiveTriangles[Cache[k]]; ++t)
+				{
+					if (TriangleScores[List[t]] > BestScore)
+					{
+						BestScore = TriangleScores[List[t]];
+						BestTriangle = List[t];
+					}
+				}
+			}
+		}
+
+		std::copy(Output.begin(), Output.end(), indices);
+	}
+
+	/*
+	* Cluster based overdraw reduction (Sander et al, Fast Triangle Reordering for Vertex Locality and Reduced Overdraw)
+	*	The cache optimized list is cut into clusters wherever a triangle misses on all 3 vertices, the cache is cold there anyway
+	*	Clusters facing away from the mesh center are likely occluders and are drawn first
+	*/
+	inline static void OptimizeOverdraw(uint32* indices, uint32 indexCount, const H2B::VERTEX* vertices, uint32 vertexCount)
+	{
+		const uint32 TriangleCount = indexCount / 3;
+		if (TriangleCount < 2)
+		{
+			return;
+		}
+
+		/* Cluster starts, in triangles */
+		std::vector<uint32> Clusters;
+		{
+			std::vector<uint32> InsertedAt(vertexCount, 0);
+			uint32 Time = ReportCacheSize + 1;
+
+			for (uint32 i = 0; i < TriangleCount; ++i)
+			{
+				uint32 Misses = 0;
+				for (uint32 Corner = 0; Corner < 3; ++Corner)
+				{
+					uint32 Index = indices[i * 3 + Corner];
+					if (Time - InsertedAt[Index] > ReportCacheSize)
+					{
+						InsertedAt[Index] = Time++;
+						Misses++;
+					}
+				}
+
+				if (i == 0 || Misses == 3)
+				{
+					Clusters.push_back(i);
+				}
+			}
+		}
+
+		if (Clusters.size() < 2)
+		{
+			return;
+		}
+
+		/* Area weighted centroid of the whole range, then of every cluster along with its area weighted normal */
+		Vector3D MeshCentroid = ComputeCentroid(indices, 0, TriangleCount, vertices);
+
+		struct Cluster
+		{
+			uint32 FirstTriangle;
+			uint32 TriangleCount;
+			float SortKey;
+		};
+
+		std::vector<Cluster> SortedClusters(Clusters.size());
+		for (uint32 i = 0; i < Clusters.size(); ++i)
+		{
+			uint32 First = Clusters[i];
+			uint32 End = i + 1 < Clusters.size() ? Clusters[i + 1] : TriangleCount;
+
+			Vector3D Normal(0.0f);
+			Vector3D Centroid = ComputeCentroid(indices, First, End, vertices, &Normal);
+
+			Vector3D Direction = Centroid - MeshCentroid;
+			float NormalLength = Normal.Length();
+
+			SortedClusters[i].FirstTriangle = First;
+			SortedClusters[i].TriangleCount = End - First;
+			SortedClusters[i].SortKey = NormalLength > 0.0f ? Vector3D::DotProduct(Direction, Normal) / NormalLength : 0.0f;
+		}
+
+		std::stable_sort(SortedClusters.begin(), SortedClusters.end(), [](const Cluster& a, const Cluster& b)
+			{
+				return a.SortKey > b.SortKey;
+			});
+
+		std::vector<uint32> Output;
+		Output.reserve(TriangleCount * 3);
+		for (uint32 i = 0; i < SortedClusters.size(); ++i)
+		{
+			const uint32* First = indices + SortedClusters[i].FirstTriangle * 3;
+			Output.insert(Output.end(), First, First + SortedClusters[i].TriangleCount * 3);
+		}
+
+		std::copy(Output.begin(), Output.end(), indices);
+	}
+
+	/*
+	* Reorders vertices into the order the index buffer first references them so vertex fetches walk memory forward
+	*	Vertices no index references are moved to the end, vertexCount never changes
+	*/
+	inline static void OptimizeVertexFetch(H2B::VERTEX* vertices, uint32 vertexCount, uint32* indices, uint32 indexCount)
+	{
+		const uint32 Unassigned = ~0u;
+		std::vector<uint32> Remap(vertexCount, Unassigned);
+		uint32 NextVertex = 0;
+
+		for (uint32 i = 0; i < indexCount; ++i)
+		{
+			uint32& NewIndex = Remap[indices[i]];
+			if (NewIndex == Unassigned)
+			{
+				NewIndex = NextVertex++;
+			}
+			indices[i] = NewIndex;
+		}
+
+		for (uint32 i = 0; i < vertexCount; ++i)
+		{
+			if (Remap[i] == Unassigned)
+			{
+				Remap[i] = NextVertex++;
+			}
+		}
+
+		std::vector<H2B::VERTEX> Reordered(vertexCount);
+		for (uint32 i = 0; i < vertexCount; ++i)
+		{
+			Reordered[Remap[i]] = vertices[i];
+		}
+
+		std::copy(Reordered.begin(), Reordered.end(), vertices);
+	}
+
+private:
+	/* Every index must be in range and no two sub meshes may share triangles, otherwise reordering one would break another */
+	inline static bool HasDisjointDrawRanges(const RawMeshData& mesh)
+	{
+		std::vector<H2B::BATCH> Ranges;
+		for (uint32 i = 0; i < mesh.MeshCount; ++i)
+		{
+			Ranges.push_back(mesh.Meshes[i].drawInfo);
+		}
+
+		std::sort(Ranges.begin(), Ranges.end(), [](const H2B::BATCH& a, const H2B::BATCH& b)
+			{
+				return a.indexOffset < b.indexOffset;
+			});
+
+		for (uint32 i = 0; i < Ranges.size(); ++i)
+		{
+			if (Ranges[i].indexCount % 3 != 0 || static_cast<uint64_t>(Ranges[i].indexOffset) + Ranges[i].indexCount > mesh.IndexCount)
+			{
+				return false;
+			}
+
+			if (i > 0 && Ranges[i - 1].indexOffset + Ranges[i - 1].indexCount > Ranges[i].indexOffset)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/* Grid cell of a vertex component, the raw bits when welding exact duplicates */
+	inline static int64_t QuantizeComponent(float value, float epsilon)
+	{
+		if (value == 0.0f)
+		{
+			return 0;
+		}
+
+		if (epsilon <= 0.0f)
+		{
+			int32 Bits;
+			std::memcpy(&Bits, &value, sizeof(Bits));
+			return Bits;
+		}
+
+		/* Keep huge values (and infinities) inside the integer range */
+		double Cell = std::floor(static_cast<double>(value) / epsilon + 0.5);
+		Cell = Cell < -4.0e18 ? -4.0e18 : (Cell > 4.0e18 ? 4.0e18 : Cell);
+		return static_cast<int64_t>(Cell);
+	}
+
+	inline static float ScoreVertex(int32 cachePosition, uint32 liveTriangles)
+	{
+		const float CacheDecayPower = 1.5f;
+		const float LastTriangleScore = 0.75f;
+		const float ValenceBoostScale = 2.0f;
+		const float ValenceBoostPower = 0.5f;
+
+		/* Nothing left to draw with this vertex */
+		if (liveTriangles == 0)
+		{
+			return -1.0f;
+		}
+
+		float Score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			/* The last triangle's vertices get a fixed score so the very next triangle doesn't just reuse them */
+			if (cachePosition < 3)
+			{
+				Score = LastTriangleScore;
+			}
+			else
+			{
+				const float Scaler = 1.0f / (OptimizerCacheSize - 3);
+				Score = std::pow(1.0f - (cachePosition - 3) * Scaler, CacheDecayPower);
+			}
+		}
+
+		/* Vertices with few triangles left are finished first so they don't get stranded */
+		Score += ValenceBoostScale * std::pow(static_cast<float>(liveTriangles), -ValenceBoostPower);
+
+		return Score;
+	}
+
+	/* Area weighted centroid of triangles [first, end), optionally accumulates the area weighted normal */
+	inline static Vector3D ComputeCentroid(const uint32* indices, uint32 first, uint32 end, const H2B::VERTEX* vertices, Vector3D* outNormal = nullptr)
+	{
+		Vector3D Centroid(0.0f);
+		float TotalArea = 0.0f;
+
+		for (uint32 i = first; i < end; ++i)
+		{
+			const H2B::VECTOR& A = vertices[indices[i * 3]].pos;
+			const H2B::VECTOR& B = vertices[indices[i * 3 + 1]].pos;
+			const H2B::VECTOR& C = vertices[indices[i * 3 + 2]].pos;
+
+			Vector3D P0(A.x, A.y, A.z);
+			Vector3D P1(B.x, B.y, B.z);
+			Vector3D P2(C.x, C.y, C.z);
+
+			/* Twice the area */
+			Vector3D Cross = Vector3D::CrossProduct(P1 - P0, P2 - P0);
+			float Area = Cross.Length();
+
+			Centroid += (P0 + P1 + P2) * (Area / 3.0f);
+			TotalArea += Area;
+
+			if (outNormal != nullptr)
+			{
+				*outNormal += Cross;
+			}
+		}
+
+		return TotalArea > 0.0f ? Centroid / TotalArea : Centroid;
+	}
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <memory>
 #include "h2bParser.h"
 #include "Math/Matrix4D.h"
 
@@ -21,6 +22,13 @@ struct RawMaterial
 	const void* padding[2];
 };
 
+/* Geometry nothing modifies anymore, shared by every RawMeshData read from the same file, see RawMeshData::ShareGeometry */
+struct RawMeshGeometry
+{
+	std::vector<H2B::VERTEX> Vertices;
+	std::vector<uint32> Indices;
+};
+
 enum LightType
 {
 	Directional =	0,
@@ -38,12 +46,26 @@ struct RawMeshData
 	uint32 MaterialCount;
 	uint32 MeshCount;
 
+	/* Geometry owned by this mesh, meshes whose geometry is shared leave these empty, see GetVertexData/GetIndexData */
 	std::vector<H2B::VERTEX> Vertices;
 	std::vector<uint32> Indices;
+
+	/* Identity of the h2b file the geometry was read from, "" if it was not read from one, see MeshCache::GetSourceKey */
+	std::string SourceKey;
+
+	/* The mapped h2b file this mesh was read from, keeps its vertices and indices alive until the geometry is owned */
+	std::shared_ptr<const H2B::MappedParser> Source;
+
+	/* Geometry shared with MeshCache, read only */
+	std::shared_ptr<const RawMeshGeometry> SharedGeometry;
+
 	std::vector<RawMaterial> Materials;
 	std::vector<H2B::BATCH> Batches;
 	std::vector<H2B::MESH> Meshes;
 
+	/* Names of Meshes read from a h2b file, copied out of the mapping (their name is nullptr), see GetMeshName */
+	std::vector<std::string> MeshNames;
+
 	std::vector<Matrix4D> WorldMatrices;
 	uint32 InstanceCount;
 
@@ -55,6 +77,10 @@ struct RawMeshData
 	Vector3D BoxMin_AABB;
 	Vector3D BoxMax_AABB;
 
+	/* Object space, centered on the AABB */
+	Vector3D BoundingSphereCenter;
+	float BoundingSphereRadius;
+
 	RawMeshData()
 	{
 		VertexCount = 0;
@@ -70,6 +96,106 @@ struct RawMeshData
 
 		BoxMin_AABB = Vector3D::ZeroVector();
 		BoxMax_AABB = Vector3D::ZeroVector();
+
+		BoundingSphereCenter = Vector3D::ZeroVector();
+		BoundingSphereRadius = 0.0f;
+	}
+
+	/* Vertices/Indices are read from Source or SharedGeometry until the geometry is made mutable */
+	bool IsGeometryShared() const
+	{
+		return Source != nullptr || SharedGeometry != nullptr;
+	}
+
+	/* @returns VertexCount vertices, straight from the mapped h2b file or MeshCache if the geometry is shared */
+	const H2B::VERTEX* GetVertexData() const
+	{
+		if (Source)
+		{
+			return Source->vertices;
+		}
+
+		return SharedGeometry ? SharedGeometry->Vertices.data() : Vertices.data();
+	}
+
+	/* @returns IndexCount indices, straight from the mapped h2b file or MeshCache if the geometry is shared */
+	const uint32* GetIndexData() const
+	{
+		if (Source)
+		{
+			return Source->indices;
+		}
+
+		return SharedGeometry ? SharedGeometry->Indices.data() : Indices.data();
+	}
+
+	/* @returns the name of sub mesh meshIndex, "" if it has none */
+	const char* GetMeshName(uint32 meshIndex) const
+	{
+		if (meshIndex < MeshNames.size())
+		{
+			return MeshNames[meshIndex].c_str();
+		}
+
+		return Meshes[meshIndex].name != nullptr ? Meshes[meshIndex].name : "";
+	}
+
+	/* Copies shared geometry into Vertices/Indices so it can be modified, the mapping or shared geometry is released */
+	void MakeGeometryMutable()
+	{
+		if (!IsGeometryShared())
+		{
+			return;
+		}
+
+		const H2B::VERTEX* SharedVertices = GetVertexData();
+		const uint32* SharedIndices = GetIndexData();
+		Vertices.assign(SharedVertices, SharedVertices + VertexCount);
+		Indices.assign(SharedIndices, SharedIndices + IndexCount);
+
+		Source.reset();
+		SharedGeometry.reset();
+	}
+
+	/* Replaces the geometry with vertices/indices, the mapping or shared geometry is released */
+	void SetGeometry(std::vector<H2B::VERTEX>&& vertices, std::vector<uint32>&& indices)
+	{
+		Vertices = std::move(vertices);
+		Indices = std::move(indices);
+		VertexCount = static_cast<uint32>(Vertices.size());
+		IndexCount = static_cast<uint32>(Indices.size());
+
+		Source.reset();
+		SharedGeometry.reset();
+	}
+
+	/*
+	* Moves the geometry into SharedGeometry so copies of this mesh can share it instead of copying it
+	*	Mapped geometry is copied out of the file and the mapping is released
+	*/
+	void ShareGeometry()
+	{
+		if (SharedGeometry)
+		{
+			return;
+		}
+
+		std::shared_ptr<RawMeshGeometry> Geometry = std::make_shared<RawMeshGeometry>();
+		if (Source)
+		{
+			Geometry->Vertices.assign(Source->vertices, Source->vertices + VertexCount);
+			Geometry->Indices.assign(Source->indices, Source->indices + IndexCount);
+			Source.reset();
+		}
+		else
+		{
+			Geometry->Vertices = std::move(Vertices);
+			Geometry->Indices = std::move(Indices);
+			Vertices.clear();
+			Indices.clear();
+		}
+
+		SharedGeometry = Geometry;
 	}
 };
 
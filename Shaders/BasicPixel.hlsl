@@ -1,6 +1,3 @@
-#define MAX_SUBMESH_PER_DRAW 512
-#define MAX_LIGHTS_PER_DRAW 16
-
 #define TEXTURE_DIFFUSE_FLAG 0x00000001
 #define TEXTURE_SPECULAR_FLAG 0x00000002
 #define TEXTURE_NORMAL_FLAG 0x00000003
@@ -52,6 +49,13 @@ struct SpotLight
     float4 ConeDirection;
 };
 
+/* Dequantizes packed vertex positions, one per static mesh, indexed by the draw's DequantizationID */
+struct PositionDequantization
+{
+    float4 Scale;
+    float4 Offset;
+};
+
 struct SceneDataGlobal
 {
 	/* Globally shared model information */
@@ -61,20 +65,11 @@ struct SceneDataGlobal
 	/* Lighting Information */    
     float4 SunAmbient;
     float4 CameraWorldPosition;
-    
-    /* Per sub-mesh transform and material data */
-    float4x4 Matrices[MAX_SUBMESH_PER_DRAW]; // World space matrices
-    Material Materials[MAX_SUBMESH_PER_DRAW]; // color/texture of surface info of all meshes    
-    
-    DirectionalLight DirectionalLights[MAX_LIGHTS_PER_DRAW];
-    
-    PointLight PointLights[MAX_LIGHTS_PER_DRAW];
-
-    SpotLight SpotLights[MAX_LIGHTS_PER_DRAW];
 
 	/* 16-byte padding for the lights,
 	* X component -> num of point lights
 	* Y component -> num of spot lights
+	* Z component -> num of dir lights
 	*/
     float4 NumOfLights;
 };
@@ -83,6 +78,22 @@ struct SceneDataGlobal
 [[vk::binding(0)]]
 StructuredBuffer<SceneDataGlobal> SceneData;
 
+/* Per sub-mesh transform and material data, sized by the level */
+[[vk::binding(1)]]
+StructuredBuffer<float4x4> Matrices; // World space matrices
+[[vk::binding(2)]]
+StructuredBuffer<Material> Materials; // color/texture of surface info of all meshes
+
+[[vk::binding(3)]]
+StructuredBuffer<DirectionalLight> DirectionalLights;
+[[vk::binding(4)]]
+StructuredBuffer<PointLight> PointLights;
+[[vk::binding(5)]]
+StructuredBuffer<SpotLight> SpotLights;
+
+[[vk::binding(6)]]
+StructuredBuffer<PositionDequantization> PositionDequantizations;
+
 [[vk::push_constant]]
 cbuffer ConstantBuffer
 {
@@ -0,0 +1,147 @@
+#pragma pack_matrix(row_major)
+
+/* Per draw IDs, indexed by draw ID */
+struct DrawData
+{
+    uint MeshID;
+    uint MaterialID;
+    uint DiffuseTextureID;
+    uint SpecularTextureID;
+    uint NormalTextureID;
+    uint FirstInstance; // firstInstance of the draw's command
+    uint InstanceCount;
+    uint IndexCount; // command arguments, for the culling pass
+    uint FirstIndex;
+    int VertexOffset;
+    uint DequantizationID; // PositionDequantizations of the draw's mesh
+    uint Padding;
+    float4 BoundsCenter; // mesh space AABB
+    float4 BoundsExtents;
+};
+
+/* VkDrawIndexedIndirectCommand */
+struct DrawCommand
+{
+    uint IndexCount;
+    uint InstanceCount;
+    uint FirstIndex;
+    int VertexOffset;
+    uint FirstInstance;
+};
+
+[[vk::binding(1)]]
+StructuredBuffer<float4x4> Matrices; // World space matrices
+
+[[vk::binding(7)]]
+StructuredBuffer<DrawData> Draws;
+
+/* Instance of the draw's mesh in every slot, visible instances are compacted to the front of the draw's slots */
+[[vk::binding(9)]]
+RWStructuredBuffer<uint> VisibleInstances;
+
+/* Indirect commands of the frame, one per draw */
+[[vk::binding(10)]]
+RWStructuredBuffer<DrawCommand> Commands;
+
+/* CullConstants */
+[[vk::push_constant]]
+cbuffer ConstantBuffer
+{
+    float4 Planes[6]; // XYZ normal pointing inside, W distance
+    uint FirstDraw;
+    uint DrawCount;
+    uint2 Padding;
+};
+
+#define THREADS_PER_DRAW 64
+
+groupshared uint VisibleFlags[THREADS_PER_DRAW];
+groupshared uint VisibleCount;
+
+/* Same test as GpuCulling::IsInstanceVisible(), the mesh AABB goes through the absolute matrix so it stays conservative */
+bool IsInstanceVisible(DrawData draw, float4x4 world)
+{
+    float3 Center = draw.BoundsCenter.x * world[0].xyz + draw.BoundsCenter.y * world[1].xyz + draw.BoundsCenter.z * world[2].xyz + world[3].xyz;
+    float3 Extents = draw.BoundsExtents.x * abs(world[0].xyz) + draw.BoundsExtents.y * abs(world[1].xyz) + draw.BoundsExtents.z * abs(world[2].xyz);
+
+    for (uint i = 0; i < 6; ++i)
+    {
+        float Distance = dot(Planes[i].xyz, Center) - Planes[i].w;
+        float Radius = dot(abs(Planes[i].xyz), Extents);
+        if (Distance < -Radius)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* One group per draw, the group tests THREADS_PER_DRAW instances at a time */
+[numthreads(THREADS_PER_DRAW, 1, 1)]
+void main(uint3 GroupID : SV_GROUPID, uint ThreadIndex : SV_GROUPINDEX)
+{
+    uint DrawID = FirstDraw + GroupID.x;
+    if (DrawID >= DrawCount)
+    {
+        return;
+    }
+
+    DrawData Draw = Draws[DrawID];
+
+    if (ThreadIndex == 0)
+    {
+        VisibleCount = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    for (uint First = 0; First < Draw.InstanceCount; First += THREADS_PER_DRAW)
+    {
+        uint Instance = First + ThreadIndex;
+
+        bool Visible = false;
+        if (Instance < Draw.InstanceCount)
+        {
+            Visible = IsInstanceVisible(Draw, Matrices[Draw.MeshID + Instance]);
+        }
+
+        VisibleFlags[ThreadIndex] = Visible ? 1 : 0;
+        GroupMemoryBarrierWithGroupSync();
+
+        /* Visible instances keep their order, like the CPU reference */
+        if (Visible)
+        {
+            uint Offset = 0;
+            for (uint i = 0; i < ThreadIndex; ++i)
+            {
+                Offset += VisibleFlags[i];
+            }
+
+            VisibleInstances[Draw.FirstInstance + VisibleCount + Offset] = Instance;
+        }
+        GroupMemoryBarrierWithGroupSync();
+
+        if (ThreadIndex == 0)
+        {
+            uint ChunkCount = 0;
+            for (uint i = 0; i < THREADS_PER_DRAW; ++i)
+            {
+                ChunkCount += VisibleFlags[i];
+            }
+
+            VisibleCount += ChunkCount;
+        }
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    if (ThreadIndex == 0)
+    {
+        DrawCommand Command;
+        Command.IndexCount = Draw.IndexCount;
+        Command.InstanceCount = VisibleCount;
+        Command.FirstIndex = Draw.FirstIndex;
+        Command.VertexOffset = Draw.VertexOffset;
+        Command.FirstInstance = Draw.FirstInstance;
+        Commands[DrawID] = Command;
+    }
+}
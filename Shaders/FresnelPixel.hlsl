@@ -1,6 +1,3 @@
-#define MAX_SUBMESH_PER_DRAW 512
-#define MAX_LIGHTS_PER_DRAW 16
-
 #define TEXTURE_DIFFUSE_FLAG 0x00000001
 #define TEXTURE_SPECULAR_FLAG 0x00000002
 #define TEXTURE_NORMAL_FLAG 0x00000003
@@ -25,6 +22,12 @@ struct Material
     uint IlluminationModel;
 };
 
+struct DirectionalLight
+{
+    float4 Direction;
+    float4 Color;
+};
+
 struct PointLight
 {
 	/* W component is used for strength of the point light */
@@ -46,29 +49,27 @@ struct SpotLight
     float4 ConeDirection;
 };
 
+/* Dequantizes packed vertex positions, one per static mesh, indexed by the draw's DequantizationID */
+struct PositionDequantization
+{
+    float4 Scale;
+    float4 Offset;
+};
+
 struct SceneDataGlobal
 {
 	/* Globally shared model information */
     float4x4 View[3];
     float4x4 Projection;
 
-	/* Lighting Information */
-    float4 LightDirection;
-    float4 LightColor;
+	/* Lighting Information */    
     float4 SunAmbient;
     float4 CameraWorldPosition;
-    
-    /* Per sub-mesh transform and material data */
-    float4x4 Matrices[MAX_SUBMESH_PER_DRAW]; // World space matrices
-    Material Materials[MAX_SUBMESH_PER_DRAW]; // color/texture of surface info of all meshes
-    
-    PointLight PointLights[MAX_LIGHTS_PER_DRAW];
-
-    SpotLight SpotLights[MAX_LIGHTS_PER_DRAW];
 
 	/* 16-byte padding for the lights,
 	* X component -> num of point lights
 	* Y component -> num of spot lights
+	* Z component -> num of dir lights
 	*/
     float4 NumOfLights;
 };
@@ -77,6 +78,47 @@ struct SceneDataGlobal
 [[vk::binding(0)]]
 StructuredBuffer<SceneDataGlobal> SceneData;
 
+/* Per sub-mesh transform and material data, sized by the level */
+[[vk::binding(1)]]
+StructuredBuffer<float4x4> Matrices; // World space matrices
+[[vk::binding(2)]]
+StructuredBuffer<Material> Materials; // color/texture of surface info of all meshes
+
+[[vk::binding(3)]]
+StructuredBuffer<DirectionalLight> DirectionalLights;
+[[vk::binding(4)]]
+StructuredBuffer<PointLight> PointLights;
+[[vk::binding(5)]]
+StructuredBuffer<SpotLight> SpotLights;
+
+[[vk::binding(6)]]
+StructuredBuffer<PositionDequantization> PositionDequantizations;
+
+/* Per draw IDs, indexed by the draw ID the vertex shader passes on */
+struct DrawData
+{
+    uint MeshID;
+    uint MaterialID;
+    uint DiffuseTextureID;
+    uint SpecularTextureID;
+    uint NormalTextureID;
+    uint FirstInstance;
+    uint InstanceCount;
+    uint IndexCount; // command arguments, for the culling pass
+    uint FirstIndex;
+    int VertexOffset;
+    uint DequantizationID; // PositionDequantizations of the draw's mesh
+    uint Padding;
+    float4 BoundsCenter; // mesh space AABB
+    float4 BoundsExtents;
+};
+
+[[vk::binding(7)]]
+StructuredBuffer<DrawData> Draws;
+
+/* Draw of the pixel, set first thing in main() */
+static DrawData Draw;
+
 [[vk::push_constant]]
 cbuffer ConstantBuffer
 {
@@ -103,6 +145,7 @@ struct PixelIn
     float3 PositionWorld : WORLD; // position in world space
     float3 Normal : NORMAL0; // normal in world space
     float2 UV : TEXCOORD0;
+    nointerpolation uint DrawID : DRAWID;
 };
 
 float4 CalcDirectionalLight(float3 lightDir, float3 surfaceNormal, float3 viewDirection, float4 diffuseColor, float2 uv)//, float specIntensity)
@@ -112,50 +155,50 @@ float4 CalcDirectionalLight(float3 lightDir, float3 surfaceNormal, float3 viewDi
     /* Specular Component */  
     float3 HalfVector = normalize(reflect(lightDir, surfaceNormal));
     float SpecIntensity = 1.0f;     
-    if (SceneData[0].Materials[MaterialID].TextureFlags & TEXTURE_SPECULAR_FLAG)
+    if (Materials[Draw.MaterialID].TextureFlags & TEXTURE_SPECULAR_FLAG)
     {
-        SpecIntensity = TextureMaps[SpecularTextureID].Sample(Sampler[SpecularTextureID], uv);
+        SpecIntensity = TextureMaps[Draw.SpecularTextureID].Sample(Sampler[Draw.SpecularTextureID], uv);
     }
     
-    float SpecularExponent = (SceneData[0].Materials[MaterialID].SpecularExponent != 0) ? SceneData[0].Materials[MaterialID].SpecularExponent : 96;
+    float SpecularExponent = (Materials[Draw.MaterialID].SpecularExponent != 0) ? Materials[Draw.MaterialID].SpecularExponent : 96;
     float Intensity = max(pow(saturate(dot(viewDirection, HalfVector)), SpecularExponent), 0);
         
-    float4 ReflectedLight = float4(SceneData[0].Materials[MaterialID].SpecularColor, 1.0f) * 1.0f * Intensity * SpecIntensity;
+    float4 ReflectedLight = float4(Materials[Draw.MaterialID].SpecularColor, 1.0f) * 1.0f * Intensity * SpecIntensity;
     
-    return (LightRatio * SceneData[0].LightDirection.w) * SceneData[0].LightColor * diffuseColor + ReflectedLight;
+    return (LightRatio * DirectionalLights[0].Direction.w) * DirectionalLights[0].Color * diffuseColor + ReflectedLight;
 }
 
 float4 CalcPointLight(uint pointLightIndex, float3 pixelPositionWorld, float3 surfaceNormal, float4 diffuseColor)
 {
-    float3 DistanceFromPixel = SceneData[0].PointLights[pointLightIndex].Position.xyz - pixelPositionWorld;
+    float3 DistanceFromPixel = PointLights[pointLightIndex].Position.xyz - pixelPositionWorld;
     float3 PointLightDir = normalize(DistanceFromPixel);
     
-    float LightRatio = saturate(dot(PointLightDir, surfaceNormal)) * SceneData[0].PointLights[pointLightIndex].Position.w;
+    float LightRatio = saturate(dot(PointLightDir, surfaceNormal)) * PointLights[pointLightIndex].Position.w;
     
-    float Attenuation = 1.0f - saturate(length(DistanceFromPixel) / SceneData[0].PointLights[pointLightIndex].Color.w);
+    float Attenuation = 1.0f - saturate(length(DistanceFromPixel) / PointLights[pointLightIndex].Color.w);
     Attenuation *= Attenuation;
     
-    return Attenuation * LightRatio * float4(SceneData[0].PointLights[pointLightIndex].Color.xyz * diffuseColor.xyz, 1);
+    return Attenuation * LightRatio * float4(PointLights[pointLightIndex].Color.xyz * diffuseColor.xyz, 1);
 }
 
 float4 CalcSpotLight(uint spotLightIndex, float3 pixelPositionWorld, float3 surfaceNormal, float4 diffuseColor)
 {
-    float3 DistanceFromPixel = SceneData[0].SpotLights[spotLightIndex].Position.xyz - pixelPositionWorld;
+    float3 DistanceFromPixel = SpotLights[spotLightIndex].Position.xyz - pixelPositionWorld;
     float3 SpotLightDir = normalize(DistanceFromPixel);
     
-    float SurfaceRatio = saturate(dot(-SpotLightDir, SceneData[0].SpotLights[spotLightIndex].ConeDirection.xyz));
-    float SpotFactor = (SurfaceRatio > SceneData[0].SpotLights[spotLightIndex].Color.w) ? 1 : 0;
+    float SurfaceRatio = saturate(dot(-SpotLightDir, SpotLights[spotLightIndex].ConeDirection.xyz));
+    float SpotFactor = (SurfaceRatio > SpotLights[spotLightIndex].Color.w) ? 1 : 0;
 
-    float LightRatio = saturate(dot(SpotLightDir, surfaceNormal)) * SceneData[0].SpotLights[spotLightIndex].Position.w;
+    float LightRatio = saturate(dot(SpotLightDir, surfaceNormal)) * SpotLights[spotLightIndex].Position.w;
     
-    float InnerConeRatio = SceneData[0].SpotLights[spotLightIndex].Color.w;
-    float OuterConeRatio = SceneData[0].SpotLights[spotLightIndex].ConeDirection.w;
+    float InnerConeRatio = SpotLights[spotLightIndex].Color.w;
+    float OuterConeRatio = SpotLights[spotLightIndex].ConeDirection.w;
     
     // Attenuation calculation
     float Attenuation = 1.0f - saturate((InnerConeRatio - SurfaceRatio) / (InnerConeRatio - OuterConeRatio));
     Attenuation *= Attenuation;
     
-    return Attenuation * SpotFactor * LightRatio * float4(SceneData[0].SpotLights[spotLightIndex].Color.xyz * diffuseColor.xyz, 1);
+    return Attenuation * SpotFactor * LightRatio * float4(SpotLights[spotLightIndex].Color.xyz * diffuseColor.xyz, 1);
 }
 
 float3x3 Inverse3x3(float3x3 mat)
@@ -191,7 +234,7 @@ float3x3 CotangentFrame(float3 normal, float3 viewDir, float2 uv)
 float3 PreturbNormal(float3 normal, float3 v, float2 texCoord)
 {
     // assume N, the interpolated vertex normal and V, the view vector (vertex to eye)
-    float3 Map = normalize(TextureMaps[NormalTextureID].Sample(Sampler[NormalTextureID], texCoord).xyz * 2.0f - 1.0f);
+    float3 Map = normalize(TextureMaps[Draw.NormalTextureID].Sample(Sampler[Draw.NormalTextureID], texCoord).xyz * 2.0f - 1.0f);
     float3x3 TBN = CotangentFrame(normal, -v, texCoord);
     //Map.y = -Map.y;
     return normalize(mul(Map, TBN));
@@ -206,6 +249,8 @@ float Fresnel(float start, float end, float normalDotView)
 // TODO: Part 4b
 float4 main(PixelIn input) : SV_TARGET
 {
+    Draw = Draws[input.DrawID];
+
     float3 SurfaceNormal = normalize(input.Normal);
     float3 ViewDirection = normalize(SceneData[0].CameraWorldPosition.xyz - input.PositionWorld);
     
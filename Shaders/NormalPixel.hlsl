@@ -1,6 +1,3 @@
-#define MAX_SUBMESH_PER_DRAW 512
-#define MAX_LIGHTS_PER_DRAW 16
-
 #define TEXTURE_DIFFUSE_FLAG 0x00000002
 #define TEXTURE_SPECULAR_FLAG 0x00000004
 #define TEXTURE_NORMAL_FLAG 0x00000008
@@ -52,6 +49,13 @@ struct SpotLight
     float4 ConeDirection;
 };
 
+/* Dequantizes packed vertex positions, one per static mesh, indexed by the draw's DequantizationID */
+struct PositionDequantization
+{
+    float4 Scale;
+    float4 Offset;
+};
+
 struct SceneDataGlobal
 {
 	/* Globally shared model information */
@@ -61,20 +65,11 @@ struct SceneDataGlobal
 	/* Lighting Information */    
     float4 SunAmbient;
     float4 CameraWorldPosition;
-    
-    /* Per sub-mesh transform and material data */
-    float4x4 Matrices[MAX_SUBMESH_PER_DRAW]; // World space matrices
-    Material Materials[MAX_SUBMESH_PER_DRAW]; // color/texture of surface info of all meshes    
-    
-    DirectionalLight DirectionalLights[MAX_LIGHTS_PER_DRAW];
-    
-    PointLight PointLights[MAX_LIGHTS_PER_DRAW];
-
-    SpotLight SpotLights[MAX_LIGHTS_PER_DRAW];
 
 	/* 16-byte padding for the lights,
 	* X component -> num of point lights
 	* Y component -> num of spot lights
+	* Z component -> num of dir lights
 	*/
     float4 NumOfLights;
 };
@@ -83,6 +78,47 @@ struct SceneDataGlobal
 [[vk::binding(0)]]
 StructuredBuffer<SceneDataGlobal> SceneData;
 
+/* Per sub-mesh transform and material data, sized by the level */
+[[vk::binding(1)]]
+StructuredBuffer<float4x4> Matrices; // World space matrices
+[[vk::binding(2)]]
+StructuredBuffer<Material> Materials; // color/texture of surface info of all meshes
+
+[[vk::binding(3)]]
+StructuredBuffer<DirectionalLight> DirectionalLights;
+[[vk::binding(4)]]
+StructuredBuffer<PointLight> PointLights;
+[[vk::binding(5)]]
+StructuredBuffer<SpotLight> SpotLights;
+
+[[vk::binding(6)]]
+StructuredBuffer<PositionDequantization> PositionDequantizations;
+
+/* Per draw IDs, indexed by the draw ID the vertex shader passes on */
+struct DrawData
+{
+    uint MeshID;
+    uint MaterialID;
+    uint DiffuseTextureID;
+    uint SpecularTextureID;
+    uint NormalTextureID;
+    uint FirstInstance;
+    uint InstanceCount;
+    uint IndexCount; // command arguments, for the culling pass
+    uint FirstIndex;
+    int VertexOffset;
+    uint DequantizationID; // PositionDequantizations of the draw's mesh
+    uint Padding;
+    float4 BoundsCenter; // mesh space AABB
+    float4 BoundsExtents;
+};
+
+[[vk::binding(7)]]
+StructuredBuffer<DrawData> Draws;
+
+/* Draw of the pixel, set first thing in main() */
+static DrawData Draw;
+
 [[vk::push_constant]]
 cbuffer ConstantBuffer
 {
@@ -109,6 +145,7 @@ struct PixelIn
     float3 PositionWorld : WORLD; // position in world space
     float3 Normal : NORMAL0; // normal in world space
     float2 UV : TEXCOORD0;
+    nointerpolation uint DrawID : DRAWID;
 };
 
 float CalcSpecularIntensity(float specularExponent, float3 lightDir, float3 viewDirection, float3 surfaceNormal)
@@ -120,36 +157,36 @@ float CalcSpecularIntensity(float specularExponent, float3 lightDir, float3 view
 float4 CalcDirectionalLight(uint dirLightIndex, float3 surfaceNormal, float4 lightDirection)//, float specIntensity)
 {
     float LightRatio = saturate(dot(-lightDirection.xyz, surfaceNormal));    
-    return (LightRatio * lightDirection.w) * SceneData[0].DirectionalLights[dirLightIndex].Color;
+    return (LightRatio * lightDirection.w) * DirectionalLights[dirLightIndex].Color;
 }
 
 float4 CalcPointLight(uint pointLightIndex, float3 pointLightDir, float3 distanceFromPixel, float3 surfaceNormal)
 {    
-    float LightRatio = saturate(dot(pointLightDir, surfaceNormal)) * SceneData[0].PointLights[pointLightIndex].Position.w;
+    float LightRatio = saturate(dot(pointLightDir, surfaceNormal)) * PointLights[pointLightIndex].Position.w;
     
-    float Attenuation = 1.0f - saturate(length(distanceFromPixel) / SceneData[0].PointLights[pointLightIndex].Color.w);
+    float Attenuation = 1.0f - saturate(length(distanceFromPixel) / PointLights[pointLightIndex].Color.w);
     Attenuation *= Attenuation;
     
-    float3 LightColor = LightRatio * SceneData[0].PointLights[pointLightIndex].Color.xyz;
+    float3 LightColor = LightRatio * PointLights[pointLightIndex].Color.xyz;
     
     return Attenuation * float4(LightColor, 1);
 }
 
 float4 CalcSpotLight(uint spotLightIndex, float3 spotLightDir, float3 pixelPositionWorld, float3 surfaceNormal)
 {    
-    float SurfaceRatio = saturate(dot(-spotLightDir, SceneData[0].SpotLights[spotLightIndex].ConeDirection.xyz));
-    float SpotFactor = (SurfaceRatio > SceneData[0].SpotLights[spotLightIndex].Color.w) ? 1 : 0;
+    float SurfaceRatio = saturate(dot(-spotLightDir, SpotLights[spotLightIndex].ConeDirection.xyz));
+    float SpotFactor = (SurfaceRatio > SpotLights[spotLightIndex].Color.w) ? 1 : 0;
 
-    float LightRatio = saturate(dot(spotLightDir, surfaceNormal)) * SceneData[0].SpotLights[spotLightIndex].Position.w;
+    float LightRatio = saturate(dot(spotLightDir, surfaceNormal)) * SpotLights[spotLightIndex].Position.w;
     
-    float InnerConeRatio = SceneData[0].SpotLights[spotLightIndex].Color.w;
-    float OuterConeRatio = SceneData[0].SpotLights[spotLightIndex].ConeDirection.w;
+    float InnerConeRatio = SpotLights[spotLightIndex].Color.w;
+    float OuterConeRatio = SpotLights[spotLightIndex].ConeDirection.w;
     
     // Attenuation calculation
     float Attenuation = 1.0f - saturate((InnerConeRatio - SurfaceRatio) / (InnerConeRatio - OuterConeRatio));
     Attenuation *= Attenuation;
     
-    float3 LightColor = SpotFactor * LightRatio * SceneData[0].SpotLights[spotLightIndex].Color.xyz;
+    float3 LightColor = SpotFactor * LightRatio * SpotLights[spotLightIndex].Color.xyz;
     
     return Attenuation * float4(LightColor, 1);
 }
@@ -187,7 +224,7 @@ float3x3 CotangentFrame(float3 normal, float3 viewDir, float2 uv)
 float3 PreturbNormal(float3 normal, float3 v, float2 texCoord)
 {
     // assume N, the interpolated vertex normal and V, the view vector (vertex to eye)
-    float3 Map = normalize(TextureMaps[NormalTextureID].Sample(Sampler[NormalTextureID], texCoord).xyz * 2.0f - 1.0f);
+    float3 Map = normalize(TextureMaps[Draw.NormalTextureID].Sample(Sampler[Draw.NormalTextureID], texCoord).xyz * 2.0f - 1.0f);
     float3x3 TBN = CotangentFrame(normal, -v, texCoord);
     //Map.y = -Map.y;
     return normalize(mul(Map, TBN));
@@ -197,74 +234,76 @@ float3 PreturbNormal(float3 normal, float3 v, float2 texCoord)
 // TODO: Part 4b
 float4 main(PixelIn input) : SV_TARGET
 {
-    float4 DiffuseColor = float4(SceneData[0].Materials[MaterialID].Diffuse, 1.0f);
-    if (SceneData[0].Materials[MaterialID].TextureFlags & TEXTURE_DIFFUSE_FLAG)
+    Draw = Draws[input.DrawID];
+
+    float4 DiffuseColor = float4(Materials[Draw.MaterialID].Diffuse, 1.0f);
+    if (Materials[Draw.MaterialID].TextureFlags & TEXTURE_DIFFUSE_FLAG)
     {
-        DiffuseColor = TextureMaps[DiffuseTextureID].Sample(Sampler[DiffuseTextureID], input.UV);
+        DiffuseColor = TextureMaps[Draw.DiffuseTextureID].Sample(Sampler[Draw.DiffuseTextureID], input.UV);
     }
     
     float3 SurfaceNormal = normalize(input.Normal);
     float3 ViewDirection = normalize(SceneData[0].CameraWorldPosition.xyz - input.PositionWorld);
     
-    if (SceneData[0].Materials[MaterialID].TextureFlags & TEXTURE_NORMAL_FLAG)
+    if (Materials[Draw.MaterialID].TextureFlags & TEXTURE_NORMAL_FLAG)
     {
         SurfaceNormal = PreturbNormal(SurfaceNormal, ViewDirection, input.UV);
     }
     //return float4(SurfaceNormal, 1.0f);    
     
    /* Specular */
-    float SpecularExponent = (SceneData[0].Materials[MaterialID].SpecularExponent != 0) ? SceneData[0].Materials[MaterialID].SpecularExponent : 96;
+    float SpecularExponent = (Materials[Draw.MaterialID].SpecularExponent != 0) ? Materials[Draw.MaterialID].SpecularExponent : 96;
     
     float4 SpecularLight = float4(0, 0, 0, 1);
     float4 DirectLight = float4(0, 0, 0, 1);
     
     for (uint i = 0; i < (uint) SceneData[0].NumOfLights.x; i++)
     {
-        float4 LightDirection = SceneData[0].DirectionalLights[i].Direction;
+        float4 LightDirection = DirectionalLights[i].Direction;
         
         /* Specular Component */
         float SpecIntensity = CalcSpecularIntensity(SpecularExponent, LightDirection.xyz, ViewDirection, SurfaceNormal);
-        if (SceneData[0].Materials[MaterialID].TextureFlags & TEXTURE_SPECULAR_FLAG)
+        if (Materials[Draw.MaterialID].TextureFlags & TEXTURE_SPECULAR_FLAG)
         {
-            SpecIntensity *= TextureMaps[SpecularTextureID].Sample(Sampler[SpecularTextureID], input.UV);
+            SpecIntensity *= TextureMaps[Draw.SpecularTextureID].Sample(Sampler[Draw.SpecularTextureID], input.UV);
         }    
     
-        SpecularLight += float4(SceneData[0].Materials[MaterialID].SpecularColor, 1.0f) * SpecIntensity;
+        SpecularLight += float4(Materials[Draw.MaterialID].SpecularColor, 1.0f) * SpecIntensity;
         DirectLight += CalcDirectionalLight(i, SurfaceNormal, LightDirection);
     }
     
     for (uint i = 0; i < (uint) SceneData[0].NumOfLights.x; i++)
     {
-        float3 DistanceFromPixel = SceneData[0].PointLights[i].Position.xyz - input.PositionWorld;
+        float3 DistanceFromPixel = PointLights[i].Position.xyz - input.PositionWorld;
         float3 PointLightDir = normalize(DistanceFromPixel);
        
         /* Specular Component */
         float SpecIntensity = CalcSpecularIntensity(SpecularExponent, PointLightDir, ViewDirection, SurfaceNormal);
-        if (SceneData[0].Materials[MaterialID].TextureFlags & TEXTURE_SPECULAR_FLAG)
+        if (Materials[Draw.MaterialID].TextureFlags & TEXTURE_SPECULAR_FLAG)
         {
-            SpecIntensity *= TextureMaps[SpecularTextureID].Sample(Sampler[SpecularTextureID], input.UV);
+            SpecIntensity *= TextureMaps[Draw.SpecularTextureID].Sample(Sampler[Draw.SpecularTextureID], input.UV);
         }
         float4 LightResult = CalcPointLight(i, PointLightDir, DistanceFromPixel, SurfaceNormal);
         DirectLight += LightResult;
-        SpecularLight += float4(SceneData[0].Materials[MaterialID].SpecularColor, 1.0f) * SpecIntensity * LightResult.w;
+        SpecularLight += float4(Materials[Draw.MaterialID].SpecularColor, 1.0f) * SpecIntensity * LightResult.w;
     }
     
     for (uint i = 0; i < (uint) SceneData[0].NumOfLights.y; i++)
     {
-        float3 DistanceFromPixel = SceneData[0].SpotLights[i].Position.xyz - input.PositionWorld;
+        float3 DistanceFromPixel = SpotLights[i].Position.xyz - input.PositionWorld;
         float3 SpotLightDir = normalize(DistanceFromPixel);
         
          /* Specular Component */
         float SpecIntensity = CalcSpecularIntensity(SpecularExponent, SpotLightDir, ViewDirection, SurfaceNormal);
-        if (SceneData[0].Materials[MaterialID].TextureFlags & TEXTURE_SPECULAR_FLAG)
+        if (Materials[Draw.MaterialID].TextureFlags & TEXTURE_SPECULAR_FLAG)
         {
-            SpecIntensity *= TextureMaps[SpecularTextureID].Sample(Sampler[SpecularTextureID], input.UV);
+            SpecIntensity *= TextureMaps[Draw.SpecularTextureID].Sample(Sampler[Draw.SpecularTextureID], input.UV);
         }
         
         float4 LightResult = CalcSpotLight(i, SpotLightDir, input.PositionWorld, SurfaceNormal);
         DirectLight += LightResult;
         
-        SpecularLight += float4(SceneData[0].Materials[MaterialID].SpecularColor, 1.0f) * SpecIntensity * LightResult.w;
+        SpecularLight += float4(Materials[Draw.MaterialID].SpecularColor, 1.0f) * SpecIntensity * LightResult.w;
     }
     
     return saturate(DirectLight + SceneData[0].SunAmbient) * DiffuseColor + SpecularLight;
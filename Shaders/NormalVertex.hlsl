@@ -1,8 +1,5 @@
 #pragma pack_matrix(row_major)
 
-#define MAX_SUBMESH_PER_DRAW 512
-#define MAX_LIGHTS_PER_DRAW 16
-
 struct Material
 {
     float3 Diffuse;
@@ -43,6 +40,13 @@ struct SpotLight
     float4 ConeDirection;
 };
 
+/* Dequantizes packed vertex positions, one per static mesh, indexed by the draw's DequantizationID */
+struct PositionDequantization
+{
+    float4 Scale;
+    float4 Offset;
+};
+
 struct SceneDataGlobal
 {
 	/* Globally shared model information */
@@ -52,20 +56,11 @@ struct SceneDataGlobal
 	/* Lighting Information */    
     float4 SunAmbient;
     float4 CameraWorldPosition;
-    
-    /* Per sub-mesh transform and material data */
-    float4x4 Matrices[MAX_SUBMESH_PER_DRAW]; // World space matrices
-    Material Materials[MAX_SUBMESH_PER_DRAW]; // color/texture of surface info of all meshes    
-    
-    DirectionalLight DirectionalLights[MAX_LIGHTS_PER_DRAW];
-    
-    PointLight PointLights[MAX_LIGHTS_PER_DRAW];
-
-    SpotLight SpotLights[MAX_LIGHTS_PER_DRAW];
 
 	/* 16-byte padding for the lights,
 	* X component -> num of point lights
 	* Y component -> num of spot lights
+	* Z component -> num of dir lights
 	*/
     float4 NumOfLights;
 };
@@ -74,6 +69,52 @@ struct SceneDataGlobal
 [[vk::binding(0)]]
 StructuredBuffer<SceneDataGlobal> SceneData;
 
+/* Per sub-mesh transform and material data, sized by the level */
+[[vk::binding(1)]]
+StructuredBuffer<float4x4> Matrices; // World space matrices
+[[vk::binding(2)]]
+StructuredBuffer<Material> Materials; // color/texture of surface info of all meshes
+
+[[vk::binding(3)]]
+StructuredBuffer<DirectionalLight> DirectionalLights;
+[[vk::binding(4)]]
+StructuredBuffer<PointLight> PointLights;
+[[vk::binding(5)]]
+StructuredBuffer<SpotLight> SpotLights;
+
+[[vk::binding(6)]]
+StructuredBuffer<PositionDequantization> PositionDequantizations;
+
+/* Per draw IDs, indexed by draw ID */
+struct DrawData
+{
+    uint MeshID;
+    uint MaterialID;
+    uint DiffuseTextureID;
+    uint SpecularTextureID;
+    uint NormalTextureID;
+    uint FirstInstance; // firstInstance of the draw's command
+    uint InstanceCount;
+    uint IndexCount; // command arguments, for the culling pass
+    uint FirstIndex;
+    int VertexOffset;
+    uint DequantizationID; // PositionDequantizations of the draw's mesh
+    uint Padding;
+    float4 BoundsCenter; // mesh space AABB
+    float4 BoundsExtents;
+};
+
+[[vk::binding(7)]]
+StructuredBuffer<DrawData> Draws;
+
+/* Draw ID of every instance, the draws' instance ranges do not overlap */
+[[vk::binding(8)]]
+StructuredBuffer<uint> InstanceDraws;
+
+/* Instance of the draw's mesh in every slot, compacted by the culling pass */
+[[vk::binding(9)]]
+StructuredBuffer<uint> VisibleInstances;
+
 [[vk::push_constant]]
 cbuffer ConstantBuffer
 {
@@ -89,12 +130,12 @@ cbuffer ConstantBuffer
     uint NormalTextureID;
 };
 
+/* PackedVertex */
 struct VertexIn
 {
-    [[vk::location(0)]] float2 UV : TEXTCOORD0;
-    [[vk::location(1)]] float3 Position : POSITION;
-    [[vk::location(2)]] float3 Normal : NORMAL0;
-    [[vk::location(3)]] float4 Color : COLOR0;
+    [[vk::location(0)]] float4 Position : POSITION; // unorm16, inside the mesh bounds
+    [[vk::location(1)]] float2 Normal : NORMAL0; // octahedral snorm16
+    [[vk::location(2)]] float2 UV : TEXTCOORD0; // half floats
 };
 
 struct VertexOut
@@ -104,22 +145,40 @@ struct VertexOut
     float3 PositionWorld : WORLD; // position in world space
     float3 Normal : NORMAL0; // normal in world space
     float2 UV : TEXCOORD0;
+    nointerpolation uint DrawID : DRAWID;
 };
 
+/* Inverse of the octahedral encoding, lower hemisphere was folded over the diagonals */
+float3 OctDecode(float2 encoded)
+{
+    float3 Normal = float3(encoded.x, encoded.y, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float T = saturate(-Normal.z);
+    Normal.x += Normal.x >= 0.0f ? -T : T;
+    Normal.y += Normal.y >= 0.0f ? -T : T;
+    return normalize(Normal);
+}
+
 VertexOut main(VertexIn inputVertex, uint InstanceID : SV_INSTANCEID)
 {
     VertexOut output;
 	
-    output.Position = float4(inputVertex.Position, 1);
+    /* InstanceID includes the command's firstInstance */
+    uint DrawID = InstanceDraws[InstanceID];
+    DrawData Draw = Draws[DrawID];
+    uint MatrixID = Draw.MeshID + VisibleInstances[InstanceID];
+    
+    float3 Position = inputVertex.Position.xyz * PositionDequantizations[Draw.DequantizationID].Scale.xyz + PositionDequantizations[Draw.DequantizationID].Offset.xyz;
+    output.Position = float4(Position, 1);
     
-    output.Position = mul(output.Position, SceneData[0].Matrices[MeshID + InstanceID]);
+    output.Position = mul(output.Position, Matrices[MatrixID]);
     output.PositionWorld = output.Position;
     output.Position = mul(output.Position, SceneData[0].View[ViewMatID]);
     output.Position = mul(output.Position, SceneData[0].Projection);
     
-    output.Color = inputVertex.Color;
-    output.Normal = mul(float4(inputVertex.Normal, 0.0f), SceneData[0].Matrices[MeshID + InstanceID]).xyz;
+    output.Color = float4(0.5f, 0.5f, 0.5f, 1.0f);
+    output.Normal = mul(float4(OctDecode(inputVertex.Normal), 0.0f), Matrices[MatrixID]).xyz;
     output.UV = inputVertex.UV;
+    output.DrawID = DrawID;
     
     return output;
 }
\ No newline at end of file
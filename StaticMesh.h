@@ -7,6 +7,7 @@
 /*
 * A Collection of Meshes in one
 *		IndexOffset -> index offset into the collection of meshes indices
+*		IndexSizeInBytes -> 2 or 4, which of the level's index buffers IndexOffset is in
 *		MaterialIndex -> Index of the first material into the collection of materials
 *		WorldMatrixIndex -> index of the first world matrix into the collection of world matrices
 */
@@ -22,6 +23,7 @@ public:
 
 	uint32 VertexOffset;
 	uint32 IndexOffset;
+	uint32 IndexSizeInBytes;
 
 	uint32 MaterialIndex;
 	uint32 WorldMatrixIndex;
@@ -30,7 +32,8 @@ public:
 
 	/* Per Static Mesh Informations */
 private:
-	Matrix4D* Transformation;
+	/* The level's world matrices, this mesh's transform is at WorldMatrixIndex. Held by index so the array can grow */
+	std::vector<Matrix4D>* WorldMatrices;
 
 	/* X, Y, Z translation vector */
 	Vector3D Translation;
@@ -46,25 +49,25 @@ public:
 
 public:
 	StaticMesh(uint32 vertexCount, uint32 vertexOffset, uint32 indexCount, uint32 indexOffset, uint32 materialCount,
-		uint32 materialIndex, uint32 meshCount, uint32 instanceCount, uint32 worldMatrixIndex, Matrix4D* transformMatrix)
-		: VertexCount(vertexCount), VertexOffset(vertexOffset), IndexOffset(indexOffset),
-		IndexCount(indexCount),	MaterialCount(materialCount), 
-		MaterialIndex(materialIndex), MeshCount(meshCount), InstanceCount(instanceCount), 
-		WorldMatrixIndex(worldMatrixIndex)
+		uint32 materialIndex, uint32 meshCount, uint32 instanceCount, uint32 worldMatrixIndex, std::vector<Matrix4D>* worldMatrices)
+		: VertexCount(vertexCount), IndexCount(indexCount), MaterialCount(materialCount), MeshCount(meshCount),
+		InstanceCount(instanceCount), VertexOffset(vertexOffset), IndexOffset(indexOffset),
+		MaterialIndex(materialIndex), WorldMatrixIndex(worldMatrixIndex)
 	{
-		Transformation = transformMatrix;
+		WorldMatrices = worldMatrices;
+		IndexSizeInBytes = sizeof(uint32);
 
-		Vector4D TranslationVector = (*transformMatrix)[3];
+		Vector4D TranslationVector = Transformation()[3];
 		Translation = Vector3D(TranslationVector.X, TranslationVector.Y, TranslationVector.Z);
 
-		Rotation = transformMatrix->GetEulerAngles();
+		Rotation = Transformation().GetEulerAngles();
 	}
 
 public:
 	void Update()
 	{
-		*Transformation = Matrix4D::MakeRotation(Rotation);
-		Transformation->SetTranslation(Translation);
+		Transformation() = Matrix4D::MakeRotation(Rotation);
+		Transformation().SetTranslation(Translation);
 	}
 
 public:
@@ -81,14 +84,14 @@ public:
 		Translation.Y = y;
 		Translation.Z = z;
 
-		Transformation->SetTranslation(Translation);
+		Transformation().SetTranslation(Translation);
 	}
 
 	/* Translate the model via vector3D translation vector */
 	void TranslateLocal(Vector3D translation)
 	{
 		Translation += translation;
-		Transformation->SetTranslation(Translation);
+		Transformation().SetTranslation(Translation);
 	}
 
 	/* Rotate the model with yaw, pitch, roll */
@@ -123,7 +126,7 @@ public:
 
 	void SetTransformMatrix(Matrix4D& mat)
 	{
-		*Transformation = mat;
+		Transformation() = mat;
 	}
 
 	Vector4D GetTranslation() const
@@ -133,7 +136,7 @@ public:
 
 	Matrix4D GetTransformMatrix() const
 	{
-		return *Transformation;
+		return (*WorldMatrices)[WorldMatrixIndex];
 	}
 
 	/*--------------------------------------------------DEBUG-------------------------------------------------------*/
@@ -192,6 +195,11 @@ public:
 		return IndexOffset;
 	}
 
+	uint32 GetIndexSizeInBytes() const
+	{
+		return IndexSizeInBytes;
+	}
+
 	uint32 GetMaterialCount() const
 	{
 		return MaterialCount;
@@ -216,4 +224,10 @@ public:
 	{
 		return WorldMatrixIndex;
 	}
+
+private:
+	Matrix4D& Transformation()
+	{
+		return (*WorldMatrices)[WorldMatrixIndex];
+	}
 };
@@ -0,0 +1,122 @@
+#pragma once
+#include <vector>
+
+#include "FrameRingBuffer.h"
+
+/*
+* A std::vector mirrored in a storage buffer (StructuredBuffer<T> in the shaders), sized by its contents instead of a fixed array
+*	Elements can be changed and appended to freely, MarkDirty() what was changed in place, Flush() picks up appends and reallocations
+*	The buffer is recreated at twice the size once Elements outgrows it, see NeedsToGrow()
+*/
+template<typename T>
+class StorageArray
+{
+public:
+	/* CPU copy, what the shaders see after the next Flush() */
+	std::vector<T> Elements;
+
+private:
+	FrameRingBuffer Ring;
+
+	/* Kept for Grow() */
+	VkBufferUsageFlags Usage;
+
+public:
+	StorageArray()
+	{
+		Usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+	}
+
+	StorageArray(const StorageArray& other) = delete;
+	StorageArray& operator=(const StorageArray& other) = delete;
+
+public:
+	/* Creates the buffer with room for at least Elements.size() elements, usage is for arrays that are more than a storage buffer */
+	bool Create(VkPhysicalDevice physicalDevice, VkDevice* device, uint32 frameCount, size_t minCapacity = 1,
+		VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+	{
+		size_t Capacity = Elements.size() > minCapacity ? Elements.size() : minCapacity;
+		Capacity = Capacity > 0 ? Capacity : 1;
+
+		Usage = usage;
+		return Ring.Create(physicalDevice, device, frameCount, Elements.data(), Elements.size() * sizeof(T),
+			Capacity * sizeof(T), Usage);
+	}
+
+	void Destroy()
+	{
+		Ring.Destroy();
+	}
+
+	/* Elements no longer fit, the buffer has to be recreated with Grow() once the GPU is done with it */
+	bool NeedsToGrow() const
+	{
+		return Elements.size() > GetCapacity();
+	}
+
+	/* Recreates the buffer, descriptors pointing at the old one have to be rewritten */
+	bool Grow(VkPhysicalDevice physicalDevice, VkDevice* device, uint32 frameCount)
+	{
+		return Create(physicalDevice, device, frameCount, GetCapacity() * 2, Usage);
+	}
+
+	/* count elements starting at first were changed in place */
+	void MarkDirty(size_t first, size_t count = 1)
+	{
+		Ring.MarkDirtyOffset(first * sizeof(T), count * sizeof(T));
+	}
+
+	/* Copies what changed into frameIndex's slice, @returns the bytes written */
+	size_t Flush(uint32 frameIndex)
+	{
+		/* Appends and reallocations only move the shadow, they do not go through MarkDirty() */
+		if (!Ring.SetShadow(Elements.data(), Elements.size() * sizeof(T)))
+		{
+			/* Needs to grow first, the old shadow may be gone */
+			return 0;
+		}
+
+		return Ring.Flush(frameIndex);
+	}
+
+	T& operator[](size_t index)
+	{
+		return Elements[index];
+	}
+
+	const T& operator[](size_t index) const
+	{
+		return Elements[index];
+	}
+
+	size_t Size() const
+	{
+		return Elements.size();
+	}
+
+	/* In elements */
+	size_t GetCapacity() const
+	{
+		return Ring.GetCapacity() / sizeof(T);
+	}
+
+	VkBuffer GetHandle() const
+	{
+		return Ring.GetHandle();
+	}
+
+	VkDeviceSize GetSliceOffset(uint32 frameIndex) const
+	{
+		return Ring.GetSliceOffset(frameIndex);
+	}
+
+	VkDeviceSize GetSliceSize() const
+	{
+		return Ring.GetSliceSize();
+	}
+
+	const FrameRingBuffer::Stats& GetStats() const
+	{
+		return Ring.GetStats();
+	}
+};
@@ -0,0 +1,66 @@
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "Math/VrixicMathBounds.h"
+#include "TestHelpers.h"
+
+/*
+* Bounds::ComputeScalar() against Bounds::ComputeSIMD() over packed positions and over H2B vertices
+*	BoundsBenchmark uses SSE, BoundsBenchmarkAVX2 AVX2: BoundsBenchmark [position count]
+*/
+
+static void Run(const char* label, unsigned int count, unsigned int strideInBytes)
+{
+	std::mt19937 Random(1);
+	std::uniform_real_distribution<float> Unit(-100.0f, 100.0f);
+
+	std::vector<float> Data(static_cast<size_t>(count) * strideInBytes / sizeof(float) + 4);
+	for (float& Value : Data)
+	{
+		Value = Unit(Random);
+	}
+
+	BoundingVolume Volume;
+	double Scalar = Test::MeasureNanoseconds(20, [&]()
+		{
+			Bounds::ComputeScalar(Data.data(), count, strideInBytes, Volume);
+			Test::Consume(Volume);
+		});
+
+#if VRIXIC_BOUNDS_SSE
+	double SIMD = Test::MeasureNanoseconds(20, [&]()
+		{
+			Bounds::ComputeSIMD(Data.data(), count, strideInBytes, Volume);
+			Test::Consume(Volume);
+		});
+#else
+	double SIMD = Scalar;
+#endif
+
+	std::cout << "\n" << label << ", " << count << " positions: scalar " << Scalar / 1e6 << " ms (" << Scalar / count << " ns/position), SIMD "
+		<< SIMD / 1e6 << " ms (" << SIMD / count << " ns/position), " << Scalar / SIMD << "x";
+}
+
+int main(int argc, char** argv)
+{
+	if (!Test::CanRunBuild())
+	{
+		return Test::SkippedResult;
+	}
+
+	unsigned int Count = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 1000000;
+
+#if VRIXIC_BOUNDS_AVX2
+	std::cout << "Bounds::Compute, AVX2";
+#elif VRIXIC_BOUNDS_SSE
+	std::cout << "Bounds::Compute, SSE";
+#else
+	std::cout << "Bounds::Compute, no SIMD on this target";
+#endif
+
+	Run("Packed (stride 12)", Count, 12);
+	Run("H2B::VERTEX (stride 36)", Count, 36);
+	std::cout << "\n";
+	return 0;
+}
@@ -0,0 +1,379 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "Math/VrixicMathBounds.h"
+#include "TestHelpers.h"
+#include "WorldBoundsCache.h"
+
+/*
+* Bounds::ComputeSIMD() against Bounds::ComputeScalar()
+*	Built twice, with SSE (the default on x64) and with AVX2 (BoundsTestsAVX2) where two positions share a register
+*	Every count up to 64 covers both remainder loops, the positions end exactly 16 bytes after the last one so a
+*	read past what Compute() documents is caught by ASan
+* Bounds::TransformAABBsSIMD() against TransformAABBsScalar() and the 8 transformed corners, WorldBoundsCache::Update() against
+* TransformAABB() per instance
+*/
+
+/* count positions strideInBytes apart in a buffer with nothing readable after the last position's 16 bytes */
+static std::vector<char> MakePositions(unsigned int count, unsigned int strideInBytes, std::mt19937& random)
+{
+	if (count == 0)
+	{
+		return std::vector<char>();
+	}
+
+	std::vector<char> Data(static_cast<size_t>(count - 1) * strideInBytes + 16);
+
+	/* Whatever sits between the positions and in the 4th float must not change the result */
+	std::uniform_int_distribution<int> Byte(0, 255);
+	for (char& Value : Data)
+	{
+		Value = static_cast<char>(Byte(random));
+	}
+
+	/* Positions around an offset center with a random scale per axis, some sets are flat on an axis */
+	std::uniform_real_distribution<float> Unit(-1.0f, 1.0f);
+	float Offset[3] = { Unit(random) * 1000.0f, Unit(random) * 1000.0f, Unit(random) * 1000.0f };
+	float Scale[3] = { std::exp(Unit(random) * 6.0f), std::exp(Unit(random) * 6.0f), random() % 8 == 0 ? 0.0f : std::exp(Unit(random) * 6.0f) };
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		float Position[3];
+		for (int Axis = 0; Axis < 3; ++Axis)
+		{
+			Position[Axis] = Offset[Axis] + Unit(random) * Scale[Axis];
+		}
+		std::memcpy(&Data[static_cast<size_t>(i) * strideInBytes], Position, sizeof(Position));
+	}
+
+	/* With a 16 byte stride the 4th float is only ever padding, make it something min/max would notice */
+	if (strideInBytes >= 16)
+	{
+		const float Padding = random() % 2 == 0 ? std::numeric_limits<float>::quiet_NaN() : -std::numeric_limits<float>::infinity();
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			std::memcpy(&Data[static_cast<size_t>(i) * strideInBytes + 12], &Padding, sizeof(float));
+		}
+	}
+
+	return Data;
+}
+
+static bool SameVector(const Vector3D& a, const Vector3D& b)
+{
+	return a.X == b.X && a.Y == b.Y && a.Z == b.Z;
+}
+
+static void CheckCompute(unsigned int count, unsigned int strideInBytes, std::mt19937& random)
+{
+	std::vector<char> Data = MakePositions(count, strideInBytes, random);
+	const float* Positions = count > 0 ? reinterpret_cast<const float*>(Data.data()) : nullptr;
+
+	BoundingVolume Scalar;
+	BoundingVolume SIMD;
+	BoundingVolume Dispatched;
+	Bounds::ComputeScalar(Positions, count, strideInBytes, Scalar);
+	Bounds::ComputeSIMD(Positions, count, strideInBytes, SIMD);
+	Bounds::Compute(Positions, count, strideInBytes, Dispatched);
+
+	/* min/max and the center are exact, the radius only differs if the compiler contracts the scalar sum into FMAs */
+	TEST_CHECK(SameVector(SIMD.Min, Scalar.Min));
+	TEST_CHECK(SameVector(SIMD.Max, Scalar.Max));
+	TEST_CHECK(SameVector(SIMD.SphereCenter, Scalar.SphereCenter));
+	TEST_CHECK(std::fabs(SIMD.SphereRadius - Scalar.SphereRadius) <= Scalar.SphereRadius * 1e-6f);
+
+	TEST_CHECK(SameVector(Dispatched.Min, SIMD.Min));
+	TEST_CHECK(SameVector(Dispatched.Max, SIMD.Max));
+	TEST_CHECK(Dispatched.SphereRadius == SIMD.SphereRadius);
+
+	/* Every position is inside both volumes */
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		float P[3];
+		std::memcpy(P, &Data[static_cast<size_t>(i) * strideInBytes], sizeof(P));
+
+		TEST_CHECK(P[0] >= SIMD.Min.X && P[1] >= SIMD.Min.Y && P[2] >= SIMD.Min.Z);
+		TEST_CHECK(P[0] <= SIMD.Max.X && P[1] <= SIMD.Max.Y && P[2] <= SIMD.Max.Z);
+
+		float DX = P[0] - SIMD.SphereCenter.X;
+		float DY = P[1] - SIMD.SphereCenter.Y;
+		float DZ = P[2] - SIMD.SphereCenter.Z;
+		TEST_CHECK(std::sqrt(DX * DX + DY * DY + DZ * DZ) <= SIMD.SphereRadius * (1.0f + 1e-6f));
+	}
+
+	if (count == 0)
+	{
+		TEST_CHECK(SameVector(SIMD.Min, Vector3D(0.0f)) && SameVector(SIMD.Max, Vector3D(0.0f)) && SIMD.SphereRadius == 0.0f);
+	}
+}
+
+#if VRIXIC_BOUNDS_SSE
+/* Equal up to float rounding of values around magnitude, the SIMD and scalar sums only differ if the compiler makes FMAs */
+static bool Close(float a, float b, float magnitude)
+{
+	return std::fabs(a - b) <= (magnitude + 1.0f) * 1e-5f;
+}
+
+/* Matrices that can mirror or flatten, every 8th element of their 3x3 is any value at all */
+static Matrix4D MakeWorld(std::mt19937& random)
+{
+	return Test::MakeWorld(random, Vector3D(0.0f), 1000.0f, 10.0f, true);
+}
+
+/* The box around the 8 corners of center +- extents, each corner as a row vector through world */
+static void TransformCorners(const Vector3D& center, const Vector3D& extents, const Matrix4D& world, float outMin[3], float outMax[3])
+{
+	for (int j = 0; j < 3; ++j)
+	{
+		outMin[j] = FLT_MAX;
+		outMax[j] = -FLT_MAX;
+	}
+
+	for (int Corner = 0; Corner < 8; ++Corner)
+	{
+		float P[3] = { center.X + (Corner & 1 ? extents.X : -extents.X), center.Y + (Corner & 2 ? extents.Y : -extents.Y),
+			center.Z + (Corner & 4 ? extents.Z : -extents.Z) };
+		for (int j = 0; j < 3; ++j)
+		{
+			float Value = P[0] * world(0, j) + P[1] * world(1, j) + P[2] * world(2, j) + world(3, j);
+			outMin[j] = std::min(outMin[j], Value);
+			outMax[j] = std::max(outMax[j], Value);
+		}
+	}
+}
+
+/* boxes' box number box against TransformAABB() and the corners of center +- extents under world */
+static void CheckBox(const BoxStreams& boxes, size_t box, const Vector3D& center, const Vector3D& extents, const Matrix4D& world)
+{
+	Vector3D Center;
+	Vector3D Extents;
+	Bounds::TransformAABB(center, extents, world, Center, Extents);
+
+	float Min[3];
+	float Max[3];
+	TransformCorners(center, extents, world, Min, Max);
+
+	float Got[6] = { boxes.CenterX[box], boxes.CenterY[box], boxes.CenterZ[box], boxes.ExtentX[box], boxes.ExtentY[box], boxes.ExtentZ[box] };
+	float Expected[6] = { Center.X, Center.Y, Center.Z, Extents.X, Extents.Y, Extents.Z };
+	float Corners[6] = { (Min[0] + Max[0]) * 0.5f, (Min[1] + Max[1]) * 0.5f, (Min[2] + Max[2]) * 0.5f,
+		(Max[0] - Min[0]) * 0.5f, (Max[1] - Min[1]) * 0.5f, (Max[2] - Min[2]) * 0.5f };
+
+	for (int j = 0; j < 3; ++j)
+	{
+		float Magnitude = std::max(std::fabs(Min[j]), std::fabs(Max[j]));
+		TEST_CHECK(Close(Got[j], Expected[j], Magnitude));
+		TEST_CHECK(Close(Got[j + 3], Expected[j + 3], Magnitude));
+		TEST_CHECK(Close(Got[j], Corners[j], Magnitude));
+		TEST_CHECK(Close(Got[j + 3], Corners[j + 3], Magnitude));
+	}
+}
+
+/* count boxes written from firstBox on, by SIMD and scalar, with every box around them left alone */
+static void CheckTransformAABBs(unsigned int count, size_t firstBox, std::mt19937& random)
+{
+	std::uniform_real_distribution<float> Unit(-1.0f, 1.0f);
+	Vector3D Center(Unit(random) * 100.0f, Unit(random) * 100.0f, Unit(random) * 100.0f);
+	Vector3D Extents(std::fabs(Unit(random)) * 50.0f, std::fabs(Unit(random)) * 50.0f, random() % 8 == 0 ? 0.0f : std::fabs(Unit(random)) * 50.0f);
+
+	std::vector<Matrix4D> Worlds(count);
+	for (Matrix4D& World : Worlds)
+	{
+		World = MakeWorld(random);
+	}
+
+	const float Untouched = -12345.0f;
+	BoxStreams Scalar;
+	BoxStreams SIMD;
+	Scalar.Resize(firstBox + count + 4);
+	SIMD.Resize(firstBox + count + 4);
+	for (BoxStreams* Boxes : { &Scalar, &SIMD })
+	{
+		for (std::vector<float>* Stream : { &Boxes->CenterX, &Boxes->CenterY, &Boxes->CenterZ, &Boxes->ExtentX, &Boxes->ExtentY, &Boxes->ExtentZ })
+		{
+			std::fill(Stream->begin(), Stream->end(), Untouched);
+		}
+	}
+
+	const Matrix4D* WorldData = count > 0 ? Worlds.data() : nullptr;
+	Bounds::TransformAABBsScalar(Center, Extents, WorldData, count, Scalar, firstBox);
+	Bounds::TransformAABBsSIMD(Center, Extents, WorldData, count, SIMD, firstBox);
+
+	for (size_t Box = 0; Box < SIMD.Size(); ++Box)
+	{
+		if (Box < firstBox || Box >= firstBox + count)
+		{
+			TEST_CHECK(SIMD.CenterX[Box] == Untouched && SIMD.ExtentZ[Box] == Untouched);
+			TEST_CHECK(Scalar.CenterX[Box] == Untouched && Scalar.ExtentZ[Box] == Untouched);
+			continue;
+		}
+
+		const Matrix4D& World = Worlds[Box - firstBox];
+		CheckBox(SIMD, Box, Center, Extents, World);
+		CheckBox(Scalar, Box, Center, Extents, World);
+	}
+}
+
+/* Every instance box of meshes against TransformAABB() of its mesh's box */
+static void CheckCache(const WorldBoundsCache& cache, const std::vector<StaticMesh>& meshes, const std::vector<Matrix4D>& worldMatrices)
+{
+	uint32 BoxCount = 0;
+	for (uint32 i = 0; i < meshes.size(); ++i)
+	{
+		const StaticMesh& Mesh = meshes[i];
+		Vector3D Center = (Mesh.MinBox_AABB + Mesh.MaxBox_AABB) * 0.5f;
+		Vector3D Extents = Mesh.MaxBox_AABB - Center;
+
+		TEST_CHECK(cache.GetFirstBox(i) == BoxCount);
+		for (uint32 j = 0; j < Mesh.InstanceCount; ++j)
+		{
+			CheckBox(cache.Boxes, BoxCount + j, Center, Extents, worldMatrices[Mesh.WorldMatrixIndex + j]);
+		}
+		BoxCount += Mesh.InstanceCount;
+	}
+
+	TEST_CHECK(cache.GetStats().BoxCount == BoxCount);
+	TEST_CHECK(cache.Boxes.Size() == BoxCount);
+}
+
+/*
+* Only boxes whose matrix or mesh changed are recomputed, Invalidate() and a change of mesh layout recompute everything they touch
+*	The mesh without instances sits where its matrices would start, past the end of the level's matrices
+*/
+static void TestWorldBoundsCache(std::mt19937& random)
+{
+	std::vector<Matrix4D> WorldMatrices(14);
+	for (Matrix4D& World : WorldMatrices)
+	{
+		World = MakeWorld(random);
+	}
+
+	/* The meshes take their own transform from WorldMatrices once, when they are made */
+	std::vector<StaticMesh> Meshes;
+	Meshes.push_back(StaticMesh(0, 0, 0, 0, 0, 0, 1, 5, 0, &WorldMatrices));
+	Meshes.push_back(StaticMesh(0, 0, 0, 0, 0, 0, 1, 9, 5, &WorldMatrices));
+	Meshes.push_back(StaticMesh(0, 0, 0, 0, 0, 0, 1, 0, 0, &WorldMatrices));
+	Meshes[2].WorldMatrixIndex = static_cast<uint32>(WorldMatrices.size());
+
+	Meshes[0].MinBox_AABB = Vector3D(-1.0f, -2.0f, -3.0f);
+	Meshes[0].MaxBox_AABB = Vector3D(1.0f, 2.0f, 3.0f);
+	Meshes[1].MinBox_AABB = Vector3D(5.0f, 0.0f, -1.0f);
+	Meshes[1].MaxBox_AABB = Vector3D(6.0f, 10.0f, 1.0f);
+	Meshes[2].MinBox_AABB = Vector3D(0.0f);
+	Meshes[2].MaxBox_AABB = Vector3D(1.0f);
+
+	WorldBoundsCache Cache;
+	Cache.Update(Meshes, WorldMatrices);
+	TEST_CHECK(Cache.GetStats().RecomputedLastUpdate == 14);
+	CheckCache(Cache, Meshes, WorldMatrices);
+
+	Cache.Update(Meshes, WorldMatrices);
+	TEST_CHECK(Cache.GetStats().RecomputedLastUpdate == 0);
+
+	/* Moved instances, alone and in a run */
+	const uint32 Moved[] = { 1, 6, 7, 8, 9, 13 };
+	for (uint32 Index : Moved)
+	{
+		WorldMatrices[Index] = MakeWorld(random);
+	}
+	Cache.Update(Meshes, WorldMatrices);
+	TEST_CHECK(Cache.GetStats().RecomputedLastUpdate == 6);
+	CheckCache(Cache, Meshes, WorldMatrices);
+
+	Cache.Invalidate();
+	Cache.Update(Meshes, WorldMatrices);
+	TEST_CHECK(Cache.GetStats().RecomputedLastUpdate == 14);
+	CheckCache(Cache, Meshes, WorldMatrices);
+
+	/* A new mesh box only recomputes that mesh's instances */
+	Meshes[0].MaxBox_AABB = Vector3D(2.0f, 2.0f, 3.0f);
+	Cache.Update(Meshes, WorldMatrices);
+	TEST_CHECK(Cache.GetStats().RecomputedLastUpdate == 5);
+	CheckCache(Cache, Meshes, WorldMatrices);
+
+	/* One instance fewer on the first mesh moves the boxes of the second */
+	Meshes[0].InstanceCount = 4;
+	Cache.Update(Meshes, WorldMatrices);
+	TEST_CHECK(Cache.GetStats().RecomputedLastUpdate == 13);
+	CheckCache(Cache, Meshes, WorldMatrices);
+
+	/* The second mesh's instances start at another matrix */
+	Meshes[1].WorldMatrixIndex = 4;
+	Cache.Update(Meshes, WorldMatrices);
+	TEST_CHECK(Cache.GetStats().RecomputedLastUpdate == 9);
+	CheckCache(Cache, Meshes, WorldMatrices);
+
+	/* A level of meshes without instances has no matrices to index at all */
+	std::vector<StaticMesh> Empty(1, Meshes[2]);
+	Empty[0].WorldMatrixIndex = 0;
+	std::vector<Matrix4D> NoMatrices;
+	WorldBoundsCache EmptyCache;
+	EmptyCache.Update(Empty, NoMatrices);
+	TEST_CHECK(EmptyCache.GetStats().BoxCount == 0);
+	TEST_CHECK(EmptyCache.GetStats().RecomputedLastUpdate == 0);
+	TEST_CHECK(EmptyCache.GetFirstBox(0) == 0);
+}
+#endif // VRIXIC_BOUNDS_SSE
+
+int main()
+{
+	if (!Test::CanRunBuild())
+	{
+		return Test::SkippedResult;
+	}
+
+#if VRIXIC_BOUNDS_AVX2
+	std::cout << "Bounds::ComputeSIMD() with AVX2";
+#elif VRIXIC_BOUNDS_SSE
+	std::cout << "Bounds::ComputeSIMD() with SSE";
+#else
+	std::cout << "Bounds::ComputeSIMD() is not built on this target, nothing to compare";
+	return Test::SkippedResult;
+#endif
+
+#if VRIXIC_BOUNDS_SSE
+	std::mt19937 Random(7);
+
+	/* 12 is packed positions, 36 an H2B::VERTEX, 16 the same as the register */
+	const unsigned int FixedStrides[] = { 12, 16, 20, 24, 32, 36, 48 };
+	for (unsigned int Stride : FixedStrides)
+	{
+		for (unsigned int Count = 0; Count <= 64; ++Count)
+		{
+			CheckCompute(Count, Stride, Random);
+		}
+		CheckCompute(1023, Stride, Random);
+		CheckCompute(1024, Stride, Random);
+	}
+
+	/* Any stride of whole floats from packed positions to a fat vertex, any count */
+	std::uniform_int_distribution<unsigned int> Floats(3, 24);
+	std::uniform_int_distribution<unsigned int> Count(0, 4099);
+	for (unsigned int i = 0; i < 2000; ++i)
+	{
+		CheckCompute(Count(Random), Floats(Random) * 4, Random);
+	}
+
+	/* Every tail of the four box loop, at box offsets that are not a multiple of four either */
+	for (unsigned int Count = 0; Count <= 7; ++Count)
+	{
+		for (size_t FirstBox = 0; FirstBox < 4; ++FirstBox)
+		{
+			for (unsigned int i = 0; i < 16; ++i)
+			{
+				CheckTransformAABBs(Count, FirstBox, Random);
+			}
+		}
+	}
+	CheckTransformAABBs(64, 0, Random);
+	CheckTransformAABBs(1021, 3, Random);
+
+	TestWorldBoundsCache(Random);
+
+	return Test::Result();
+#endif // VRIXIC_BOUNDS_SSE
+}
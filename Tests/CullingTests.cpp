@@ -0,0 +1,193 @@
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "GpuCulling.h"
+#include "WorldBoundsCache.h"
+#include "TestHelpers.h"
+
+/*
+* GpuCulling::CullReference(), the CPU copy of Shaders/CullCompute.hlsl, against the CPU culling path
+*	WorldBoundsCache + Frustum::TestAABBs() pick the visible instances like the renderer does, DrawList::Build() turns them into
+*	commands and VisibleInstances slots, the kernel run on the unculled list has to write exactly the same
+*	Draws have up to 130 instances so they cross the shader's 64 instance chunks, some meshes have none
+*/
+
+/* Instances around where the cameras look */
+static Matrix4D MakeWorld(std::mt19937& random)
+{
+	return Test::MakeWorld(random, Vector3D(0.0f, 0.0f, 100.0f), 150.0f, 4.0f, false);
+}
+
+/* meshCount meshes of 1 - 4 submeshes, each mesh's instances follow the previous mesh's in outWorldMatrices */
+static void MakeLevel(uint32 meshCount, std::mt19937& random, std::vector<StaticMesh>& outMeshes, std::vector<Matrix4D>& outWorldMatrices)
+{
+	std::uniform_real_distribution<float> Unit(-1.0f, 1.0f);
+
+	/* The meshes read their own transform when they are made, the first matrix stands in until the matrices are final */
+	outWorldMatrices.assign(1, Matrix4D::Identity());
+	outMeshes.clear();
+
+	uint32 MatrixCount = 0;
+	uint32 IndexOffset = 0;
+	for (uint32 i = 0; i < meshCount; ++i)
+	{
+		uint32 InstanceCount = random() % 8 == 0 ? 0 : 1 + random() % 130;
+		uint32 SubMeshCount = 1 + random() % 4;
+
+		StaticMesh Static(100, i * 100, 0, IndexOffset, SubMeshCount, i * 4, SubMeshCount, InstanceCount, 0, &outWorldMatrices);
+		Static.WorldMatrixIndex = MatrixCount;
+		Static.IndexSizeInBytes = random() % 2 == 0 ? sizeof(uint16) : sizeof(uint32);
+
+		for (uint32 j = 0; j < SubMeshCount; ++j)
+		{
+			Mesh SubMesh;
+			SubMesh.IndexOffset = Static.IndexCount;
+			SubMesh.IndexCount = 3 * (1 + random() % 50);
+			SubMesh.MaterialIndex = j;
+			SubMesh.SpecularTextureIndex = 0;
+			SubMesh.NormalTextureIndex = 0;
+			Static.AddSubMesh(SubMesh);
+			Static.IndexCount += SubMesh.IndexCount;
+		}
+		IndexOffset += Static.IndexCount;
+
+		Vector3D Center(Unit(random) * 10.0f, Unit(random) * 10.0f, Unit(random) * 10.0f);
+		Vector3D Extents(std::fabs(Unit(random)) * 20.0f, std::fabs(Unit(random)) * 20.0f, random() % 8 == 0 ? 0.0f : std::fabs(Unit(random)) * 20.0f);
+		Static.MinBox_AABB = Center - Extents;
+		Static.MaxBox_AABB = Center + Extents;
+
+		outMeshes.push_back(Static);
+		MatrixCount += InstanceCount;
+	}
+
+	outWorldMatrices.resize(MatrixCount);
+	for (Matrix4D& World : outWorldMatrices)
+	{
+		World = MakeWorld(random);
+	}
+}
+
+/* Visible instances of every mesh out of the CPU culling masks, what renderer.h hands DrawList::Build() */
+static void CullOnCpu(const std::vector<StaticMesh>& meshes, const std::vector<Matrix4D>& worldMatrices, const Frustum& frustum,
+	WorldBoundsCache& bounds, std::vector<std::vector<uint32>>& outVisibleInstances)
+{
+	bounds.Update(meshes, worldMatrices);
+
+	std::vector<uint32> Mask;
+	frustum.TestAABBs(bounds.Boxes, Mask);
+
+	outVisibleInstances.resize(meshes.size());
+	for (uint32 i = 0; i < meshes.size(); ++i)
+	{
+		outVisibleInstances[i].clear();
+		for (uint32 j = 0; j < meshes[i].GetInstanceCount(); ++j)
+		{
+			uint32 Box = bounds.GetFirstBox(i) + j;
+			if (Mask[Box / 32] & (1u << (Box % 32)))
+			{
+				outVisibleInstances[i].push_back(j);
+			}
+		}
+	}
+}
+
+/* Returns how many instances are visible */
+static size_t CheckLevel(DrawList& drawList, const std::vector<StaticMesh>& meshes, const std::vector<Matrix4D>& worldMatrices,
+	const Frustum& frustum, WorldBoundsCache& bounds)
+{
+	/* The list the culling pass starts from */
+	drawList.Build(meshes);
+	std::vector<DrawData> Draws = drawList.Draws.Elements;
+
+	std::vector<VkDrawIndexedIndirectCommand> Commands;
+	std::vector<uint32> VisibleInstances;
+	GpuCulling::CullReference(Draws, worldMatrices, frustum, Commands, VisibleInstances);
+
+	std::vector<std::vector<uint32>> CpuVisibleInstances;
+	CullOnCpu(meshes, worldMatrices, frustum, bounds, CpuVisibleInstances);
+	drawList.Build(meshes, &CpuVisibleInstances);
+
+	TEST_CHECK(drawList.Draws.Size() == Draws.size());
+	TEST_CHECK(drawList.Commands.Size() == Commands.size());
+	TEST_CHECK(VisibleInstances.size() == drawList.VisibleInstances.Size());
+	if (drawList.Commands.Size() != Commands.size() || VisibleInstances.size() != drawList.VisibleInstances.Size())
+	{
+		return 0;
+	}
+
+	size_t Visible = 0;
+	for (uint32 i = 0; i < Commands.size(); ++i)
+	{
+		const VkDrawIndexedIndirectCommand& Expected = drawList.Commands[i];
+		const VkDrawIndexedIndirectCommand& Command = Commands[i];
+		TEST_CHECK(Command.indexCount == Expected.indexCount);
+		TEST_CHECK(Command.instanceCount == Expected.instanceCount);
+		TEST_CHECK(Command.firstIndex == Expected.firstIndex);
+		TEST_CHECK(Command.vertexOffset == Expected.vertexOffset);
+		TEST_CHECK(Command.firstInstance == Expected.firstInstance);
+		TEST_CHECK(Command.instanceCount <= Draws[i].InstanceCount);
+
+		/* Slots past the visible count are not read */
+		for (uint32 k = 0; k < Command.instanceCount && k < Expected.instanceCount; ++k)
+		{
+			TEST_CHECK(VisibleInstances[Command.firstInstance + k] == drawList.VisibleInstances[Expected.firstInstance + k]);
+		}
+		Visible += Command.instanceCount;
+	}
+
+	return Visible;
+}
+
+int main()
+{
+	/* Any handle will do, the mock never looks at them */
+	VkDevice Device = reinterpret_cast<VkDevice>(1);
+	GpuMemory::Get().Initialize(reinterpret_cast<VkPhysicalDevice>(1), Device);
+	DeletionQueue::Get().Initialize(2);
+
+	/* The allocator prints what it does in DEBUG builds */
+	std::cout.setstate(std::ios::failbit);
+
+	std::mt19937 Random(23);
+	size_t Visible = 0;
+	size_t Instances = 0;
+	for (uint32 Level = 0; Level < 40; ++Level)
+	{
+		std::vector<StaticMesh> Meshes;
+		std::vector<Matrix4D> WorldMatrices;
+		MakeLevel(1 + Random() % 48, Random, Meshes, WorldMatrices);
+
+		DrawList Draws;
+		Draws.Create(reinterpret_cast<VkPhysicalDevice>(1), &Device, 2, Meshes);
+
+		/* Instances move between frames like the renderer's, the cache only recomputes what moved */
+		WorldBoundsCache Bounds;
+		for (uint32 Frame = 0; Frame < 8; ++Frame)
+		{
+			for (uint32 i = 0; i < WorldMatrices.size() / 8; ++i)
+			{
+				WorldMatrices[Random() % WorldMatrices.size()] = MakeWorld(Random);
+			}
+
+			Frustum CameraPlanes;
+			Test::CameraFrustum(Random, CameraPlanes);
+			Visible += CheckLevel(Draws, Meshes, WorldMatrices, CameraPlanes, Bounds);
+			Instances += Draws.GetStats().InstanceCount;
+		}
+
+		Draws.Destroy();
+	}
+
+	DeletionQueue::Get().Flush();
+	GpuMemory::Get().Shutdown();
+	std::cout.clear();
+
+	/* Neither everything nor nothing visible, or the comparison says little */
+	TEST_CHECK(Visible > Instances / 20 && Visible < Instances - Instances / 20);
+	std::cout << "\n" << Visible << " of " << Instances << " instances visible";
+
+	TEST_CHECK(MockDevice::LiveBuffers == 0);
+
+	return Test::Result();
+}
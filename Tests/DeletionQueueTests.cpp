@@ -0,0 +1,234 @@
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "DeletionQueue.h"
+#include "TestHelpers.h"
+
+/*
+* Stress test of DeletionQueue against a mock device (MockGateware.h)
+*	Everything retired during frame N has to be destroyed at the start of frame N + FramesInFlight, not before or after,
+*	including what destroy callbacks retire from inside BeginFrame() and Flush(), and what other threads retire meanwhile
+*/
+
+/* One retired resource, Retire() and destroy record the frames they ran in */
+struct Resource
+{
+	size_t RetiredFrame = 0;
+	size_t DestroyedFrame = 0;
+	uint32 DestroyCount = 0;
+
+	/* Retired by this one's destroy callback, a chain of resources that free each other */
+	std::shared_ptr<Resource> Child;
+	uint32 ChildDepth = 0;
+};
+
+/* Everything TestFrames() retired, outlives the test so callbacks a broken queue leaves behind stay safe to run */
+static std::vector<std::shared_ptr<Resource>> Resources;
+
+static void Retire(const std::shared_ptr<Resource>& resource)
+{
+	DeletionQueue& Queue = DeletionQueue::Get();
+
+	Resources.push_back(resource);
+	resource->RetiredFrame = Queue.GetFrameNumber();
+
+	Queue.Retire([resource]()
+		{
+			resource->DestroyCount++;
+			resource->DestroyedFrame = DeletionQueue::Get().GetFrameNumber();
+
+			/* Re-entrant retirement, BeginFrame() runs callbacks outside its lock */
+			if (resource->ChildDepth > 0)
+			{
+				resource->Child = std::make_shared<Resource>();
+				resource->Child->ChildDepth = resource->ChildDepth - 1;
+				Retire(resource->Child);
+			}
+		});
+}
+
+/* Every resource retired at or before frameNumber - framesInFlight is destroyed exactly once, the rest are alive */
+static void CheckResources(const std::vector<std::shared_ptr<Resource>>& resources, size_t frameNumber, uint32 framesInFlight)
+{
+	for (const std::shared_ptr<Resource>& Item : resources)
+	{
+		if (Item->RetiredFrame + framesInFlight <= frameNumber)
+		{
+			TEST_CHECK(Item->DestroyCount == 1);
+			TEST_CHECK(Item->DestroyedFrame == Item->RetiredFrame + framesInFlight);
+		}
+		else
+		{
+			TEST_CHECK(Item->DestroyCount == 0);
+		}
+	}
+}
+
+/* Random retirement over many frames, some with chains that retire more from their destroy callbacks */
+static void TestFrames(uint32 framesInFlight, std::mt19937& random)
+{
+	DeletionQueue& Queue = DeletionQueue::Get();
+	Queue.Initialize(framesInFlight);
+	framesInFlight = framesInFlight > 0 ? framesInFlight : 1;
+
+	Resources.clear();
+
+	for (uint32 Frame = 0; Frame < 500; ++Frame)
+	{
+		Queue.BeginFrame();
+		size_t FrameNumber = Queue.GetFrameNumber();
+		CheckResources(Resources, FrameNumber, framesInFlight);
+
+		/* Pending is everything not yet destroyed, including the children retired during this BeginFrame() */
+		uint32 Pending = 0;
+		for (const std::shared_ptr<Resource>& Item : Resources)
+		{
+			Pending += Item->DestroyCount == 0 ? 1 : 0;
+		}
+		TEST_CHECK(Queue.GetStats().PendingCount == Pending);
+
+		/* Idle frames too */
+		uint32 RetireCount = random() % 4 == 0 ? 0 : random() % 8;
+		for (uint32 i = 0; i < RetireCount; ++i)
+		{
+			std::shared_ptr<Resource> Item = std::make_shared<Resource>();
+			Item->ChildDepth = random() % 4 == 0 ? random() % 4 : 0;
+			Retire(Item);
+		}
+	}
+
+	/* Flush keeps going until the chains retired by its own callbacks are gone too */
+	Queue.Flush();
+	for (const std::shared_ptr<Resource>& Item : Resources)
+	{
+		TEST_CHECK(Item->DestroyCount == 1);
+		TEST_CHECK(Item->ChildDepth == 0 || (Item->Child && Item->Child->DestroyCount == 1));
+	}
+	TEST_CHECK(Queue.GetStats().PendingCount == 0);
+}
+
+/* Retire() from worker threads while the main thread starts frames, nothing destroyed early or twice */
+static void TestConcurrentRetire(uint32 framesInFlight)
+{
+	DeletionQueue& Queue = DeletionQueue::Get();
+	Queue.Initialize(framesInFlight);
+
+	const uint32 ThreadCount = 4;
+	const uint32 RetiresPerThread = 20000;
+
+	struct Entry
+	{
+		size_t EarliestFrame;
+		std::atomic<size_t> DestroyedFrame;
+		std::atomic<uint32> DestroyCount;
+	};
+	std::unique_ptr<Entry[]> Entries(new Entry[ThreadCount * RetiresPerThread]);
+
+	std::atomic<bool> Done(false);
+	std::vector<std::thread> Threads;
+	for (uint32 t = 0; t < ThreadCount; ++t)
+	{
+		Threads.emplace_back([&Queue, &Entries, t]()
+			{
+				for (uint32 i = 0; i < RetiresPerThread; ++i)
+				{
+					Entry* Item = &Entries[t * RetiresPerThread + i];
+					Item->DestroyedFrame = 0;
+					Item->DestroyCount = 0;
+
+					/* The frame Retire() records is at least this one */
+					Item->EarliestFrame = Queue.GetFrameNumber();
+					Queue.Retire([Item]()
+						{
+							Item->DestroyedFrame = DeletionQueue::Get().GetFrameNumber();
+							Item->DestroyCount++;
+						});
+				}
+			});
+	}
+
+	std::thread Frames([&Queue, &Done]()
+		{
+			while (!Done)
+			{
+				Queue.BeginFrame();
+				std::this_thread::yield();
+			}
+		});
+
+	for (std::thread& Thread : Threads)
+	{
+		Thread.join();
+	}
+	Done = true;
+	Frames.join();
+
+	Queue.Flush();
+	size_t FlushFrame = Queue.GetFrameNumber();
+	for (uint32 i = 0; i < ThreadCount * RetiresPerThread; ++i)
+	{
+		const Entry& Item = Entries[i];
+		TEST_CHECK(Item.DestroyCount == 1);
+
+		/* Destroyed by a BeginFrame() at least FramesInFlight frames later, or by the Flush() */
+		TEST_CHECK(Item.DestroyedFrame >= Item.EarliestFrame + framesInFlight || Item.DestroyedFrame == FlushFrame);
+	}
+}
+
+/* RetireBuffer() hands the buffer and its memory to the queue, the mock device sees them go at the right frame */
+static void TestRetireBuffer(uint32 framesInFlight)
+{
+	DeletionQueue& Queue = DeletionQueue::Get();
+	Queue.Initialize(framesInFlight);
+
+	int32 BuffersBefore = MockDevice::LiveBuffers;
+	uint32 AllocationsBefore = GpuMemory::Get().GetStats().AllocationCount;
+
+	VkBuffer Buffer = nullptr;
+	GpuAllocation Allocation;
+	TEST_CHECK(GpuMemory::Get().CreateBuffer(1000, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, &Buffer, &Allocation) == VK_SUCCESS);
+	TEST_CHECK(MockDevice::LiveBuffers == BuffersBefore + 1);
+
+	Queue.RetireBuffer(Buffer, Allocation);
+	TEST_CHECK(Buffer == nullptr && !Allocation.IsValid());
+
+	/* Nothing to do for a buffer that is already gone */
+	Queue.RetireBuffer(Buffer, Allocation);
+
+	for (uint32 i = 1; i < framesInFlight; ++i)
+	{
+		Queue.BeginFrame();
+		TEST_CHECK(MockDevice::LiveBuffers == BuffersBefore + 1);
+	}
+
+	Queue.BeginFrame();
+	TEST_CHECK(MockDevice::LiveBuffers == BuffersBefore);
+	TEST_CHECK(GpuMemory::Get().GetStats().AllocationCount == AllocationsBefore);
+	TEST_CHECK(Queue.GetStats().PendingCount == 0);
+}
+
+int main()
+{
+	/* Any handle will do, the mock never looks at them */
+	GpuMemory::Get().Initialize(reinterpret_cast<VkPhysicalDevice>(1), reinterpret_cast<VkDevice>(1));
+
+	std::mt19937 Random(19);
+	for (uint32 FramesInFlight = 1; FramesInFlight <= 4; ++FramesInFlight)
+	{
+		TestFrames(FramesInFlight, Random);
+		TestRetireBuffer(FramesInFlight);
+		TestConcurrentRetire(FramesInFlight);
+	}
+
+	/* Initialize(0) is clamped to one frame */
+	TestFrames(0, Random);
+
+	GpuMemory::Get().Shutdown();
+	TEST_CHECK(MockDevice::LiveBuffers == 0);
+	TEST_CHECK(MockDevice::LiveMemory == 0);
+
+	return Test::Result();
+}
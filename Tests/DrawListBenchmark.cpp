@@ -0,0 +1,207 @@
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "DrawList.h"
+#include "TestHelpers.h"
+
+/*
+* Recording the opaque pass, the per submesh loop DrawList replaced against DrawList::Build() + Flush() + Record()
+*	The vkCmd* calls are MockGateware.h's, they append their arguments to the command buffer, so what a driver does
+*	per call after that is not in the times
+*	The generated meshes have 1 - 6 submeshes and 1 - 8 instances, a third of them with 32 bit indices
+*	DrawListBenchmark [mesh count]
+*/
+
+static GW::GRAPHICS::GVulkanSurface Surface;
+
+/* Same layout as renderer.h's ConstantBuffer, 128 bytes */
+struct ConstantBuffer
+{
+	uint32 MeshID;
+	uint32 MaterialID;
+	uint32 DiffuseTextureID;
+	uint32 ViewMatID;
+
+	Vector3D Color;
+	uint32 SpecularTextureID;
+
+	Vector3D FresnelColor;
+	uint32 NormalTextureID;
+
+	uint32 Padding[20];
+};
+
+/* meshCount meshes sorted 16 bit indices first, like the meshes the old loop drew */
+static void MakeMeshes(uint32 meshCount, std::vector<StaticMesh>& outMeshes, std::vector<Matrix4D>& outWorldMatrices)
+{
+	std::mt19937 Random(21);
+
+	outWorldMatrices.assign(1, Matrix4D::Identity());
+	outMeshes.clear();
+
+	uint32 MatrixCount = 0;
+	for (uint32 Size = 0; Size < 2; ++Size)
+	{
+		for (uint32 i = Size * (meshCount - meshCount / 3); i < (Size == 0 ? meshCount - meshCount / 3 : meshCount); ++i)
+		{
+			uint32 InstanceCount = 1 + Random() % 8;
+			uint32 SubMeshCount = 1 + Random() % 6;
+
+			StaticMesh Static(100, i * 100, 0, i * 600, SubMeshCount, i * 6, SubMeshCount, InstanceCount, 0, &outWorldMatrices);
+			Static.WorldMatrixIndex = MatrixCount;
+			Static.IndexSizeInBytes = Size == 0 ? sizeof(uint16) : sizeof(uint32);
+
+			for (uint32 j = 0; j < SubMeshCount; ++j)
+			{
+				Mesh SubMesh;
+				SubMesh.IndexOffset = Static.IndexCount;
+				SubMesh.IndexCount = 3 * (1 + Random() % 30);
+				SubMesh.MaterialIndex = j;
+				SubMesh.SpecularTextureIndex = 0;
+				SubMesh.NormalTextureIndex = 0;
+				Static.AddSubMesh(SubMesh);
+				Static.IndexCount += SubMesh.IndexCount;
+			}
+
+			Static.MinBox_AABB = Vector3D(-1.0f);
+			Static.MaxBox_AABB = Vector3D(1.0f);
+
+			outMeshes.push_back(Static);
+			MatrixCount += InstanceCount;
+		}
+	}
+
+	outWorldMatrices.assign(MatrixCount, Matrix4D::Identity());
+}
+
+/* renderer.h's opaque pass before DrawList, a push constant and a draw per submesh */
+static void RecordLoop(VkCommandBuffer commandBuffer, const std::vector<StaticMesh>& meshes, LevelData* levelData)
+{
+	VkPipelineLayout PipelineLayout = nullptr;
+	ConstantBuffer Buffer = { };
+
+	uint32 BoundIndexSize = sizeof(uint16);
+	for (uint32 i = 0; i < meshes.size(); ++i)
+	{
+		Buffer.MeshID = meshes[i].GetWorldMatrixIndex();
+
+		if (meshes[i].GetIndexSizeInBytes() != BoundIndexSize)
+		{
+			BoundIndexSize = meshes[i].GetIndexSizeInBytes();
+			levelData->BindIndices(BoundIndexSize);
+		}
+
+		for (uint32 j = 0; j < meshes[i].GetMeshCount(); ++j)
+		{
+			Buffer.MaterialID = meshes[i].GetMaterialIndex() + meshes[i].GetSubMeshMaterialIndex(j);
+			Buffer.DiffuseTextureID = meshes[i].GetSubMeshDiffuseTextureIndex(j);
+			Buffer.SpecularTextureID = meshes[i].GetSubMeshSpecularTextureIndex(j);
+			Buffer.NormalTextureID = meshes[i].GetSubMeshNormalTextureIndex(j);
+			Buffer.ViewMatID = 0;
+			vkCmdPushConstants(commandBuffer, PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+				sizeof(ConstantBuffer), &Buffer);
+			vkCmdDrawIndexed(commandBuffer, meshes[i].GetSubMeshIndexCount(j), meshes[i].GetInstanceCount(),
+				meshes[i].GetIndexOffset() + meshes[i].GetSubMeshIndexOffset(j), meshes[i].GetVertexOffset(), 0);
+		}
+	}
+}
+
+static void Run(uint32 meshCount, unsigned int repeats)
+{
+	VkDevice Device = reinterpret_cast<VkDevice>(1);
+	VkPhysicalDevice PhysicalDevice = reinterpret_cast<VkPhysicalDevice>(1);
+
+	std::vector<StaticMesh> Meshes;
+	std::vector<Matrix4D> WorldMatrices;
+	MakeMeshes(meshCount, Meshes, WorldMatrices);
+
+	/* Only the index buffer binds are used, a camera entry is a level without meshes */
+	std::vector<RawMeshData> RawData(1);
+	RawData[0].IsCamera = true;
+	LevelData Level(&Device, &Surface, RawData);
+
+	VkCommandBuffer CommandBuffer = new VkCommandBuffer_T();
+	Surface.CommandBuffer = CommandBuffer;
+
+	double Loop = Test::MeasureNanoseconds(repeats, [&]()
+		{
+			vkBeginCommandBuffer(CommandBuffer, nullptr);
+			RecordLoop(CommandBuffer, Meshes, &Level);
+		});
+	uint32 LoopCalls = CommandBuffer->CallCount;
+
+	/* With and without multiDrawIndirect, the fallback reads the commands back from the list */
+	DrawList Draws[2];
+	double Build[2];
+	double Flush[2];
+	double Record[2];
+	uint32 RecordCalls[2];
+	for (uint32 i = 0; i < 2; ++i)
+	{
+		MockDevice::MultiDrawIndirect = i == 0;
+		std::cout.setstate(std::ios::failbit);
+		Draws[i].Create(PhysicalDevice, &Device, 2, Meshes);
+		std::cout.clear();
+
+		Build[i] = Test::MeasureNanoseconds(repeats, [&]() { Draws[i].Build(Meshes); });
+		Draws[i].Flush(0);
+
+		/* Nothing changed since the last Flush() of the slice, what a static level costs every frame */
+		size_t Bytes = 0;
+		Flush[i] = Test::MeasureNanoseconds(repeats, [&]() { Bytes += Draws[i].Flush(0); });
+		Test::Consume(Bytes);
+
+		Record[i] = Test::MeasureNanoseconds(repeats, [&]()
+			{
+				vkBeginCommandBuffer(CommandBuffer, nullptr);
+				Draws[i].Record(CommandBuffer, 0, &Level);
+			});
+		RecordCalls[i] = CommandBuffer->CallCount;
+
+		TEST_CHECK(Draws[i].GetStats().CallCount == RecordCalls[i]);
+	}
+	MockDevice::MultiDrawIndirect = true;
+
+	/* One draw per submesh either way, the fallback skips nothing since every mesh has instances */
+	uint32 DrawCount = Draws[0].GetStats().DrawCount;
+	TEST_CHECK(LoopCalls == DrawCount * 2);
+	TEST_CHECK(RecordCalls[1] == DrawCount);
+	TEST_CHECK(RecordCalls[0] == 2);
+
+	std::cout << "\n" << meshCount << " meshes, " << DrawCount << " draws: loop " << Loop / 1e3 << " us (" << LoopCalls << " calls), "
+		<< "Build " << Build[0] / 1e3 << " us, Flush " << Flush[0] / 1e3 << " us, "
+		<< "Record " << Record[0] / 1e3 << " us (" << RecordCalls[0] << " calls, multi draw indirect), "
+		<< Record[1] / 1e3 << " us (" << RecordCalls[1] << " calls, one per draw)";
+
+	Draws[0].Destroy();
+	Draws[1].Destroy();
+	delete CommandBuffer;
+	Surface.CommandBuffer = nullptr;
+}
+
+int main(int argc, char** argv)
+{
+	/* Any handle will do, the mock never looks at them */
+	GpuMemory::Get().Initialize(reinterpret_cast<VkPhysicalDevice>(1), reinterpret_cast<VkDevice>(1));
+	DeletionQueue::Get().Initialize(2);
+
+	std::cout << "Opaque pass recording on the CPU, best of the runs";
+	if (argc > 1)
+	{
+		Run(static_cast<uint32>(std::strtoul(argv[1], nullptr, 10)), 20);
+	}
+	else
+	{
+		const uint32 MeshCounts[] = { 1000, 5000, 20000 };
+		for (uint32 MeshCount : MeshCounts)
+		{
+			Run(MeshCount, 20);
+		}
+	}
+
+	DeletionQueue::Get().Flush();
+	GpuMemory::Get().Shutdown();
+
+	return Test::Result();
+}
@@ -0,0 +1,88 @@
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "GenericDefines.h"
+#include "Math/Vector2D.h"
+#include "Math/Vector4D.h"
+
+/* Frustum.h's debug helpers fill LevelData.h's Vertex, which needs the whole renderer, same layout */
+struct Vertex
+{
+	Vector2D TexCoord;
+	Vector3D Position;
+	Vector3D Normal;
+	Vector4D Color;
+};
+
+#include "Frustum.h"
+#include "TestHelpers.h"
+
+/*
+* Frustum::TestAABBs() against Frustum::TestAABBsScalar() over 1M boxes scattered around a camera
+*	FrustumBenchmark uses SSE, FrustumBenchmarkAVX2 AVX2: FrustumBenchmark [box count]
+*/
+int main(int argc, char** argv)
+{
+	if (!Test::CanRunBuild())
+	{
+		return Test::SkippedResult;
+	}
+
+	size_t Count = argc > 1 ? static_cast<size_t>(std::strtoul(argv[1], nullptr, 10)) : 1000000;
+
+#if VRIXIC_BOUNDS_AVX2
+	std::cout << "Frustum::TestAABBs, AVX2";
+#elif VRIXIC_BOUNDS_SSE
+	std::cout << "Frustum::TestAABBs, SSE";
+#else
+	std::cout << "Frustum::TestAABBs, no SIMD on this target";
+#endif
+
+	Frustum CameraPlanes;
+	CameraPlanes.SetFrustumInternals(16.0f / 9.0f, 1.0f, 0.1f, 500.0f);
+	CameraPlanes.CreateFrustum(Vector3D(0.0f), Vector3D(1.0f, 0.0f, 0.0f), Vector3D(0.0f, 1.0f, 0.0f), Vector3D(0.0f, 0.0f, 1.0f));
+
+	std::mt19937 Random(1);
+	std::uniform_real_distribution<float> Position(-500.0f, 500.0f);
+	std::uniform_real_distribution<float> Extent(0.1f, 5.0f);
+
+	BoxStreams Boxes;
+	Boxes.Resize(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		Boxes.CenterX[i] = Position(Random);
+		Boxes.CenterY[i] = Position(Random);
+		Boxes.CenterZ[i] = Position(Random);
+		Boxes.ExtentX[i] = Extent(Random);
+		Boxes.ExtentY[i] = Extent(Random);
+		Boxes.ExtentZ[i] = Extent(Random);
+	}
+
+	std::vector<uint32> Mask;
+	double Scalar = Test::MeasureNanoseconds(20, [&]()
+		{
+			Mask.assign((Count + 31) / 32, 0);
+			CameraPlanes.TestAABBsScalar(Boxes, 0, Count, Mask);
+			Test::Consume(Mask[0]);
+		});
+
+	double SIMD = Test::MeasureNanoseconds(20, [&]()
+		{
+			CameraPlanes.TestAABBs(Boxes, Mask);
+			Test::Consume(Mask[0]);
+		});
+
+	size_t Visible = 0;
+	for (uint32 Word : Mask)
+	{
+		for (uint32 Bits = Word; Bits != 0; Bits &= Bits - 1)
+		{
+			Visible++;
+		}
+	}
+
+	std::cout << "\n" << Count << " boxes, " << Visible << " visible: scalar " << Scalar / 1e6 << " ms (" << Scalar / Count << " ns/box), TestAABBs "
+		<< SIMD / 1e6 << " ms (" << SIMD / Count << " ns/box), " << Scalar / SIMD << "x\n";
+	return 0;
+}
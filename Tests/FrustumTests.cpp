@@ -0,0 +1,171 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "GenericDefines.h"
+#include "Math/Vector2D.h"
+#include "Math/Vector4D.h"
+
+/* Frustum.h's debug helpers fill LevelData.h's Vertex, which needs the whole renderer, same layout */
+struct Vertex
+{
+	Vector2D TexCoord;
+	Vector3D Position;
+	Vector3D Normal;
+	Vector4D Color;
+};
+
+#include "Frustum.h"
+#include "TestHelpers.h"
+
+/*
+* Frustum::TestAABBs() against Frustum::TestAABBsScalar()
+*	Built twice, with SSE (the default on x64) testing 4 boxes at a time and with AVX2 (FrustumTestsAVX2) testing 8 then 4,
+*	every count up to 100 crosses the 8 / 4 / tail boundaries and the 32 bit words of the mask
+*/
+
+static void RandomBoxes(size_t count, std::mt19937& random, BoxStreams& outBoxes)
+{
+	std::uniform_real_distribution<float> Position(-300.0f, 300.0f);
+	std::uniform_real_distribution<float> Extent(0.0f, 40.0f);
+
+	outBoxes.Resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		outBoxes.CenterX[i] = Position(random);
+		outBoxes.CenterY[i] = Position(random);
+		outBoxes.CenterZ[i] = Position(random);
+
+		/* Points and flat boxes too */
+		bool Point = random() % 16 == 0;
+		outBoxes.ExtentX[i] = Point ? 0.0f : Extent(random);
+		outBoxes.ExtentY[i] = Point ? 0.0f : Extent(random);
+		outBoxes.ExtentZ[i] = Point || random() % 16 == 0 ? 0.0f : Extent(random);
+	}
+}
+
+/* Boxes that touch planes exactly, Distance == -Radius must not be culled by either path */
+static void TouchingBoxes(const Frustum& frustum, size_t count, std::mt19937& random, BoxStreams& outBoxes)
+{
+	outBoxes.Resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const Plane& P = frustum.Planes[random() % 6];
+
+		/* On an axis aligned plane the box center is exactly representable at distance -extent */
+		outBoxes.CenterX[i] = P.X * (P.Distance - 1.0f);
+		outBoxes.CenterY[i] = P.Y * (P.Distance - 1.0f);
+		outBoxes.CenterZ[i] = P.Z * (P.Distance - 1.0f);
+		outBoxes.ExtentX[i] = 1.0f;
+		outBoxes.ExtentY[i] = 1.0f;
+		outBoxes.ExtentZ[i] = 1.0f;
+	}
+}
+
+/* Planes of the box -size to size on every axis, normals pointing inside */
+static Frustum BoxFrustum(float size)
+{
+	Frustum Result;
+	Result.Planes[0] = Plane(1.0f, 0.0f, 0.0f, -size);
+	Result.Planes[1] = Plane(-1.0f, 0.0f, 0.0f, -size);
+	Result.Planes[2] = Plane(0.0f, 1.0f, 0.0f, -size);
+	Result.Planes[3] = Plane(0.0f, -1.0f, 0.0f, -size);
+	Result.Planes[4] = Plane(0.0f, 0.0f, 1.0f, -size);
+	Result.Planes[5] = Plane(0.0f, 0.0f, -1.0f, -size);
+	return Result;
+}
+
+/* Returns how many boxes are visible */
+static size_t CheckMasks(const Frustum& frustum, const BoxStreams& boxes)
+{
+	size_t Count = boxes.Size();
+
+	std::vector<uint32> Mask;
+	frustum.TestAABBs(boxes, Mask);
+
+	std::vector<uint32> Expected((Count + 31) / 32, 0);
+	frustum.TestAABBsScalar(boxes, 0, Count, Expected);
+
+	TEST_CHECK(Mask.size() == Expected.size());
+	if (Mask.size() != Expected.size())
+	{
+		return 0;
+	}
+
+	size_t Visible = 0;
+	for (size_t i = 0; i < Mask.size(); ++i)
+	{
+		TEST_CHECK(Mask[i] == Expected[i]);
+		for (uint32 Bits = Mask[i]; Bits != 0; Bits &= Bits - 1)
+		{
+			Visible++;
+		}
+	}
+
+	/* Nothing past the last box */
+	if (Count % 32 != 0)
+	{
+		TEST_CHECK((Mask.back() >> (Count % 32)) == 0);
+	}
+
+	return Visible;
+}
+
+int main()
+{
+	if (!Test::CanRunBuild())
+	{
+		return Test::SkippedResult;
+	}
+
+#if VRIXIC_BOUNDS_AVX2
+	std::cout << "Frustum::TestAABBs() with AVX2";
+#elif VRIXIC_BOUNDS_SSE
+	std::cout << "Frustum::TestAABBs() with SSE";
+#else
+	std::cout << "Frustum::TestAABBs() is scalar on this target";
+#endif
+
+	std::mt19937 Random(25);
+	BoxStreams Boxes;
+
+	size_t Visible = 0;
+	size_t Tested = 0;
+	for (uint32 f = 0; f < 20; ++f)
+	{
+		Frustum CameraPlanes;
+		Test::CameraFrustum(Random, CameraPlanes);
+		for (size_t Count = 0; Count <= 100; ++Count)
+		{
+			RandomBoxes(Count, Random, Boxes);
+			Visible += CheckMasks(CameraPlanes, Boxes);
+			Tested += Count;
+		}
+
+		std::uniform_int_distribution<size_t> Count(0, 5000);
+		RandomBoxes(Count(Random), Random, Boxes);
+		Visible += CheckMasks(CameraPlanes, Boxes);
+		Tested += Boxes.Size();
+	}
+
+	/* The random boxes have to land on both sides or the comparison says little */
+	TEST_CHECK(Visible > 0 && Visible < Tested);
+
+	/* Exactly touching boxes are visible in both */
+	Frustum Cube = BoxFrustum(100.0f);
+	for (size_t Count = 0; Count <= 40; ++Count)
+	{
+		TouchingBoxes(Cube, Count, Random, Boxes);
+		TEST_CHECK(CheckMasks(Cube, Boxes) == Count);
+	}
+
+	/* A NaN box compares false against every plane, both keep it */
+	RandomBoxes(19, Random, Boxes);
+	Boxes.CenterX[3] = std::numeric_limits<float>::quiet_NaN();
+	Boxes.CenterY[12] = std::numeric_limits<float>::quiet_NaN();
+	Boxes.ExtentZ[17] = std::numeric_limits<float>::quiet_NaN();
+	CheckMasks(Cube, Boxes);
+
+	return Test::Result();
+}
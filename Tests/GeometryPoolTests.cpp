@@ -0,0 +1,328 @@
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "GeometryPool.h"
+#include "TestHelpers.h"
+
+/*
+* GeometryPool uploads through UploadService into mock device local buffers (MockGateware.h)
+*	After the batch is submitted every range has to hold its mesh's vertices and its indices, narrowed to uint16 when they fit,
+*	meshes already resident are not uploaded again and growing an arena keeps what it held
+*	All of it runs with the batch on the graphics queue and again with the copies on a transfer queue
+*/
+
+/* Same size as PackedVertex, the pool only copies bytes */
+struct TestVertex
+{
+	uint16 Position[4];
+	int16 Normal[2];
+	uint16 TexCoord[2];
+};
+
+struct TestMesh
+{
+	std::string Key;
+	std::vector<TestVertex> Vertices;
+	std::vector<uint32> Indices;
+
+	GeometryPool::MeshData GetData() const
+	{
+		return { Key, Vertices.data(), static_cast<uint32>(Vertices.size()), Indices.data(), static_cast<uint32>(Indices.size()) };
+	}
+};
+
+static GW::GRAPHICS::GVulkanSurface Surface;
+
+/* Random vertices, indices below vertexCount with largestIndex somewhere among them */
+static TestMesh MakeMesh(const std::string& key, uint32 vertexCount, uint32 indexCount, uint32 largestIndex, std::mt19937& random)
+{
+	TestMesh Mesh;
+	Mesh.Key = key;
+	Mesh.Vertices.resize(vertexCount);
+	for (TestVertex& Vertex : Mesh.Vertices)
+	{
+		unsigned char* Bytes = reinterpret_cast<unsigned char*>(&Vertex);
+		for (size_t i = 0; i < sizeof(TestVertex); ++i)
+		{
+			Bytes[i] = static_cast<unsigned char>(random());
+		}
+	}
+
+	Mesh.Indices.resize(indexCount);
+	for (uint32& Index : Mesh.Indices)
+	{
+		Index = random() % (largestIndex + 1);
+	}
+	if (indexCount > 0)
+	{
+		Mesh.Indices[random() % indexCount] = largestIndex;
+	}
+
+	return Mesh;
+}
+
+static const char* GetArenaData(VkBuffer buffer)
+{
+	return buffer->Memory->Data + buffer->Offset;
+}
+
+/* What the frame does, the batch runs and the staging buffers are retired */
+static void SubmitUploads()
+{
+	UploadService::Get().Submit();
+	DeletionQueue::Get().BeginFrame();
+}
+
+/* The range holds mesh's bytes, indices in the arena of the width the pool picked for them */
+static void CheckRange(const TestMesh& mesh, const GeometryPool::Range& range)
+{
+	TEST_CHECK(range.VertexCount == mesh.Vertices.size());
+	TEST_CHECK(range.IndexCount == mesh.Indices.size());
+
+	bool FitsShort = true;
+	for (uint32 Index : mesh.Indices)
+	{
+		FitsShort &= Index <= GeometryPool::MaxShortIndex;
+	}
+	TEST_CHECK(range.IndexSizeInBytes == (FitsShort ? sizeof(uint16) : sizeof(uint32)));
+
+	GeometryPool& Pool = GeometryPool::Get();
+	if (!mesh.Vertices.empty())
+	{
+		const char* Vertices = GetArenaData(Pool.GetVertexBuffer()) + static_cast<size_t>(range.VertexOffset) * sizeof(TestVertex);
+		TEST_CHECK(std::memcmp(Vertices, mesh.Vertices.data(), mesh.Vertices.size() * sizeof(TestVertex)) == 0);
+	}
+
+	if (mesh.Indices.empty())
+	{
+		return;
+	}
+
+	const char* Indices = GetArenaData(Pool.GetIndexBuffer(range.IndexSizeInBytes)) + static_cast<size_t>(range.IndexOffset) * range.IndexSizeInBytes;
+	if (range.IndexSizeInBytes == sizeof(uint32))
+	{
+		TEST_CHECK(std::memcmp(Indices, mesh.Indices.data(), mesh.Indices.size() * sizeof(uint32)) == 0);
+		return;
+	}
+
+	uint32 Mismatches = 0;
+	for (size_t i = 0; i < mesh.Indices.size(); ++i)
+	{
+		uint16 Index = 0;
+		std::memcpy(&Index, Indices + i * sizeof(uint16), sizeof(uint16));
+		Mismatches += Index != mesh.Indices[i];
+	}
+	TEST_CHECK(Mismatches == 0);
+}
+
+static std::vector<GeometryPool::MeshData> GetData(const std::vector<TestMesh>& meshes)
+{
+	std::vector<GeometryPool::MeshData> Data;
+	for (const TestMesh& Mesh : meshes)
+	{
+		Data.push_back(Mesh.GetData());
+	}
+
+	return Data;
+}
+
+/* 16 and 32 bit meshes, one without indices, one without a key and the same key twice in one call */
+static void TestUpload(std::mt19937& random)
+{
+	std::vector<TestMesh> Meshes;
+	Meshes.push_back(MakeMesh("Short", 300, 900, 299, random));
+	Meshes.push_back(MakeMesh("Restart", 70000, 3000, 0xFFFF, random));
+	Meshes.push_back(MakeMesh("Long", 100000, 6000, 99999, random));
+	Meshes.push_back(MakeMesh("NoIndices", 17, 0, 0, random));
+	Meshes.push_back(MakeMesh("", 40, 120, 39, random));
+	Meshes.push_back(Meshes[0]);
+
+	std::vector<GeometryPool::Range> Ranges;
+	TEST_CHECK(GeometryPool::Get().Acquire(GetData(Meshes), Ranges));
+	TEST_CHECK(Ranges.size() == Meshes.size());
+
+	GeometryPool::Stats Stats = GeometryPool::Get().GetStats();
+	TEST_CHECK(Stats.MeshesUploadedLastAcquire == 5);
+	TEST_CHECK(Stats.MeshesReusedLastAcquire == 1);
+
+	SubmitUploads();
+	for (size_t i = 0; i < Meshes.size() && i < Ranges.size(); ++i)
+	{
+		CheckRange(Meshes[i], Ranges[i]);
+	}
+
+	/* The duplicate shares the first one's range */
+	TEST_CHECK(Ranges[5].VertexOffset == Ranges[0].VertexOffset && Ranges[5].IndexOffset == Ranges[0].IndexOffset);
+
+	/* A second level with the same keyed meshes, their geometry is not even read */
+	std::vector<GeometryPool::MeshData> Resident = GetData(Meshes);
+	Resident.pop_back();
+	Resident.erase(Resident.begin() + 4);
+	for (GeometryPool::MeshData& Mesh : Resident)
+	{
+		Mesh.Vertices = nullptr;
+		Mesh.Indices = nullptr;
+	}
+
+	std::vector<GeometryPool::Range> ResidentRanges;
+	TEST_CHECK(GeometryPool::Get().Acquire(Resident, ResidentRanges));
+	Stats = GeometryPool::Get().GetStats();
+	TEST_CHECK(Stats.MeshesUploadedLastAcquire == 0);
+	TEST_CHECK(Stats.MeshesReusedLastAcquire == 4);
+	TEST_CHECK(Stats.BytesUploadedLastAcquire == 0);
+	for (size_t i = 0; i < ResidentRanges.size(); ++i)
+	{
+		TEST_CHECK(ResidentRanges[i].VertexOffset == Ranges[i].VertexOffset && ResidentRanges[i].IndexOffset == Ranges[i].IndexOffset);
+	}
+
+	GeometryPool::Get().Release(ResidentRanges);
+	GeometryPool::Get().Release(Ranges);
+	SubmitUploads();
+
+	Stats = GeometryPool::Get().GetStats();
+	TEST_CHECK(Stats.MeshCount == 0);
+	TEST_CHECK(Stats.VerticesUsed == 0 && Stats.IndicesUsed == 0 && Stats.ShortIndicesUsed == 0);
+}
+
+/* Levels that outgrow the arenas, what was resident has to be copied into the new buffers */
+static void TestGrowth(std::mt19937& random)
+{
+	std::vector<TestMesh> Meshes;
+	std::vector<std::vector<GeometryPool::Range>> Ranges;
+	uint32 GrowCountBefore = GeometryPool::Get().GetStats().GrowCount;
+
+	for (uint32 Level = 0; Level < 6; ++Level)
+	{
+		std::vector<TestMesh> LevelMeshes;
+		for (uint32 i = 0; i < 4; ++i)
+		{
+			uint32 VertexCount = 20000 + random() % 120000;
+			uint32 LargestIndex = (random() % 2) ? VertexCount - 1 : VertexCount % 0xFFFF;
+			LevelMeshes.push_back(MakeMesh("Level" + std::to_string(Level) + "_" + std::to_string(i), VertexCount, 3 * (10000 + random() % 60000), LargestIndex, random));
+		}
+
+		Ranges.emplace_back();
+		TEST_CHECK(GeometryPool::Get().Acquire(GetData(LevelMeshes), Ranges.back()));
+		SubmitUploads();
+
+		Meshes.insert(Meshes.end(), LevelMeshes.begin(), LevelMeshes.end());
+	}
+
+	TEST_CHECK(GeometryPool::Get().GetStats().GrowCount > GrowCountBefore);
+
+	for (size_t Level = 0; Level < Ranges.size(); ++Level)
+	{
+		for (size_t i = 0; i < Ranges[Level].size(); ++i)
+		{
+			CheckRange(Meshes[Level * 4 + i], Ranges[Level][i]);
+		}
+	}
+
+	for (const std::vector<GeometryPool::Range>& LevelRanges : Ranges)
+	{
+		GeometryPool::Get().Release(LevelRanges);
+	}
+	SubmitUploads();
+}
+
+/* The staging buffer cannot be created, none of the meshes that needed it may become resident */
+static void TestStagingFailure(std::mt19937& random)
+{
+	std::vector<TestMesh> Meshes;
+	Meshes.push_back(MakeMesh("Resident", 500, 1500, 499, random));
+
+	std::vector<GeometryPool::Range> ResidentRanges;
+	TEST_CHECK(GeometryPool::Get().Acquire(GetData(Meshes), ResidentRanges));
+	SubmitUploads();
+
+	/* Over half a block, staging it needs a dedicated allocation of its own, which fails */
+	Meshes.push_back(MakeMesh("Big", 1100000, 30000, 1099999, random));
+	Meshes.push_back(Meshes.back());
+	Meshes.push_back(MakeMesh("", 40, 120, 39, random));
+
+	MockDevice::FailAllocations = true;
+	std::vector<GeometryPool::Range> Ranges;
+	TEST_CHECK(!GeometryPool::Get().Acquire(GetData(Meshes), Ranges));
+	MockDevice::FailAllocations = false;
+	SubmitUploads();
+
+	CheckRange(Meshes[0], Ranges[0]);
+	for (size_t i = 1; i < Ranges.size(); ++i)
+	{
+		TEST_CHECK(Ranges[i].Key.empty() && Ranges[i].VertexCount == 0 && Ranges[i].IndexCount == 0);
+	}
+
+	GeometryPool::Stats Stats = GeometryPool::Get().GetStats();
+	TEST_CHECK(Stats.MeshCount == 1);
+	TEST_CHECK(Stats.VerticesUsed == Meshes[0].Vertices.size());
+	TEST_CHECK(Stats.ShortIndicesUsed + Stats.IndicesUsed == Meshes[0].Indices.size());
+
+	/* Nothing stale was left behind, the next level uploads the mesh again */
+	std::vector<GeometryPool::Range> RetryRanges;
+	TEST_CHECK(GeometryPool::Get().Acquire({ Meshes[1].GetData() }, RetryRanges));
+	TEST_CHECK(GeometryPool::Get().GetStats().MeshesUploadedLastAcquire == 1);
+	SubmitUploads();
+	CheckRange(Meshes[1], RetryRanges[0]);
+
+	GeometryPool::Get().Release(RetryRanges);
+	GeometryPool::Get().Release(Ranges);
+	GeometryPool::Get().Release(ResidentRanges);
+	SubmitUploads();
+	TEST_CHECK(GeometryPool::Get().GetStats().MeshCount == 0);
+}
+
+/* Arenas the pool created are shared between the families when the copies run on a transfer queue */
+static void CheckArenaSharing(VkSharingMode sharing)
+{
+	GeometryPool& Pool = GeometryPool::Get();
+	VkBuffer Arenas[] = { Pool.GetVertexBuffer(), Pool.GetIndexBuffer(sizeof(uint32)), Pool.GetIndexBuffer(sizeof(uint16)) };
+	for (VkBuffer Arena : Arenas)
+	{
+		TEST_CHECK(Arena == nullptr || Arena->SharingMode == sharing);
+	}
+}
+
+int main()
+{
+	/* Any handle will do, the mock never looks at them */
+	GpuMemory::Get().Initialize(reinterpret_cast<VkPhysicalDevice>(1), reinterpret_cast<VkDevice>(1));
+	DeletionQueue::Get().Initialize(2);
+
+	/* The pool and the allocator print what they do in DEBUG builds */
+	std::cout.setstate(std::ios::failbit);
+
+	const bool TransferQueues[] = { false, true };
+	for (bool TransferQueue : TransferQueues)
+	{
+		Surface.HasTransferQueue = TransferQueue;
+		UploadService::Get().Initialize(reinterpret_cast<VkDevice>(1), &Surface);
+		GeometryPool::Get().Initialize(sizeof(TestVertex));
+		TEST_CHECK(UploadService::Get().GetStats().UsesTransferQueue == TransferQueue);
+
+		std::mt19937 Random(11);
+		TestUpload(Random);
+		TestGrowth(Random);
+		TestStagingFailure(Random);
+
+		CheckArenaSharing(TransferQueue ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE);
+
+		/* Every copy batch on the transfer queue is waited on by the graphics batch submitted after it */
+		TEST_CHECK((MockDevice::QueueSubmits[1] > 0) == TransferQueue);
+		TEST_CHECK(MockDevice::WaitingSubmits == MockDevice::QueueSubmits[1]);
+
+		GeometryPool::Get().Shutdown();
+		DeletionQueue::Get().Flush();
+		UploadService::Get().Shutdown();
+	}
+	std::cout.clear();
+
+	TEST_CHECK(MockDevice::InvalidCopies == 0);
+	TEST_CHECK(MockDevice::InvalidSubmits == 0);
+	TEST_CHECK(MockDevice::LiveBuffers == 0);
+	TEST_CHECK(MockDevice::LiveSemaphores == 0);
+	TEST_CHECK(MockDevice::LiveCommandPools == 0);
+
+	return Test::Result();
+}
@@ -0,0 +1,320 @@
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "GpuMemoryAllocator.h"
+#include "TestHelpers.h"
+
+/*
+* Randomized allocate / free against GpuMemoryAllocator over a calloc backend, run under ASan/UBSan
+*	After every operation the live allocations must not overlap, stay inside their block, keep their alignment and
+*	their bytes, and the stats must add up to what is alive, both in the allocator and in the backend
+*	The heaps are small so the budget, dedicated blocks and backend failures are all hit: GpuMemoryAllocatorTests [operations]
+*/
+
+static const size_t BlockSize = 1024 * 1024;
+
+/* Type 0 is device local on heap 0, type 1 host visible on heap 1, type 2 host visible on heap 0 */
+static const uint32 MemoryTypeCount = 3;
+static const bool HostVisible[MemoryTypeCount] = { false, true, true };
+
+/* Blocks of calloc memory, mapped for the host visible types */
+class MockBackend : public GpuMemoryBackend
+{
+public:
+	struct LiveBlock
+	{
+		uint32 MemoryTypeIndex;
+		size_t SizeInBytes;
+		char* Data;
+	};
+
+	std::map<GpuMemoryHandle, LiveBlock> Blocks;
+	size_t LiveBytes = 0;
+
+	/* AllocateBlock() fails once every FailEvery calls, 0 never */
+	uint32 FailEvery = 0;
+	uint32 CallCount = 0;
+	uint32 FailedCount = 0;
+
+public:
+	virtual GpuMemoryHandle AllocateBlock(uint32 memoryTypeIndex, size_t sizeInBytes, char** outMapped) override
+	{
+		CallCount++;
+		if (FailEvery > 0 && CallCount % FailEvery == 0)
+		{
+			FailedCount++;
+			return nullptr;
+		}
+
+		char* Data = static_cast<char*>(std::calloc(sizeInBytes, 1));
+		Blocks[Data] = { memoryTypeIndex, sizeInBytes, Data };
+		LiveBytes += sizeInBytes;
+
+		*outMapped = HostVisible[memoryTypeIndex] ? Data : nullptr;
+		return Data;
+	}
+
+	virtual void FreeBlock(uint32 memoryTypeIndex, GpuMemoryHandle memory) override
+	{
+		std::map<GpuMemoryHandle, LiveBlock>::iterator Found = Blocks.find(memory);
+		TEST_CHECK(Found != Blocks.end());
+		if (Found == Blocks.end())
+		{
+			return;
+		}
+
+		TEST_CHECK(Found->second.MemoryTypeIndex == memoryTypeIndex);
+		LiveBytes -= Found->second.SizeInBytes;
+		std::free(Found->second.Data);
+		Blocks.erase(Found);
+	}
+};
+
+/* Bytes filled at each end of a mapped allocation, the range checks already cover the middle */
+static const size_t FilledBytes = 2048;
+
+/* An allocation the test holds and the byte it filled the ends of its mapped range with */
+struct LiveAllocation
+{
+	GpuAllocation Allocation;
+	size_t Alignment;
+	unsigned char Fill;
+};
+
+struct Tester
+{
+	MockBackend Backend;
+	GpuMemoryAllocator Allocator;
+	std::vector<LiveAllocation> Live;
+	std::vector<size_t> Budgets;
+
+	std::mt19937 Random;
+	uint32 Failures = 0;
+
+	Tester() : Random(16)
+	{
+		Budgets = { 40 * BlockSize, 20 * BlockSize };
+		Allocator.Initialize(&Backend, { 0, 1, 0 }, Budgets, BlockSize);
+	}
+
+	/* Mostly size class allocations, then buddy ranges and a few dedicated blocks */
+	size_t RandomSize()
+	{
+		uint32 Kind = Random() % 100;
+		if (Kind < 70)
+		{
+			return 1 + Random() % GpuMemoryAllocator::MaxSizeClassInBytes;
+		}
+		if (Kind < 95)
+		{
+			return GpuMemoryAllocator::MaxSizeClassInBytes + 1 + Random() % (BlockSize / 2 - GpuMemoryAllocator::MaxSizeClassInBytes);
+		}
+		return BlockSize / 2 + 1 + Random() % (2 * BlockSize);
+	}
+
+	void Allocate()
+	{
+		uint32 MemoryTypeIndex = Random() % MemoryTypeCount;
+		size_t Size = RandomSize();
+		size_t Alignment = size_t(1) << (Random() % 17);
+
+		GpuMemoryAllocator::Stats Before = Allocator.GetStats();
+
+		LiveAllocation Item;
+		Item.Alignment = Alignment;
+		Item.Fill = static_cast<unsigned char>(1 + Random() % 255);
+		if (!Allocator.Allocate(MemoryTypeIndex, Size, Alignment, Item.Allocation))
+		{
+			/* Only the budget or the backend may fail it, and nothing may change but the counters */
+			Failures++;
+			TEST_CHECK(!Item.Allocation.IsValid());
+
+			GpuMemoryAllocator::Stats After = Allocator.GetStats();
+			TEST_CHECK(After.AllocationCount == Before.AllocationCount);
+			TEST_CHECK(After.UsedBytes == Before.UsedBytes);
+			TEST_CHECK(After.ReservedBytes == Before.ReservedBytes);
+			return;
+		}
+
+		const GpuAllocation& Allocation = Item.Allocation;
+		TEST_CHECK(Allocation.Size == Size);
+		TEST_CHECK(Allocation.ReservedSize >= Size && Allocation.ReservedSize >= Alignment);
+		TEST_CHECK(Allocation.Offset % Alignment == 0);
+		TEST_CHECK(Allocation.MemoryTypeIndex == MemoryTypeIndex);
+
+		std::map<GpuMemoryHandle, MockBackend::LiveBlock>::iterator Owner = Backend.Blocks.find(Allocation.Memory);
+		TEST_CHECK(Owner != Backend.Blocks.end());
+		if (Owner == Backend.Blocks.end())
+		{
+			return;
+		}
+
+		TEST_CHECK(Owner->second.MemoryTypeIndex == MemoryTypeIndex);
+		TEST_CHECK(Allocation.Offset + Allocation.ReservedSize <= Owner->second.SizeInBytes);
+
+		if (HostVisible[MemoryTypeIndex])
+		{
+			TEST_CHECK(Allocation.Mapped == Owner->second.Data + Allocation.Offset);
+
+			size_t Ends = Size < 2 * FilledBytes ? Size : FilledBytes;
+			std::memset(Allocation.Mapped, Item.Fill, Ends);
+			std::memset(Allocation.Mapped + Size - Ends, Item.Fill, Ends);
+		}
+		else
+		{
+			TEST_CHECK(Allocation.Mapped == nullptr);
+		}
+
+		Live.push_back(Item);
+	}
+
+	void Free(size_t index)
+	{
+		LiveAllocation& Item = Live[index];
+
+		/* A range handed to someone else in the meantime would have been overwritten */
+		if (Item.Allocation.Mapped)
+		{
+			const unsigned char* Bytes = reinterpret_cast<const unsigned char*>(Item.Allocation.Mapped);
+			size_t Size = Item.Allocation.Size;
+			size_t Ends = Size < 2 * FilledBytes ? Size : FilledBytes;
+
+			bool Intact = true;
+			for (size_t i = 0; i < Ends && Intact; ++i)
+			{
+				Intact = Bytes[i] == Item.Fill && Bytes[Size - 1 - i] == Item.Fill;
+			}
+			TEST_CHECK(Intact);
+		}
+
+		Allocator.Free(Item.Allocation);
+		TEST_CHECK(!Item.Allocation.IsValid());
+
+		Live[index] = Live.back();
+		Live.pop_back();
+	}
+
+	/* Live ranges must not overlap and the stats must match them and the backend */
+	void CheckState()
+	{
+		std::map<GpuMemoryHandle, std::map<size_t, size_t>> Ranges;
+		size_t UsedBytes = 0;
+		size_t ReservedBytes = 0;
+		for (const LiveAllocation& Item : Live)
+		{
+			const GpuAllocation& Allocation = Item.Allocation;
+			UsedBytes += Allocation.Size;
+			ReservedBytes += Allocation.ReservedSize;
+
+			std::map<size_t, size_t>& BlockRanges = Ranges[Allocation.Memory];
+			std::map<size_t, size_t>::iterator Next = BlockRanges.lower_bound(Allocation.Offset);
+			if (Next != BlockRanges.end())
+			{
+				TEST_CHECK(Allocation.Offset + Allocation.ReservedSize <= Next->first);
+			}
+			if (Next != BlockRanges.begin())
+			{
+				TEST_CHECK(std::prev(Next)->second <= Allocation.Offset);
+			}
+			BlockRanges[Allocation.Offset] = Allocation.Offset + Allocation.ReservedSize;
+		}
+
+		GpuMemoryAllocator::Stats Current = Allocator.GetStats();
+		TEST_CHECK(Current.AllocationCount == Live.size());
+		TEST_CHECK(Current.UsedBytes == UsedBytes);
+		TEST_CHECK(Current.ReservedBytes == ReservedBytes);
+		TEST_CHECK(Current.BlockCount == Backend.Blocks.size());
+		TEST_CHECK(Current.BlockBytes == Backend.LiveBytes);
+
+		for (uint32 i = 0; i < Current.Heaps.size(); ++i)
+		{
+			TEST_CHECK(Current.Heaps[i].BlockBytes <= Budgets[i]);
+		}
+	}
+
+	/* Once everything is freed at most one sub allocated block per memory type is kept */
+	void CheckEmpty()
+	{
+		GpuMemoryAllocator::Stats Current = Allocator.GetStats();
+		TEST_CHECK(Current.AllocationCount == 0 && Current.UsedBytes == 0 && Current.ReservedBytes == 0);
+		TEST_CHECK(Current.DedicatedBlockCount == 0);
+		TEST_CHECK(Current.BlockCount <= MemoryTypeCount);
+	}
+
+	void Run(uint32 operationCount)
+	{
+		for (uint32 Operation = 0; Operation < operationCount; ++Operation)
+		{
+			/* Phases that fill the heaps up, drain them, and hold steady, with and without backend failures */
+			uint32 Phase = (Operation / 5000) % 4;
+			Backend.FailEvery = Phase == 3 ? 7 : 0;
+			uint32 AllocatePercent = Phase == 0 ? 70 : (Phase == 1 ? 30 : 50);
+
+			if (Live.empty() || Random() % 100 < AllocatePercent)
+			{
+				Allocate();
+			}
+			else
+			{
+				Free(Random() % Live.size());
+			}
+
+			/* Freeing nothing does nothing */
+			if (Operation % 1000 == 0)
+			{
+				GpuAllocation Invalid;
+				Allocator.Free(Invalid);
+			}
+
+			if (Operation % 97 == 0 || Live.size() < 4)
+			{
+				CheckState();
+			}
+
+			if (Operation % 50000 == 49999)
+			{
+				while (!Live.empty())
+				{
+					Free(Live.size() - 1);
+				}
+				CheckEmpty();
+			}
+		}
+
+		while (!Live.empty())
+		{
+			Free(Random() % Live.size());
+		}
+		CheckState();
+		CheckEmpty();
+	}
+};
+
+int main(int argc, char** argv)
+{
+	uint32 OperationCount = argc > 1 ? static_cast<uint32>(std::strtoul(argv[1], nullptr, 10)) : 200000;
+
+	Tester Allocations;
+	Allocations.Run(OperationCount);
+
+	/* The budget and the backend both refused some, or the test never reached them */
+	GpuMemoryAllocator::Stats Current = Allocations.Allocator.GetStats();
+	uint32 OverBudgetCount = 0;
+	for (const GpuMemoryAllocator::HeapStats& Heap : Current.Heaps)
+	{
+		OverBudgetCount += Heap.OverBudgetCount;
+	}
+	TEST_CHECK(OverBudgetCount > 0);
+	TEST_CHECK(Allocations.Backend.FailedCount > 0);
+
+	std::cout << "\n" << OperationCount << " operations, " << Allocations.Failures << " allocations refused (" << OverBudgetCount << " over budget, "
+		<< Allocations.Backend.FailedCount << " by the backend)";
+
+	Allocations.Allocator.Shutdown();
+	TEST_CHECK(Allocations.Backend.Blocks.empty());
+
+	return Test::Result();
+}
@@ -0,0 +1,267 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "h2bParser.h"
+#include "TestHelpers.h"
+
+/*
+* Fuzzes H2B::MappedParser with validate on, parsing must never read outside its input and whatever it accepts
+* must be safe to draw from
+*	Built with H2B_FUZZ_LIBFUZZER (LEVELRENDERER_LIBFUZZER) this is a libFuzzer target, seed it with Assets/h2b
+*	Otherwise main() runs every .h2b under a folder (Assets/ by default) truncated at many lengths and with its header,
+*	counts and tables mutated: H2BFuzz [folder] [mutations per file]
+*/
+
+/* Header layout: version, vertexCount, indexCount, materialCount, meshCount */
+static const size_t HeaderSize = 20;
+
+/* data is copied into a buffer of exactly size bytes so a read past the end is caught by ASan */
+static bool ParseInput(const uint8_t* data, size_t size)
+{
+	std::vector<char> Buffer(data, data + size);
+
+	H2B::MappedParser Parser;
+	if (!Parser.ParseMemory(Buffer.data(), Buffer.size(), true))
+	{
+		return false;
+	}
+
+	const char* Begin = Buffer.data();
+	const char* End = Begin + Buffer.size();
+	TEST_CHECK(reinterpret_cast<const char*>(Parser.vertices + Parser.vertexCount) <= End);
+	TEST_CHECK(reinterpret_cast<const char*>(Parser.indices + Parser.indexCount) <= End);
+	TEST_CHECK(reinterpret_cast<const char*>(Parser.batches + Parser.materialCount) <= End);
+
+	/* Walk every accepted range the way a mesh upload would */
+	float Sum = 0.0f;
+	for (uint32_t i = 0; i < Parser.meshCount; ++i)
+	{
+		const H2B::MESH& Mesh = Parser.meshes[i];
+		TEST_CHECK(Mesh.materialIndex < Parser.materialCount);
+		TEST_CHECK(static_cast<uint64_t>(Mesh.drawInfo.indexOffset) + Mesh.drawInfo.indexCount <= Parser.indexCount);
+		if (Mesh.name)
+		{
+			TEST_CHECK(Mesh.name >= Begin && Mesh.name + std::strlen(Mesh.name) < End);
+		}
+
+		for (uint32_t j = 0; j < Mesh.drawInfo.indexCount && Mesh.drawInfo.indexOffset + j < Parser.indexCount; ++j)
+		{
+			uint32_t Index = Parser.indices[Mesh.drawInfo.indexOffset + j];
+			TEST_CHECK(Index < Parser.vertexCount);
+			if (Index < Parser.vertexCount)
+			{
+				H2B::VECTOR Position;
+				std::memcpy(&Position, &Parser.vertices[Index].pos, sizeof(Position));
+				Sum += Position.x;
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < Parser.materialCount; ++i)
+	{
+		const char* const* Strings = &Parser.materials[i].name;
+		for (uint32_t j = 0; j < 10; ++j)
+		{
+			if (Strings[j])
+			{
+				TEST_CHECK(Strings[j] >= Begin && Strings[j] + std::strlen(Strings[j]) < End);
+			}
+		}
+	}
+
+	Test::Consume(Sum);
+	return true;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	unsigned int FailuresBefore = Test::FailureCount();
+	ParseInput(data, size);
+	if (Test::FailureCount() != FailuresBefore)
+	{
+		/* libFuzzer only keeps inputs that crash */
+		std::abort();
+	}
+	return 0;
+}
+
+#ifndef H2B_FUZZ_LIBFUZZER
+static void PutUint32(std::vector<uint8_t>& data, size_t offset, uint32_t value)
+{
+	if (offset + 4 <= data.size())
+	{
+		std::memcpy(&data[offset], &value, 4);
+	}
+}
+
+/* Counts that are off by a little, the boundaries and garbage */
+static uint32_t MutateCount(uint32_t count, std::mt19937& random)
+{
+	switch (random() % 6)
+	{
+	case 0: return count + 1;
+	case 1: return count - 1;
+	case 2: return count * 2;
+	case 3: return 0;
+	case 4: return 0xFFFFFFFFu - (random() % 4);
+	default: return random();
+	}
+}
+
+static std::vector<uint8_t> Mutate(const std::vector<uint8_t>& original, std::mt19937& random)
+{
+	std::vector<uint8_t> Data = original;
+
+	uint32_t MutationCount = 1 + random() % 4;
+	for (uint32_t m = 0; m < MutationCount && !Data.empty(); ++m)
+	{
+		/* The tail holds the strings, batches and mesh table, the parts with variable sizes */
+		size_t TailSize = Data.size() < 4096 ? Data.size() : 4096;
+		switch (random() % 6)
+		{
+		case 0:
+		{
+			size_t CountOffset = 4 + 4 * (random() % 4);
+			uint32_t Count = 0;
+			if (CountOffset + 4 <= Data.size())
+			{
+				std::memcpy(&Count, &Data[CountOffset], 4);
+			}
+			PutUint32(Data, CountOffset, MutateCount(Count, random));
+			break;
+		}
+		case 1:
+			Data[random() % (Data.size() < HeaderSize ? Data.size() : HeaderSize)] = static_cast<uint8_t>(random());
+			break;
+		case 2:
+			Data[Data.size() - 1 - random() % TailSize] = static_cast<uint8_t>(random());
+			break;
+		case 3:
+		{
+			/* Removes or adds a string terminator */
+			uint8_t& Byte = Data[Data.size() - 1 - random() % TailSize];
+			Byte = Byte == 0 ? 0x41 : 0;
+			break;
+		}
+		case 4:
+		{
+			/* A batch, draw range or index that points elsewhere */
+			size_t Offset = (Data.size() - 1 - random() % TailSize) & ~size_t(3);
+			uint32_t Value = 0;
+			if (Offset + 4 <= Data.size())
+			{
+				std::memcpy(&Value, &Data[Offset], 4);
+			}
+			PutUint32(Data, Offset, MutateCount(Value, random));
+			break;
+		}
+		default:
+			Data[random() % Data.size()] = static_cast<uint8_t>(random());
+			break;
+		}
+	}
+
+	if (random() % 4 == 0)
+	{
+		Data.resize(random() % (Data.size() + 1));
+	}
+
+	return Data;
+}
+
+static bool ReadWholeFile(const std::filesystem::path& path, std::vector<uint8_t>& outData)
+{
+	std::ifstream File(path, std::ios::binary);
+	if (!File)
+	{
+		return false;
+	}
+
+	outData.assign(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+	return true;
+}
+
+/* Runs one corpus file, returns how many of the inputs were accepted */
+static uint32_t FuzzFile(const std::vector<uint8_t>& original, uint32_t mutationCount, std::mt19937& random)
+{
+	uint32_t Accepted = 0;
+
+	/* The untouched file is a valid h2b */
+	bool OriginalParsed = ParseInput(original.data(), original.size());
+	TEST_CHECK(OriginalParsed);
+	Accepted += OriginalParsed ? 1 : 0;
+
+	/* Every length through the header and first vertices, evenly spaced lengths through the body and the whole tail */
+	std::vector<size_t> Lengths;
+	for (size_t i = 0; i < original.size() && i <= 256; ++i)
+	{
+		Lengths.push_back(i);
+	}
+	for (size_t i = 1; i < 512; ++i)
+	{
+		Lengths.push_back(original.size() * i / 512);
+	}
+	for (size_t i = 1; i <= 64 && i <= original.size(); ++i)
+	{
+		Lengths.push_back(original.size() - i);
+	}
+
+	for (size_t Length : Lengths)
+	{
+		Accepted += ParseInput(original.data(), Length) ? 1 : 0;
+	}
+
+	for (uint32_t i = 0; i < mutationCount; ++i)
+	{
+		std::vector<uint8_t> Mutated = Mutate(original, random);
+		Accepted += ParseInput(Mutated.data(), Mutated.size()) ? 1 : 0;
+	}
+
+	return Accepted;
+}
+
+int main(int argc, char** argv)
+{
+	std::filesystem::path Folder = argc > 1 ? argv[1] : LEVELRENDERER_ASSETS_DIR;
+	uint32_t MutationCount = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 2000;
+
+	std::error_code Error;
+	uint32_t FileCount = 0;
+	for (const std::filesystem::directory_entry& Entry : std::filesystem::recursive_directory_iterator(Folder, Error))
+	{
+		if (!Entry.is_regular_file() || Entry.path().extension() != ".h2b")
+		{
+			continue;
+		}
+
+		std::vector<uint8_t> Original;
+		if (!ReadWholeFile(Entry.path(), Original))
+		{
+			std::cout << "\nFailed to read " << Entry.path().string();
+			TEST_CHECK(false);
+			continue;
+		}
+
+		/* Same inputs on every run, a failure can be replayed */
+		std::mt19937 Random(static_cast<uint32_t>(Original.size()));
+		uint32_t Accepted = FuzzFile(Original, MutationCount, Random);
+		std::cout << "\n" << Entry.path().filename().string() << ": " << Accepted << " inputs accepted";
+		FileCount++;
+	}
+
+	if (FileCount == 0)
+	{
+		std::cout << "\nNo .h2b files under " << Folder.string();
+		TEST_CHECK(FileCount > 0);
+	}
+
+	return Test::Result();
+}
+#endif // H2B_FUZZ_LIBFUZZER
@@ -0,0 +1,165 @@
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "FileHelper.h"
+#include "GameLevelBinary.h"
+#include "TestHelpers.h"
+
+/*
+* FileHelper::ReadGameLevelBinaryFile() on a level compiled from Levels/ and on corrupted copies of it
+*	A corrupt compiled level has to be rejected (false, nothing read) so Level::ReadRawData() recompiles it,
+*	under UBSan an entry whose Type or Light is cast to an enum it is not part of aborts the test
+*/
+
+static std::vector<char> ReadFile(const std::string& path)
+{
+	std::ifstream Input(path, std::ios::binary);
+	return std::vector<char>((std::istreambuf_iterator<char>(Input)), std::istreambuf_iterator<char>());
+}
+
+static void WriteFile(const std::string& path, const std::vector<char>& data)
+{
+	std::ofstream Output(path, std::ios::binary | std::ios::trunc);
+	Output.write(data.data(), data.size());
+}
+
+static bool ReadSilently(const std::string& path, std::vector<RawMeshData>& Meshes)
+{
+	/* The reader prints per entry in DEBUG builds */
+	std::cout.setstate(std::ios::failbit);
+	bool Result = FileHelper::ReadGameLevelBinaryFile(path.c_str(), Meshes);
+	std::cout.clear();
+	return Result;
+}
+
+/* The compiled level reads back as the text file it was compiled from */
+static void TestRoundTrip(const std::string& levelPath, const std::string& binaryPath)
+{
+	std::vector<RawMeshData> Expected;
+	std::cout.setstate(std::ios::failbit);
+	FileHelper::ReadGameLevelFile(levelPath.c_str(), Expected);
+	std::cout.clear();
+
+	std::vector<RawMeshData> Meshes;
+	TEST_CHECK(ReadSilently(binaryPath, Meshes));
+	TEST_CHECK(Meshes.size() == Expected.size());
+	for (size_t i = 0; i < Meshes.size() && i < Expected.size(); ++i)
+	{
+		TEST_CHECK(Meshes[i].Name == Expected[i].Name);
+		TEST_CHECK(Meshes[i].IsCamera == Expected[i].IsCamera);
+		TEST_CHECK(Meshes[i].IsLight == Expected[i].IsLight);
+		TEST_CHECK(Meshes[i].Light == Expected[i].Light);
+		TEST_CHECK(Meshes[i].InstanceCount == Expected[i].InstanceCount);
+		TEST_CHECK(Meshes[i].WorldMatrices.size() == Expected[i].WorldMatrices.size());
+		if (Meshes[i].WorldMatrices.size() == Expected[i].WorldMatrices.size() && !Meshes[i].WorldMatrices.empty())
+		{
+			TEST_CHECK(std::memcmp(Meshes[i].WorldMatrices.data(), Expected[i].WorldMatrices.data(), Meshes[i].WorldMatrices.size() * sizeof(Matrix4D)) == 0);
+		}
+	}
+}
+
+/* Every entry's Type and Light set to values outside their enums, one at a time */
+static void TestOutOfRangeEnums(const std::vector<char>& compiled, const std::string& scratchPath)
+{
+	GameLevelBinaryHeader Header;
+	std::memcpy(&Header, compiled.data(), sizeof(GameLevelBinaryHeader));
+
+	const uint32 BadValues[] = { 3, 3607101441u, 0xFFFFFFFFu };
+	for (uint32 i = 0; i < Header.EntryCount; ++i)
+	{
+		size_t EntryOffset = sizeof(GameLevelBinaryHeader) + i * sizeof(GameLevelBinaryEntry);
+		size_t FieldOffsets[] = { EntryOffset + offsetof(GameLevelBinaryEntry, Type), EntryOffset + offsetof(GameLevelBinaryEntry, Light) };
+
+		for (size_t FieldOffset : FieldOffsets)
+		{
+			for (uint32 BadValue : BadValues)
+			{
+				std::vector<char> Corrupted = compiled;
+				std::memcpy(Corrupted.data() + FieldOffset, &BadValue, sizeof(uint32));
+				WriteFile(scratchPath, Corrupted);
+
+				std::vector<RawMeshData> Meshes;
+				TEST_CHECK(!ReadSilently(scratchPath, Meshes));
+				TEST_CHECK(Meshes.empty());
+			}
+		}
+	}
+}
+
+/* Random bytes of the header and entries overwritten, whatever is accepted has to hold valid enums */
+static void TestMutations(const std::vector<char>& compiled, const std::string& scratchPath, unsigned int mutationCount)
+{
+	GameLevelBinaryHeader Header;
+	std::memcpy(&Header, compiled.data(), sizeof(GameLevelBinaryHeader));
+	size_t EntriesEnd = sizeof(GameLevelBinaryHeader) + Header.EntryCount * sizeof(GameLevelBinaryEntry);
+
+	std::mt19937 Random(1);
+	for (unsigned int i = 0; i < mutationCount; ++i)
+	{
+		std::vector<char> Corrupted = compiled;
+		unsigned int ByteCount = 1 + Random() % 4;
+		for (unsigned int j = 0; j < ByteCount; ++j)
+		{
+			Corrupted[Random() % EntriesEnd] = static_cast<char>(Random());
+		}
+		WriteFile(scratchPath, Corrupted);
+
+		std::vector<RawMeshData> Meshes;
+		if (ReadSilently(scratchPath, Meshes))
+		{
+			for (const RawMeshData& Mesh : Meshes)
+			{
+				TEST_CHECK(Mesh.Light == LightType::Directional || Mesh.Light == LightType::Point || Mesh.Light == LightType::Spot);
+				TEST_CHECK(!(Mesh.IsCamera && Mesh.IsLight));
+			}
+		}
+		else
+		{
+			TEST_CHECK(Meshes.empty());
+		}
+	}
+}
+
+int main()
+{
+	/* The reader looks for meshes in ../Assets/h2b/ like the renderer, which runs from a folder next to Assets/ */
+	std::filesystem::current_path(LEVELRENDERER_ASSETS_DIR "/../Levels");
+
+	std::string BinaryPath = (std::filesystem::temp_directory_path() / "LevelBinaryTests.lvlb").string();
+	std::string ScratchPath = (std::filesystem::temp_directory_path() / "LevelBinaryTestsCorrupt.lvlb").string();
+
+	const char* Levels[] = { "GameLevelLights.txt", "GameLevelMain.txt" };
+	for (const char* Level : Levels)
+	{
+		std::cout.setstate(std::ios::failbit);
+		bool Converted = FileHelper::ConvertGameLevelFile(Level, BinaryPath.c_str());
+		std::cout.clear();
+		TEST_CHECK(Converted);
+		if (!Converted)
+		{
+			continue;
+		}
+
+		std::vector<char> Compiled = ReadFile(BinaryPath);
+		TEST_CHECK(Compiled.size() >= sizeof(GameLevelBinaryHeader));
+		if (Compiled.size() < sizeof(GameLevelBinaryHeader))
+		{
+			continue;
+		}
+
+		TestRoundTrip(Level, BinaryPath);
+		TestOutOfRangeEnums(Compiled, ScratchPath);
+		TestMutations(Compiled, ScratchPath, 1000);
+	}
+
+	std::remove(BinaryPath.c_str());
+	std::remove(ScratchPath.c_str());
+	return Test::Result();
+}
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FileHelper.h"
+#include "MeshCache.h"
+#include "TestHelpers.h"
+
+/*
+* FileHelper::ReadGameLevelFileStream() (ifstream, line by line) against FileHelper::ReadGameLevelFile() (mapped, in place)
+*	Both readers have to produce the same entries, which is checked on every level before it is timed
+*	The generated level names meshes without h2b files so only the text is parsed, the Levels/ files also load their meshes
+*	FileHelper::LoadGameLevelMeshes() on GameLevelMain.txt is timed serially and on a pool, MeshCache is cleared before every load
+*	LevelParserTests (LEVEL_PARSER_TESTS) only runs the checks: LevelParserBenchmark [generated instance count]
+*/
+
+typedef void (*LevelReader)(const char* path, std::vector<RawMeshData>& Meshes);
+
+static void ReadSilently(LevelReader reader, const char* path, std::vector<RawMeshData>& Meshes)
+{
+	/* Both readers print per mesh in DEBUG builds, that would be most of what is timed */
+	std::cout.setstate(std::ios::failbit);
+	reader(path, Meshes);
+	std::cout.clear();
+}
+
+/* Every field a text reader fills, the world matrices bit for bit */
+static void CheckReadersAgree(const char* label, const char* path)
+{
+	std::vector<RawMeshData> Stream;
+	std::vector<RawMeshData> Mapped;
+	ReadSilently(FileHelper::ReadGameLevelFileStream, path, Stream);
+	ReadSilently(FileHelper::ReadGameLevelFile, path, Mapped);
+
+	unsigned int FailuresBefore = Test::FailureCount();
+
+	TEST_CHECK(!Mapped.empty());
+	TEST_CHECK(Stream.size() == Mapped.size());
+	size_t Count = std::min(Stream.size(), Mapped.size());
+	for (size_t i = 0; i < Count; ++i)
+	{
+		const RawMeshData& Expected = Stream[i];
+		const RawMeshData& Entry = Mapped[i];
+
+		TEST_CHECK(Entry.Name == Expected.Name);
+		TEST_CHECK(Entry.IsCamera == Expected.IsCamera);
+		TEST_CHECK(Entry.IsLight == Expected.IsLight);
+		TEST_CHECK(Entry.Light == Expected.Light);
+		TEST_CHECK(Entry.InstanceCount == Expected.InstanceCount);
+
+		TEST_CHECK(Entry.VertexCount == Expected.VertexCount);
+		TEST_CHECK(Entry.IndexCount == Expected.IndexCount);
+		TEST_CHECK(Entry.MaterialCount == Expected.MaterialCount);
+		TEST_CHECK(Entry.MeshCount == Expected.MeshCount);
+
+		TEST_CHECK(Entry.WorldMatrices.size() == Expected.WorldMatrices.size());
+		if (Entry.WorldMatrices.size() == Expected.WorldMatrices.size() && !Entry.WorldMatrices.empty())
+		{
+			TEST_CHECK(std::memcmp(Entry.WorldMatrices.data(), Expected.WorldMatrices.data(), Entry.WorldMatrices.size() * sizeof(Matrix4D)) == 0);
+		}
+	}
+
+	if (Test::FailureCount() != FailuresBefore)
+	{
+		std::cout << "\n  readers disagree on " << label;
+	}
+}
+
+#ifndef LEVEL_PARSER_TESTS
+static void Run(const char* label, const char* path, unsigned int repeats)
+{
+	CheckReadersAgree(label, path);
+
+	std::vector<RawMeshData> Meshes;
+	double Stream = Test::MeasureNanoseconds(repeats, [&]()
+		{
+			Meshes.clear();
+			ReadSilently(FileHelper::ReadGameLevelFileStream, path, Meshes);
+		});
+	double Mapped = Test::MeasureNanoseconds(repeats, [&]()
+		{
+			Meshes.clear();
+			ReadSilently(FileHelper::ReadGameLevelFile, path, Meshes);
+		});
+
+	size_t MatrixCount = 0;
+	for (const RawMeshData& Mesh : Meshes)
+	{
+		MatrixCount += Mesh.WorldMatrices.size();
+	}
+
+	std::cout << "\n" << label << ": stream " << Stream / 1e6 << " ms, mapped " << Mapped / 1e6 << " ms, "
+		<< Stream / Mapped << "x (" << Meshes.size() << " entries, " << MatrixCount << " matrices)";
+}
+
+/* The h2b loads of path's mesh entries on 1 worker against more, the entries are read once and loaded again every run */
+static void RunMeshLoading(const char* label, const char* path, unsigned int repeats)
+{
+	std::vector<RawMeshData> Meshes;
+	ReadSilently(FileHelper::ReadGameLevelFile, path, Meshes);
+
+	uint32 MeshCount = 0;
+	for (const RawMeshData& Mesh : Meshes)
+	{
+		MeshCount += !Mesh.IsCamera && !Mesh.IsLight;
+	}
+
+	/* 0 is LoadGameLevelMeshes()' default, one worker per hardware thread */
+	const uint32 WorkerCounts[] = { 1, 2, 4, 0 };
+	double Serial = 0.0;
+	for (uint32 Workers : WorkerCounts)
+	{
+		double Loading = Test::MeasureNanoseconds(repeats, [&]()
+			{
+				MeshCache::Get().Clear();
+				std::cout.setstate(std::ios::failbit);
+				FileHelper::LoadGameLevelMeshes(Meshes, Workers);
+				std::cout.clear();
+			});
+		Serial = Workers == 1 ? Loading : Serial;
+
+		std::cout << "\n" << label << " h2b loading, " << MeshCount << " meshes on ";
+		if (Workers == 0)
+		{
+			std::cout << "every hardware thread (" << std::max(1u, std::thread::hardware_concurrency()) << ")";
+		}
+		else
+		{
+			std::cout << Workers << (Workers == 1 ? " thread" : " threads");
+		}
+		std::cout << ": " << Loading / 1e6 << " ms, " << Serial / Loading << "x";
+	}
+}
+#endif // LEVEL_PARSER_TESTS
+
+static void WriteMatrix(std::ofstream& fileHandle, std::mt19937& random)
+{
+	std::uniform_real_distribution<float> Value(-100.0f, 100.0f);
+
+	char Buffer[256];
+	for (unsigned int Row = 0; Row < 4; ++Row)
+	{
+		std::snprintf(Buffer, sizeof(Buffer), "%s(%.4f, %.4f, %.4f, %.4f)%s", Row == 0 ? "<Matrix 4x4 " : "            ",
+			Value(random), Value(random), Value(random), Value(random), Row == 3 ? ">\n" : "\n");
+		fileHandle << Buffer;
+	}
+}
+
+/*
+* instanceCount instances spread over 256 mesh names, with the exporter's ".001" suffixes, a camera and every kind of light
+*	Only one camera, the stream reader adds the matrix of a second one to the entry before it
+*/
+static void WriteGeneratedLevel(const std::string& path, unsigned int instanceCount)
+{
+	std::ofstream FileHandle(path, std::ios::binary);
+	FileHandle << "# Game Level Exporter v1.0\n";
+
+	std::mt19937 Random(1);
+	char Buffer[256];
+	for (unsigned int i = 0; i < instanceCount; ++i)
+	{
+		unsigned int Mesh = i % 256;
+		unsigned int Instance = i / 256;
+		if (Instance == 0)
+		{
+			std::snprintf(Buffer, sizeof(Buffer), "MESH\nBenchmark_Mesh_%u\n", Mesh);
+		}
+		else
+		{
+			std::snprintf(Buffer, sizeof(Buffer), "MESH\nBenchmark_Mesh_%u.%03u\n", Mesh, Instance);
+		}
+		FileHandle << Buffer;
+		WriteMatrix(FileHandle, Random);
+
+		if (i == instanceCount / 2)
+		{
+			FileHandle << "CAMERA\nCamera\n";
+			WriteMatrix(FileHandle, Random);
+		}
+	}
+
+	const char* Lights[] = { "Point.001", "Sun", "Spot.002", "Point.002", "Area" };
+	for (const char* Light : Lights)
+	{
+		FileHandle << "LIGHT\n" << Light << "\n";
+		WriteMatrix(FileHandle, Random);
+	}
+}
+
+static void WriteWithoutCarriageReturns(const char* path, const std::string& outPath)
+{
+	std::ifstream Input(path, std::ios::binary);
+	std::string Text((std::istreambuf_iterator<char>(Input)), std::istreambuf_iterator<char>());
+	Text.erase(std::remove(Text.begin(), Text.end(), '\r'), Text.end());
+
+	std::ofstream Output(outPath, std::ios::binary);
+	Output << Text;
+}
+
+int main(int argc, char** argv)
+{
+#ifdef LEVEL_PARSER_TESTS
+	unsigned int InstanceCount = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 3000;
+#else
+	unsigned int InstanceCount = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 100000;
+#endif // LEVEL_PARSER_TESTS
+
+	/* The readers look for meshes in ../Assets/h2b/ like the renderer, which runs from a folder next to Assets/ */
+	std::filesystem::current_path(LEVELRENDERER_ASSETS_DIR "/../Levels");
+
+	std::string GeneratedPath = (std::filesystem::temp_directory_path() / "LevelParserBenchmark.txt").string();
+	WriteGeneratedLevel(GeneratedPath, InstanceCount);
+
+	std::string Label = "Generated, " + std::to_string(InstanceCount) + " instances, " +
+		std::to_string(std::filesystem::file_size(GeneratedPath) >> 10) + " KB";
+
+#ifdef LEVEL_PARSER_TESTS
+	CheckReadersAgree(Label.c_str(), GeneratedPath.c_str());
+#else
+	std::cout << "Game level text parsing, best of the runs";
+	Run(Label.c_str(), GeneratedPath.c_str(), 10);
+#endif // LEVEL_PARSER_TESTS
+	std::remove(GeneratedPath.c_str());
+
+	/*
+	* Mesh loading included, MeshCache is warm after the first run
+	*	The files are CRLF and the stream reader only drops '\r' in Windows text mode, both read an LF copy
+	*/
+	const char* Levels[] = { "GameLevelMain.txt", "GameLevelLights.txt", "NormalMapTest.txt", "TestLevel_Textures_3.txt" };
+	for (const char* Level : Levels)
+	{
+		std::string CopyPath = (std::filesystem::temp_directory_path() / Level).string();
+		WriteWithoutCarriageReturns(Level, CopyPath);
+#ifdef LEVEL_PARSER_TESTS
+		CheckReadersAgree(Level, CopyPath.c_str());
+#else
+		Run(Level, CopyPath.c_str(), 10);
+		if (std::strcmp(Level, "GameLevelMain.txt") == 0)
+		{
+			RunMeshLoading(Level, CopyPath.c_str(), 10);
+		}
+#endif // LEVEL_PARSER_TESTS
+		std::remove(CopyPath.c_str());
+	}
+
+	return Test::Result();
+}
@@ -0,0 +1,983 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+/*
+* Stands in for Gateware.h (and the Vulkan headers it pulls in) in the headless tests, GatewareDefine.h includes this
+* instead when LEVELRENDERER_MOCK_GATEWARE is defined
+*	Only what the headers under test use is declared
+*/
+namespace GW
+{
+	namespace MATH
+	{
+		struct GVECTORF
+		{
+			float x, y, z, w;
+		};
+
+		struct GMATRIXF
+		{
+			GVECTORF row1, row2, row3, row4;
+		};
+	}
+}
+
+/* Queues and command pools only know their family, GVulkanSurface's graphics family is 0 and its transfer only family 1 */
+struct VkQueue_T
+{
+	uint32_t QueueFamilyIndex;
+};
+
+struct VkCommandPool_T
+{
+	uint32_t QueueFamilyIndex;
+};
+
+/*
+* Vulkan memory and buffers of a fake device, enough for GpuMemory.h and DeletionQueue.h
+*	Blocks are zeroed heap memory, buffers remember the memory they are bound to
+*	MockDevice counts what is alive so tests can tell when something was destroyed
+*/
+struct MockDevice
+{
+	static inline VkQueue_T GraphicsQueue{ 0 };
+	static inline VkQueue_T TransferQueue{ 1 };
+	static inline VkCommandPool_T GraphicsCommandPool{ 0 };
+
+	static inline std::atomic<int32_t> LiveBuffers{ 0 };
+	static inline std::atomic<int32_t> LiveMemory{ 0 };
+
+	/* vkAllocateMemory() fails while set */
+	static inline bool FailAllocations = false;
+
+	/* Copies that read or wrote outside their buffers, they are skipped */
+	static inline std::atomic<int32_t> InvalidCopies{ 0 };
+
+	/* vkGetPhysicalDeviceFeatures() reports multiDrawIndirect and drawIndirectFirstInstance while set */
+	static inline bool MultiDrawIndirect = true;
+
+	/* vkQueueSubmit() calls per queue family, and the ones that waited on a semaphore */
+	static inline uint32_t QueueSubmits[2] = { 0, 0 };
+	static inline uint32_t WaitingSubmits = 0;
+
+	/* Command buffers submitted to a queue of another family than their pool's, and waits on timeline values nothing signalled yet */
+	static inline std::atomic<int32_t> InvalidSubmits{ 0 };
+
+	static inline std::atomic<int32_t> LiveSemaphores{ 0 };
+	static inline std::atomic<int32_t> LiveCommandPools{ 0 };
+};
+
+typedef struct VkDevice_T* VkDevice;
+typedef struct VkPhysicalDevice_T* VkPhysicalDevice;
+typedef uint64_t VkDeviceSize;
+typedef uint32_t VkFlags;
+typedef VkFlags VkBufferUsageFlags;
+typedef VkFlags VkMemoryPropertyFlags;
+
+struct VkDeviceMemory_T
+{
+	char* Data;
+};
+typedef VkDeviceMemory_T* VkDeviceMemory;
+
+enum VkSharingMode
+{
+	VK_SHARING_MODE_EXCLUSIVE = 0,
+	VK_SHARING_MODE_CONCURRENT = 1
+};
+
+struct VkBuffer_T
+{
+	VkDeviceSize Size;
+	VkDeviceMemory Memory;
+	VkDeviceSize Offset;
+	VkSharingMode SharingMode;
+};
+typedef VkBuffer_T* VkBuffer;
+
+enum VkResult
+{
+	VK_SUCCESS = 0,
+	VK_ERROR_OUT_OF_DEVICE_MEMORY = -2
+};
+
+enum VkStructureType
+{
+	VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO = 12,
+	VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO = 5,
+	VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE = 6,
+	VK_STRUCTURE_TYPE_SUBMIT_INFO = 4,
+	VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO = 9,
+	VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO = 39,
+	VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO = 40,
+	VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO = 42,
+	VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER = 45,
+	VK_STRUCTURE_TYPE_MEMORY_BARRIER = 46,
+	VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR = 1000207002,
+	VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR = 1000207003
+};
+
+enum VkMemoryPropertyFlagBits
+{
+	VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT = 0x1,
+	VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT = 0x2,
+	VK_MEMORY_PROPERTY_HOST_COHERENT_BIT = 0x4
+};
+
+enum VkBufferUsageFlagBits
+{
+	VK_BUFFER_USAGE_TRANSFER_SRC_BIT = 0x1,
+	VK_BUFFER_USAGE_TRANSFER_DST_BIT = 0x2,
+	VK_BUFFER_USAGE_STORAGE_BUFFER_BIT = 0x20,
+	VK_BUFFER_USAGE_INDEX_BUFFER_BIT = 0x40,
+	VK_BUFFER_USAGE_VERTEX_BUFFER_BIT = 0x80,
+	VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT = 0x100
+};
+
+#define VK_WHOLE_SIZE (~0ULL)
+
+struct VkPhysicalDeviceLimits
+{
+	VkDeviceSize minStorageBufferOffsetAlignment;
+	VkDeviceSize nonCoherentAtomSize;
+	uint32_t maxDrawIndirectCount;
+};
+
+struct VkPhysicalDeviceProperties
+{
+	VkPhysicalDeviceLimits limits;
+};
+
+struct VkMemoryType
+{
+	VkMemoryPropertyFlags propertyFlags;
+	uint32_t heapIndex;
+};
+
+struct VkMemoryHeap
+{
+	VkDeviceSize size;
+	VkFlags flags;
+};
+
+struct VkPhysicalDeviceMemoryProperties
+{
+	uint32_t memoryTypeCount;
+	VkMemoryType memoryTypes[32];
+	uint32_t memoryHeapCount;
+	VkMemoryHeap memoryHeaps[16];
+};
+
+struct VkMemoryAllocateInfo
+{
+	VkStructureType sType;
+	const void* pNext;
+	VkDeviceSize allocationSize;
+	uint32_t memoryTypeIndex;
+};
+
+struct VkBufferCreateInfo
+{
+	VkStructureType sType;
+	const void* pNext;
+	VkFlags flags;
+	VkDeviceSize size;
+	VkBufferUsageFlags usage;
+	VkSharingMode sharingMode;
+	uint32_t queueFamilyIndexCount;
+	const uint32_t* pQueueFamilyIndices;
+};
+
+struct VkMemoryRequirements
+{
+	VkDeviceSize size;
+	VkDeviceSize alignment;
+	uint32_t memoryTypeBits;
+};
+
+struct VkMappedMemoryRange
+{
+	VkStructureType sType;
+	const void* pNext;
+	VkDeviceMemory memory;
+	VkDeviceSize offset;
+	VkDeviceSize size;
+};
+
+inline void vkGetPhysicalDeviceProperties(VkPhysicalDevice, VkPhysicalDeviceProperties* outProperties)
+{
+	outProperties->limits.minStorageBufferOffsetAlignment = 64;
+	outProperties->limits.nonCoherentAtomSize = 64;
+	outProperties->limits.maxDrawIndirectCount = ~0u;
+}
+
+/* A discrete GPU: 1 GB device local and 256 MB host visible */
+inline void vkGetPhysicalDeviceMemoryProperties(VkPhysicalDevice, VkPhysicalDeviceMemoryProperties* outProperties)
+{
+	*outProperties = { };
+	outProperties->memoryTypeCount = 2;
+	outProperties->memoryTypes[0] = { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0 };
+	outProperties->memoryTypes[1] = { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 1 };
+	outProperties->memoryHeapCount = 2;
+	outProperties->memoryHeaps[0] = { 1ull << 30, 1 };
+	outProperties->memoryHeaps[1] = { 256ull << 20, 0 };
+}
+
+inline VkResult vkAllocateMemory(VkDevice, const VkMemoryAllocateInfo* allocateInfo, const void*, VkDeviceMemory* outMemory)
+{
+	char* Data = MockDevice::FailAllocations ? nullptr : static_cast<char*>(std::calloc(allocateInfo->allocationSize, 1));
+	if (Data == nullptr)
+	{
+		return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+	}
+
+	*outMemory = new VkDeviceMemory_T{ Data };
+	MockDevice::LiveMemory++;
+	return VK_SUCCESS;
+}
+
+inline void vkFreeMemory(VkDevice, VkDeviceMemory memory, const void*)
+{
+	if (memory)
+	{
+		std::free(memory->Data);
+		delete memory;
+		MockDevice::LiveMemory--;
+	}
+}
+
+inline VkResult vkMapMemory(VkDevice, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize, VkFlags, void** outData)
+{
+	*outData = memory->Data + offset;
+	return VK_SUCCESS;
+}
+
+inline void vkUnmapMemory(VkDevice, VkDeviceMemory) { }
+
+inline VkResult vkFlushMappedMemoryRanges(VkDevice, uint32_t, const VkMappedMemoryRange*)
+{
+	return VK_SUCCESS;
+}
+
+inline VkResult vkCreateBuffer(VkDevice, const VkBufferCreateInfo* createInfo, const void*, VkBuffer* outBuffer)
+{
+	*outBuffer = new VkBuffer_T{ createInfo->size, nullptr, 0, createInfo->sharingMode };
+	MockDevice::LiveBuffers++;
+	return VK_SUCCESS;
+}
+
+inline void vkDestroyBuffer(VkDevice, VkBuffer buffer, const void*)
+{
+	if (buffer)
+	{
+		delete buffer;
+		MockDevice::LiveBuffers--;
+	}
+}
+
+/* Sizes round up to 256 bytes like most desktop drivers, any memory type */
+inline void vkGetBufferMemoryRequirements(VkDevice, VkBuffer buffer, VkMemoryRequirements* outRequirements)
+{
+	outRequirements->size = (buffer->Size + 255) / 256 * 256;
+	outRequirements->alignment = 256;
+	outRequirements->memoryTypeBits = 0x3;
+}
+
+inline VkResult vkBindBufferMemory(VkDevice, VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize offset)
+{
+	buffer->Memory = memory;
+	buffer->Offset = offset;
+	return VK_SUCCESS;
+}
+
+namespace GvkHelper
+{
+	inline VkResult find_memory_type(const VkPhysicalDevice& physicalDevice, const uint32_t& filter, const VkMemoryPropertyFlags& properties, uint32_t* outIndex)
+	{
+		VkPhysicalDeviceMemoryProperties MemoryProperties;
+		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &MemoryProperties);
+		for (uint32_t i = 0; i < MemoryProperties.memoryTypeCount; ++i)
+		{
+			if ((filter & (1u << i)) && (MemoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+			{
+				*outIndex = i;
+				return VK_SUCCESS;
+			}
+		}
+
+		return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+	}
+}
+
+/*
+* Command buffers, the graphics and transfer queues and timeline semaphores, enough for UploadService.h
+*	Copies are recorded into the command buffer and run in order by vkQueueSubmit(), barriers, image copies and blits do nothing
+*/
+namespace GW
+{
+	enum class GReturn
+	{
+		SUCCESS = 0,
+		FAILURE = 1,
+		FEATURE_UNSUPPORTED = 3
+	};
+
+	namespace GRAPHICS
+	{
+		/* Any handle will do, the mock never looks at them */
+		class GVulkanSurface
+		{
+		public:
+			unsigned int ImageCount = 2;
+			unsigned int CurrentImage = 0;
+
+			GReturn GetSwapchainImageCount(unsigned int& outImageCount) const
+			{
+				outImageCount = ImageCount;
+				return GReturn::SUCCESS;
+			}
+
+			GReturn GetSwapchainCurrentImage(unsigned int& outImageIndex) const
+			{
+				outImageIndex = CurrentImage;
+				return GReturn::SUCCESS;
+			}
+
+			/* GetTransferQueue() gives out MockDevice::TransferQueue while set, like a device with a transfer only family */
+			bool HasTransferQueue = false;
+
+			GReturn GetQueueFamilyIndices(unsigned int& outGraphicsIndex, unsigned int& outPresentIndex) const
+			{
+				outGraphicsIndex = outPresentIndex = MockDevice::GraphicsQueue.QueueFamilyIndex;
+				return GReturn::SUCCESS;
+			}
+
+			GReturn GetGraphicsQueue(void** outVkQueue) const
+			{
+				*outVkQueue = &MockDevice::GraphicsQueue;
+				return GReturn::SUCCESS;
+			}
+
+			GReturn GetTransferQueue(void** outVkQueue, unsigned int& outFamilyIndex) const
+			{
+				if (!HasTransferQueue)
+				{
+					return GReturn::FEATURE_UNSUPPORTED;
+				}
+
+				*outVkQueue = &MockDevice::TransferQueue;
+				outFamilyIndex = MockDevice::TransferQueue.QueueFamilyIndex;
+				return GReturn::SUCCESS;
+			}
+
+			GReturn GetCommandPool(void** outCommandPool) const
+			{
+				*outCommandPool = &MockDevice::GraphicsCommandPool;
+				return GReturn::SUCCESS;
+			}
+
+			/* Every image records into CommandBuffer, which the test sets */
+			void* CommandBuffer = nullptr;
+
+			GReturn GetCommandBuffer(unsigned int, void** outCommandBuffer) const
+			{
+				*outCommandBuffer = CommandBuffer;
+				return GReturn::SUCCESS;
+			}
+		};
+	}
+}
+
+struct VkCommandBuffer_T
+{
+	std::vector<std::function<void()>> Commands;
+
+	/* Arguments of the draw, bind and push constant calls, they are not run */
+	std::vector<uint64_t> Arguments;
+	uint32_t CallCount = 0;
+
+	/* Of the pool it was allocated from */
+	uint32_t QueueFamilyIndex = 0;
+};
+typedef VkCommandBuffer_T* VkCommandBuffer;
+
+/* A timeline semaphore, binary ones are not used */
+struct VkSemaphore_T
+{
+	uint64_t Value;
+};
+typedef VkSemaphore_T* VkSemaphore;
+
+typedef VkQueue_T* VkQueue;
+typedef VkCommandPool_T* VkCommandPool;
+typedef struct VkFence_T* VkFence;
+typedef struct VkImage_T* VkImage;
+
+#define VK_NULL_HANDLE nullptr
+#define VK_QUEUE_FAMILY_IGNORED (~0U)
+
+typedef VkFlags VkAccessFlags;
+typedef VkFlags VkPipelineStageFlags;
+
+enum VkAccessFlagBits
+{
+	VK_ACCESS_INDIRECT_COMMAND_READ_BIT = 0x1,
+	VK_ACCESS_INDEX_READ_BIT = 0x2,
+	VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT = 0x4,
+	VK_ACCESS_UNIFORM_READ_BIT = 0x8,
+	VK_ACCESS_SHADER_READ_BIT = 0x20,
+	VK_ACCESS_SHADER_WRITE_BIT = 0x40,
+	VK_ACCESS_TRANSFER_READ_BIT = 0x800,
+	VK_ACCESS_TRANSFER_WRITE_BIT = 0x1000
+};
+
+enum VkPipelineStageFlagBits
+{
+	VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT = 0x1,
+	VK_PIPELINE_STAGE_VERTEX_SHADER_BIT = 0x8,
+	VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT = 0x80,
+	VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT = 0x800,
+	VK_PIPELINE_STAGE_TRANSFER_BIT = 0x1000,
+	VK_PIPELINE_STAGE_ALL_COMMANDS_BIT = 0x10000
+};
+
+enum VkImageLayout
+{
+	VK_IMAGE_LAYOUT_UNDEFINED = 0,
+	VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL = 5,
+	VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL = 6,
+	VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL = 7
+};
+
+enum VkFilter
+{
+	VK_FILTER_NEAREST = 0,
+	VK_FILTER_LINEAR = 1
+};
+
+enum VkSemaphoreType
+{
+	VK_SEMAPHORE_TYPE_BINARY_KHR = 0,
+	VK_SEMAPHORE_TYPE_TIMELINE_KHR = 1
+};
+
+enum VkCommandPoolCreateFlagBits
+{
+	VK_COMMAND_POOL_CREATE_TRANSIENT_BIT = 0x1
+};
+
+enum VkImageAspectFlagBits
+{
+	VK_IMAGE_ASPECT_COLOR_BIT = 0x1
+};
+
+enum VkCommandBufferLevel
+{
+	VK_COMMAND_BUFFER_LEVEL_PRIMARY = 0
+};
+
+enum VkCommandBufferUsageFlagBits
+{
+	VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT = 0x1
+};
+
+enum VkIndexType
+{
+	VK_INDEX_TYPE_UINT16 = 0,
+	VK_INDEX_TYPE_UINT32 = 1
+};
+
+struct VkBufferCopy
+{
+	VkDeviceSize srcOffset;
+	VkDeviceSize dstOffset;
+	VkDeviceSize size;
+};
+
+struct VkImageSubresourceRange
+{
+	VkFlags aspectMask;
+	uint32_t baseMipLevel;
+	uint32_t levelCount;
+	uint32_t baseArrayLayer;
+	uint32_t layerCount;
+};
+
+struct VkImageSubresourceLayers
+{
+	VkFlags aspectMask;
+	uint32_t mipLevel;
+	uint32_t baseArrayLayer;
+	uint32_t layerCount;
+};
+
+struct VkOffset3D
+{
+	int32_t x, y, z;
+};
+
+struct VkExtent3D
+{
+	uint32_t width, height, depth;
+};
+
+struct VkBufferImageCopy
+{
+	VkDeviceSize bufferOffset;
+	uint32_t bufferRowLength;
+	uint32_t bufferImageHeight;
+	VkImageSubresourceLayers imageSubresource;
+	VkOffset3D imageOffset;
+	VkExtent3D imageExtent;
+};
+
+struct VkImageBlit
+{
+	VkImageSubresourceLayers srcSubresource;
+	VkOffset3D srcOffsets[2];
+	VkImageSubresourceLayers dstSubresource;
+	VkOffset3D dstOffsets[2];
+};
+
+struct VkMemoryBarrier
+{
+	VkStructureType sType;
+	const void* pNext;
+	VkAccessFlags srcAccessMask;
+	VkAccessFlags dstAccessMask;
+};
+
+struct VkImageMemoryBarrier
+{
+	VkStructureType sType;
+	const void* pNext;
+	VkAccessFlags srcAccessMask;
+	VkAccessFlags dstAccessMask;
+	VkImageLayout oldLayout;
+	VkImageLayout newLayout;
+	uint32_t srcQueueFamilyIndex;
+	uint32_t dstQueueFamilyIndex;
+	VkImage image;
+	VkImageSubresourceRange subresourceRange;
+};
+
+struct VkCommandBufferAllocateInfo
+{
+	VkStructureType sType;
+	const void* pNext;
+	VkCommandPool commandPool;
+	VkCommandBufferLevel level;
+	uint32_t commandBufferCount;
+};
+
+struct VkCommandBufferBeginInfo
+{
+	VkStructureType sType;
+	const void* pNext;
+	VkFlags flags;
+	const void* pInheritanceInfo;
+};
+
+struct VkSubmitInfo
+{
+	VkStructureType sType;
+	const void* pNext;
+	uint32_t waitSemaphoreCount;
+	const VkSemaphore* pWaitSemaphores;
+	const VkPipelineStageFlags* pWaitDstStageMask;
+	uint32_t commandBufferCount;
+	const VkCommandBuffer* pCommandBuffers;
+	uint32_t signalSemaphoreCount;
+	const VkSemaphore* pSignalSemaphores;
+};
+
+struct VkTimelineSemaphoreSubmitInfoKHR
+{
+	VkStructureType sType;
+	const void* pNext;
+	uint32_t waitSemaphoreValueCount;
+	const uint64_t* pWaitSemaphoreValues;
+	uint32_t signalSemaphoreValueCount;
+	const uint64_t* pSignalSemaphoreValues;
+};
+
+struct VkSemaphoreTypeCreateInfoKHR
+{
+	VkStructureType sType;
+	const void* pNext;
+	VkSemaphoreType semaphoreType;
+	uint64_t initialValue;
+};
+
+struct VkSemaphoreCreateInfo
+{
+	VkStructureType sType;
+	const void* pNext;
+	VkFlags flags;
+};
+
+struct VkCommandPoolCreateInfo
+{
+	VkStructureType sType;
+	const void* pNext;
+	VkFlags flags;
+	uint32_t queueFamilyIndex;
+};
+
+/* Only timeline semaphores, the VkSemaphoreTypeCreateInfoKHR has to be chained */
+inline VkResult vkCreateSemaphore(VkDevice, const VkSemaphoreCreateInfo* createInfo, const void*, VkSemaphore* outSemaphore)
+{
+	const VkSemaphoreTypeCreateInfoKHR* TypeInfo = static_cast<const VkSemaphoreTypeCreateInfoKHR*>(createInfo->pNext);
+	if (TypeInfo == nullptr || TypeInfo->sType != VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR || TypeInfo->semaphoreType != VK_SEMAPHORE_TYPE_TIMELINE_KHR)
+	{
+		return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+	}
+
+	*outSemaphore = new VkSemaphore_T{ TypeInfo->initialValue };
+	MockDevice::LiveSemaphores++;
+	return VK_SUCCESS;
+}
+
+inline void vkDestroySemaphore(VkDevice, VkSemaphore semaphore, const void*)
+{
+	if (semaphore)
+	{
+		delete semaphore;
+		MockDevice::LiveSemaphores--;
+	}
+}
+
+inline VkResult vkCreateCommandPool(VkDevice, const VkCommandPoolCreateInfo* createInfo, const void*, VkCommandPool* outCommandPool)
+{
+	*outCommandPool = new VkCommandPool_T{ createInfo->queueFamilyIndex };
+	MockDevice::LiveCommandPools++;
+	return VK_SUCCESS;
+}
+
+inline void vkDestroyCommandPool(VkDevice, VkCommandPool commandPool, const void*)
+{
+	if (commandPool)
+	{
+		delete commandPool;
+		MockDevice::LiveCommandPools--;
+	}
+}
+
+inline VkResult vkAllocateCommandBuffers(VkDevice, const VkCommandBufferAllocateInfo* allocateInfo, VkCommandBuffer* outCommandBuffers)
+{
+	for (uint32_t i = 0; i < allocateInfo->commandBufferCount; ++i)
+	{
+		outCommandBuffers[i] = new VkCommandBuffer_T();
+		outCommandBuffers[i]->QueueFamilyIndex = allocateInfo->commandPool->QueueFamilyIndex;
+	}
+
+	return VK_SUCCESS;
+}
+
+inline void vkFreeCommandBuffers(VkDevice, VkCommandPool, uint32_t count, const VkCommandBuffer* commandBuffers)
+{
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		delete commandBuffers[i];
+	}
+}
+
+inline VkResult vkBeginCommandBuffer(VkCommandBuffer commandBuffer, const VkCommandBufferBeginInfo*)
+{
+	commandBuffer->Commands.clear();
+	commandBuffer->Arguments.clear();
+	commandBuffer->CallCount = 0;
+	return VK_SUCCESS;
+}
+
+inline VkResult vkEndCommandBuffer(VkCommandBuffer)
+{
+	return VK_SUCCESS;
+}
+
+inline void vkCmdPipelineBarrier(VkCommandBuffer, VkPipelineStageFlags, VkPipelineStageFlags, VkFlags, uint32_t, const VkMemoryBarrier*,
+	uint32_t, const void*, uint32_t, const VkImageMemoryBarrier*) { }
+
+/* Both buffers are read when the copy runs, a buffer destroyed before the submission is a use after free ASan reports */
+inline void vkCmdCopyBuffer(VkCommandBuffer commandBuffer, VkBuffer source, VkBuffer destination, uint32_t regionCount, const VkBufferCopy* regions)
+{
+	std::vector<VkBufferCopy> Regions(regions, regions + regionCount);
+	commandBuffer->Commands.push_back([source, destination, Regions]()
+		{
+			for (const VkBufferCopy& Region : Regions)
+			{
+				if (Region.srcOffset + Region.size > source->Size || Region.dstOffset + Region.size > destination->Size)
+				{
+					MockDevice::InvalidCopies++;
+					continue;
+				}
+
+				std::memmove(destination->Memory->Data + destination->Offset + Region.dstOffset,
+					source->Memory->Data + source->Offset + Region.srcOffset, Region.size);
+			}
+		});
+}
+
+inline void vkCmdCopyBufferToImage(VkCommandBuffer, VkBuffer, VkImage, VkImageLayout, uint32_t, const VkBufferImageCopy*) { }
+
+inline void vkCmdBlitImage(VkCommandBuffer, VkImage, VkImageLayout, VkImage, VkImageLayout, uint32_t, const VkImageBlit*, VkFilter) { }
+
+/*
+* Runs the command buffers right away, the fence is never used
+*	Waits are checked instead of waited on: the value has to be signalled by an earlier submission, submissions run in order
+*/
+inline VkResult vkQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo* submits, VkFence)
+{
+	for (uint32_t i = 0; i < submitCount; ++i)
+	{
+		const VkTimelineSemaphoreSubmitInfoKHR* TimelineInfo = static_cast<const VkTimelineSemaphoreSubmitInfoKHR*>(submits[i].pNext);
+		if (TimelineInfo != nullptr && TimelineInfo->sType != VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR)
+		{
+			TimelineInfo = nullptr;
+		}
+
+		MockDevice::QueueSubmits[queue->QueueFamilyIndex]++;
+		if (submits[i].waitSemaphoreCount > 0)
+		{
+			MockDevice::WaitingSubmits++;
+		}
+
+		for (uint32_t j = 0; j < submits[i].waitSemaphoreCount; ++j)
+		{
+			if (TimelineInfo == nullptr || j >= TimelineInfo->waitSemaphoreValueCount || submits[i].pWaitDstStageMask == nullptr ||
+				submits[i].pWaitSemaphores[j]->Value < TimelineInfo->pWaitSemaphoreValues[j])
+			{
+				MockDevice::InvalidSubmits++;
+			}
+		}
+
+		for (uint32_t j = 0; j < submits[i].commandBufferCount; ++j)
+		{
+			if (submits[i].pCommandBuffers[j]->QueueFamilyIndex != queue->QueueFamilyIndex)
+			{
+				MockDevice::InvalidSubmits++;
+			}
+
+			for (const std::function<void()>& Command : submits[i].pCommandBuffers[j]->Commands)
+			{
+				Command();
+			}
+		}
+
+		/* Timeline values only go up */
+		for (uint32_t j = 0; j < submits[i].signalSemaphoreCount; ++j)
+		{
+			if (TimelineInfo == nullptr || j >= TimelineInfo->signalSemaphoreValueCount ||
+				TimelineInfo->pSignalSemaphoreValues[j] <= submits[i].pSignalSemaphores[j]->Value)
+			{
+				MockDevice::InvalidSubmits++;
+				continue;
+			}
+
+			submits[i].pSignalSemaphores[j]->Value = TimelineInfo->pSignalSemaphoreValues[j];
+		}
+	}
+
+	return VK_SUCCESS;
+}
+
+/*
+* Draws, vertex input, pipelines and descriptor sets, enough for LevelData.h, DrawList.h and GpuCulling.h
+*	Recording calls only append their arguments to the command buffer, which is what a driver does first too
+*	Pipelines are never run, their handles only have to be unique
+*/
+typedef uint32_t VkBool32;
+typedef VkFlags VkShaderStageFlags;
+typedef struct VkPipeline_T* VkPipeline;
+typedef struct VkPipelineLayout_T* VkPipelineLayout;
+typedef struct VkPipelineCache_T* VkPipelineCache;
+typedef struct VkShaderModule_T* VkShaderModule;
+typedef struct VkDescriptorSet_T* VkDescriptorSet;
+typedef struct VkDescriptorSetLayout_T* VkDescriptorSetLayout;
+
+enum VkFormat
+{
+	VK_FORMAT_R16G16_SNORM = 75,
+	VK_FORMAT_R16G16_SFLOAT = 83,
+	VK_FORMAT_R16G16B16A16_UNORM = 91,
+	VK_FORMAT_R32G32_SFLOAT = 103,
+	VK_FORMAT_R32G32B32_SFLOAT = 106,
+	VK_FORMAT_R32G32B32A32_SFLOAT = 109
+};
+
+enum VkShaderStageFlagBits
+{
+	VK_SHADER_STAGE_VERTEX_BIT = 0x1,
+	VK_SHADER_STAGE_FRAGMENT_BIT = 0x10,
+	VK_SHADER_STAGE_COMPUTE_BIT = 0x20
+};
+
+enum VkPipelineBindPoint
+{
+	VK_PIPELINE_BIND_POINT_GRAPHICS = 0,
+	VK_PIPELINE_BIND_POINT_COMPUTE = 1
+};
+
+/* Only the ones GpuCulling.h creates, values as in vulkan_core.h */
+enum VkPipelineStructureType
+{
+	VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO = 18,
+	VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO = 29,
+	VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO = 30
+};
+
+struct VkPhysicalDeviceFeatures
+{
+	VkBool32 multiDrawIndirect;
+	VkBool32 drawIndirectFirstInstance;
+};
+
+struct VkDrawIndexedIndirectCommand
+{
+	uint32_t indexCount;
+	uint32_t instanceCount;
+	uint32_t firstIndex;
+	int32_t vertexOffset;
+	uint32_t firstInstance;
+};
+
+struct VkPushConstantRange
+{
+	VkShaderStageFlags stageFlags;
+	uint32_t offset;
+	uint32_t size;
+};
+
+struct VkPipelineLayoutCreateInfo
+{
+	VkPipelineStructureType sType;
+	const void* pNext;
+	VkFlags flags;
+	uint32_t setLayoutCount;
+	const VkDescriptorSetLayout* pSetLayouts;
+	uint32_t pushConstantRangeCount;
+	const VkPushConstantRange* pPushConstantRanges;
+};
+
+struct VkPipelineShaderStageCreateInfo
+{
+	VkPipelineStructureType sType;
+	const void* pNext;
+	VkFlags flags;
+	VkShaderStageFlagBits stage;
+	VkShaderModule module;
+	const char* pName;
+	const void* pSpecializationInfo;
+};
+
+struct VkComputePipelineCreateInfo
+{
+	VkPipelineStructureType sType;
+	const void* pNext;
+	VkFlags flags;
+	VkPipelineShaderStageCreateInfo stage;
+	VkPipelineLayout layout;
+	VkPipeline basePipelineHandle;
+	int32_t basePipelineIndex;
+};
+
+inline void vkGetPhysicalDeviceFeatures(VkPhysicalDevice, VkPhysicalDeviceFeatures* outFeatures)
+{
+	outFeatures->multiDrawIndirect = MockDevice::MultiDrawIndirect;
+	outFeatures->drawIndirectFirstInstance = MockDevice::MultiDrawIndirect;
+}
+
+inline void vkCmdBindVertexBuffers(VkCommandBuffer commandBuffer, uint32_t firstBinding, uint32_t bindingCount, const VkBuffer* buffers,
+	const VkDeviceSize* offsets)
+{
+	commandBuffer->Arguments.push_back(firstBinding);
+	for (uint32_t i = 0; i < bindingCount; ++i)
+	{
+		commandBuffer->Arguments.push_back(reinterpret_cast<uint64_t>(buffers[i]));
+		commandBuffer->Arguments.push_back(offsets[i]);
+	}
+	commandBuffer->CallCount++;
+}
+
+inline void vkCmdBindIndexBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType)
+{
+	commandBuffer->Arguments.insert(commandBuffer->Arguments.end(), { reinterpret_cast<uint64_t>(buffer), offset, static_cast<uint64_t>(indexType) });
+	commandBuffer->CallCount++;
+}
+
+inline void vkCmdPushConstants(VkCommandBuffer commandBuffer, VkPipelineLayout, VkShaderStageFlags, uint32_t offset, uint32_t size, const void* values)
+{
+	size_t First = commandBuffer->Arguments.size();
+	commandBuffer->Arguments.resize(First + 1 + (size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+	commandBuffer->Arguments[First] = offset;
+	std::memcpy(&commandBuffer->Arguments[First + 1], values, size);
+	commandBuffer->CallCount++;
+}
+
+inline void vkCmdDrawIndexed(VkCommandBuffer commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex,
+	int32_t vertexOffset, uint32_t firstInstance)
+{
+	commandBuffer->Arguments.insert(commandBuffer->Arguments.end(), { indexCount, instanceCount, firstIndex, static_cast<uint64_t>(vertexOffset), firstInstance });
+	commandBuffer->CallCount++;
+}
+
+inline void vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride)
+{
+	commandBuffer->Arguments.insert(commandBuffer->Arguments.end(), { reinterpret_cast<uint64_t>(buffer), offset, drawCount, stride });
+	commandBuffer->CallCount++;
+}
+
+inline void vkCmdBindPipeline(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipeline pipeline)
+{
+	commandBuffer->Arguments.insert(commandBuffer->Arguments.end(), { static_cast<uint64_t>(bindPoint), reinterpret_cast<uint64_t>(pipeline) });
+	commandBuffer->CallCount++;
+}
+
+inline void vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout, uint32_t firstSet,
+	uint32_t setCount, const VkDescriptorSet* sets, uint32_t, const uint32_t*)
+{
+	commandBuffer->Arguments.push_back(static_cast<uint64_t>(bindPoint));
+	commandBuffer->Arguments.push_back(firstSet);
+	for (uint32_t i = 0; i < setCount; ++i)
+	{
+		commandBuffer->Arguments.push_back(reinterpret_cast<uint64_t>(sets[i]));
+	}
+	commandBuffer->CallCount++;
+}
+
+inline void vkCmdDispatch(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+{
+	commandBuffer->Arguments.insert(commandBuffer->Arguments.end(), { groupCountX, groupCountY, groupCountZ });
+	commandBuffer->CallCount++;
+}
+
+inline VkResult vkCreatePipelineLayout(VkDevice, const VkPipelineLayoutCreateInfo*, const void*, VkPipelineLayout* outPipelineLayout)
+{
+	*outPipelineLayout = reinterpret_cast<VkPipelineLayout>(new char);
+	return VK_SUCCESS;
+}
+
+inline void vkDestroyPipelineLayout(VkDevice, VkPipelineLayout pipelineLayout, const void*)
+{
+	delete reinterpret_cast<char*>(pipelineLayout);
+}
+
+inline VkResult vkCreateComputePipelines(VkDevice, VkPipelineCache, uint32_t count, const VkComputePipelineCreateInfo*, const void*, VkPipeline* outPipelines)
+{
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		outPipelines[i] = reinterpret_cast<VkPipeline>(new char);
+	}
+
+	return VK_SUCCESS;
+}
+
+inline void vkDestroyPipeline(VkDevice, VkPipeline pipeline, const void*)
+{
+	delete reinterpret_cast<char*>(pipeline);
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "Math/Matrix4D.h"
+
+/*
+* Checks, timing and random scenes shared by the headless tests and benchmarks in Tests/
+*	A failed check is printed and counted instead of stopping the test, main returns Test::Result() so ctest sees it
+*/
+struct Test
+{
+	/* ctest SKIP_RETURN_CODE of every test */
+	static const int SkippedResult = 77;
+
+	static unsigned int& FailureCount()
+	{
+		static unsigned int Count = 0;
+		return Count;
+	}
+
+	static void Fail(const char* condition, const char* file, int line)
+	{
+		/* A broken invariant tends to fail thousands of times in a randomized test, the first few say enough */
+		if (FailureCount()++ < 16)
+		{
+			std::cout << "\n" << file << "(" << line << "): check failed: " << condition;
+		}
+	}
+
+	/* Exit code of a test */
+	static int Result()
+	{
+		if (FailureCount() > 0)
+		{
+			std::cout << "\n" << FailureCount() << " checks failed\n";
+			return 1;
+		}
+
+		std::cout << "\nAll checks passed\n";
+		return 0;
+	}
+
+	/* False when the test was built for AVX2 (-mavx2) and the CPU running it has none */
+	static bool CanRunBuild()
+	{
+#if defined(__AVX2__) && (defined(__GNUC__) || defined(__clang__))
+		if (!__builtin_cpu_supports("avx2"))
+		{
+			std::cout << "\nSkipped, built for AVX2 but the CPU has none\n";
+			return false;
+		}
+#endif // __AVX2__
+		return true;
+	}
+
+	/* Fastest of repeats calls of function, in nanoseconds */
+	template<typename FunctionType>
+	static double MeasureNanoseconds(unsigned int repeats, FunctionType function)
+	{
+		double Best = 0.0;
+		for (unsigned int i = 0; i < repeats; ++i)
+		{
+			std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+			function();
+			double Elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Start).count();
+			Best = (i == 0 || Elapsed < Best) ? Elapsed : Best;
+		}
+
+		return Best;
+	}
+
+	/* Keeps a benchmark's result alive so the measured work is not optimized away */
+	template<typename ValueType>
+	static void Consume(const ValueType& value)
+	{
+		static volatile unsigned char Sink = 0;
+		const unsigned char* Bytes = reinterpret_cast<const unsigned char*>(&value);
+		for (size_t i = 0; i < sizeof(ValueType); ++i)
+		{
+			Sink = Sink ^ Bytes[i];
+		}
+	}
+
+	/*
+	* Rotation, a scale per axis of up to maxScale and a translation of up to translation around center
+	*	Degenerate matrices can also mirror or flatten an axis, and every 8th element of their 3x3 is any value at all
+	*/
+	static Matrix4D MakeWorld(std::mt19937& random, const Vector3D& center, float translation, float maxScale, bool degenerate)
+	{
+		std::uniform_real_distribution<float> Unit(-1.0f, 1.0f);
+
+		Matrix4D World = Matrix4D::MakeRotation(Vector3D(Unit(random) * 180.0f, Unit(random) * 180.0f, Unit(random) * 180.0f));
+		for (int Row = 0; Row < 3; ++Row)
+		{
+			float Scale = degenerate ? (random() % 16 == 0 ? 0.0f : Unit(random) * maxScale) : 0.1f + std::fabs(Unit(random)) * maxScale;
+			for (int Column = 0; Column < 3; ++Column)
+			{
+				World(Row, Column) = degenerate && random() % 8 == 0 ? Unit(random) * maxScale : World(Row, Column) * Scale;
+			}
+		}
+		World.SetTranslation(center + Vector3D(Unit(random) * translation, Unit(random) * translation, Unit(random) * translation));
+		return World;
+	}
+
+	/*
+	* A camera somewhere looking somewhere, planes through Frustum::CreateFrustum() like the renderer builds them
+	*	A template so only the tests that cull include Frustum.h, it needs a Vertex each of them gets its own way
+	*/
+	template<typename FrustumType>
+	static void CameraFrustum(std::mt19937& random, FrustumType& outFrustum)
+	{
+		std::uniform_real_distribution<float> Unit(-1.0f, 1.0f);
+
+		outFrustum.SetFrustumInternals(16.0f / 9.0f, 1.0f + Unit(random) * 0.5f, 0.1f, 200.0f + Unit(random) * 100.0f);
+
+		Vector3D Forward(Unit(random), Unit(random), Unit(random) + 2.0f);
+		Forward.Normalize();
+		Vector3D Right = Vector3D::CrossProduct(Vector3D(0.0f, 1.0f, 0.0f), Forward);
+		Right.Normalize();
+		Vector3D Up = Vector3D::CrossProduct(Forward, Right);
+
+		outFrustum.CreateFrustum(Vector3D(Unit(random) * 50.0f, Unit(random) * 50.0f, Unit(random) * 50.0f), Right, Up, Forward);
+	}
+};
+
+#define TEST_CHECK(condition) ((condition) ? (void)0 : Test::Fail(#condition, __FILE__, __LINE__))
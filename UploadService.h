@@ -0,0 +1,489 @@
+#pragma once
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "GatewareDefine.h"
+#include "GenericDefines.h"
+#include "GpuMemory.h"
+#include "DeletionQueue.h"
+
+/*
+* Batches every upload of a frame, submitted once right before the frame's own submission
+*	Copies go to the device's transfer only queue when Gateware found one, with VK_KHR_timeline_semaphore: the copy batch
+*	signals CopiesDone and a small graphics batch waits on that value, the frame is ordered behind it by the graphics queue
+*	and the barrier that ends it. Buffers and images the copies write are VK_SHARING_MODE_CONCURRENT between both families
+*	The graphics batch also carries what needs a graphics queue: the final image layouts, mip blits and culling dispatches
+*	Without a transfer queue both batches are one command buffer on the graphics queue
+*	Nothing waits on the CPU, staging buffers and whatever is retired with RetireAfterSubmit() go to DeletionQueue on Submit(),
+*	the frame's fence covers both batches since the frame waits for the graphics one, which waits for the copies
+*	Uploads recorded before the first frame (the first level load) go out with it
+*	Render thread only, command buffers and the command pools are not guarded
+*/
+class UploadService
+{
+public:
+	struct Stats
+	{
+		uint32 CopiesLastSubmit;
+		size_t BytesLastSubmit;
+
+		uint32 SubmitCount;
+		size_t TotalBytesUploaded;
+
+		bool UsesTransferQueue;
+	};
+
+private:
+	VkDevice Device;
+	GW::GRAPHICS::GVulkanSurface* VlkSurface;
+
+	/* nullptr when the copies stay on the graphics queue */
+	VkQueue TransferQueue;
+	VkCommandPool TransferCommandPool;
+
+	/* Timeline semaphore the copy batches signal, CopiesDoneValue is the last value submitted */
+	VkSemaphore CopiesDone;
+	uint64_t CopiesDoneValue;
+
+	/* Batches being recorded, nullptr if nothing was recorded into them since the last Submit() */
+	VkCommandBuffer CopyCommandBuffer;
+	VkCommandBuffer GraphicsCommandBuffer;
+
+	/* Staging buffers and old resources the batch still reads */
+	std::vector<std::function<void()>> PendingRetires;
+
+	uint32 PendingCopies;
+	size_t PendingBytes;
+
+	Stats CurrentStats;
+
+private:
+	UploadService()
+	{
+		Device = nullptr;
+		VlkSurface = nullptr;
+
+		TransferQueue = nullptr;
+		TransferCommandPool = nullptr;
+		CopiesDone = nullptr;
+		CopiesDoneValue = 0;
+
+		CopyCommandBuffer = nullptr;
+		GraphicsCommandBuffer = nullptr;
+
+		PendingCopies = 0;
+		PendingBytes = 0;
+
+		CurrentStats = { };
+	}
+
+public:
+	UploadService(const UploadService& other) = delete;
+	UploadService& operator=(const UploadService& other) = delete;
+
+	static UploadService& Get()
+	{
+		static UploadService Instance;
+		return Instance;
+	}
+
+public:
+	/* Has to be called before the first upload and the first buffer with transfer usage, it picks their sharing mode */
+	void Initialize(VkDevice device, GW::GRAPHICS::GVulkanSurface* vlkSurface)
+	{
+		Device = device;
+		VlkSurface = vlkSurface;
+
+		unsigned int GraphicsFamily = 0;
+		unsigned int PresentFamily = 0;
+		VlkSurface->GetQueueFamilyIndices(GraphicsFamily, PresentFamily);
+
+		VkQueue Queue = nullptr;
+		unsigned int TransferFamily = GraphicsFamily;
+		if (VlkSurface->GetTransferQueue((void**)&Queue, TransferFamily) != GW::GReturn::SUCCESS || !CreateTransferObjects(TransferFamily))
+		{
+			Queue = nullptr;
+			TransferFamily = GraphicsFamily;
+		}
+
+		TransferQueue = Queue;
+		GpuMemory::Get().SetUploadQueueFamilies(GraphicsFamily, TransferFamily);
+		CurrentStats.UsesTransferQueue = TransferQueue != nullptr;
+	}
+
+	/* Call once the device is idle and DeletionQueue was flushed, the submitted command buffers are freed by then */
+	void Shutdown()
+	{
+		if (CopiesDone != nullptr)
+		{
+			vkDestroySemaphore(Device, CopiesDone, nullptr);
+			CopiesDone = nullptr;
+		}
+
+		if (TransferCommandPool != nullptr)
+		{
+			vkDestroyCommandPool(Device, TransferCommandPool, nullptr);
+			TransferCommandPool = nullptr;
+		}
+
+		TransferQueue = nullptr;
+		CopiesDoneValue = 0;
+	}
+
+	/*
+	* Staging memory the next batch copies from, filled by the caller through the returned pointer
+	*	@returns nullptr if the buffer could not be created
+	*/
+	char* Stage(size_t sizeInBytes, VkBuffer* outBuffer)
+	{
+		*outBuffer = nullptr;
+		if (sizeInBytes == 0)
+		{
+			return nullptr;
+		}
+
+		VkBuffer StagingBufferHandle = nullptr;
+		GpuAllocation StagingBufferMemory;
+		if (GpuMemory::Get().CreateBuffer(sizeInBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &StagingBufferHandle, &StagingBufferMemory) != VK_SUCCESS)
+		{
+			std::cout << "\n[UploadService]: Failed to create a " << sizeInBytes << " byte staging buffer";
+			return nullptr;
+		}
+
+		PendingRetires.push_back([StagingBufferHandle, StagingBufferMemory]() mutable
+			{
+				GpuMemory::Get().DestroyBuffer(StagingBufferHandle, StagingBufferMemory);
+			});
+		PendingBytes += sizeInBytes;
+
+		*outBuffer = StagingBufferHandle;
+		return StagingBufferMemory.Mapped;
+	}
+
+	void CopyBuffer(VkBuffer source, VkBuffer destination, const std::vector<VkBufferCopy>& regions)
+	{
+		if (regions.empty())
+		{
+			return;
+		}
+
+		vkCmdCopyBuffer(GetCopyCommandBuffer(), source, destination, static_cast<uint32>(regions.size()), regions.data());
+		PendingCopies += static_cast<uint32>(regions.size());
+	}
+
+	/* Copies regions into every mip level and layer of destination, the image ends up in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL */
+	void CopyBufferToImage(VkBuffer source, VkImage destination, uint32 levelCount, uint32 layerCount, const std::vector<VkBufferImageCopy>& regions)
+	{
+		VkCommandBuffer Commands = GetCopyCommandBuffer();
+		ImageBarrier(Commands, destination, 0, levelCount, layerCount, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+		vkCmdCopyBufferToImage(Commands, source, destination, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32>(regions.size()), regions.data());
+		PendingCopies += static_cast<uint32>(regions.size());
+
+		/* On the graphics queue, the shader stages are not part of a transfer queue */
+		ImageBarrier(GetGraphicsCommandBuffer(), destination, 0, levelCount, layerCount, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+	}
+
+	/*
+	* Copies regions into mip level 0 of every layer, the graphics batch blits each level below it out of the one above
+	*	destination needs VK_IMAGE_USAGE_TRANSFER_SRC_BIT and a format with linear filtered blits, it ends up in
+	*	VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+	*/
+	void CopyBufferToImageAndBlitMipmaps(VkBuffer source, VkImage destination, uint32 width, uint32 height, uint32 levelCount, uint32 layerCount,
+		const std::vector<VkBufferImageCopy>& regions)
+	{
+		VkCommandBuffer Copies = GetCopyCommandBuffer();
+		ImageBarrier(Copies, destination, 0, levelCount, layerCount, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+		vkCmdCopyBufferToImage(Copies, source, destination, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32>(regions.size()), regions.data());
+		PendingCopies += static_cast<uint32>(regions.size());
+
+		/* Blits need a graphics queue, each level is read once the one above it was written */
+		VkCommandBuffer Commands = GetGraphicsCommandBuffer();
+		for (uint32 i = 1; i < levelCount; ++i)
+		{
+			ImageBarrier(Commands, destination, i - 1, 1, layerCount, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+			VkImageBlit Blit = { };
+			Blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, i - 1, 0, layerCount };
+			Blit.srcOffsets[1] = { MipExtent(width, i - 1), MipExtent(height, i - 1), 1 };
+			Blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, i, 0, layerCount };
+			Blit.dstOffsets[1] = { MipExtent(width, i), MipExtent(height, i), 1 };
+			vkCmdBlitImage(Commands, destination, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, destination, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &Blit,
+				VK_FILTER_LINEAR);
+		}
+
+		/* Every level but the last was a blit source */
+		const VkPipelineStageFlags ShaderStages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		if (levelCount > 1)
+		{
+			ImageBarrier(Commands, destination, 0, levelCount - 1, layerCount, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, ShaderStages);
+		}
+		ImageBarrier(Commands, destination, levelCount - 1, 1, layerCount, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, ShaderStages);
+	}
+
+	/* Copies recorded after this see the writes of the copies recorded before it, for buffers that are written and then read in one batch */
+	void TransferBarrier()
+	{
+		VkMemoryBarrier Barrier = { };
+		Barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		Barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		Barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(GetCopyCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &Barrier, 0, nullptr, 0, nullptr);
+	}
+
+	/*
+	* The graphics batch, for work other than copies that has to run before the frame and outside its render pass, such as culling dispatches
+	*	It runs after this frame's copies and the closing barrier of Submit() makes its shader writes visible to the frame
+	*/
+	VkCommandBuffer GetBatchCommandBuffer()
+	{
+		return GetGraphicsCommandBuffer();
+	}
+
+	/* destroy is handed to DeletionQueue once the batch that reads the resource was submitted */
+	void RetireAfterSubmit(std::function<void()> destroy)
+	{
+		PendingRetires.push_back(std::move(destroy));
+	}
+
+	/* Same as DeletionQueue::RetireBuffer() but waits for the batch, buffer and allocation are reset */
+	void RetireBufferAfterSubmit(VkBuffer& buffer, GpuAllocation& allocation)
+	{
+		VkBuffer Buffer = buffer;
+		GpuAllocation Allocation = allocation;
+		RetireAfterSubmit([Buffer, Allocation]() mutable { GpuMemory::Get().DestroyBuffer(Buffer, Allocation); });
+
+		buffer = nullptr;
+		allocation = GpuAllocation();
+	}
+
+	/*
+	* Submits what was recorded since the last call, has to be called before the frame's submission (EndFrame())
+	*	The copies go to the transfer queue first, the graphics batch waits for them on the graphics queue and its closing
+	*	barrier makes them visible to the frame submitted after it
+	*/
+	void Submit()
+	{
+		if (CopyCommandBuffer == nullptr && GraphicsCommandBuffer == nullptr)
+		{
+			/* Retired without a copy reading it, the frames in flight may still do */
+			RetirePending();
+			return;
+		}
+
+		uint64_t WaitValue = 0;
+		if (CopyCommandBuffer != nullptr)
+		{
+			vkEndCommandBuffer(CopyCommandBuffer);
+
+			uint64_t SignalValue = CopiesDoneValue + 1;
+			VkTimelineSemaphoreSubmitInfoKHR TimelineInfo = { };
+			TimelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+			TimelineInfo.signalSemaphoreValueCount = 1;
+			TimelineInfo.pSignalSemaphoreValues = &SignalValue;
+
+			VkSubmitInfo SubmitInfo = { };
+			SubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			SubmitInfo.pNext = &TimelineInfo;
+			SubmitInfo.commandBufferCount = 1;
+			SubmitInfo.pCommandBuffers = &CopyCommandBuffer;
+			SubmitInfo.signalSemaphoreCount = 1;
+			SubmitInfo.pSignalSemaphores = &CopiesDone;
+			if (vkQueueSubmit(TransferQueue, 1, &SubmitInfo, VK_NULL_HANDLE) == VK_SUCCESS)
+			{
+				CopiesDoneValue = SignalValue;
+				WaitValue = SignalValue;
+			}
+			else
+			{
+				std::cout << "\n[UploadService]: Failed to submit " << PendingCopies << " copies to the transfer queue";
+			}
+
+			RetireCommandBuffer(TransferCommandPool, CopyCommandBuffer);
+			CopyCommandBuffer = nullptr;
+		}
+
+		/* There is always a graphics batch, it holds the wait and the closing barrier */
+		VkCommandBuffer Commands = GetGraphicsCommandBuffer();
+
+		VkMemoryBarrier Barrier = { };
+		Barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		Barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		Barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT |
+			VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+		vkCmdPipelineBarrier(Commands, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+			0, 1, &Barrier, 0, nullptr, 0, nullptr);
+
+		vkEndCommandBuffer(Commands);
+
+		VkQueue GraphicsQueue = nullptr;
+		VlkSurface->GetGraphicsQueue((void**)&GraphicsQueue);
+
+		/* Everything in the graphics batch reads or transitions what the copies wrote */
+		VkPipelineStageFlags WaitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+		VkTimelineSemaphoreSubmitInfoKHR TimelineInfo = { };
+		TimelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+		TimelineInfo.waitSemaphoreValueCount = 1;
+		TimelineInfo.pWaitSemaphoreValues = &WaitValue;
+
+		VkSubmitInfo SubmitInfo = { };
+		SubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		SubmitInfo.commandBufferCount = 1;
+		SubmitInfo.pCommandBuffers = &Commands;
+		if (WaitValue != 0)
+		{
+			SubmitInfo.pNext = &TimelineInfo;
+			SubmitInfo.waitSemaphoreCount = 1;
+			SubmitInfo.pWaitSemaphores = &CopiesDone;
+			SubmitInfo.pWaitDstStageMask = &WaitStage;
+		}
+		if (vkQueueSubmit(GraphicsQueue, 1, &SubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+		{
+			std::cout << "\n[UploadService]: Failed to submit the graphics batch of " << PendingCopies << " copies";
+		}
+
+		RetireCommandBuffer(GetCommandPool(), Commands);
+		GraphicsCommandBuffer = nullptr;
+
+		RetirePending();
+
+		CurrentStats.CopiesLastSubmit = PendingCopies;
+		CurrentStats.BytesLastSubmit = PendingBytes;
+		CurrentStats.SubmitCount++;
+		CurrentStats.TotalBytesUploaded += PendingBytes;
+
+		PendingCopies = 0;
+		PendingBytes = 0;
+	}
+
+	const Stats& GetStats() const
+	{
+		return CurrentStats;
+	}
+
+private:
+	/* Command pool and timeline semaphore of the transfer queue, @returns false and leaves neither if one could not be created */
+	bool CreateTransferObjects(uint32 queueFamilyIndex)
+	{
+		VkCommandPoolCreateInfo PoolInfo = { };
+		PoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		PoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		PoolInfo.queueFamilyIndex = queueFamilyIndex;
+
+		VkSemaphoreTypeCreateInfoKHR TypeInfo = { };
+		TypeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+		TypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+		TypeInfo.initialValue = 0;
+
+		VkSemaphoreCreateInfo SemaphoreInfo = { };
+		SemaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		SemaphoreInfo.pNext = &TypeInfo;
+
+		if (vkCreateCommandPool(Device, &PoolInfo, nullptr, &TransferCommandPool) != VK_SUCCESS ||
+			vkCreateSemaphore(Device, &SemaphoreInfo, nullptr, &CopiesDone) != VK_SUCCESS)
+		{
+			std::cout << "\n[UploadService]: Failed to set up the transfer queue, uploads stay on the graphics queue";
+			Shutdown();
+			return false;
+		}
+
+		return true;
+	}
+
+	void RetirePending()
+	{
+		for (uint32 i = 0; i < PendingRetires.size(); ++i)
+		{
+			DeletionQueue::Get().Retire(std::move(PendingRetires[i]));
+		}
+		PendingRetires.clear();
+	}
+
+	/* The command buffer lives until the frame's fence says the batch is done */
+	void RetireCommandBuffer(VkCommandPool commandPool, VkCommandBuffer commandBuffer)
+	{
+		VkDevice DeviceHandle = Device;
+		DeletionQueue::Get().Retire([DeviceHandle, commandPool, commandBuffer]()
+			{
+				vkFreeCommandBuffers(DeviceHandle, commandPool, 1, &commandBuffer);
+			});
+	}
+
+	/* Copies go into the graphics batch when there is no transfer queue */
+	VkCommandBuffer GetCopyCommandBuffer()
+	{
+		if (TransferQueue == nullptr)
+		{
+			return GetGraphicsCommandBuffer();
+		}
+
+		return BeginOnFirstUse(TransferCommandPool, CopyCommandBuffer);
+	}
+
+	VkCommandBuffer GetGraphicsCommandBuffer()
+	{
+		return BeginOnFirstUse(GetCommandPool(), GraphicsCommandBuffer);
+	}
+
+	VkCommandBuffer BeginOnFirstUse(VkCommandPool commandPool, VkCommandBuffer& commandBuffer)
+	{
+		if (commandBuffer != nullptr)
+		{
+			return commandBuffer;
+		}
+
+		VkCommandBufferAllocateInfo AllocateInfo = { };
+		AllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		AllocateInfo.commandPool = commandPool;
+		AllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		AllocateInfo.commandBufferCount = 1;
+		vkAllocateCommandBuffers(Device, &AllocateInfo, &commandBuffer);
+
+		VkCommandBufferBeginInfo BeginInfo = { };
+		BeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		BeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		vkBeginCommandBuffer(commandBuffer, &BeginInfo);
+
+		return commandBuffer;
+	}
+
+	VkCommandPool GetCommandPool() const
+	{
+		VkCommandPool CommandPool = nullptr;
+		VlkSurface->GetCommandPool((void**)&CommandPool);
+		return CommandPool;
+	}
+
+	static void ImageBarrier(VkCommandBuffer commandBuffer, VkImage image, uint32 baseLevel, uint32 levelCount, uint32 layerCount,
+		VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+		VkPipelineStageFlags srcStages, VkPipelineStageFlags dstStages)
+	{
+		VkImageMemoryBarrier Barrier = { };
+		Barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		Barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		Barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		Barrier.image = image;
+		Barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, baseLevel, levelCount, 0, layerCount };
+		Barrier.srcAccessMask = srcAccess;
+		Barrier.dstAccessMask = dstAccess;
+		Barrier.oldLayout = oldLayout;
+		Barrier.newLayout = newLayout;
+		vkCmdPipelineBarrier(commandBuffer, srcStages, dstStages, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
+	}
+
+	/* Size of a mip level along one axis, never below 1 */
+	static int32 MipExtent(uint32 extent, uint32 level)
+	{
+		return static_cast<int32>(extent >> level > 0 ? extent >> level : 1);
+	}
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include <vector>
+#include "GatewareDefine.h"
+#include "GenericDefines.h"
+
+struct VertexAttribute
+{
+	uint32 Location;
+	VkFormat Format;
+	uint32 Offset;
+};
+
+/* Describes one interleaved vertex buffer, vertex structs return theirs from GetLayout() so pipelines always match the struct */
+struct VertexLayout
+{
+	uint32 Stride;
+	std::vector<VertexAttribute> Attributes;
+};
@@ -2,6 +2,7 @@
 #include <vector>
 #include <vulkan/vulkan_core.h>
 #include "GenericDefines.h"
+#include "VertexLayout.h"
 #include "Math/Vector2D.h"
 #include <iostream>
 
@@ -134,6 +135,21 @@ public:
 		AssemblyStateCreateInfo.flags = 0;
 	}
 
+	/* Replaces the vertex input state with one per-vertex binding described by layout */
+	void SetVertexLayout(uint32 bindingNum, const VertexLayout& layout)
+	{
+		VertexBindingDescriptions.clear();
+		VertexAttributeDescriptions.clear();
+
+		AddNewVertexInputBindingDescription(bindingNum, layout.Stride, VK_VERTEX_INPUT_RATE_VERTEX);
+		for (uint32 i = 0; i < layout.Attributes.size(); ++i)
+		{
+			AddNewVertexInputAttributeDescription(layout.Attributes[i].Location, bindingNum, layout.Attributes[i].Format, layout.Attributes[i].Offset);
+		}
+
+		SetVertexInputStateCreateInfo();
+	}
+
 	void SetVertexInputStateCreateInfo()
 	{
 		VertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
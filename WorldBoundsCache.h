@@ -0,0 +1,141 @@
+#pragma once
+#include <cstring>
+#include <vector>
+
+#include "GenericDefines.h"
+#include "Math/Matrix4D.h"
+#include "Math/VrixicMathBounds.h"
+#include "StaticMesh.h"
+
+/*
+* World AABB of every instance of the static meshes, as center / extents streams for CPU culling
+*	Instance j of mesh i is box GetFirstBox(i) + j
+*	A box is only recomputed when its world matrix differs from the one it was last computed with, or its mesh changed,
+*	runs of changed instances go through Bounds::TransformAABBs() four at a time
+*/
+class WorldBoundsCache
+{
+public:
+	struct Stats
+	{
+		uint32 BoxCount;
+		uint32 RecomputedLastUpdate;
+	};
+
+	BoxStreams Boxes;
+
+private:
+	/* What the boxes of a mesh were computed from */
+	struct MeshEntry
+	{
+		uint32 FirstBox;
+		uint32 WorldMatrixIndex;
+		uint32 InstanceCount;
+
+		Vector3D Center;
+		Vector3D Extents;
+	};
+
+	std::vector<MeshEntry> Meshes;
+
+	/* World matrix each box was computed with */
+	std::vector<Matrix4D> Matrices;
+
+	Stats CurrentStats;
+
+public:
+	WorldBoundsCache()
+	{
+		CurrentStats = { };
+	}
+
+public:
+	/* Brings the boxes up to date with meshes and their instances' matrices in worldMatrices */
+	void Update(const std::vector<StaticMesh>& meshes, const std::vector<Matrix4D>& worldMatrices)
+	{
+		uint32 BoxCount = 0;
+		for (uint32 i = 0; i < meshes.size(); ++i)
+		{
+			BoxCount += meshes[i].GetInstanceCount();
+		}
+
+		Boxes.Resize(BoxCount);
+		Matrices.resize(BoxCount);
+		Meshes.resize(meshes.size());
+
+		uint32 Recomputed = 0;
+		uint32 FirstBox = 0;
+		for (uint32 i = 0; i < meshes.size(); ++i)
+		{
+			const StaticMesh& Mesh = meshes[i];
+
+			MeshEntry Entry = { };
+			Entry.FirstBox = FirstBox;
+			Entry.WorldMatrixIndex = Mesh.GetWorldMatrixIndex();
+			Entry.InstanceCount = Mesh.GetInstanceCount();
+			Entry.Center = (Mesh.MinBox_AABB + Mesh.MaxBox_AABB) * 0.5f;
+			Entry.Extents = Mesh.MaxBox_AABB - Entry.Center;
+
+			/* A new level or a moved mesh, none of its boxes can be trusted */
+			bool MeshChanged = memcmp(&Meshes[i], &Entry, sizeof(MeshEntry)) != 0;
+			Meshes[i] = Entry;
+
+			/* Nothing to index, a mesh without instances may point one past the level's last matrix */
+			if (Entry.InstanceCount == 0)
+			{
+				continue;
+			}
+
+			const Matrix4D* InstanceMatrices = &worldMatrices[Entry.WorldMatrixIndex];
+			uint32 RunStart = 0;
+			uint32 RunCount = 0;
+			for (uint32 j = 0; j <= Entry.InstanceCount; ++j)
+			{
+				bool Changed = false;
+				if (j < Entry.InstanceCount)
+				{
+					Matrix4D& Cached = Matrices[FirstBox + j];
+					Changed = MeshChanged || memcmp(&Cached, &InstanceMatrices[j], sizeof(Matrix4D)) != 0;
+					if (Changed)
+					{
+						Cached = InstanceMatrices[j];
+					}
+				}
+
+				if (Changed)
+				{
+					RunStart = RunCount == 0 ? j : RunStart;
+					RunCount++;
+				}
+				else if (RunCount > 0)
+				{
+					Bounds::TransformAABBs(Entry.Center, Entry.Extents, InstanceMatrices + RunStart, RunCount, Boxes, FirstBox + RunStart);
+					Recomputed += RunCount;
+					RunCount = 0;
+				}
+			}
+
+			FirstBox += Entry.InstanceCount;
+		}
+
+		CurrentStats.BoxCount = BoxCount;
+		CurrentStats.RecomputedLastUpdate = Recomputed;
+	}
+
+	/* Every box is recomputed by the next Update() */
+	void Invalidate()
+	{
+		Meshes.clear();
+		Matrices.clear();
+	}
+
+	uint32 GetFirstBox(uint32 meshIndex) const
+	{
+		return Meshes[meshIndex].FirstBox;
+	}
+
+	const Stats& GetStats() const
+	{
+		return CurrentStats;
+	}
+};
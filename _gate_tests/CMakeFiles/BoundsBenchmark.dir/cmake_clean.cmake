@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BoundsBenchmark"
+  "BoundsBenchmark.pdb"
+  "CMakeFiles/BoundsBenchmark.dir/BoundsBenchmark.cpp.o"
+  "CMakeFiles/BoundsBenchmark.dir/BoundsBenchmark.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BoundsBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BoundsBenchmarkAVX2"
+  "BoundsBenchmarkAVX2.pdb"
+  "CMakeFiles/BoundsBenchmarkAVX2.dir/BoundsBenchmark.cpp.o"
+  "CMakeFiles/BoundsBenchmarkAVX2.dir/BoundsBenchmark.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BoundsBenchmarkAVX2.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
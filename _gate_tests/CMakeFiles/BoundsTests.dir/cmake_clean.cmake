@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BoundsTests"
+  "BoundsTests.pdb"
+  "CMakeFiles/BoundsTests.dir/BoundsTests.cpp.o"
+  "CMakeFiles/BoundsTests.dir/BoundsTests.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BoundsTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BoundsTestsAVX2"
+  "BoundsTestsAVX2.pdb"
+  "CMakeFiles/BoundsTestsAVX2.dir/BoundsTests.cpp.o"
+  "CMakeFiles/BoundsTestsAVX2.dir/BoundsTests.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BoundsTestsAVX2.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/CullingTests.dir/CullingTests.cpp.o"
+  "CMakeFiles/CullingTests.dir/CullingTests.cpp.o.d"
+  "CullingTests"
+  "CullingTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/CullingTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
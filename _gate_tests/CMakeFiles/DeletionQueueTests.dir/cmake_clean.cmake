@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DeletionQueueTests.dir/DeletionQueueTests.cpp.o"
+  "CMakeFiles/DeletionQueueTests.dir/DeletionQueueTests.cpp.o.d"
+  "DeletionQueueTests"
+  "DeletionQueueTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DeletionQueueTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DrawListBenchmark.dir/DrawListBenchmark.cpp.o"
+  "CMakeFiles/DrawListBenchmark.dir/DrawListBenchmark.cpp.o.d"
+  "DrawListBenchmark"
+  "DrawListBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DrawListBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
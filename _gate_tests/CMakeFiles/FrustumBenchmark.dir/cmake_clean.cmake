@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FrustumBenchmark.dir/FrustumBenchmark.cpp.o"
+  "CMakeFiles/FrustumBenchmark.dir/FrustumBenchmark.cpp.o.d"
+  "FrustumBenchmark"
+  "FrustumBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FrustumBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FrustumBenchmarkAVX2.dir/FrustumBenchmark.cpp.o"
+  "CMakeFiles/FrustumBenchmarkAVX2.dir/FrustumBenchmark.cpp.o.d"
+  "FrustumBenchmarkAVX2"
+  "FrustumBenchmarkAVX2.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FrustumBenchmarkAVX2.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
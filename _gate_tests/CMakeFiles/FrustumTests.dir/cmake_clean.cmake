@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FrustumTests.dir/FrustumTests.cpp.o"
+  "CMakeFiles/FrustumTests.dir/FrustumTests.cpp.o.d"
+  "FrustumTests"
+  "FrustumTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FrustumTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FrustumTestsAVX2.dir/FrustumTests.cpp.o"
+  "CMakeFiles/FrustumTestsAVX2.dir/FrustumTests.cpp.o.d"
+  "FrustumTestsAVX2"
+  "FrustumTestsAVX2.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FrustumTestsAVX2.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
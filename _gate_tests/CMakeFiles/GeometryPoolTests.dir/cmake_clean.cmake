@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/GeometryPoolTests.dir/GeometryPoolTests.cpp.o"
+  "CMakeFiles/GeometryPoolTests.dir/GeometryPoolTests.cpp.o.d"
+  "GeometryPoolTests"
+  "GeometryPoolTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/GeometryPoolTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/GpuMemoryAllocatorTests.dir/GpuMemoryAllocatorTests.cpp.o"
+  "CMakeFiles/GpuMemoryAllocatorTests.dir/GpuMemoryAllocatorTests.cpp.o.d"
+  "GpuMemoryAllocatorTests"
+  "GpuMemoryAllocatorTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/GpuMemoryAllocatorTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
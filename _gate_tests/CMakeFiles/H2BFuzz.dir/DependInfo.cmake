@@ -0,0 +1,20 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/Tests/H2BFuzz.cpp" "CMakeFiles/H2BFuzz.dir/H2BFuzz.cpp.o" "gcc" "CMakeFiles/H2BFuzz.dir/H2BFuzz.cpp.o.d"
+  "/root/repo/MappedFile.cpp" "CMakeFiles/H2BFuzz.dir/root/repo/MappedFile.cpp.o" "gcc" "CMakeFiles/H2BFuzz.dir/root/repo/MappedFile.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
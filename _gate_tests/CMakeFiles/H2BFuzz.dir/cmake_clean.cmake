@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/H2BFuzz.dir/H2BFuzz.cpp.o"
+  "CMakeFiles/H2BFuzz.dir/H2BFuzz.cpp.o.d"
+  "CMakeFiles/H2BFuzz.dir/root/repo/MappedFile.cpp.o"
+  "CMakeFiles/H2BFuzz.dir/root/repo/MappedFile.cpp.o.d"
+  "H2BFuzz"
+  "H2BFuzz.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/H2BFuzz.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
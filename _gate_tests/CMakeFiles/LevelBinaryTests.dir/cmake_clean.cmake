@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LevelBinaryTests.dir/LevelBinaryTests.cpp.o"
+  "CMakeFiles/LevelBinaryTests.dir/LevelBinaryTests.cpp.o.d"
+  "CMakeFiles/LevelBinaryTests.dir/root/repo/FileHelper.cpp.o"
+  "CMakeFiles/LevelBinaryTests.dir/root/repo/FileHelper.cpp.o.d"
+  "CMakeFiles/LevelBinaryTests.dir/root/repo/MappedFile.cpp.o"
+  "CMakeFiles/LevelBinaryTests.dir/root/repo/MappedFile.cpp.o.d"
+  "LevelBinaryTests"
+  "LevelBinaryTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LevelBinaryTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
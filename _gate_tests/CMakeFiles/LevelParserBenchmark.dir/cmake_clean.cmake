@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LevelParserBenchmark.dir/LevelParserBenchmark.cpp.o"
+  "CMakeFiles/LevelParserBenchmark.dir/LevelParserBenchmark.cpp.o.d"
+  "CMakeFiles/LevelParserBenchmark.dir/root/repo/FileHelper.cpp.o"
+  "CMakeFiles/LevelParserBenchmark.dir/root/repo/FileHelper.cpp.o.d"
+  "CMakeFiles/LevelParserBenchmark.dir/root/repo/MappedFile.cpp.o"
+  "CMakeFiles/LevelParserBenchmark.dir/root/repo/MappedFile.cpp.o.d"
+  "LevelParserBenchmark"
+  "LevelParserBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LevelParserBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
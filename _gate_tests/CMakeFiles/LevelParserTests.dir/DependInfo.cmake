@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/Tests/LevelParserBenchmark.cpp" "CMakeFiles/LevelParserTests.dir/LevelParserBenchmark.cpp.o" "gcc" "CMakeFiles/LevelParserTests.dir/LevelParserBenchmark.cpp.o.d"
+  "/root/repo/FileHelper.cpp" "CMakeFiles/LevelParserTests.dir/root/repo/FileHelper.cpp.o" "gcc" "CMakeFiles/LevelParserTests.dir/root/repo/FileHelper.cpp.o.d"
+  "/root/repo/MappedFile.cpp" "CMakeFiles/LevelParserTests.dir/root/repo/MappedFile.cpp.o" "gcc" "CMakeFiles/LevelParserTests.dir/root/repo/MappedFile.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LevelParserTests.dir/LevelParserBenchmark.cpp.o"
+  "CMakeFiles/LevelParserTests.dir/LevelParserBenchmark.cpp.o.d"
+  "CMakeFiles/LevelParserTests.dir/root/repo/FileHelper.cpp.o"
+  "CMakeFiles/LevelParserTests.dir/root/repo/FileHelper.cpp.o.d"
+  "CMakeFiles/LevelParserTests.dir/root/repo/MappedFile.cpp.o"
+  "CMakeFiles/LevelParserTests.dir/root/repo/MappedFile.cpp.o.d"
+  "LevelParserTests"
+  "LevelParserTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LevelParserTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,28 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/Tests
+# Build directory: /root/repo/_gate_tests
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(H2BFuzz "/root/repo/_gate_tests/H2BFuzz")
+set_tests_properties(H2BFuzz PROPERTIES  SKIP_RETURN_CODE "77" _BACKTRACE_TRIPLES "/root/repo/Tests/CMakeLists.txt;47;add_test;/root/repo/Tests/CMakeLists.txt;52;add_headless_test;/root/repo/Tests/CMakeLists.txt;0;")
+add_test(BoundsTests "/root/repo/_gate_tests/BoundsTests")
+set_tests_properties(BoundsTests PROPERTIES  SKIP_RETURN_CODE "77" _BACKTRACE_TRIPLES "/root/repo/Tests/CMakeLists.txt;47;add_test;/root/repo/Tests/CMakeLists.txt;70;add_headless_test;/root/repo/Tests/CMakeLists.txt;0;")
+add_test(BoundsTestsAVX2 "/root/repo/_gate_tests/BoundsTestsAVX2")
+set_tests_properties(BoundsTestsAVX2 PROPERTIES  SKIP_RETURN_CODE "77" _BACKTRACE_TRIPLES "/root/repo/Tests/CMakeLists.txt;47;add_test;/root/repo/Tests/CMakeLists.txt;73;add_headless_test;/root/repo/Tests/CMakeLists.txt;0;")
+add_test(FrustumTests "/root/repo/_gate_tests/FrustumTests")
+set_tests_properties(FrustumTests PROPERTIES  SKIP_RETURN_CODE "77" _BACKTRACE_TRIPLES "/root/repo/Tests/CMakeLists.txt;47;add_test;/root/repo/Tests/CMakeLists.txt;80;add_headless_test;/root/repo/Tests/CMakeLists.txt;0;")
+add_test(FrustumTestsAVX2 "/root/repo/_gate_tests/FrustumTestsAVX2")
+set_tests_properties(FrustumTestsAVX2 PROPERTIES  SKIP_RETURN_CODE "77" _BACKTRACE_TRIPLES "/root/repo/Tests/CMakeLists.txt;47;add_test;/root/repo/Tests/CMakeLists.txt;83;add_headless_test;/root/repo/Tests/CMakeLists.txt;0;")
+add_test(DeletionQueueTests "/root/repo/_gate_tests/DeletionQueueTests")
+set_tests_properties(DeletionQueueTests PROPERTIES  SKIP_RETURN_CODE "77" _BACKTRACE_TRIPLES "/root/repo/Tests/CMakeLists.txt;47;add_test;/root/repo/Tests/CMakeLists.txt;91;add_headless_test;/root/repo/Tests/CMakeLists.txt;0;")
+add_test(GpuMemoryAllocatorTests "/root/repo/_gate_tests/GpuMemoryAllocatorTests")
+set_tests_properties(GpuMemoryAllocatorTests PROPERTIES  SKIP_RETURN_CODE "77" _BACKTRACE_TRIPLES "/root/repo/Tests/CMakeLists.txt;47;add_test;/root/repo/Tests/CMakeLists.txt;95;add_headless_test;/root/repo/Tests/CMakeLists.txt;0;")
+add_test(CullingTests "/root/repo/_gate_tests/CullingTests")
+set_tests_properties(CullingTests PROPERTIES  SKIP_RETURN_CODE "77" _BACKTRACE_TRIPLES "/root/repo/Tests/CMakeLists.txt;47;add_test;/root/repo/Tests/CMakeLists.txt;105;add_headless_test;/root/repo/Tests/CMakeLists.txt;0;")
+add_test(GeometryPoolTests "/root/repo/_gate_tests/GeometryPoolTests")
+set_tests_properties(GeometryPoolTests PROPERTIES  SKIP_RETURN_CODE "77" _BACKTRACE_TRIPLES "/root/repo/Tests/CMakeLists.txt;47;add_test;/root/repo/Tests/CMakeLists.txt;113;add_headless_test;/root/repo/Tests/CMakeLists.txt;0;")
+add_test(LevelParserTests "/root/repo/_gate_tests/LevelParserTests")
+set_tests_properties(LevelParserTests PROPERTIES  SKIP_RETURN_CODE "77" _BACKTRACE_TRIPLES "/root/repo/Tests/CMakeLists.txt;47;add_test;/root/repo/Tests/CMakeLists.txt;117;add_headless_test;/root/repo/Tests/CMakeLists.txt;0;")
+add_test(LevelBinaryTests "/root/repo/_gate_tests/LevelBinaryTests")
+set_tests_properties(LevelBinaryTests PROPERTIES  SKIP_RETURN_CODE "77" _BACKTRACE_TRIPLES "/root/repo/Tests/CMakeLists.txt;47;add_test;/root/repo/Tests/CMakeLists.txt;124;add_headless_test;/root/repo/Tests/CMakeLists.txt;0;")
@@ -3,6 +3,10 @@
 #include <fstream>
 #include <vector>
 #include <set>
+#include <string>
+#include <cstring>
+
+#include "MappedFile.h"
 
 namespace H2B {
 
@@ -48,6 +52,169 @@ namespace H2B {
 		BATCH drawInfo;
 		unsigned materialIndex;
 	};
+	/*
+	* Zero copy h2b reader, the file is memory mapped and vertices, indices and batches point straight into the mapping,
+	* material and mesh names point at the null terminated strings in the mapping
+	*	Everything stays valid for as long as the MappedParser is alive and Parse/Clear is not called again
+	*/
+	class MappedParser
+	{
+		MappedFile file;
+	public:
+		char version[4];
+		unsigned vertexCount;
+		unsigned indexCount;
+		unsigned materialCount;
+		unsigned meshCount;
+		const VERTEX* vertices;
+		const unsigned* indices;
+		std::vector<MATERIAL> materials;
+		const BATCH* batches;
+		std::vector<MESH> meshes;
+
+		MappedParser()
+		{
+			Clear();
+		}
+
+		MappedParser(const MappedParser& other) = delete;
+		MappedParser& operator=(const MappedParser& other) = delete;
+
+		/*
+		* validate also checks every batch, mesh and index against the counts in the header,
+		* truncated files are always rejected from the header alone before anything is allocated
+		*/
+		bool Parse(const char* h2bPath, bool validate = false)
+		{
+			Clear();
+			if (!file.Open(h2bPath))
+				return false;
+			return ParseData(file.Data(), file.Size(), validate);
+		}
+		/* Same as Parse on h2b data already in memory, data has to be 4 byte aligned and outlive everything pointing into it */
+		bool ParseMemory(const char* data, size_t size, bool validate = false)
+		{
+			Clear();
+			return ParseData(data, size, validate);
+		}
+		/* Smallest file that can hold the counts in the header, every string takes at least its terminator */
+		static unsigned long long MinimumFileSize(unsigned vertexCount, unsigned indexCount, unsigned materialCount, unsigned meshCount)
+		{
+			return 20ull + 36ull * vertexCount + 4ull * indexCount + (80ull + 10ull + 8ull) * materialCount + (1ull + 8ull + 4ull) * meshCount;
+		}
+		/* Every draw range must stay inside the index buffer and every index inside the vertex buffer */
+		bool Validate() const
+		{
+			for (unsigned i = 0; i < materialCount; ++i) {
+				BATCH batch;
+				std::memcpy(&batch, batches + i, sizeof(BATCH));
+				if (static_cast<unsigned long long>(batch.indexOffset) + batch.indexCount > indexCount)
+					return false;
+			}
+			for (unsigned i = 0; i < meshCount; ++i) {
+				if (static_cast<unsigned long long>(meshes[i].drawInfo.indexOffset) + meshes[i].drawInfo.indexCount > indexCount)
+					return false;
+				if (meshes[i].materialIndex >= materialCount)
+					return false;
+			}
+			for (unsigned i = 0; i < indexCount; ++i) {
+				if (indices[i] >= vertexCount)
+					return false;
+			}
+			return true;
+		}
+		void Clear()
+		{
+			file.Close();
+			*reinterpret_cast<unsigned*>(version) = 0;
+			vertexCount = indexCount = materialCount = meshCount = 0;
+			vertices = nullptr;
+			indices = nullptr;
+			batches = nullptr;
+			materials.clear();
+			meshes.clear();
+		}
+	private:
+		bool ParseData(const char* data, size_t size, bool validate)
+		{
+			const char* cursor = data;
+			const char* end = data + size;
+
+			if (!Read(cursor, end, version, 4))
+				return Fail();
+			if (version[1] < '1' || version[2] < '9' || version[3] < 'd')
+				return Fail();
+			if (!Read(cursor, end, &vertexCount, 4) || !Read(cursor, end, &indexCount, 4) ||
+				!Read(cursor, end, &materialCount, 4) || !Read(cursor, end, &meshCount, 4))
+				return Fail();
+			if (MinimumFileSize(vertexCount, indexCount, materialCount, meshCount) > size)
+				return Fail();
+
+			/* Vertices are packed (alignment 1), indices start at 20 + 36 * vertexCount which is always 4 byte aligned */
+			vertices = reinterpret_cast<const VERTEX*>(cursor);
+			if (!Skip(cursor, end, 36ull * vertexCount))
+				return Fail();
+			indices = reinterpret_cast<const unsigned*>(cursor);
+			if (!Skip(cursor, end, 4ull * indexCount))
+				return Fail();
+
+			materials.resize(materialCount);
+			for (unsigned i = 0; i < materialCount; ++i) {
+				if (!Read(cursor, end, &materials[i].attrib, 80))
+					return Fail();
+				for (int j = 0; j < 10; ++j) {
+					if (!ReadString(cursor, end, *((&materials[i].name) + j)))
+						return Fail();
+				}
+			}
+
+			batches = reinterpret_cast<const BATCH*>(cursor);
+			if (!Skip(cursor, end, 8ull * materialCount))
+				return Fail();
+
+			meshes.resize(meshCount);
+			for (unsigned i = 0; i < meshCount; ++i) {
+				if (!ReadString(cursor, end, meshes[i].name) ||
+					!Read(cursor, end, &meshes[i].drawInfo, 8) ||
+					!Read(cursor, end, &meshes[i].materialIndex, 4))
+					return Fail();
+			}
+			if (validate && !Validate())
+				return Fail();
+			return true;
+		}
+		bool Fail()
+		{
+			Clear();
+			return false;
+		}
+		static bool Skip(const char*& cursor, const char* end, unsigned long long size)
+		{
+			if (size > static_cast<unsigned long long>(end - cursor))
+				return false;
+			cursor += size;
+			return true;
+		}
+		static bool Read(const char*& cursor, const char* end, void* out, unsigned long long size)
+		{
+			if (size > static_cast<unsigned long long>(end - cursor))
+				return false;
+			std::memcpy(out, cursor, size);
+			cursor += size;
+			return true;
+		}
+		/* Empty strings are returned as nullptr, same as Parser */
+		static bool ReadString(const char*& cursor, const char* end, const char*& out)
+		{
+			const char* terminator = static_cast<const char*>(std::memchr(cursor, '\0', end - cursor));
+			if (terminator == nullptr)
+				return false;
+			out = terminator == cursor ? nullptr : cursor;
+			cursor = terminator + 1;
+			return true;
+		}
+	};
+	/* Owning reader, copies everything out of a MappedParser so nothing references the file after Parse */
 	class Parser
 	{
 		std::set<std::string> file_strings;
@@ -62,52 +229,32 @@ namespace H2B {
 		std::vector<MATERIAL> materials;
 		std::vector<BATCH> batches;
 		std::vector<MESH> meshes;
-		bool Parse(const char* h2bPath)
+		bool Parse(const char* h2bPath, bool validate = false)
 		{
 			Clear();
-			std::ifstream file;
-			char buffer[260] = { 0, };
-			file.open(h2bPath, std::ios_base::in |
-				std::ios_base::binary);
-			if (file.is_open() == false)
+			MappedParser mapped;
+			if (!mapped.Parse(h2bPath, validate))
 				return false;
-			file.read(version, 4);
-			if (version[1] < '1' || version[2] < '9' || version[3] < 'd')
-				return false;
-			file.read(reinterpret_cast<char*>(&vertexCount), 4);
-			file.read(reinterpret_cast<char*>(&indexCount), 4);
-			file.read(reinterpret_cast<char*>(&materialCount), 4);
-			file.read(reinterpret_cast<char*>(&meshCount), 4);
-			vertices.resize(vertexCount);
-			file.read(reinterpret_cast<char*>(vertices.data()), 36 * vertexCount);
-			indices.resize(indexCount);
-			file.read(reinterpret_cast<char*>(indices.data()), 4 * indexCount);
-			materials.resize(materialCount);
-			for (int i = 0; i < materialCount; ++i) {
-				file.read(reinterpret_cast<char*>(&materials[i].attrib), 80);
+			std::memcpy(version, mapped.version, 4);
+			vertexCount = mapped.vertexCount;
+			indexCount = mapped.indexCount;
+			materialCount = mapped.materialCount;
+			meshCount = mapped.meshCount;
+			vertices.assign(mapped.vertices, mapped.vertices + vertexCount);
+			indices.assign(mapped.indices, mapped.indices + indexCount);
+			materials = mapped.materials;
+			for (unsigned i = 0; i < materialCount; ++i) {
 				for (int j = 0; j < 10; ++j) {
-					buffer[0] = '\0';
-					*((&materials[i].name) + j) = nullptr;
-					file.getline(buffer, 260, '\0');
-					if (buffer[0] != '\0') {
-						auto last = file_strings.insert(buffer);
-						*((&materials[i].name) + j) = last.first->c_str();
-					}
+					const char*& str = *((&materials[i].name) + j);
+					if (str != nullptr)
+						str = file_strings.insert(str).first->c_str();
 				}
 			}
-			batches.resize(materialCount);
-			file.read(reinterpret_cast<char*>(batches.data()), 8 * materialCount);
-			meshes.resize(meshCount);
-			for (int i = 0; i < meshCount; ++i) {
-				buffer[0] = '\0';
-				meshes[i].name = nullptr;
-				file.getline(buffer, 260, '\0');
-				if (buffer[0] != '\0') {
-					auto last = file_strings.insert(buffer);
-					meshes[i].name = last.first->c_str();
-				}
-				file.read(reinterpret_cast<char*>(&meshes[i].drawInfo), 8);
-				file.read(reinterpret_cast<char*>(&meshes[i].materialIndex), 4);
+			batches.assign(mapped.batches, mapped.batches + materialCount);
+			meshes = mapped.meshes;
+			for (unsigned i = 0; i < meshCount; ++i) {
+				if (meshes[i].name != nullptr)
+					meshes[i].name = file_strings.insert(meshes[i].name).first->c_str();
 			}
 			return true;
 		}
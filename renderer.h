@@ -7,14 +7,21 @@
 #include "Math/Matrix4D.h"
 #include "FileHelper.h"
 #include "Level.h"
+#include "LevelStreamer.h"
 #include "StaticMesh.h"
 #include "Frustum.h"
 #include "VulkanPipeline.h"
+#include "GpuMemory.h"
+#include "DeletionQueue.h"
+#include "UploadService.h"
+#include "GpuCulling.h"
+#include "WorldBoundsCache.h"
 
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_vulkan.h"
 
 #define ENABLE_FRUSTUM_CULLING 1
+#define ENABLE_GPU_CULLING 1
 #define DRAW_LIGHTS 0
 
 // Default fence timeout in nanoseconds
@@ -130,6 +137,8 @@ class Renderer
 	VkShaderModule PixelShader_Basic = nullptr;
 	VkShaderModule PixelShader_Debug = nullptr;
 
+	VkShaderModule ComputeShader_Cull = nullptr;
+
 	// pipeline settings for drawing (also required)
 	VkPipeline Pipeline_Normal = nullptr;
 	VkPipeline Pipeline_Toon = nullptr;
@@ -150,6 +159,9 @@ class Renderer
 
 	Frustum CameraFrustum;
 
+	/* Culls the opaque draws per instance when ENABLE_GPU_CULLING is on and the device can draw them indirectly */
+	GpuCulling Culling;
+
 	Vector3D LightPos;
 
 	/* ImGui*/
@@ -176,20 +188,35 @@ class Renderer
 	uint32 ImguiVertexCount = 0;
 	uint32 ImguiIndexCount = 0;
 	VkBuffer ImguiVertexBuffer = VK_NULL_HANDLE;
-	VkDeviceMemory ImguiVertexBufferData = nullptr;
+	GpuAllocation ImguiVertexBufferMemory;
 
 	VkBuffer ImguiIndexBuffer = VK_NULL_HANDLE;
-	VkDeviceMemory ImguiIndexBufferData = nullptr;
-
-	void* ImguiVertexBufferMapped = nullptr;
-	void* ImguiIndexBufferMapped = nullptr;
+	GpuAllocation ImguiIndexBufferMemory;
 
 public:
 
 	Level* World;
+
+	/* Builds the next level in the background, swapped with World at a frame boundary once ready */
+	LevelStreamer Streamer;
+
 	/* Collection of all static meshes */
 	std::vector<StaticMesh> StaticMeshes;
-	std::vector<StaticMesh> RenderMeshes;
+	/* Instances of every StaticMeshes entry that passed CPU culling, in instance order */
+	std::vector<std::vector<uint32>> VisibleInstanceIDs;
+
+	/* What the CPU culling found for one mesh, swapped into VisibleInstanceIDs when it differs */
+	std::vector<uint32> CulledInstanceIDs;
+
+	/* StaticMeshes or VisibleInstanceIDs changed since World->OpaqueDraws was last built */
+	bool OpaqueDrawsChanged = true;
+
+	/* World AABBs the CPU culling tests, kept across frames */
+	WorldBoundsCache InstanceBounds;
+
+	/* Frustum::TestAABBs() result for InstanceBounds, one bit per box */
+	std::vector<uint32> VisibleBoxMask;
+	float CullNsPerBox = 0.0f;
 
 	std::vector<StaticMesh> DebugMeshes;
 
@@ -252,6 +279,20 @@ public:
 		vlk.GetDevice((void**)&device);
 		vlk.GetPhysicalDevice((void**)&physicalDevice);
 
+		/* Every buffer below is sub allocated from shared blocks */
+		GpuMemory::Get().Initialize(physicalDevice, device);
+
+		/* Static geometry of every level lives in one pair of arenas */
+		GeometryPool::Get().Initialize(sizeof(PackedVertex));
+
+		/* Geometry and textures are recorded into one batch per frame instead of being submitted and waited on, copied on a transfer queue if there is one */
+		UploadService::Get().Initialize(device, &vlk);
+
+		/* Resources replaced while frames are in flight are destroyed once those frames are done */
+		uint32 FramesInFlight = 0;
+		vlk.GetSwapchainImageCount(FramesInFlight);
+		DeletionQueue::Get().Initialize(FramesInFlight);
+
 		World = new Level(&device, &vlk, &pipelineLayout, "Vrixic", "../Levels/NormalMapTest.txt");
 
 		/***************** SHADER INTIALIZATION ******************/
@@ -363,6 +404,17 @@ public:
 			(char*)shaderc_result_get_bytes(result), &PixelShader_FresnelNormal);
 		shaderc_result_release(result); // done
 
+		std::string ComputeShaderCullSource = FileHelper::LoadShaderFileIntoString("../Shaders/CullCompute.hlsl");
+
+		result = shaderc_compile_into_spv( // compile
+			compiler, ComputeShaderCullSource.c_str(), ComputeShaderCullSource.length(),
+			shaderc_compute_shader, "main.comp", "main", options);
+		if (shaderc_result_get_compilation_status(result) != shaderc_compilation_status_success) // errors?
+			std::cout << "Compute Shader Errors: " << shaderc_result_get_error_message(result) << std::endl;
+		GvkHelper::create_shader_module(device, shaderc_result_get_length(result), // load into Vulkan
+			(char*)shaderc_result_get_bytes(result), &ComputeShader_Cull);
+		shaderc_result_release(result); // done
+
 		// Free runtime shader compiler resources
 		shaderc_compile_options_release(options);
 		shaderc_compiler_release(compiler);
@@ -380,16 +432,8 @@ public:
 		// Assembly State
 		PipelineCreator.SetInputAssemblyStateCreateInfo(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
 
-		// Vertex Input State
-		PipelineCreator.AddNewVertexInputBindingDescription(0, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX);
-		// Vertex attribs descs
-		PipelineCreator.AddNewVertexInputAttributeDescription(0, 0, VK_FORMAT_R32G32_SFLOAT, 0);
-		PipelineCreator.AddNewVertexInputAttributeDescription(1, 0, VK_FORMAT_R32G32B32_SFLOAT, 8);
-		PipelineCreator.AddNewVertexInputAttributeDescription(2, 0, VK_FORMAT_R32G32B32_SFLOAT, 20);
-		PipelineCreator.AddNewVertexInputAttributeDescription(3, 0, VK_FORMAT_R32G32B32A32_SFLOAT, 32);
-
-		// Set Vertex input state create info 
-		PipelineCreator.SetVertexInputStateCreateInfo();
+		// Vertex Input State, level meshes use the packed vertex
+		PipelineCreator.SetVertexLayout(0, PackedVertex::GetLayout());
 
 		// Viewport State (we still need to set this up even though we will overwrite the values)
 		Vector2D Pos = Vector2D(0.0f, 0.0f);
@@ -422,58 +466,21 @@ public:
 		PipelineCreator.SetDynamicStateCreateInfo();
 
 		/* Load World Before pipeline creation */
-		Frustum CamF;
 		float AspectRatio = 0.0f;
 		vlk.GetAspectRatio(AspectRatio);
 
 		/* Load the file */
 		std::vector<RawMeshData> RawData;
-		FileHelper::ReadGameLevelFile("../Levels/NormalMapTest.txt", RawData);
-
-		H2B::VERTEX V;
-		V.pos = reinterpret_cast<H2B::VECTOR&>(CamF.FarPlaneTopLeft);
-
-		RawMeshData Data;
-		Data.IndexCount = Frustum::GetFrustumIndexCount();
-		Data.VertexCount = Frustum::GetFrustumVertexCount();
-
-		Data.Vertices.resize(Frustum::GetFrustumVertexCount());
-		for (uint32 i = 0; i < Frustum::GetFrustumVertexCount(); ++i)
-		{
-			Data.Vertices[i] = V; // empty vector
-		}
-
-		Data.Indices.resize(Frustum::GetFrustumIndexCount());
-		uint32* Indices = Frustum::GetFrustumIndices();
-		for (uint32 i = 0; i < Frustum::GetFrustumIndexCount(); ++i)
-		{
-			Data.Indices[i] = Indices[i];
-		}
-
-		Data.InstanceCount = 1;
-		Data.MaterialCount = 1;
-		Data.MeshCount = 1;
-
-		RawMaterial Mat = { };
-		Data.Materials.push_back(Mat); // random mat
-
-		Data.WorldMatrices.push_back(Matrix4D::Identity());
-
-		H2B::MESH M;
-		M.materialIndex = 0;
-		M.name = "nullptr";
-		M.drawInfo.indexCount = Frustum::GetFrustumIndexCount();
-		M.drawInfo.indexOffset = 0;
+		World->ReadRawData(RawData);
 
-		Data.Meshes.push_back(M);
-
-		RawData.push_back(Data);
+		AppendFrustumDebugMesh(RawData);
 
 		StaticMeshes = World->Load(RawData);
 
 		StaticMesh MeshCpy = StaticMeshes[StaticMeshes.size() - 1];
 		DebugMeshes.push_back(MeshCpy);
 		StaticMeshes.pop_back();
+		ShowAllInstances();
 
 		// Descriptor pipeline layout
 
@@ -485,6 +492,9 @@ public:
 		PipelineCreator.SetLayoutCreateInfo(DescSetLayouts.size(), *DescSetLayouts.data());
 		PipelineCreator.CreatePipelineLayout(&device, pipelineLayout);
 
+		/* Culling binds the same storage set */
+		Culling.CreatePipeline(device, ComputeShader_Cull, *DescSetLayouts[0]);
+
 		// Pipeline State... (FINALLY) 
 		PipelineCreator.SetGraphicsPipelineCreateInfo(&pipelineLayout, &renderPass);
 		PipelineCreator.CreateGraphicsPipelines(&device, Pipeline_Normal);
@@ -509,6 +519,7 @@ public:
 		* TODO: Not make this hardcoded size to one
 		*/
 		PipelineCreator.SetInputAssemblyStateCreateInfo(VK_PRIMITIVE_TOPOLOGY_LINE_LIST);
+		PipelineCreator.SetVertexLayout(0, Vertex::GetLayout());
 		PipelineCreator.ClearStageCreateInfos();
 		PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_VERTEX_BIT, &VertexShader_Basic);
 		PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_FRAGMENT_BIT, &PixelShader_Basic);
@@ -529,7 +540,7 @@ public:
 
 
 #if DRAW_LIGHTS
-		LightPos = Vector3D(World->ShaderSceneData[0].PointLights[0].Position.X, World->ShaderSceneData[0].PointLights[0].Position.Y, World->ShaderSceneData[0].PointLights[0].Position.Z);
+		LightPos = Vector3D(World->PointLights[0].Position.X, World->PointLights[0].Position.Y, World->PointLights[0].Position.Z);
 #endif
 
 		InitImguiResources();
@@ -574,8 +585,25 @@ public:
 		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
+		/*
+		* Before Bind(), it flushes the draw list with the rest of the level's storage, GPU culling starts from every instance
+		*	Only rebuilt when the meshes or the CPU culled instances changed, what GPU culling starts from is fixed after a load
+		*/
+		bool CullOnGpu = IsGpuCullingActive();
+		bool CullOnCpu = ENABLE_FRUSTUM_CULLING && !CullOnGpu;
+		if (OpaqueDrawsChanged)
+		{
+			World->OpaqueDraws.Build(StaticMeshes, CullOnCpu ? &VisibleInstanceIDs : nullptr);
+			OpaqueDrawsChanged = false;
+		}
 		World->Bind();
 
+		/* The frame is inside its render pass, the dispatch goes into the upload batch's graphics command buffer submitted ahead of it */
+		if (CullOnGpu)
+		{
+			Culling.Record(UploadService::Get().GetBatchCommandBuffer(), World->GetShaderStorageDescSet(currentBuffer), CameraFrustum, World->OpaqueDraws);
+		}
+
 		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, *CurrentPipeline);
 		ConstantBuffer Buffer = { };
 
@@ -588,41 +616,29 @@ public:
 		TempColor.Z = (sin(GridColor.Z * 0.1f) + 1.0f) * 0.5f;
 
 		Buffer.FresnelColor = TempColor;
+		Buffer.ViewMatID = 0;
 
-		for (uint32 i = 0; i < RenderMeshes.size(); ++i)
-		{
-			Buffer.MeshID = RenderMeshes[i].GetWorldMatrixIndex();
+		/* Mesh, material and texture IDs come from the draw list, only what every draw shares is pushed */
+		vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT |
+			VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(ConstantBuffer), &Buffer);
 
-			for (uint32 j = 0; j < RenderMeshes[i].GetMeshCount(); ++j)
-			{
-				Buffer.MaterialID = RenderMeshes[i].GetMaterialIndex() + RenderMeshes[i].GetSubMeshMaterialIndex(j);
-				Buffer.DiffuseTextureID = RenderMeshes[i].GetSubMeshDiffuseTextureIndex(j);
-				Buffer.SpecularTextureID = RenderMeshes[i].GetSubMeshSpecularTextureIndex(j);
-				Buffer.NormalTextureID = RenderMeshes[i].GetSubMeshNormalTextureIndex(j);
-				Buffer.ViewMatID = 0;
-
-				vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT |
-					VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(ConstantBuffer), &Buffer);
-				vkCmdDrawIndexed(commandBuffer,
-					RenderMeshes[i].GetSubMeshIndexCount(j),
-					RenderMeshes[i].GetInstanceCount(),
-					RenderMeshes[i].GetIndexOffset() + RenderMeshes[i].GetSubMeshIndexOffset(j),
-					RenderMeshes[i].GetVertexOffset(), 0);
-			}
-		}
+		/* One indirect draw per index width, with GPU culling the instance counts are the culling pass' */
+		World->OpaqueDraws.Record(commandBuffer, currentBuffer, World->GetLevelData());
 
 
 
 #if DRAW_LIGHTS
 		/* Draw AABBS */
 		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline_Debug);
-
+		World->GetLevelData()->BindDynamic();
 
 		Matrix4D Mat = Matrix4D::Identity();
 		//Mat.ScaleMatrix(-0.75f);
-		World->ShaderSceneData[0].PointLights[0].Position = LightPos;
+		World->PointLights[0].Position = LightPos;
 		Mat.SetTranslation(LightPos);
-		World->ShaderSceneData[0].WorldMatrices[0] = Mat;
+		World->WorldMatrices[0] = Mat;
+		World->PointLights.MarkDirty(0);
+		World->WorldMatrices.MarkDirty(0);
 
 		Buffer.MeshID = 0;// StaticMeshes[i].GetWorldMatrixIndex();
 		Buffer.ViewMatID = 0;
@@ -634,9 +650,10 @@ public:
 			24,
 			StaticMeshes[0].GetInstanceCount(),
 			World->GetLevelData()->DebugBoxIndexStart,
-			World->GetLevelData()->DebugBoxVertexStart, 0);
+			World->GetLevelData()->DebugBoxVertexStart - World->GetLevelData()->DynamicVertexStart, 0);
 
 		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, *CurrentPipeline);
+		World->GetLevelData()->Bind();
 #endif // DRAW_LIGHTS
 
 
@@ -725,6 +742,10 @@ public:
 			/* Draw AABBS */
 			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline_Debug);
 
+			/* Debug geometry is in the dynamic buffer, offsets are relative to its start */
+			World->GetLevelData()->BindDynamic();
+			uint32 DynamicVertexStart = World->GetLevelData()->DynamicVertexStart;
+
 			for (uint32 i = 0; i < StaticMeshes.size(); ++i)
 			{
 				Buffer.MeshID = StaticMeshes[i].GetWorldMatrixIndex();
@@ -737,7 +758,7 @@ public:
 					24,
 					StaticMeshes[i].GetInstanceCount(),
 					World->GetLevelData()->DebugBoxIndexStart,
-					World->GetLevelData()->DebugBoxVertexStart + (i * 8), 0);
+					World->GetLevelData()->DebugBoxVertexStart - DynamicVertexStart + (i * 8), 0);
 			}
 
 			/* Draw Frustum */
@@ -751,7 +772,7 @@ public:
 				Frustum::GetFrustumIndexCount(),
 				1,
 				World->GetLevelData()->DebugBoxIndexStart - 24,
-				World->GetLevelData()->DebugBoxVertexStart - 8, 0);
+				World->GetLevelData()->DebugBoxVertexStart - DynamicVertexStart - 8, 0);
 
 			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline_Debug2);
 
@@ -767,6 +788,9 @@ public:
 		/*--------------------------------------------------DEBUG-------------------------------------------------------*/
 
 		RenderImGui(commandBuffer);
+
+		/* Before EndFrame() so the frame is submitted after this frame's uploads */
+		UploadService::Get().Submit();
 	}
 	// TODO: Part 4b
 	void UpdateCamera()
@@ -774,6 +798,9 @@ public:
 		using namespace GW::MATH;
 		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
 
+		/* StartFrame() waited on this frame's fence, what the frame that last used it retired can go */
+		DeletionQueue::Get().BeginFrame();
+
 		// Define All Of the Key/Controller State Variables 
 		float RightTriggerState = 0, LeftTriggerState = 0, LeftStickYAxis = 0, LeftStickXAxis = 0, RightStickYAxis = 0, RightStickXAxis = 0;
 		float WKeyState, SKeyState = 0, AKeyState = 0, DKeyState = 0, SpaceKeyState = 0, LeftShiftKeyState = 0;
@@ -830,13 +857,10 @@ public:
 
 		if (FKeyState > 0)
 		{
+			/* The current level keeps rendering while the next one streams in, only one level streams at a time */
 			std::string FilePath;
-			if (FileHelper::OpenFileDialog(FilePath))
+			if (!Streamer.IsBusy() && FileHelper::OpenFileDialog(FilePath))
 			{
-				vkDeviceWaitIdle(device);
-				delete World;
-				StaticMeshes.clear();
-
 				std::string LevelName;
 				uint32 PeriodIndex = -1;
 				uint32 LastSlashIndex = -1;
@@ -859,110 +883,15 @@ public:
 					LevelName.push_back(FilePath[i]);
 				}
 
-				World = new Level(&device, &vlk, &pipelineLayout, LevelName.c_str(), FilePath.c_str());
-
-				{
-					/* Load the file */
-					std::vector<RawMeshData> RawData;
-					FileHelper::ReadGameLevelFile(FilePath.c_str(), RawData);
-
-					H2B::VERTEX V;
-					V.pos = { 0,0,0 };
-
-					RawMeshData Data;
-					Data.IndexCount = Frustum::GetFrustumIndexCount();
-					Data.VertexCount = Frustum::GetFrustumVertexCount();
-
-					Data.Vertices.resize(Frustum::GetFrustumVertexCount());
-					for (uint32 i = 0; i < Frustum::GetFrustumVertexCount(); ++i)
-					{
-						Data.Vertices[i] = V; // empty vector
-					}
-
-					Data.Indices.resize(Frustum::GetFrustumIndexCount());
-					uint32* Indices = Frustum::GetFrustumIndices();
-					for (uint32 i = 0; i < Frustum::GetFrustumIndexCount(); ++i)
-					{
-						Data.Indices[i] = Indices[i];
-					}
-
-					Data.InstanceCount = 1;
-					Data.MaterialCount = 1;
-					Data.MeshCount = 1;
-
-					RawMaterial Mat;
-					Data.Materials.push_back(Mat); // random mat
-
-					Data.WorldMatrices.push_back(Matrix4D::Identity());
-
-					H2B::MESH M;
-					M.materialIndex = 0;
-					M.name = "nullptr";
-					M.drawInfo.indexCount = Frustum::GetFrustumIndexCount();
-					M.drawInfo.indexOffset = 0;
-
-					Data.Meshes.push_back(M);
-
-					RawData.push_back(Data);
-
-					StaticMeshes = World->Load(RawData);
-
-					StaticMesh MeshCpy = StaticMeshes[StaticMeshes.size() - 1];
-					DebugMeshes.clear();
-					DebugMeshes.push_back(MeshCpy);
-					StaticMeshes.pop_back();
-				}
-
-				{
-					vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
-					vkDestroyPipeline(device, Pipeline_Normal, nullptr);
-					vkDestroyPipeline(device, Pipeline_Fresnel, nullptr);
-					vkDestroyPipeline(device, Pipeline_FresnelNormal, nullptr);
-					vkDestroyPipeline(device, Pipeline_Toon, nullptr);
-
-					VkRenderPass renderPass;
-					vlk.GetRenderPass((void**)&renderPass);
-
-					std::vector<VkDescriptorSetLayout*> DescSetLayouts = World->GetShaderStorageDescSetLayouts();
-					PipelineCreator.SetLayoutCreateInfo(DescSetLayouts.size(), *DescSetLayouts.data());
-
-					PipelineCreator.CreatePipelineLayout(&device, pipelineLayout);
-					PipelineCreator.SetGraphicsPipelineCreateInfo(&pipelineLayout, &renderPass);
-
-					PipelineCreator.SetInputAssemblyStateCreateInfo(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
-
-					PipelineCreator.ClearStageCreateInfos();
-					PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_VERTEX_BIT, &VertexShader_Normal);
-					PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_FRAGMENT_BIT, &PixelShader_Normal);
-					PipelineCreator.CreateGraphicsPipelines(&device, Pipeline_Normal);
-
-					PipelineCreator.ClearStageCreateInfos();
-					PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_VERTEX_BIT, &VertexShader_Normal);
-					PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_FRAGMENT_BIT, &PixelShader_Toon);
-					PipelineCreator.CreateGraphicsPipelines(&device, Pipeline_Toon);
-
-					PipelineCreator.ClearStageCreateInfos();
-					PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_VERTEX_BIT, &VertexShader_Normal);
-					PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_FRAGMENT_BIT, &PixelShader_Fresnel);
-					PipelineCreator.CreateGraphicsPipelines(&device, Pipeline_Fresnel);
-
-					PipelineCreator.ClearStageCreateInfos();
-					PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_VERTEX_BIT, &VertexShader_Normal);
-					PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_FRAGMENT_BIT, &PixelShader_FresnelNormal);
-					PipelineCreator.CreateGraphicsPipelines(&device, Pipeline_FresnelNormal);
-
-				}
-
-				CameraView1 = World->GetViewMatrix1();
-				CameraView2 = World->GetViewMatrix2();
-				CameraView3 = World->GetViewMatrix3();
-
-#if DRAW_LIGHTS
-				LightPos = Vector3D(World->ShaderSceneData[0].PointLights[0].Position.X, World->ShaderSceneData[0].PointLights[0].Position.Y, World->ShaderSceneData[0].PointLights[0].Position.Z);
-#endif
+				Streamer.Begin(new Level(&device, &vlk, &pipelineLayout, LevelName.c_str(), FilePath.c_str()), &Renderer::AppendFrustumDebugMesh);
 			}
 		}
 
+		if (Streamer.IsReadyToSwap())
+		{
+			SwapStreamedLevel();
+		}
+
 		if (Input.GetState(G_KEY_L, LKeyState) == GW::GReturn::SUCCESS && LKeyState > 0)
 		{
 			CaptureInput = false;
@@ -1141,7 +1070,7 @@ public:
 
 			CameraFrustum.CreateFrustum(Pos, Right, UP, Forw);
 			CameraFrustum.DebugUpdateNormalVerts(World->GetLevelData()->GetVertices()->size() - 12, World->GetLevelData()->GetVertices());
-			CameraFrustum.DebugUpdateVertices(World->GetLevelData()->DebugBoxVertexStart - Frustum::GetFrustumVertexCount(), Vertices);
+			CameraFrustum.DebugUpdateVertices(World->GetLevelData()->DebugBoxVertexStart - World->GetLevelData()->DynamicVertexStart - Frustum::GetFrustumVertexCount(), Vertices);
 			World->GetLevelData()->UpdateVertexBuffer();
 #endif
 
@@ -1165,26 +1094,43 @@ public:
 		}
 
 #if ENABLE_FRUSTUM_CULLING
-		uint32 RemovedGPUCalls = 0;
-		RenderMeshes.clear();
-		for (uint32 i = 0; i < StaticMeshes.size(); ++i)
+		/* Every instance on its own, the culling pass does the same on the GPU */
+		if (!IsGpuCullingActive())
 		{
-			/* --> Make the box in ndc space */
-			Vector4D MinBox4D = World->ShaderSceneData->WorldMatrices[StaticMeshes[i].GetWorldMatrixIndex()] * Vector4D(StaticMeshes[i].MinBox_AABB, 1.0f);
-			Vector4D MaxBox4D = World->ShaderSceneData->WorldMatrices[StaticMeshes[i].GetWorldMatrixIndex()] * Vector4D(StaticMeshes[i].MaxBox_AABB, 1.0f);
+			/* Only the instances that moved get new boxes */
+			InstanceBounds.Update(StaticMeshes, World->WorldMatrices.Elements);
 
-			Vector3D MinBox = Vector3D(MinBox4D.X, MinBox4D.Y, MinBox4D.Z);
-			Vector3D MaxBox = Vector3D(MaxBox4D.X, MaxBox4D.Y, MaxBox4D.Z);
+			std::chrono::steady_clock::time_point CullBegin = std::chrono::steady_clock::now();
+			CameraFrustum.TestAABBs(InstanceBounds.Boxes, VisibleBoxMask);
+			std::chrono::steady_clock::time_point CullEnd = std::chrono::steady_clock::now();
 
-			if (CameraFrustum.TestAABB(MinBox, MaxBox) == PlaneIntersectionResult::Back)
-			{
-				StaticMeshes[i].Color_AABB = RED;
-				RemovedGPUCalls++;
-			}
-			else
+			size_t BoxCount = InstanceBounds.Boxes.Size();
+			CullNsPerBox = BoxCount > 0 ? std::chrono::duration<float, std::nano>(CullEnd - CullBegin).count() / BoxCount : 0.0f;
+
+			VisibleInstanceIDs.resize(StaticMeshes.size());
+			for (uint32 i = 0; i < StaticMeshes.size(); ++i)
 			{
-				StaticMeshes[i].Color_AABB = GREEN;
-				RenderMeshes.push_back(StaticMeshes[i]);
+				CulledInstanceIDs.clear();
+
+				uint32 FirstBox = InstanceBounds.GetFirstBox(i);
+				for (uint32 j = 0; j < StaticMeshes[i].GetInstanceCount(); ++j)
+				{
+					uint32 Box = FirstBox + j;
+					if (VisibleBoxMask[Box / 32] & (1u << (Box % 32)))
+					{
+						CulledInstanceIDs.push_back(j);
+					}
+				}
+
+				/* A still camera over still instances leaves the draw list as it is */
+				if (CulledInstanceIDs != VisibleInstanceIDs[i])
+				{
+					VisibleInstanceIDs[i].swap(CulledInstanceIDs);
+					OpaqueDrawsChanged = true;
+				}
+
+				/* The debug boxes are drawn per mesh */
+				StaticMeshes[i].Color_AABB = VisibleInstanceIDs[i].empty() ? RED : GREEN;
 			}
 		}
 #endif
@@ -1207,6 +1153,172 @@ public:
 		TimePassed = std::chrono::duration_cast<ms>(end - begin).count();
 	}
 
+	/* Every instance of every mesh visible, until the CPU culling replaces them, for a level that was just loaded */
+	void ShowAllInstances()
+	{
+		OpaqueDrawsChanged = true;
+
+		VisibleInstanceIDs.resize(StaticMeshes.size());
+		for (uint32 i = 0; i < StaticMeshes.size(); ++i)
+		{
+			std::vector<uint32>& MeshVisibleInstances = VisibleInstanceIDs[i];
+			MeshVisibleInstances.resize(StaticMeshes[i].GetInstanceCount());
+			for (uint32 j = 0; j < MeshVisibleInstances.size(); ++j)
+			{
+				MeshVisibleInstances[j] = j;
+			}
+		}
+	}
+
+	/* Culling writes the commands, so they have to be read as an indirect buffer */
+	bool IsGpuCullingActive()
+	{
+#if ENABLE_FRUSTUM_CULLING && ENABLE_GPU_CULLING
+		return World->OpaqueDraws.UsesMultiDrawIndirect();
+#else
+		return false;
+#endif
+	}
+
+	/*
+	* Swaps in the level the streamer finished, called between StartFrame() and Render() so the current
+	*	command buffer has not recorded anything from the old level yet, the frames in flight may still use it so it is retired
+	*/
+	void SwapStreamedLevel()
+	{
+		std::vector<StaticMesh> NewStaticMeshes;
+		Level* NewWorld = Streamer.Finish(NewStaticMeshes);
+		if (NewWorld == nullptr)
+		{
+			return;
+		}
+
+		Level* OldWorld = World;
+		DeletionQueue::Get().Retire([OldWorld]() { delete OldWorld; });
+		World = NewWorld;
+
+		StaticMeshes = std::move(NewStaticMeshes);
+		InstanceBounds.Invalidate();
+
+		/* Frustum mesh is always the last mesh */
+		DebugMeshes.clear();
+		DebugMeshes.push_back(StaticMeshes[StaticMeshes.size() - 1]);
+		StaticMeshes.pop_back();
+
+		/* The culling in UpdateCamera() is skipped while input is not captured */
+		ShowAllInstances();
+
+		/* Texture count is baked into the level's descriptor set layouts */
+		RebuildLevelPipelines();
+
+		CameraView1 = World->GetViewMatrix1();
+		CameraView2 = World->GetViewMatrix2();
+		CameraView3 = World->GetViewMatrix3();
+
+#if DRAW_LIGHTS
+		LightPos = Vector3D(World->PointLights[0].Position.X, World->PointLights[0].Position.Y, World->PointLights[0].Position.Z);
+#endif
+	}
+
+	/* Recreates the pipeline layout and the shading pipelines against World's descriptor set layouts */
+	void RebuildLevelPipelines()
+	{
+		/* Frames in flight may still be using the old ones */
+		VkDevice Device = device;
+		VkPipelineLayout OldPipelineLayout = pipelineLayout;
+		VkPipeline OldPipelines[] = { Pipeline_Normal, Pipeline_Fresnel, Pipeline_FresnelNormal, Pipeline_Toon };
+		DeletionQueue::Get().Retire([Device, OldPipelineLayout, OldPipelines]()
+			{
+				vkDestroyPipelineLayout(Device, OldPipelineLayout, nullptr);
+				for (uint32 i = 0; i < 4; ++i)
+				{
+					vkDestroyPipeline(Device, OldPipelines[i], nullptr);
+				}
+			});
+
+		VkRenderPass renderPass;
+		vlk.GetRenderPass((void**)&renderPass);
+
+		std::vector<VkDescriptorSetLayout*> DescSetLayouts = World->GetShaderStorageDescSetLayouts();
+		PipelineCreator.SetLayoutCreateInfo(DescSetLayouts.size(), *DescSetLayouts.data());
+
+		PipelineCreator.CreatePipelineLayout(&device, pipelineLayout);
+		PipelineCreator.SetGraphicsPipelineCreateInfo(&pipelineLayout, &renderPass);
+
+		Culling.CreatePipeline(device, ComputeShader_Cull, *DescSetLayouts[0]);
+
+		PipelineCreator.SetInputAssemblyStateCreateInfo(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+		PipelineCreator.SetVertexLayout(0, PackedVertex::GetLayout());
+
+		PipelineCreator.ClearStageCreateInfos();
+		PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_VERTEX_BIT, &VertexShader_Normal);
+		PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_FRAGMENT_BIT, &PixelShader_Normal);
+		PipelineCreator.CreateGraphicsPipelines(&device, Pipeline_Normal);
+
+		PipelineCreator.ClearStageCreateInfos();
+		PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_VERTEX_BIT, &VertexShader_Normal);
+		PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_FRAGMENT_BIT, &PixelShader_Toon);
+		PipelineCreator.CreateGraphicsPipelines(&device, Pipeline_Toon);
+
+		PipelineCreator.ClearStageCreateInfos();
+		PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_VERTEX_BIT, &VertexShader_Normal);
+		PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_FRAGMENT_BIT, &PixelShader_Fresnel);
+		PipelineCreator.CreateGraphicsPipelines(&device, Pipeline_Fresnel);
+
+		PipelineCreator.ClearStageCreateInfos();
+		PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_VERTEX_BIT, &VertexShader_Normal);
+		PipelineCreator.AddNewStageCreateInfo(VK_SHADER_STAGE_FRAGMENT_BIT, &PixelShader_FresnelNormal);
+		PipelineCreator.CreateGraphicsPipelines(&device, Pipeline_FresnelNormal);
+	}
+
+	/*
+	* Adds the camera frustum debug mesh, it has to be the last mesh so it can be split off into DebugMeshes after loading
+	*	Vertices are placeholders, they are rewritten every frame by Frustum::DebugUpdateVertices()
+	*/
+	static void AppendFrustumDebugMesh(std::vector<RawMeshData>& rawData)
+	{
+		Frustum CamF;
+
+		H2B::VERTEX V;
+		V.pos = reinterpret_cast<H2B::VECTOR&>(CamF.FarPlaneTopLeft);
+
+		RawMeshData Data;
+		Data.IndexCount = Frustum::GetFrustumIndexCount();
+		Data.VertexCount = Frustum::GetFrustumVertexCount();
+
+		Data.Vertices.resize(Frustum::GetFrustumVertexCount());
+		for (uint32 i = 0; i < Frustum::GetFrustumVertexCount(); ++i)
+		{
+			Data.Vertices[i] = V; // empty vector
+		}
+
+		Data.Indices.resize(Frustum::GetFrustumIndexCount());
+		uint32* Indices = Frustum::GetFrustumIndices();
+		for (uint32 i = 0; i < Frustum::GetFrustumIndexCount(); ++i)
+		{
+			Data.Indices[i] = Indices[i];
+		}
+
+		Data.InstanceCount = 1;
+		Data.MaterialCount = 1;
+		Data.MeshCount = 1;
+
+		RawMaterial Mat = { };
+		Data.Materials.push_back(Mat); // random mat
+
+		Data.WorldMatrices.push_back(Matrix4D::Identity());
+
+		H2B::MESH M;
+		M.materialIndex = 0;
+		M.name = "nullptr";
+		M.drawInfo.indexCount = Frustum::GetFrustumIndexCount();
+		M.drawInfo.indexOffset = 0;
+
+		Data.Meshes.push_back(M);
+
+		rawData.push_back(Data);
+	}
+
 	void NewImguiFrame()
 	{
 		ImGui::NewFrame();
@@ -1217,6 +1329,64 @@ public:
 
 		//ImGui::End();
 
+		if (Streamer.IsBusy())
+		{
+			ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f));
+			ImGui::Begin("Level Streaming", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoInputs);
+			ImGui::Text("Loading %s...", Streamer.GetLevelName().c_str());
+			ImGui::ProgressBar(Streamer.GetProgress(), ImVec2(200.0f, 0.0f));
+			ImGui::End();
+		}
+
+#if DEBUG
+		if (World != nullptr)
+		{
+			const FrameRingBuffer::Stats& UploadStats = World->GetSceneDataUploadStats();
+
+			ImGui::SetNextWindowPos(ImVec2(10.0f, ImGui::GetIO().DisplaySize.y - 200.0f));
+			ImGui::Begin("Scene Data Uploads", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoInputs);
+			ImGui::Text("Scene data: %zu / %zu bytes this frame (%u ranges)", UploadStats.BytesUploadedLastFrame, UploadStats.SliceSizeInBytes, UploadStats.RangesUploadedLastFrame);
+			ImGui::Text("Total uploaded: %.2f MB", UploadStats.TotalBytesUploaded / (1024.0f * 1024.0f));
+
+			GpuMemoryAllocator::Stats MemoryStats = GpuMemory::Get().GetStats();
+			ImGui::Text("GPU memory: %.2f MB used in %u allocations, %.2f MB in %u blocks", MemoryStats.UsedBytes / (1024.0f * 1024.0f),
+				MemoryStats.AllocationCount, MemoryStats.BlockBytes / (1024.0f * 1024.0f), MemoryStats.BlockCount);
+
+			GeometryPool::Stats PoolStats = GeometryPool::Get().GetStats();
+			ImGui::Text("Geometry pool: %u meshes, vertices %u / %u (%u free ranges, %.0f%% fragmented), indices %u / %u (%u free ranges, %.0f%% fragmented)",
+				PoolStats.MeshCount, PoolStats.VerticesUsed, PoolStats.VertexCapacity, PoolStats.VertexFreeRangeCount, PoolStats.VertexFragmentation * 100.0f,
+				PoolStats.IndicesUsed, PoolStats.IndexCapacity, PoolStats.IndexFreeRangeCount, PoolStats.IndexFragmentation * 100.0f);
+			ImGui::Text("Last level load: %u meshes uploaded, %u reused", PoolStats.MeshesUploadedLastAcquire, PoolStats.MeshesReusedLastAcquire);
+			ImGui::Text("16 bit indices: %u / %u (%u free ranges), level saves %.2f KB of index memory", PoolStats.ShortIndicesUsed, PoolStats.ShortIndexCapacity,
+				PoolStats.ShortIndexFreeRangeCount, World->GetLevelData()->GetIndexBytesSaved() / 1024.0f);
+
+			DeletionQueue::Stats DeletionStats = DeletionQueue::Get().GetStats();
+			ImGui::Text("Deferred deletions: %u pending, %u destroyed this frame", DeletionStats.PendingCount, DeletionStats.DestroyedLastFrame);
+
+			const UploadService::Stats& UploadBatchStats = UploadService::Get().GetStats();
+			ImGui::Text("Upload batches: %u submitted, last one %u copies (%.2f KB), %.2f MB total, copied on the %s queue", UploadBatchStats.SubmitCount,
+				UploadBatchStats.CopiesLastSubmit, UploadBatchStats.BytesLastSubmit / 1024.0f, UploadBatchStats.TotalBytesUploaded / (1024.0f * 1024.0f),
+				UploadBatchStats.UsesTransferQueue ? "transfer" : "graphics");
+
+			const DrawList::Stats& DrawStats = World->OpaqueDraws.GetStats();
+			ImGui::Text("Opaque pass: %u draws, %u instances in %u %s calls, recorded in %.3f ms", DrawStats.DrawCount, DrawStats.InstanceCount,
+				DrawStats.CallCount, DrawStats.UsesMultiDrawIndirect ? "indirect" : "direct", DrawStats.RecordTimeMs);
+
+			if (IsGpuCullingActive())
+			{
+				const GpuCulling::Stats& CullStats = Culling.GetStats();
+				ImGui::Text("GPU culling: %u instances of %u draws tested", CullStats.InstancesTested, CullStats.DrawsCulled);
+			}
+			else
+			{
+				ImGui::Text("GPU culling: off, %u of %u instances visible to the CPU culling", DrawStats.VisibleInstanceCount, DrawStats.InstanceCount);
+				ImGui::Text("Instance bounds: %u cached, %u recomputed this frame, tested in %.2f ns per box", InstanceBounds.GetStats().BoxCount,
+					InstanceBounds.GetStats().RecomputedLastUpdate, CullNsPerBox);
+			}
+			ImGui::End();
+		}
+#endif // DEBUG
+
 		// Render to generate draw buffers
 		ImGui::Render();
 	}
@@ -1234,75 +1404,40 @@ public:
 			return;
 		}
 
-		GW::GReturn Result;
-		VkPhysicalDevice PhysicalDevice = nullptr;
-		if ((Result = vlk.GetPhysicalDevice((void**)&PhysicalDevice)) != GW::GReturn::SUCCESS)
-		{
-			std::cout << "\n[Gateware] Failed to get PhysicalDevice....";
-			return;
-		}
-
 		// Update buffers only if vertex or index count has been changed compared to current buffer size
 		// Vertex buffer
 		if ((ImguiVertexBuffer == VK_NULL_HANDLE) || (ImguiVertexCount != imDrawData->TotalVtxCount))
 		{
-			{
-				if (ImguiVertexBufferMapped)
-				{
-					vkUnmapMemory(device, ImguiVertexBufferData);
-					ImguiVertexBufferMapped = nullptr;
-				}
+			/* Frames in flight may still draw from the old buffer */
+			DeletionQueue::Get().RetireBuffer(ImguiVertexBuffer, ImguiVertexBufferMemory);
 
-				if (ImguiVertexBuffer)
-				{
-					vkDeviceWaitIdle(device);
-					vkDestroyBuffer(device, ImguiVertexBuffer, nullptr);
-					vkFreeMemory(device, ImguiVertexBufferData, nullptr);
-				}
-			}
-
-			{
-
-				GvkHelper::create_buffer(PhysicalDevice, device, vertexBufferSize,
-					VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-					VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &ImguiVertexBuffer, &ImguiVertexBufferData);
-			}
+			GpuMemory::Get().CreateBuffer(vertexBufferSize,
+				VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+				VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &ImguiVertexBuffer, &ImguiVertexBufferMemory);
 
 			ImguiVertexCount = imDrawData->TotalVtxCount;
-			ImguiVertexBufferMapped = new ImDrawVert[ImguiVertexCount];
-			vkMapMemory(device, ImguiVertexBufferData, 0, VK_WHOLE_SIZE, 0, &ImguiVertexBufferMapped);
 		}
 
 		// Index buffer
 		if ((ImguiIndexBuffer == VK_NULL_HANDLE) || (ImguiIndexCount < imDrawData->TotalIdxCount))
 		{
-			{
-				if (ImguiIndexBufferMapped)
-				{
-					vkUnmapMemory(device, ImguiIndexBufferData);
-					ImguiIndexBufferMapped = nullptr;
-				}
+			DeletionQueue::Get().RetireBuffer(ImguiIndexBuffer, ImguiIndexBufferMemory);
 
-				if (ImguiIndexBuffer)
-				{
-					vkDestroyBuffer(device, ImguiIndexBuffer, nullptr);
-					vkFreeMemory(device, ImguiIndexBufferData, nullptr);
-				}
-			}
-
-			GvkHelper::create_buffer(PhysicalDevice, device, indexBufferSize,
+			GpuMemory::Get().CreateBuffer(indexBufferSize,
 				VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-				VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &ImguiIndexBuffer, &ImguiIndexBufferData);
+				VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &ImguiIndexBuffer, &ImguiIndexBufferMemory);
 
 			ImguiIndexCount = imDrawData->TotalIdxCount;
-			ImguiIndexBufferMapped = new ImDrawIdx[ImguiIndexCount];
+		}
 
-			vkMapMemory(device, ImguiIndexBufferData, 0, VK_WHOLE_SIZE, 0, &ImguiIndexBufferMapped);
+		if (ImguiVertexBufferMemory.Mapped == nullptr || ImguiIndexBufferMemory.Mapped == nullptr)
+		{
+			return;
 		}
 
-		// Upload data
-		ImDrawVert* vtxDst = (ImDrawVert*)ImguiVertexBufferMapped;
-		ImDrawIdx* idxDst = (ImDrawIdx*)ImguiIndexBufferMapped;
+		// Upload data, both buffers stay mapped
+		ImDrawVert* vtxDst = (ImDrawVert*)ImguiVertexBufferMemory.Mapped;
+		ImDrawIdx* idxDst = (ImDrawIdx*)ImguiIndexBufferMemory.Mapped;
 
 		for (int n = 0; n < imDrawData->CmdListsCount; n++) {
 			const ImDrawList* cmd_list = imDrawData->CmdLists[n];
@@ -1312,24 +1447,9 @@ public:
 			idxDst += cmd_list->IdxBuffer.Size;
 		}
 
-		//GvkHelper::write_to_buffer(device, ImguiVertexBufferData, ImguiVertexBufferMapped, vertexBufferSize);
-		//GvkHelper::write_to_buffer(device, ImguiIndexBufferData, ImguiIndexBufferMapped, indexBufferSize);
-
 		// Flush to make writes visible to GPU
-		VkMappedMemoryRange mappedRangeV = {};
-		mappedRangeV.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-		mappedRangeV.memory = ImguiVertexBufferData;
-		mappedRangeV.offset = 0;
-		mappedRangeV.size = VK_WHOLE_SIZE;
-
-		vkFlushMappedMemoryRanges(device, 1, &mappedRangeV);
-
-		VkMappedMemoryRange mappedRangeI = {};
-		mappedRangeI.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-		mappedRangeI.memory = ImguiIndexBufferData;
-		mappedRangeI.offset = 0;
-		mappedRangeI.size = VK_WHOLE_SIZE;
-		vkFlushMappedMemoryRanges(device, 1, &mappedRangeI);
+		GpuMemory::Get().Flush(ImguiVertexBufferMemory);
+		GpuMemory::Get().Flush(ImguiIndexBufferMemory);
 	}
 
 	// Draw current imGui frame into a command buffer
@@ -2118,7 +2238,10 @@ private:
 	void CleanUp()
 	{
 		// wait till everything has completed
+		UploadService::Get().Submit();
 		vkDeviceWaitIdle(device);
+		DeletionQueue::Get().Flush();
+		UploadService::Get().Shutdown();
 		ImGui::DestroyContext();
 
 		// Release allocated buffers, shaders & pipeline
@@ -2131,6 +2254,8 @@ private:
 		vkDestroyShaderModule(device, PixelShader_Toon, nullptr);
 		vkDestroyShaderModule(device, PixelShader_Fresnel, nullptr);
 		vkDestroyShaderModule(device, PixelShader_FresnelNormal, nullptr);
+		vkDestroyShaderModule(device, ComputeShader_Cull, nullptr);
+		Culling.Destroy();
 		vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
 		vkDestroyPipeline(device, Pipeline_Normal, nullptr);
 		vkDestroyPipeline(device, Pipeline_Toon, nullptr);
@@ -2157,15 +2282,20 @@ private:
 		vkDestroyShaderModule(device, VertexShader_ImGui, nullptr);
 		vkDestroyShaderModule(device, PixelShader_ImGui, nullptr);
 
-		vkDestroyBuffer(device, ImguiVertexBuffer, nullptr);
-		vkDestroyBuffer(device, ImguiIndexBuffer, nullptr);
+		GpuMemory::Get().DestroyBuffer(ImguiVertexBuffer, ImguiVertexBufferMemory);
+		GpuMemory::Get().DestroyBuffer(ImguiIndexBuffer, ImguiIndexBufferMemory);
 
-		vkFreeMemory(device, ImguiVertexBufferData, nullptr);
-		vkFreeMemory(device, ImguiIndexBufferData, nullptr);
+		Streamer.Cancel();
 
 		if (World)
 		{
 			delete World;
+			World = nullptr;
 		}
+
+		GeometryPool::Get().Shutdown();
+
+		/* Last, every buffer above came out of it */
+		GpuMemory::Get().Shutdown();
 	}
 };